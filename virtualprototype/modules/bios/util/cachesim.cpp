@@ -0,0 +1,441 @@
+/*==============================================================================
+ *
+ * DESC    : Trace driven model of the OR1300 instruction and data caches
+ *
+ *==============================================================================
+ *
+ *  The model follows i-cache.v and d-cache.v line by line for everything that
+ *  decides hits and misses: the set mapping, the per set policy state (FIFO
+ *  counter, 5 bit PLRU and 2 bit LRU counters) with the same victim selection
+ *  and update rules, way locking, and the write-back/write-through and region
+ *  rules of the D$. Timing, the prefetcher, the victim buffer and the write
+ *  buffer are not modelled.
+ *
+ *  The caches are configured with the values software writes with
+ *  icache_write_cfg()/dcache_write_cfg() (see cache.h), either as a number or as
+ *  a comma separated list, e.g. "4k,4way,lru,wb". Several D$ configurations can
+ *  be given; they all run on the same trace.
+ *
+ *  Trace format (one access per line, addresses in hex, '#' starts a comment):
+ *    I <addr>   instruction fetch        R <addr>   load
+ *    W <addr>   store                    F          flush both caches
+ *    SR <addr>  bus read of another master (snoop)
+ *    SW <addr>  bus write of another master (snoop)
+ *  The din format (0 = load, 1 = store, 2 = fetch) is accepted as well.
+ *
+ *============================================================================*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+enum Event {
+   PERF_INSTRUCTION_FETCH,
+   PERF_ICACHE_MISS,
+   PERF_DCACHE_UNCACHE_WRITE,
+   PERF_DCACHE_UNCACHE_READ,
+   PERF_DCACHE_CACHE_WRITE,
+   PERF_DCACHE_CACHE_READ,
+   PERF_DCACHE_MISS,
+   PERF_DCACHE_WRITE_BACK,
+   PERF_DCACHE_WRITE_THROUGH,
+   PERF_DCACHE_SNOOPY_INVAL,
+   NR_OF_EVENTS
+};
+
+static const char *eventNames[NR_OF_EVENTS] = {
+   "PERF_INSTRUCTION_FETCH", "PERF_ICACHE_MISS", "PERF_DCACHE_UNCACHE_WRITE",
+   "PERF_DCACHE_UNCACHE_READ", "PERF_DCACHE_CACHE_WRITE", "PERF_DCACHE_CACHE_READ",
+   "PERF_DCACHE_MISS", "PERF_DCACHE_WRITE_BACK", "PERF_DCACHE_WRITE_THROUGH",
+   "PERF_DCACHE_SNOOPY_INVAL"
+};
+
+static const char *sizeNames[] = { "1k", "2k", "4k", "8k", "16k", "32k" };
+static const char *waysNames[] = { "dm", "2way", "4way", "dm" };
+static const char *policyNames[] = { "fifo", "plru", "lru", "lru" };
+
+/*
+ * The configuration register fields as defined in registerFile.v
+ */
+struct CacheConfig {
+   uint32_t value;
+
+   unsigned sizeCode() const { unsigned code = (((value >> 28) & 1) << 2) | ((value >> 30) & 3);
+                               return code > 5 ? 5 : code; }
+   unsigned nrOfWays() const { return (value & 3) == 2 ? 4 : (value & 3) == 1 ? 2 : 1; }
+   unsigned policy() const { return (value >> 16) & 3; }
+   bool writeBack() const { return (value >> 8) & 1; }
+   bool coherence() const { return (value >> 18) & 1; }
+   bool lockFill() const { return (value >> 9) & 1; }
+   unsigned lockedWays() const { return (value >> 14) & 3; }
+   unsigned nrOfSets() const { return (1024u << sizeCode()) / 32 / nrOfWays(); }
+
+   std::string name(bool instructionCache) const {
+      std::string s = std::string(sizeNames[sizeCode()]) + "," + waysNames[value & 3] + "," + policyNames[policy()];
+      if (!instructionCache) s += writeBack() ? ",wb" : ",wt";
+      if (coherence()) s += ",coh";
+      if (lockedWays() != 0) s += ",lock" + std::to_string(lockedWays());
+      return s;
+   }
+};
+
+static bool parseConfig(const char *text, uint32_t resetValue, CacheConfig &cfg) {
+   char *end;
+   cfg.value = strtoul(text, &end, 0);
+   if (*text != 0 && *end == 0) return true;
+   cfg.value = resetValue;
+   std::string list(text);
+   size_t pos = 0;
+   while (pos <= list.size()) {
+      size_t comma = list.find(',', pos);
+      std::string token = list.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+      pos = (comma == std::string::npos) ? list.size() + 1 : comma + 1;
+      bool found = false;
+      for (unsigned i = 0; i < 6; i++)
+         if (token == sizeNames[i]) {
+            cfg.value = (cfg.value & ~((3u << 30) | (1u << 28))) | ((i & 3) << 30) | ((i >> 2) << 28);
+            found = true;
+         }
+      for (unsigned i = 0; i < 3; i++) {
+         if (token == waysNames[i]) { cfg.value = (cfg.value & ~3u) | i; found = true; }
+         if (token == policyNames[i]) { cfg.value = (cfg.value & ~(3u << 16)) | (i << 16); found = true; }
+      }
+      if (token == "wb" || token == "wt") { cfg.value = (cfg.value & ~(1u << 8)) | ((token == "wb") << 8); found = true; }
+      if (token == "coh") { cfg.value |= 1u << 18; found = true; }
+      if (token.compare(0, 4, "lock") == 0 && token.size() == 5 && token[4] >= '0' && token[4] <= '3') {
+         cfg.value = (cfg.value & ~(3u << 14)) | ((unsigned)(token[4] - '0') << 14);
+         found = true;
+      }
+      if (!found) return false;
+   }
+   return true;
+}
+
+/*
+ * One cache; the policy state is kept in the encoding of the RTL and the ways
+ * are handled as one-hot vectors (way 1 = bit 0) as in the RTL
+ */
+class Cache {
+public:
+   Cache(const CacheConfig &cfg, bool instructionCache) : m_cfg(cfg), m_icache(instructionCache),
+                                                          m_sets(cfg.nrOfSets()) { flush(); }
+
+   /* returns the number of dirty lines written back */
+   unsigned flush() {
+      unsigned dirty = 0;
+      for (Set &set : m_sets) {
+         for (unsigned way = 0; way < 4; way++) dirty += set.valid[way] && set.dirty[way];
+         set = Set();
+      }
+      return dirty;
+   }
+
+   /* returns the way (0..3) holding the line or -1 */
+   int lookup(uint32_t address) const {
+      const Set &set = m_sets[setIndex(address)];
+      for (unsigned way = 0; way < m_cfg.nrOfWays(); way++)
+         if (set.valid[way] && set.tag[way] == (address >> 5)) return way;
+      return -1;
+   }
+
+   /* loads the line and returns the way it was placed in; wasDirty reports a write-back */
+   unsigned fill(uint32_t address, bool &wasDirty) {
+      Set &set = m_sets[setIndex(address)];
+      unsigned way = logicalWay(lockMask(policyWay(set)));
+      wasDirty = set.valid[way] && set.dirty[way];
+      set.valid[way] = true;
+      set.dirty[way] = false;
+      set.tag[way] = address >> 5;
+      updateOnFill(set);
+      return way;
+   }
+
+   /* a cache read or write action on a hit (only the D$ updates its policy here) */
+   void touch(uint32_t address, unsigned way, bool write) {
+      Set &set = m_sets[setIndex(address)];
+      if (write) set.dirty[way] = true;
+      if (!m_icache) updateOnHit(set, 1u << way);
+   }
+
+   /* snoop support; returns true when the line was dirty */
+   bool invalidate(uint32_t address, unsigned way) {
+      Set &set = m_sets[setIndex(address)];
+      bool dirty = set.dirty[way];
+      set.valid[way] = set.dirty[way] = false;
+      return dirty;
+   }
+
+   bool clean(uint32_t address, unsigned way) {
+      Set &set = m_sets[setIndex(address)];
+      bool dirty = set.dirty[way];
+      set.dirty[way] = false;
+      return dirty;
+   }
+
+   const CacheConfig &config() const { return m_cfg; }
+   std::string name() const { return m_cfg.name(m_icache); }
+
+private:
+   struct Set {
+      uint32_t tag[4] = { 0, 0, 0, 0 };
+      bool valid[4] = { false, false, false, false };
+      bool dirty[4] = { false, false, false, false };
+      unsigned fifo = 0, plru = 0;
+      unsigned lru[4] = { 0, 0, 0, 0 };
+   };
+
+   unsigned setIndex(uint32_t address) const { return (address >> 5) % m_sets.size(); }
+
+   /* the replacement way (one-hot) as selected by the policy */
+   unsigned policyWay(const Set &set) const {
+      switch (m_cfg.policy()) {
+         case 0 : return 1u << (set.fifo & 3);
+         case 1 : if (set.plru & 16) {
+                     unsigned pair = set.plru & 3;
+                     return (pair == 0 || pair == 3) ? 1 : (~pair & 3);
+                  } else {
+                     unsigned pair = (set.plru >> 2) & 3;
+                     return ((pair == 0 || pair == 3) ? 1 : (~pair & 3)) << 2;
+                  }
+         default : if (m_icache) {
+                      for (unsigned way = 0; way < 3; way++)
+                         if (set.lru[way] == 0) return 1u << way;
+                      return 8;
+                   }
+                   for (unsigned way = 0; way < 3; way++) {
+                      bool oldest = true;
+                      for (unsigned other = 0; other < 4; other++)
+                         if (other != way && set.lru[way] > set.lru[other]) oldest = false;
+                      if (oldest) return 1u << way;
+                   }
+                   return 8;
+      }
+   }
+
+   /* way locking, see "Here the way locking is defined" in d-cache.v */
+   unsigned lockMask(unsigned oneHot) const {
+      unsigned ways = m_cfg.nrOfWays(), locked = m_cfg.lockedWays();
+      if (ways == 1 || (locked == 0 && !m_cfg.lockFill())) return oneHot;
+      unsigned lockedMask, fillMask;
+      if (ways == 4) {
+         static const unsigned lockedMasks[4] = { 0x0, 0x8, 0xC, 0xE };
+         lockedMask = lockedMasks[locked];
+         fillMask = 8 >> locked;
+      } else {
+         lockedMask = locked == 0 ? 0 : 2;
+         fillMask = locked == 0 ? 2 : 1;
+      }
+      unsigned allowed = m_cfg.lockFill() ? fillMask : ((ways == 4 ? 0xF : 0x3) & ~lockedMask);
+      if (oneHot & allowed) return oneHot;
+      for (unsigned way = 0; way < 4; way++)
+         if (allowed & (1u << way)) return 1u << way;
+      return 8;
+   }
+
+   /* the way actually written; with 2 ways the data memories are selected by bit 1 */
+   unsigned logicalWay(unsigned oneHot) const {
+      switch (m_cfg.nrOfWays()) {
+         case 4  : return __builtin_ctz(oneHot);
+         case 2  : return (oneHot & 2) ? 1 : 0;
+         default : return 0;
+      }
+   }
+
+   void updateLru(Set &set, unsigned used) const {
+      unsigned old = set.lru[used];
+      for (unsigned way = 0; way < 4; way++)
+         if (way == used) set.lru[way] = 3;
+         else if (set.lru[way] > old) set.lru[way]--;
+   }
+
+   /* UPDATE_TAGS of a line load */
+   void updateOnFill(Set &set) const {
+      switch (m_cfg.nrOfWays()) {
+         case 4  : set.fifo = (set.fifo + 1) & 3; break;
+         case 2  : set.fifo = ~set.fifo & 1; break;
+         default : set.fifo = 0; break;
+      }
+      if (!m_icache) return;
+      /* The I$ updates its LRU/PLRU state only here, while its hit vector is still
+       * clear from the miss (i-cache.v, s_lruSelect and s_newPlru at UPDATE_TAGS) */
+      switch (m_cfg.nrOfWays()) {
+         case 4  : set.plru = set.plru & 0xC;
+                   updateLru(set, 0);
+                   break;
+         case 2  : set.plru = 0x10;
+                   set.lru[0] = 0; set.lru[1] = set.lru[2] = set.lru[3] = 3;
+                   break;
+         default : set.plru = 0x12;
+                   set.lru[0] = 0; set.lru[1] = set.lru[2] = set.lru[3] = 3;
+                   break;
+      }
+   }
+
+   /* cache read or write action of the D$ */
+   void updateOnHit(Set &set, unsigned hit) const {
+      switch (m_cfg.nrOfWays()) {
+         case 4  : set.plru = (hit & 0xC) ? (0x10 | ((hit >> 2) << 2) | (set.plru & 3)) : ((set.plru & 0xC) | hit);
+                   updateLru(set, __builtin_ctz(hit));
+                   break;
+         case 2  : set.plru = 0x10 | hit;
+                   set.lru[0] = (hit & 1) ? 3 : 0;
+                   set.lru[1] = (hit & 1) ? 0 : 3;
+                   set.lru[2] = set.lru[3] = 3;
+                   break;
+         default : set.plru = 0x12;
+                   set.lru[0] = 0; set.lru[1] = set.lru[2] = set.lru[3] = 3;
+                   break;
+      }
+   }
+
+   CacheConfig m_cfg;
+   bool m_icache;
+   std::vector<Set> m_sets;
+};
+
+/*
+ * One simulated system: an I$ and a D$ with their event counters
+ */
+struct System {
+   Cache icache, dcache;
+   uint64_t events[NR_OF_EVENTS] = { 0 };
+
+   System(const CacheConfig &icfg, const CacheConfig &dcfg) : icache(icfg, true), dcache(dcfg, false) {}
+
+   void fetch(uint32_t address) {
+      events[PERF_INSTRUCTION_FETCH]++;
+      if (icache.lookup(address) < 0) {
+         bool dummy;
+         events[PERF_ICACHE_MISS]++;
+         icache.fill(address, dummy);
+      }
+   }
+
+   void access(uint32_t address, bool write) {
+      /* 0x40000000 - 0x7FFFFFFF and 0xC0000000 - 0xFFFFFFFF are not cached */
+      if ((address >> 30) & 1) {
+         events[write ? PERF_DCACHE_UNCACHE_WRITE : PERF_DCACHE_UNCACHE_READ]++;
+         return;
+      }
+      events[write ? PERF_DCACHE_CACHE_WRITE : PERF_DCACHE_CACHE_READ]++;
+      int way = dcache.lookup(address);
+      if (way < 0) {
+         bool wasDirty;
+         events[PERF_DCACHE_MISS]++;
+         way = dcache.fill(address, wasDirty);
+         if (wasDirty) events[PERF_DCACHE_WRITE_BACK]++;
+      }
+      /* the non-coherent region is always write-back */
+      bool writeBack = (address >> 31) || dcache.config().writeBack();
+      if (write && !writeBack) events[PERF_DCACHE_WRITE_THROUGH]++;
+      dcache.touch(address, way, write && writeBack);
+   }
+
+   void snoop(uint32_t address, bool write) {
+      if ((address >> 30) != 0 || !dcache.config().coherence()) return;
+      int way = dcache.lookup(address);
+      if (way < 0) return;
+      if (write) {
+         events[PERF_DCACHE_SNOOPY_INVAL]++;
+         if (dcache.invalidate(address, way)) events[PERF_DCACHE_WRITE_BACK]++;
+      } else if (dcache.clean(address, way)) events[PERF_DCACHE_WRITE_BACK]++;
+   }
+
+   void flush() {
+      icache.flush();
+      events[PERF_DCACHE_WRITE_BACK] += dcache.flush();
+   }
+};
+
+static void usage(const char *name) {
+   fprintf(stderr, "Usage: %s [-i <icache cfg>] [-d <dcache cfg>]... [-csv] [trace]\n", name);
+   fprintf(stderr, "  cfg: a value as written by icache_write_cfg()/dcache_write_cfg(), or a list of\n");
+   fprintf(stderr, "       1k|2k|4k|8k|16k|32k, dm|2way|4way, fifo|plru|lru, wb|wt, coh, lock0-3\n");
+   fprintf(stderr, "       (unspecified fields keep their reset value)\n");
+   fprintf(stderr, "  -d may be given several times to simulate several D$ configurations\n");
+   fprintf(stderr, "  the trace is read from stdin if no file is given\n");
+}
+
+int main(int argc, char **argv) {
+   /* reset values of the configuration registers: I$ 4k 2-way LRU, D$ 4k 4-way LRU write-back */
+   CacheConfig icfg = { 0x80020001 };
+   std::vector<CacheConfig> dcfgs;
+   const char *traceName = NULL;
+   bool csv = false;
+
+   for (int i = 1; i < argc; i++) {
+      CacheConfig cfg;
+      if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+         if (!parseConfig(argv[++i], 0x80020001, icfg)) { usage(argv[0]); return 1; }
+      } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+         if (!parseConfig(argv[++i], 0x80020102, cfg)) { usage(argv[0]); return 1; }
+         dcfgs.push_back(cfg);
+      } else if (strcmp(argv[i], "-csv") == 0) csv = true;
+      else if (argv[i][0] != '-' && traceName == NULL) traceName = argv[i];
+      else { usage(argv[0]); return 1; }
+   }
+   if (dcfgs.empty()) dcfgs.push_back(CacheConfig{ 0x80020102 });
+
+   FILE *trace = (traceName == NULL) ? stdin : fopen(traceName, "r");
+   if (trace == NULL) {
+      fprintf(stderr, "Unable to open %s\n", traceName);
+      return 1;
+   }
+
+   std::vector<System> systems;
+   for (const CacheConfig &dcfg : dcfgs) systems.emplace_back(icfg, dcfg);
+
+   char line[256], type[8];
+   unsigned long lineNumber = 0;
+   while (fgets(line, sizeof(line), trace) != NULL) {
+      uint32_t address = 0;
+      lineNumber++;
+      char *comment = strchr(line, '#');
+      if (comment != NULL) *comment = 0;
+      int fields = sscanf(line, "%7s %x", type, &address);
+      if (fields <= 0) continue;
+      std::string t(type);
+      if (t == "F") {
+         for (System &system : systems) system.flush();
+         continue;
+      }
+      if (fields != 2) {
+         fprintf(stderr, "%s:%lu: missing address\n", traceName ? traceName : "stdin", lineNumber);
+         return 1;
+      }
+      for (System &system : systems) {
+         if (t == "I" || t == "2") system.fetch(address);
+         else if (t == "R" || t == "0") system.access(address, false);
+         else if (t == "W" || t == "1") system.access(address, true);
+         else if (t == "SR") system.snoop(address, false);
+         else if (t == "SW") system.snoop(address, true);
+         else {
+            fprintf(stderr, "%s:%lu: unknown access type %s\n", traceName ? traceName : "stdin", lineNumber, type);
+            return 1;
+         }
+      }
+   }
+   if (trace != stdin) fclose(trace);
+
+   if (csv) {
+      printf("icache,dcache");
+      for (unsigned e = 0; e < NR_OF_EVENTS; e++) printf(",%s", eventNames[e]);
+      printf("\n");
+   }
+   for (const System &system : systems) {
+      if (csv) {
+         printf("\"%s\",\"%s\"", system.icache.name().c_str(), system.dcache.name().c_str());
+         for (unsigned e = 0; e < NR_OF_EVENTS; e++) printf(",%llu", (unsigned long long) system.events[e]);
+         printf("\n");
+         continue;
+      }
+      printf("I$ %s (0x%08x), D$ %s (0x%08x)\n", system.icache.name().c_str(), system.icache.config().value,
+             system.dcache.name().c_str(), system.dcache.config().value);
+      for (unsigned e = 0; e < NR_OF_EVENTS; e++)
+         printf("  %-28s %12llu\n", eventNames[e], (unsigned long long) system.events[e]);
+   }
+   return 0;
+}
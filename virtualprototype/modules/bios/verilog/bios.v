@@ -9,6 +9,7 @@ module bios ( input wire       clock,
                                dataValidIn,
             input wire [3:0]   byteEnablesIn,
             input wire [7:0]   burstSizeIn,
+            input wire         wrapBurstIn,
             output reg [31:0]  addressDataOut,
             output reg         busErrorOut,
                                dataValidOut,
@@ -45,7 +46,7 @@ module bios ( input wire       clock,
   reg         s_endTransactionReg, s_transactionActiveReg;
   reg [7:0]   s_burstSizeReg;
   reg [8:0]   s_burstCountReg;
-  reg         s_readNotWriteReg;
+  reg         s_readNotWriteReg, s_wrapBurstReg;
   reg [10:0]  s_RomAddressReg;
   reg [3:0]   s_byteEnablesReg;
 
@@ -53,12 +54,14 @@ module bios ( input wire       clock,
   wire [8:0]  s_burstCountNext = (s_stateMachineReg == INTERPRET && s_isMyBurst == 1'b1) ? {1'b0,s_burstSizeReg} - 9'd1 :
                                  (s_stateMachineReg == BURST) ? s_burstCountReg - 9'd1 : s_burstCountReg;
   wire [10:0] s_RomAddressNext = (s_stateMachineReg == INTERPRET && s_isMyBurst == 1'b1) ? s_addressReg[12:2] :
+                                 (s_stateMachineReg == BURST && s_wrapBurstReg == 1'b1) ? {s_RomAddressReg[10:3], s_RomAddressReg[2:0] + 3'd1} :
                                  (s_stateMachineReg == BURST) ? s_RomAddressReg + 11'd1 : s_RomAddressReg;
   
   always @(posedge clock)
     begin
       s_addressReg           <= (beginTransactionIn == 1'b1) ? addressDataIn : s_addressReg;
       s_burstSizeReg         <= (beginTransactionIn == 1'b1) ? burstSizeIn : s_burstSizeReg;
+      s_wrapBurstReg         <= (beginTransactionIn == 1'b1) ? wrapBurstIn : s_wrapBurstReg;
       s_readNotWriteReg      <= (beginTransactionIn == 1'b1) ? readNotWriteIn : s_readNotWriteReg;
       s_byteEnablesReg       <= (beginTransactionIn == 1'b1) ? byteEnablesIn : s_byteEnablesReg;
       s_endTransactionReg    <= ~reset & endTransactionIn;
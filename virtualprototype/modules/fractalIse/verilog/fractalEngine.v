@@ -0,0 +1,421 @@
+module fractalEngineUnit ( input wire               clock,
+                                                 reset,
+                                                 flush,
+                           input wire [15:0]     nMax,
+                           input wire [1:0]      colorModel,
+                           input wire            load,
+                                                 take,
+                           input wire signed [31:0] loadCx,
+                                                 loadCy,
+                           input wire [10:0]     loadTag,
+                           output wire           free,
+                                                 done,
+                           output reg [15:0]     color,
+                           output wire [10:0]    tag );
+
+  /*
+   *
+   * This unit iterates two pixels at the same time in a ring of two stages: stage A computes the
+   * products of one pixel while stage B adds the products of the other pixel, after which both
+   * pixels change stage. Hence the multipliers are used in every cycle. The arithmetic is the one
+   * of fractalIse, so both compute the same colours.
+   *
+   * A pixel is loaded when stage B is free, and a finished pixel stays in the ring until it is taken.
+   * The tag travels with the pixel (for the fractalEngine the line buffer half and the pixel index).
+   *
+   */
+  localparam [1:0] EMPTY = 2'd0;
+  localparam [1:0] RUN   = 2'd1;
+  localparam [1:0] DONE  = 2'd2;
+
+  reg [1:0]         s_stateAReg, s_stateBReg;
+  reg signed [31:0] s_xAReg, s_yAReg, s_cxAReg, s_cyAReg, s_cxBReg, s_cyBReg;
+  reg signed [31:0] s_xxBReg, s_yyBReg, s_xxhBReg, s_yyhBReg, s_2xyBReg;
+  reg [15:0]        s_nAReg, s_nBReg;
+  reg [10:0]        s_tagAReg, s_tagBReg;
+
+  /*
+   *
+   * Stage A: the products
+   *
+   */
+  wire signed [63:0] s_multXX = s_xAReg*s_xAReg;
+  wire signed [63:0] s_multYY = s_yAReg*s_yAReg;
+  wire signed [63:0] s_multXY = s_xAReg*s_yAReg;
+
+  always @(posedge clock)
+    begin
+      s_stateBReg <= (reset == 1'b1 || flush == 1'b1) ? EMPTY : s_stateAReg;
+      s_xxBReg    <= s_multXX[59:28];
+      s_yyBReg    <= s_multYY[59:28];
+      s_xxhBReg   <= s_multXX[63:32];
+      s_yyhBReg   <= s_multYY[63:32];
+      s_2xyBReg   <= s_multXY[58:27];
+      s_cxBReg    <= s_cxAReg;
+      s_cyBReg    <= s_cyAReg;
+      s_nBReg     <= (s_stateAReg == RUN) ? s_nAReg + 16'd1 : s_nAReg;
+      s_tagBReg   <= s_tagAReg;
+    end
+
+  /*
+   *
+   * Stage B: the additions, the abort and the loading of a new pixel
+   *
+   */
+  wire [31:0] s_xxPlusYy = s_xxhBReg + s_yyhBReg;
+  wire        s_abort    = (s_xxPlusYy[31:24] > 8'd4 || s_nBReg == nMax) ? 1'b1 : 1'b0;
+  wire        s_loadNow  = (s_stateBReg == EMPTY) ? load : 1'b0;
+  wire [1:0]  s_stateANext = (reset == 1'b1 || flush == 1'b1) ? EMPTY :
+                             (s_loadNow == 1'b1) ? RUN :
+                             (s_stateBReg == RUN && s_abort == 1'b1) ? DONE :
+                             (s_stateBReg == DONE && take == 1'b1) ? EMPTY : s_stateBReg;
+
+  assign free = (s_stateBReg == EMPTY) ? 1'b1 : 1'b0;
+  assign done = (s_stateBReg == DONE) ? 1'b1 : 1'b0;
+  assign tag  = s_tagBReg;
+
+  always @(posedge clock)
+    begin
+      s_stateAReg <= s_stateANext;
+      s_xAReg     <= (s_loadNow == 1'b1) ? loadCx : s_xxBReg - s_yyBReg + s_cxBReg;
+      s_yAReg     <= (s_loadNow == 1'b1) ? loadCy : s_2xyBReg + s_cyBReg;
+      s_cxAReg    <= (s_loadNow == 1'b1) ? loadCx : s_cxBReg;
+      s_cyAReg    <= (s_loadNow == 1'b1) ? loadCy : s_cyBReg;
+      s_nAReg     <= (s_loadNow == 1'b1) ? 16'd0 : s_nBReg;
+      s_tagAReg   <= (s_loadNow == 1'b1) ? loadTag : s_tagBReg;
+    end
+
+  /*
+   *
+   * Here the color of a finished pixel is defined (the color models of fractalIse)
+   *
+   */
+  wire [4:0] s_selected1 = {s_nBReg[0],4'hF};
+  wire [4:0] s_selected2 = {~s_nBReg[6:3],1'b0};
+  wire [4:0] s_red1      = (s_nBReg[3] == 1'b1) ? s_selected1 : 5'd0;
+  wire [5:0] s_green1    = (s_nBReg[2] == 1'b1) ? {s_selected1,1'b0} : 6'd0;
+  wire [4:0] s_blue1     = (s_nBReg[1] == 1'b1) ? s_selected1 : 5'd0;
+  wire [4:0] s_red2      = (s_nBReg[2] == 1'b1) ? s_selected2 : 5'd0;
+  wire [5:0] s_green2    = (s_nBReg[1] == 1'b1) ? {s_selected2,1'b0} : 6'd0;
+  wire [4:0] s_blue2     = (s_nBReg[0] == 1'b1) ? s_selected2 : 5'd0;
+
+  always @*
+    if (s_nBReg == nMax) color <= 16'd0;
+    else case (colorModel)
+      2'b00   : color <= 16'hFFFF;
+      2'b01   : color <= {s_nBReg[3:0], 1'b0, s_nBReg[3:0], 2'b00, s_nBReg[3:0], 1'b0};
+      2'b10   : color <= {s_red1,s_green1,s_blue1};
+      default : color <= {s_red2,s_green2,s_blue2};
+    endcase
+endmodule
+
+module fractalEngine #( parameter [7:0] customInstructionId = 8'h22,
+                        parameter nrOfUnits = 4,
+                        parameter [8:0] maxBurstSize = 9'd64 )
+                     ( input wire         clock,
+                                          reset,
+                                          ciStart,
+                                          ciCke,
+                       input wire [7:0]   ciN,
+                       input wire [31:0]  ciValueA,
+                                          ciValueB,
+                       output wire [31:0] ciResult,
+                       output wire        ciDone,
+                       output wire        irq,
+                       // here the bus master interface is defined
+                       output wire        requestBus,
+                       input wire         busGrant,
+                       output reg         beginTransactionOut,
+                       output wire [31:0] addressDataOut,
+                       output reg         endTransactionOut,
+                       output reg  [3:0]  byteEnablesOut,
+                       output wire        dataValidOut,
+                       output reg  [7:0]  burstSizeOut,
+                       input wire         busyIn,
+                                          busErrorIn);
+
+  /*
+   *
+   * This module computes a whole frame of the mandelbrot fractal without the cpu. The pixels are
+   * handed out to nrOfUnits fractalEngineUnits (two pixels each), the finished pixels are collected
+   * in a line buffer of two lines, and a finished line is written to the frame buffer in bursts
+   * of at most maxBurstSize words while the next line is computed.
+   *
+   * ci commands (ciValueA[3] = 1 writes ciValueB to the register ciValueA[2:0], ciValueA[3] = 0
+   * reads it):
+   *     0        cx0, x-coordinate of the first pixel (Q4.28)
+   *     1        cy0, y-coordinate of the first line (Q4.28)
+   *     2        delta, the increment of both coordinates (Q4.28)
+   *     3        width in pixels (even, at most 1024)
+   *     4        height in lines (at most 2047)
+   *     5        bits 15..0 n_max, bits 17..16 the color model (as for fractalIse)
+   *     6        frame buffer address (word aligned)
+   *     7        Write: bit 0 = 1 starts the frame, bit 1 enables the irq.
+   *              Read: the status, reading it clears the irq:
+   *              bit 0     the engine is busy
+   *              bit 1     the frame is done (irq pending)
+   *              bit 2     a bus error occured, the frame was aborted
+   *              bit 3     the parameters are invalid, the frame was not started
+   *              bit 4     irq enabled
+   *              bits 26..16 the number of lines written to the frame buffer
+   * The registers 0 to 6 can not be written while the engine is busy.
+   *
+   * The pixels are written as the cpu writes the results of fractalIse, so the frame buffer can
+   * be shown directly. The writes are not snooped, the cpu has to invalidate its copies of the
+   * frame buffer before it reads it.
+   *
+   */
+  localparam [2:0] IDLE        = 3'd0;
+  localparam [2:0] REQUEST_BUS = 3'd1;
+  localparam [2:0] INIT_BURST  = 3'd2;
+  localparam [2:0] DO_BURST    = 3'd3;
+  localparam [2:0] END_TRANS   = 3'd4;
+  localparam [2:0] END_ERROR   = 3'd5;
+
+  reg [2:0] s_stateMachineReg, s_stateMachineNext;
+
+  /*
+   *
+   * Here the registers are defined
+   *
+   */
+  reg signed [31:0] s_cx0Reg, s_cy0Reg, s_deltaReg;
+  reg [31:0] s_frameBufferReg;
+  reg [15:0] s_nMaxReg;
+  reg [10:0] s_widthReg, s_heightReg, s_linesDoneReg;
+  reg [1:0]  s_colorModelReg;
+  reg        s_busyReg, s_donePendingReg, s_busErrorReg, s_paramErrorReg, s_irqEnableReg;
+
+  wire s_isMyCi     = (ciN == customInstructionId) ? ciStart & ciCke : 1'b0;
+  wire s_writeReg   = s_isMyCi & ciValueA[3];
+  wire s_we         = s_writeReg & ~s_busyReg;
+  wire s_readStatus = (s_isMyCi == 1'b1 && ciValueA[3:0] == 4'd7) ? 1'b1 : 1'b0;
+  wire s_invalid    = (s_widthReg == 11'd0 || s_widthReg[0] == 1'b1 || s_widthReg > 11'd1024 || s_heightReg == 11'd0) ? 1'b1 : 1'b0;
+  wire s_startCmd   = (s_writeReg == 1'b1 && ciValueA[2:0] == 3'd7 && ciValueB[0] == 1'b1) ? ~s_busyReg : 1'b0;
+  wire s_start      = s_startCmd & ~s_invalid;
+  wire s_frameDone, s_lineSent;
+
+  always @(posedge clock)
+    begin
+      s_cx0Reg         <= (s_we == 1'b1 && ciValueA[2:0] == 3'd0) ? ciValueB : s_cx0Reg;
+      s_cy0Reg         <= (s_we == 1'b1 && ciValueA[2:0] == 3'd1) ? ciValueB : s_cy0Reg;
+      s_deltaReg       <= (s_we == 1'b1 && ciValueA[2:0] == 3'd2) ? ciValueB : s_deltaReg;
+      s_widthReg       <= (reset == 1'b1) ? 11'd0 : (s_we == 1'b1 && ciValueA[2:0] == 3'd3) ? ciValueB[10:0] : s_widthReg;
+      s_heightReg      <= (reset == 1'b1) ? 11'd0 : (s_we == 1'b1 && ciValueA[2:0] == 3'd4) ? ciValueB[10:0] : s_heightReg;
+      s_nMaxReg        <= (s_we == 1'b1 && ciValueA[2:0] == 3'd5) ? ciValueB[15:0] : s_nMaxReg;
+      s_colorModelReg  <= (s_we == 1'b1 && ciValueA[2:0] == 3'd5) ? ciValueB[17:16] : s_colorModelReg;
+      s_frameBufferReg <= (s_we == 1'b1 && ciValueA[2:0] == 3'd6) ? {ciValueB[31:2],2'd0} : s_frameBufferReg;
+      s_irqEnableReg   <= (reset == 1'b1) ? 1'b0 : (s_writeReg == 1'b1 && ciValueA[2:0] == 3'd7) ? ciValueB[1] : s_irqEnableReg;
+      s_paramErrorReg  <= (reset == 1'b1) ? 1'b0 : (s_startCmd == 1'b1) ? s_invalid : s_paramErrorReg;
+      s_busErrorReg    <= (reset == 1'b1 || s_start == 1'b1) ? 1'b0 : (s_stateMachineReg == END_ERROR) ? 1'b1 : s_busErrorReg;
+      s_busyReg        <= (reset == 1'b1 || s_frameDone == 1'b1 || s_stateMachineReg == END_ERROR) ? 1'b0 : (s_start == 1'b1) ? 1'b1 : s_busyReg;
+      s_donePendingReg <= (reset == 1'b1 || s_start == 1'b1 || s_readStatus == 1'b1) ? 1'b0 :
+                          (s_frameDone == 1'b1 || s_stateMachineReg == END_ERROR) ? 1'b1 : s_donePendingReg;
+      s_linesDoneReg   <= (reset == 1'b1 || s_start == 1'b1) ? 11'd0 : (s_lineSent == 1'b1) ? s_linesDoneReg + 11'd1 : s_linesDoneReg;
+    end
+
+  assign irq = s_donePendingReg & s_irqEnableReg;
+
+  /*
+   *
+   * here the ci interface is defined
+   *
+   */
+  reg [31:0] s_selectedResult;
+
+  assign ciDone   = s_isMyCi;
+  assign ciResult = (s_isMyCi == 1'b0) ? 32'd0 : s_selectedResult;
+
+  always @*
+    case (ciValueA[2:0])
+      3'd0    : s_selectedResult <= s_cx0Reg;
+      3'd1    : s_selectedResult <= s_cy0Reg;
+      3'd2    : s_selectedResult <= s_deltaReg;
+      3'd3    : s_selectedResult <= {21'd0,s_widthReg};
+      3'd4    : s_selectedResult <= {21'd0,s_heightReg};
+      3'd5    : s_selectedResult <= {14'd0,s_colorModelReg,s_nMaxReg};
+      3'd6    : s_selectedResult <= s_frameBufferReg;
+      default : s_selectedResult <= {5'd0,s_linesDoneReg,11'd0,s_irqEnableReg,s_paramErrorReg,s_busErrorReg,s_donePendingReg,s_busyReg};
+    endcase
+
+  /*
+   *
+   * Here the pixels are handed out, line by line. Line n is computed into half n[0] of the line
+   * buffer, which has to be written out first.
+   *
+   */
+  reg signed [31:0] s_dispCxReg, s_dispCyReg;
+  reg [10:0] s_dispLineReg, s_dispPixelReg;
+  reg        s_dispActiveReg;
+  reg [1:0]  s_halfBusyReg;
+
+  wire [nrOfUnits-1:0] s_unitFree, s_unitDone, s_load, s_take;
+  wire                 s_dispHalf    = s_dispLineReg[0];
+  wire                 s_canDispatch = (s_dispPixelReg != 11'd0 || s_halfBusyReg[s_dispHalf] == 1'b0) ? s_dispActiveReg : 1'b0;
+  wire                 s_dispatch    = |s_load;
+  wire                 s_lastPixel   = (s_dispPixelReg == s_widthReg - 11'd1) ? s_dispatch : 1'b0;
+
+  assign s_load = (s_canDispatch == 1'b1) ? s_unitFree & ~(s_unitFree - 1) : {nrOfUnits{1'b0}}; // the first free unit
+
+  always @(posedge clock)
+    begin
+      s_dispActiveReg <= (reset == 1'b1 || s_stateMachineReg == END_ERROR) ? 1'b0 : (s_start == 1'b1) ? 1'b1 :
+                         (s_lastPixel == 1'b1 && s_dispLineReg == s_heightReg - 11'd1) ? 1'b0 : s_dispActiveReg;
+      s_dispPixelReg  <= (s_start == 1'b1 || s_lastPixel == 1'b1) ? 11'd0 : (s_dispatch == 1'b1) ? s_dispPixelReg + 11'd1 : s_dispPixelReg;
+      s_dispLineReg   <= (s_start == 1'b1) ? 11'd0 : (s_lastPixel == 1'b1) ? s_dispLineReg + 11'd1 : s_dispLineReg;
+      s_dispCxReg     <= (s_start == 1'b1 || s_lastPixel == 1'b1) ? s_cx0Reg : (s_dispatch == 1'b1) ? s_dispCxReg + s_deltaReg : s_dispCxReg;
+      s_dispCyReg     <= (s_start == 1'b1) ? s_cy0Reg : (s_lastPixel == 1'b1) ? s_dispCyReg + s_deltaReg : s_dispCyReg;
+    end
+
+  /*
+   *
+   * Here the iteration units are defined
+   *
+   */
+  wire [16*nrOfUnits-1:0] s_unitColors;
+  wire [11*nrOfUnits-1:0] s_unitTags;
+
+  genvar n;
+
+  generate
+    for (n = 0 ; n < nrOfUnits ; n = n + 1)
+      begin : units
+        fractalEngineUnit unit ( .clock(clock),
+                                 .reset(reset),
+                                 .flush(s_start),
+                                 .nMax(s_nMaxReg),
+                                 .colorModel(s_colorModelReg),
+                                 .load(s_load[n]),
+                                 .take(s_take[n]),
+                                 .loadCx(s_dispCxReg),
+                                 .loadCy(s_dispCyReg),
+                                 .loadTag({s_dispHalf,s_dispPixelReg[9:0]}),
+                                 .free(s_unitFree[n]),
+                                 .done(s_unitDone[n]),
+                                 .color(s_unitColors[n*16+15:n*16]),
+                                 .tag(s_unitTags[n*11+10:n*11]) );
+      end
+  endgenerate
+
+  /*
+   *
+   * Here one finished pixel per cycle is written to the line buffer; the even and the odd pixels
+   * are kept in separate memories so that a bus word is read at once.
+   *
+   */
+  reg [15:0] s_takeColor;
+  reg [10:0] s_takeTag;
+  reg [10:0] s_pixelCount0Reg, s_pixelCount1Reg;
+  integer    i;
+
+  assign s_take = s_unitDone & ~(s_unitDone - 1); // the first finished unit
+
+  always @*
+    begin
+      s_takeColor = 16'd0;
+      s_takeTag   = 11'd0;
+      for (i = 0 ; i < nrOfUnits ; i = i + 1)
+        if (s_take[i] == 1'b1)
+          begin
+            s_takeColor = s_unitColors[i*16 +: 16];
+            s_takeTag   = s_unitTags[i*11 +: 11];
+          end
+    end
+
+  wire s_collect    = |s_take;
+  wire s_lineStart0 = (s_dispatch == 1'b1 && s_dispPixelReg == 11'd0 && s_dispHalf == 1'b0) ? 1'b1 : 1'b0;
+  wire s_lineStart1 = (s_dispatch == 1'b1 && s_dispPixelReg == 11'd0 && s_dispHalf == 1'b1) ? 1'b1 : 1'b0;
+  reg  s_sendHalfReg;
+
+  always @(posedge clock)
+    begin
+      s_pixelCount0Reg <= (s_start == 1'b1 || s_lineStart0 == 1'b1) ? 11'd0 :
+                          (s_collect == 1'b1 && s_takeTag[10] == 1'b0) ? s_pixelCount0Reg + 11'd1 : s_pixelCount0Reg;
+      s_pixelCount1Reg <= (s_start == 1'b1 || s_lineStart1 == 1'b1) ? 11'd0 :
+                          (s_collect == 1'b1 && s_takeTag[10] == 1'b1) ? s_pixelCount1Reg + 11'd1 : s_pixelCount1Reg;
+      s_halfBusyReg[0] <= (reset == 1'b1 || s_start == 1'b1) ? 1'b0 : (s_lineStart0 == 1'b1) ? 1'b1 :
+                          (s_lineSent == 1'b1 && s_sendHalfReg == 1'b0) ? 1'b0 : s_halfBusyReg[0];
+      s_halfBusyReg[1] <= (reset == 1'b1 || s_start == 1'b1) ? 1'b0 : (s_lineStart1 == 1'b1) ? 1'b1 :
+                          (s_lineSent == 1'b1 && s_sendHalfReg == 1'b1) ? 1'b0 : s_halfBusyReg[1];
+    end
+
+  wire [1:0] s_halfReady = {(s_pixelCount1Reg == s_widthReg) ? s_halfBusyReg[1] : 1'b0,
+                            (s_pixelCount0Reg == s_widthReg) ? s_halfBusyReg[0] : 1'b0};
+  wire [15:0] s_evenPixel, s_oddPixel;
+  reg  [8:0]  s_readWordReg;
+  wire        s_doWrite;
+  wire [8:0]  s_readWordNext = (s_doWrite == 1'b1) ? s_readWordReg + 9'd1 : s_readWordReg;
+
+  sramSDpSync #( .nrOfAddressBits(10),
+                 .nrOfDataBits(16) ) evenPixels
+              ( .clock(clock),
+                .writeEnable(s_collect & ~s_takeTag[0]),
+                .writeAddress({s_takeTag[10],s_takeTag[9:1]}),
+                .readAddress({s_sendHalfReg,s_readWordNext}),
+                .writeData(s_takeColor),
+                .readDataW(),
+                .readDataR(s_evenPixel) );
+
+  sramSDpSync #( .nrOfAddressBits(10),
+                 .nrOfDataBits(16) ) oddPixels
+              ( .clock(clock),
+                .writeEnable(s_collect & s_takeTag[0]),
+                .writeAddress({s_takeTag[10],s_takeTag[9:1]}),
+                .readAddress({s_sendHalfReg,s_readWordNext}),
+                .writeData(s_takeColor),
+                .readDataW(),
+                .readDataR(s_oddPixel) );
+
+  /*
+   *
+   * Here the bus interface is defined, the lines follow each other in the frame buffer. The
+   * bytes of a word end up in memory as after a store of the fractalIse result by the cpu, on
+   * the bus this is the even pixel in the lower half.
+   *
+   */
+  reg [31:0] s_busAddressReg, s_addressDataOutReg;
+  reg [9:0]  s_wordsLeftReg;
+  reg [8:0]  s_burstCountReg;
+  reg        s_dataValidReg;
+  wire [31:0] s_busPixelWord = {s_oddPixel,s_evenPixel};
+  wire [8:0]  s_burstSizeNext = ({1'b0,s_wordsLeftReg} > {1'b0,maxBurstSize}) ? maxBurstSize : s_wordsLeftReg[8:0];
+
+  assign s_doWrite      = ((s_stateMachineReg == DO_BURST) && s_burstCountReg[8] == 1'b0) ? ~busyIn : 1'b0;
+  assign s_lineSent     = (s_stateMachineReg == END_TRANS && s_wordsLeftReg == 10'd0) ? 1'b1 : 1'b0;
+  assign s_frameDone    = (s_lineSent == 1'b1 && s_linesDoneReg == s_heightReg - 11'd1) ? 1'b1 : 1'b0;
+  assign requestBus     = (s_stateMachineReg == REQUEST_BUS) ? 1'b1 : 1'b0;
+  assign addressDataOut = s_addressDataOutReg;
+  assign dataValidOut   = s_dataValidReg;
+
+  always @*
+    case (s_stateMachineReg)
+      IDLE            : s_stateMachineNext <= (s_busyReg == 1'b1 && s_halfReady[s_sendHalfReg] == 1'b1) ? REQUEST_BUS : IDLE;
+      REQUEST_BUS     : s_stateMachineNext <= (busGrant == 1'b1) ? INIT_BURST : REQUEST_BUS;
+      INIT_BURST      : s_stateMachineNext <= DO_BURST;
+      DO_BURST        : s_stateMachineNext <= (busErrorIn == 1'b1) ? END_ERROR :
+                                              (s_burstCountReg[8] == 1'b1 && busyIn == 1'b0) ? END_TRANS : DO_BURST;
+      END_TRANS       : s_stateMachineNext <= (s_wordsLeftReg != 10'd0) ? REQUEST_BUS : IDLE;
+      default         : s_stateMachineNext <= IDLE;
+    endcase
+
+  always @(posedge clock)
+    begin
+      s_stateMachineReg   <= (reset == 1'b1) ? IDLE : s_stateMachineNext;
+      s_sendHalfReg       <= (reset == 1'b1 || s_start == 1'b1) ? 1'b0 : (s_lineSent == 1'b1) ? ~s_sendHalfReg : s_sendHalfReg;
+      s_busAddressReg     <= (s_start == 1'b1) ? s_frameBufferReg : (s_doWrite == 1'b1) ? s_busAddressReg + 32'd4 : s_busAddressReg;
+      s_wordsLeftReg      <= (s_stateMachineReg == IDLE) ? s_widthReg[10:1] :
+                             (s_stateMachineReg == INIT_BURST) ? s_wordsLeftReg - {1'b0,s_burstSizeNext} : s_wordsLeftReg;
+      s_readWordReg       <= (s_stateMachineReg == IDLE) ? 9'd0 : s_readWordNext;
+      beginTransactionOut <= (s_stateMachineReg == INIT_BURST) ? 1'd1 : 1'd0;
+      byteEnablesOut      <= (s_stateMachineReg == INIT_BURST) ? 4'hF : 4'd0;
+      s_addressDataOutReg <= (s_stateMachineReg == INIT_BURST) ? s_busAddressReg :
+                             (s_doWrite == 1'b1) ? s_busPixelWord :
+                             (busyIn == 1'b1) ? s_addressDataOutReg : 32'd0;
+      s_dataValidReg      <= (s_doWrite == 1'b1) ? 1'b1 : (busyIn == 1'b1) ? s_dataValidReg : 1'b0;
+      endTransactionOut   <= (s_stateMachineReg == END_TRANS || s_stateMachineReg == END_ERROR) ? 1'b1 : 1'b0;
+      burstSizeOut        <= (s_stateMachineReg == INIT_BURST) ? s_burstSizeNext[7:0] - 8'd1 : 8'd0;
+      s_burstCountReg     <= (s_stateMachineReg == INIT_BURST) ? s_burstSizeNext - 9'd1 :
+                             (s_doWrite == 1'b1) ? s_burstCountReg - 9'd1 : s_burstCountReg;
+    end
+
+endmodule
@@ -0,0 +1,169 @@
+/*
+ *
+ * This module implements the arithmetic of the myflpt number format (mfp) as
+ * custom instructions:
+ *
+ *   bit 31     : sign
+ *   bits 30..8 : magnitude, normalized to bit 22 (value = magnitude * 2^-23)
+ *   bits 7..0  : exponent with a bias of 250
+ *   0x00000000 : zero
+ *
+ * The results are bit-exact with mfp_add, mfp_sub, mfp_mul and mfp_cmp of the
+ * software reference (truncation, flush to zero on underflow, saturation to
+ * 0x7FFFFF/0xFF on overflow). The operation is selected by ciN:
+ *
+ *   customInstructionId + 0 : ciResult <= ciValueA + ciValueB   (1 cycle)
+ *   customInstructionId + 1 : ciResult <= ciValueA - ciValueB   (1 cycle)
+ *   customInstructionId + 2 : ciResult <= ciValueA * ciValueB   (2 cycles)
+ *   customInstructionId + 3 : ciResult <= -1, 0 or 1 for ciValueA <, == or > ciValueB (1 cycle)
+ *
+ * customInstructionId must be a multiple of 4.
+ *
+ */
+module mfpIse #( parameter [7:0] customInstructionId = 8'h24 )
+              ( input wire         clock,
+                                   reset,
+                                   ciStart,
+                                   ciCke,
+                input wire [7:0]   ciN,
+                input wire [31:0]  ciValueA,
+                                   ciValueB,
+                output wire        ciDone,
+                output wire [31:0] ciResult );
+
+  localparam [1:0] ADD = 2'd0;
+  localparam [1:0] SUB = 2'd1;
+  localparam [1:0] MUL = 2'd2;
+  localparam [1:0] CMP = 2'd3;
+
+  /*
+   *
+   * Here we define the control signals
+   *
+   */
+  wire s_isMyCi = (ciN[7:2] == customInstructionId[7:2]) ? ciStart & ciCke : 1'b0;
+  wire s_isMul  = (ciN[1:0] == MUL) ? s_isMyCi : 1'b0;
+  reg  s_mulBusyReg;
+
+  always @(posedge clock) s_mulBusyReg <= ~reset & (s_isMul | (s_mulBusyReg & ~ciCke));
+
+  /*
+   *
+   * The leading zeros of a 24-bit value (24 for zero)
+   *
+   */
+  function [4:0] leadingZeros;
+    input [23:0] value;
+    integer n;
+    begin
+      leadingZeros = 5'd24;
+      for (n = 0; n < 24; n = n + 1)
+        if (value[n] == 1'b1) leadingZeros = 23 - n;
+    end
+  endfunction
+
+  /*
+   *
+   * Here the operands are decoded, a subtraction adds the negated ciValueB (zero stays zero)
+   *
+   */
+  wire s_zeroA = (ciValueA == 32'd0) ? 1'b1 : 1'b0;
+  wire s_zeroB = (ciValueB == 32'd0) ? 1'b1 : 1'b0;
+  wire s_signA = ciValueA[31];
+  wire s_signB = ciValueB[31] ^ ((ciN[1:0] == SUB) ? ~s_zeroB : 1'b0);
+  wire [31:0] s_valueB = {s_signB, ciValueB[30:0]};
+  wire [7:0] s_expA = ciValueA[7:0];
+  wire [7:0] s_expB = ciValueB[7:0];
+  wire [22:0] s_magA = ciValueA[30:8];
+  wire [22:0] s_magB = ciValueB[30:8];
+
+  /*
+   *
+   * Here the addition and subtraction are done
+   *
+   */
+  wire s_aIsBig = (s_expA >= s_expB) ? 1'b1 : 1'b0;
+  wire [7:0] s_expDiff = (s_aIsBig == 1'b1) ? s_expA - s_expB : s_expB - s_expA;
+  wire [7:0] s_expBig = (s_aIsBig == 1'b1) ? s_expA : s_expB;
+  wire [22:0] s_alignedA = (s_aIsBig == 1'b1) ? s_magA : s_magA >> s_expDiff;
+  wire [22:0] s_alignedB = (s_aIsBig == 1'b1) ? s_magB >> s_expDiff : s_magB;
+  wire [24:0] s_termA = (s_signA == 1'b1) ? 25'd0 - {2'd0, s_alignedA} : {2'd0, s_alignedA};
+  wire [24:0] s_termB = (s_signB == 1'b1) ? 25'd0 - {2'd0, s_alignedB} : {2'd0, s_alignedB};
+  wire [24:0] s_sum = s_termA + s_termB;
+  wire [23:0] s_sumMag = (s_sum[24] == 1'b1) ? 24'd0 - s_sum[23:0] : s_sum[23:0];
+  wire [4:0]  s_sumZeros = leadingZeros(s_sumMag);
+  wire [23:0] s_sumNorm = s_sumMag << s_sumZeros;
+  wire [9:0]  s_sumExp = {2'd0, s_expBig} + 10'd1 - {5'd0, s_sumZeros};
+  reg [31:0]  s_addResult;
+
+  always @*
+    if (s_zeroA == 1'b1) s_addResult <= s_valueB;
+    else if (s_zeroB == 1'b1) s_addResult <= ciValueA;
+    else if (s_expDiff > 8'd22) s_addResult <= (s_aIsBig == 1'b1) ? ciValueA : s_valueB;
+    else if (s_sum == 25'd0) s_addResult <= 32'd0;
+    else if (s_sumExp[9] == 1'b1) s_addResult <= 32'd0;
+    else if (s_sumExp[8] == 1'b1) s_addResult <= {s_sum[24], 23'h7FFFFF, 8'hFF};
+    else s_addResult <= {s_sum[24], s_sumNorm[23:1], s_sumExp[7:0]};
+
+  /*
+   *
+   * Here the comparison is done, equal signs compare {exponent, magnitude}
+   *
+   */
+  wire s_aIsGreater = ({s_expA, s_magA} > {s_expB, s_magB}) ? 1'b1 : 1'b0;
+  reg [31:0] s_cmpResult;
+
+  always @*
+    if (ciValueA == ciValueB) s_cmpResult <= 32'd0;
+    else if (s_zeroA == 1'b1) s_cmpResult <= (ciValueB[31] == 1'b1) ? 32'd1 : 32'hFFFFFFFF;
+    else if (s_zeroB == 1'b1) s_cmpResult <= (s_signA == 1'b1) ? 32'hFFFFFFFF : 32'd1;
+    else if (s_signA != ciValueB[31]) s_cmpResult <= (s_signA == 1'b1) ? 32'hFFFFFFFF : 32'd1;
+    else s_cmpResult <= (s_aIsGreater ^ s_signA) ? 32'd1 : 32'hFFFFFFFF;
+
+  /*
+   *
+   * Here the multiplication is done, the product is registered and normalized in the second cycle
+   *
+   */
+  wire [45:0] s_product = s_magA * s_magB;
+  reg [22:0] s_productReg;
+  reg [9:0]  s_productExpReg;
+  reg        s_productSignReg, s_productZeroReg;
+
+  always @(posedge clock)
+    if (s_isMul == 1'b1)
+      begin
+        s_productReg     <= s_product[45:23];
+        s_productExpReg  <= {2'd0, s_expA} + {2'd0, s_expB} - 10'd250;
+        s_productSignReg <= s_signA ^ ciValueB[31];
+        s_productZeroReg <= s_zeroA | s_zeroB;
+      end
+
+  wire [4:0]  s_productZeros = leadingZeros({s_productReg, 1'b0});
+  wire [22:0] s_productNorm = s_productReg << s_productZeros;
+  wire [9:0]  s_productExp = s_productExpReg - {5'd0, s_productZeros};
+  reg [31:0]  s_mulResult;
+
+  always @*
+    if (s_productZeroReg == 1'b1 || s_productReg == 23'd0) s_mulResult <= 32'd0;
+    else if (s_productExp[9] == 1'b1) s_mulResult <= 32'd0;
+    else if (s_productExp[8] == 1'b1) s_mulResult <= {s_productSignReg, 23'h7FFFFF, 8'hFF};
+    else s_mulResult <= {s_productSignReg, s_productNorm, s_productExp[7:0]};
+
+  /*
+   *
+   * Here the outputs are defined
+   *
+   */
+  wire s_oneCycleDone = s_isMyCi & ~s_isMul;
+  reg [31:0] s_result;
+
+  always @*
+    if (s_mulBusyReg == 1'b1) s_result <= s_mulResult;
+    else if (ciN[1:0] == CMP) s_result <= s_cmpResult;
+    else s_result <= s_addResult;
+
+  assign ciDone   = s_oneCycleDone | (s_mulBusyReg & ciCke);
+  assign ciResult = (s_oneCycleDone == 1'b1 || (s_mulBusyReg & ciCke) == 1'b1) ? s_result : 32'd0;
+
+endmodule
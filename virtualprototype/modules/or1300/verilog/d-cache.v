@@ -1,5 +1,6 @@
 /*
- * This D-cache is a 2, 4, 8 kbyte coherent cache.
+ * This D-cache is a 1, 2, 4, 8, 16 or 32 kbyte coherent cache (the maximum size is
+ * selected at synthesis time by MaximumCacheSize).
  * It can be configured to use 1,2 or 4 ways.
  * It can be run-time configured to use FIFO,PLRU or LRU replacement
  * It incorporates the load-store unit
@@ -35,9 +36,62 @@
  * 01 -> PLRU
  * 1x -> LRU
  *
+ * prefetch mode:
+ * 00 -> No prefetching
+ * 01 -> Next-line prefetching (each miss on line n prefetches line n+1)
+ * 1x -> Stride prefetching (two consecutive misses with the same line distance
+ *       prefetch the next line of the stream)
+ * A prefetched line is kept in a one line prefetch buffer next to the cache. A miss
+ * that hits the prefetch buffer fills the cache line from this buffer instead of the
+ * bus. Any bus write (including our own write-backs) covering the buffered line
+ * invalidates the buffer. Prefetching is only performed in the non-coherent regions
+ * (or with coherence disabled).
+ *
+ * software cache control (l.cas opcode space, address = rA + rB):
+ * memoryStore 110 -> Prefetch hint; schedules a prefetch of the addressed line into the
+ *                    prefetch buffer without stalling the core. The hint is dropped if
+ *                    the line is already cached or a prefetch is in flight.
+ * memoryStore 111 -> Zero line; allocates the addressed line in the cache and fills it
+ *                    with zeros without reading the memory. The line is marked dirty,
+ *                    hence this is only performed in the non-coherent region or for a
+ *                    non-coherent write-back configuration, otherwise it is ignored.
+ *
+ * write buffer:
+ * Uncacheable writes and write-throughs are posted into a 4 entry write buffer and do
+ * not stall the core unless the buffer is full. Cache hits continue while the buffer
+ * drains. The buffer is drained in order before any other bus action of the core
+ * (uncacheable reads, atomic operations, line loads, flushes), hence posted writes are
+ * only visible to other bus masters after completion of such an action or an l.msync.
+ * Bus errors of posted writes are not reported to the core.
+ *
+ * victim buffer:
+ * When enabled, lines evicted from the cache are kept in a 4 entry fully associative
+ * victim buffer (FIFO replacement). A miss that hits the victim buffer swaps the line
+ * back into the cache instead of paying the bus burst, which mainly helps the direct
+ * mapped configurations with conflicting lines. The evicted words are captured from the
+ * data memories while the new line is written (read-before-write), dirty lines are
+ * written back before being moved into the buffer, hence all entries are clean. Any bus
+ * write covering a buffered line invalidates the entry. As for the prefetcher, the victim
+ * buffer is only used in the non-coherent regions (or with coherence disabled).
+ *
+ * way locking:
+ * lockedWays excludes the highest ways from replacement (4-way: 1 -> way 4, 2 -> ways 3-4,
+ * 3 -> ways 2-4; 2-way: any value -> way 2). Lines in a locked way stay resident until
+ * they are flushed or invalidated by a snoop. When lockFill is set all misses are
+ * placed in the way that is locked next, such that software can preload this way by
+ * touching the data before raising lockedWays (lock-on-fill). Locking has no effect
+ * in the direct mapped configuration.
+ *
+ * critical word first:
+ * Line loads are issued as wrapping bursts (wrapBurstOut) starting at the requested word.
+ * The word is written to the register file as soon as it arrives (early restart), so
+ * instructions that do not touch the memory can continue while the rest of the line
+ * is filled. Other memory operations wait until the line fill has completed.
+ *
  * Note: The openrisc is big-endian
  */
-module dCache   ( input wire         clock,
+module dCache #( parameter [2:0] MaximumCacheSize = 3'd3 )
+                ( input wire         clock,
                                      reset,
                                      flushCache,
                                      pipelineStall,
@@ -63,6 +117,7 @@ module dCache   ( input wire         clock,
                   input wire         privateDirtyIn,
                   output wire [7:0]  burstSizeOut,
                   input wire [7:0]   burstSizeIn,
+                  output wire        wrapBurstOut,
                   
                   // Here the interface to the scratchpad memory is defined
                   output wire [31:0] dataToSpm,
@@ -87,6 +142,11 @@ module dCache   ( input wire         clock,
                                      cacheStall,
                                      writeThrough,
                                      invalidate,
+                                     prefetch,
+                                     prefetchHit,
+                                     postedWrite,
+                                     writeBufferStall,
+                                     victimHit,
                   
                   // Here the interface to the cpu is defined
                   output wire        stallCpu,
@@ -94,11 +154,15 @@ module dCache   ( input wire         clock,
                   input wire         memorySync,
                   input wire [1:0]   replacementPolicy,
                                      numberOfWays,
-                                     cacheSize,
+                                     prefetchMode,
+                  input wire [2:0]   cacheSize,
                   input wire         writeBackPolicy,
                                      coherenceEnabled,
                                      mesiEnabled,
                                      snarfingEnabled,
+                                     victimEnabled,
+                                     lockFill,
+                  input wire [1:0]   lockedWays,
                   input wire [29:0]  instructionAddress,
                   input wire [31:0]  dataFromCore,
                                      memoryAddress,
@@ -137,23 +201,31 @@ module dCache   ( input wire         clock,
   localparam [1:0] TWO_WAY_SET_ASSOCIATIVE  = 2'b01;
   localparam [1:0] FOUR_WAY_SET_ASSOCIATIVE = 2'b10;
   
-  localparam [3:0] DIRECT_MAPPED_1K            = 4'b0000;
-  localparam [3:0] DIRECT_MAPPED_2K            = 4'b0001;
-  localparam [3:0] DIRECT_MAPPED_4K            = 4'b0010;
-  localparam [3:0] DIRECT_MAPPED_8K            = 4'b0011;
-  localparam [3:0] TWO_WAY_SET_ASSOCIATIVE_1K  = 4'b0100;
-  localparam [3:0] TWO_WAY_SET_ASSOCIATIVE_2K  = 4'b0101;
-  localparam [3:0] TWO_WAY_SET_ASSOCIATIVE_4K  = 4'b0110;
-  localparam [3:0] TWO_WAY_SET_ASSOCIATIVE_8K  = 4'b0111;
-  localparam [3:0] FOUR_WAY_SET_ASSOCIATIVE_1K = 4'b1000;
-  localparam [3:0] FOUR_WAY_SET_ASSOCIATIVE_2K = 4'b1001;
-  localparam [3:0] FOUR_WAY_SET_ASSOCIATIVE_4K = 4'b1010;
-  localparam [3:0] FOUR_WAY_SET_ASSOCIATIVE_8K = 4'b1011;
+  localparam [4:0] DIRECT_MAPPED_1K             = 5'b00000;
+  localparam [4:0] DIRECT_MAPPED_2K             = 5'b00001;
+  localparam [4:0] DIRECT_MAPPED_4K             = 5'b00010;
+  localparam [4:0] DIRECT_MAPPED_8K             = 5'b00011;
+  localparam [4:0] DIRECT_MAPPED_16K            = 5'b00100;
+  localparam [4:0] DIRECT_MAPPED_32K            = 5'b00101;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_1K   = 5'b01000;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_2K   = 5'b01001;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_4K   = 5'b01010;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_8K   = 5'b01011;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_16K  = 5'b01100;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_32K  = 5'b01101;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_1K  = 5'b10000;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_2K  = 5'b10001;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_4K  = 5'b10010;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_8K  = 5'b10011;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_16K = 5'b10100;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_32K = 5'b10101;
   
-  localparam [1:0] SIZE_1K = 2'b00;
-  localparam [1:0] SIZE_2K = 2'b01;
-  localparam [1:0] SIZE_4K = 2'b10;
-  localparam [1:0] SIZE_8K = 2'b11;
+  localparam [2:0] SIZE_1K  = 3'b000;
+  localparam [2:0] SIZE_2K  = 3'b001;
+  localparam [2:0] SIZE_4K  = 3'b010;
+  localparam [2:0] SIZE_8K  = 3'b011;
+  localparam [2:0] SIZE_16K = 3'b100;
+  localparam [2:0] SIZE_32K = 3'b101;
   
  
   localparam [1:0] FIFO_REPLACEMENT         = 2'b00;
@@ -174,6 +246,8 @@ module dCache   ( input wire         clock,
   localparam [2:0] STORE_WORD                   = 3'b011;
   localparam [2:0] COMPARE_AND_SWAP             = 3'b100;
   localparam [2:0] SWAP                         = 3'b101;
+  localparam [2:0] PREFETCH_LINE                = 3'b110;
+  localparam [2:0] ZERO_LINE                    = 3'b111;
 
   localparam [5:0] IDLE             = 6'd0;
   localparam [5:0] REQUEST_THE_BUS  = 6'd1;
@@ -197,6 +271,7 @@ module dCache   ( input wire         clock,
   localparam [5:0] FLUSH_LOOKUP     = 6'd19;
   localparam [5:0] FLUSH_INVALIDATE = 6'd20;
   localparam [5:0] FLUSH_DONE       = 6'd21;
+  localparam [5:0] PREFETCH_COPY    = 6'd22;
 
   localparam [4:0] UNCACHEABLE_WRITE     = 5'd0;
   localparam [4:0] UNCACHEABLE_READ      = 5'd1;
@@ -208,11 +283,24 @@ module dCache   ( input wire         clock,
   localparam [4:0] WRITE_THROUGH         = 5'd7;
   localparam [4:0] SNOOPY_WRITE_BACK     = 5'd8;
   localparam [4:0] FLUSH_WRITE_BACK      = 5'd9;
+  localparam [4:0] PREFETCH_LOAD         = 5'd10;
+
+  localparam [1:0] NO_PREFETCH           = 2'b00;
+  localparam [1:0] NEXT_LINE_PREFETCH    = 2'b01;
 
-  wire s_internalStall, s_busError;
+  /*
+   * The tag and data memories are sized for the largest cache selectable at run time
+   * (MaximumCacheSize, direct mapped); smaller configurations use only part of them.
+   */
+  localparam integer MaximumSetBits = MaximumCacheSize + 5;
+  localparam integer DataIndexBits  = MaximumCacheSize + 6;
+
+  wire s_internalStall, s_busError, s_prefetchBufferHit, s_victimBufferHit, s_localLineFill, s_writeThroughRequired;
   wire s_invertedClock = ~clock;
   reg s_flushRequestReg, s_flushActiveReg, s_cacheEnabledReg;
-  reg [31:0] s_selectedCacheData, s_busDataInReg;
+  reg s_writeBufferEmptyReg, s_writeBufferFullReg;
+  reg s_earlyRestartReg, s_earlyRestartDoneReg;
+  reg [31:0] s_selectedCacheData, s_busDataInReg, s_writeBackAddress;
   reg s_dataForward1, s_dataForward2;
   reg [4:0] s_busTransactionTypeReg;
   reg [2:0] s_busTransactionLengthReg;
@@ -220,6 +308,7 @@ module dCache   ( input wire         clock,
   reg s_busDataInValidReg, s_waitWriteBackReg;
   reg [31:0] s_busAddressReg;
   reg [2:0] s_wordBurstSelectReg;
+  reg s_wrapBurstReg;
 
   /*
    *
@@ -235,6 +324,7 @@ module dCache   ( input wire         clock,
   reg s_stage2AbortReg, s_stage2ValidReg, s_stage1UReadReg, s_stage1UWriteReg, s_stage1CReadReg, s_stage1CWriteReg;
   reg s_stage1SpmReadReg, s_stage1CasReg, s_stage1SwapReg, s_stage1CacheActionReg, s_stage2UReadReg;
   reg s_stage2UWriteReg, s_stage2CReadReg, s_stage2CWriteReg, s_stage2SpmReadReg, s_stage2CasReg, s_stage2SwapReg, s_stage2CacheActionReg;
+  reg s_stage1PrefetchReg, s_stage1ZeroReg, s_stage2PrefetchReg, s_stage2ZeroReg;
   
   wire [31:0] s_stage2DataToCoreNext = (s_internalStall == 1'b0) ? s_selectedCacheData :
                                        (s_busDataInValidReg == 1'b1 &&
@@ -247,8 +337,7 @@ module dCache   ( input wire         clock,
   wire s_stage2AbortNext        = (reset == 1'b1 || s_internalStall == 1'b0) ? 1'b0 : s_busError;
   wire s_stage2ValidNext        = (reset == 1'b1 || s_internalStall == 1'b0) ? 1'b0 :
                                   (s_cacheStateReg == RELEASE &&
-                                   (s_busTransactionTypeReg == UNCACHEABLE_WRITE ||
-                                    s_busTransactionTypeReg == UNCACHEABLE_READ ||
+                                   (s_busTransactionTypeReg == UNCACHEABLE_READ ||
                                     s_busTransactionTypeReg == ATOMIC_SWAP ||
                                     s_busTransactionTypeReg == ATOMIC_CAS
                                    )
@@ -274,6 +363,10 @@ module dCache   ( input wire         clock,
   wire s_stage1CasNext         = (memoryStore == COMPARE_AND_SWAP && s_spmAddressed == 1'b0) ? 1'b1 : 1'b0;
   wire s_stage1SwapNext        = (memoryStore == SWAP && s_spmAddressed == 1'b0) ? 1'b1 : 1'b0;
   wire s_stage1CacheActionNext = (memoryLoad != NO_LOAD || memoryStore != NO_STORE) ? 1'b1 : 1'b0;
+  wire s_stage1PrefetchNext    = (s_cacheEnabledReg == 1'b1 && memoryAddress[30] == 1'b0 && memoryStore == PREFETCH_LINE &&
+                                  (coherenceEnabled == 1'b0 || memoryAddress[31] == 1'b1)) ? 1'b1 : 1'b0;
+  wire s_stage1ZeroNext        = (s_cacheEnabledReg == 1'b1 && memoryAddress[30] == 1'b0 && memoryStore == ZERO_LINE &&
+                                  (memoryAddress[31] == 1'b1 || (coherenceEnabled == 1'b0 && writeBackPolicy == 1'b1))) ? 1'b1 : 1'b0;
 
   always @*
     case (memoryStore)
@@ -313,6 +406,8 @@ module dCache   ( input wire         clock,
        s_stage1CasReg         <= 1'b0;
        s_stage1SwapReg        <= 1'b0;
        s_stage1CacheActionReg <= 1'b0;
+       s_stage1PrefetchReg    <= 1'b0;
+       s_stage1ZeroReg        <= 1'b0;
      end
    else if (s_internalStall == 1'b0)
      begin
@@ -324,6 +419,8 @@ module dCache   ( input wire         clock,
        s_stage1CasReg         <= s_stage1CasNext;
        s_stage1SwapReg        <= s_stage1SwapNext;
        s_stage1CacheActionReg <= s_stage1CacheActionNext;
+       s_stage1PrefetchReg    <= s_stage1PrefetchNext;
+       s_stage1ZeroReg        <= s_stage1ZeroNext;
      end
  
  always @(posedge clock)
@@ -356,6 +453,8 @@ module dCache   ( input wire         clock,
         s_stage2CasReg            <= 0;
         s_stage2SwapReg           <= 0;
         s_stage2CacheActionReg    <= 0;
+        s_stage2PrefetchReg       <= 0;
+        s_stage2ZeroReg           <= 0;
       end
     else if (s_internalStall == 1'b0)
       begin
@@ -371,6 +470,8 @@ module dCache   ( input wire         clock,
         s_stage2CasReg            <= s_stage1CasReg;
         s_stage2SwapReg           <= s_stage1SwapReg;
         s_stage2CacheActionReg    <= s_stage1CacheActionReg;
+        s_stage2PrefetchReg       <= s_stage1PrefetchReg;
+        s_stage2ZeroReg           <= s_stage1ZeroReg;
       end
 
   always @(posedge clock) 
@@ -430,8 +531,9 @@ module dCache   ( input wire         clock,
    *
    *
    */
-  wire s_registerWe = ~s_internalStall & (s_stage2UReadReg | s_stage2CasReg | s_stage2SwapReg |
-                                          s_stage2CReadReg | s_stage2SpmReadReg );
+  wire s_registerWe = (~s_internalStall & ~s_earlyRestartDoneReg & (s_stage2UReadReg | s_stage2CasReg | s_stage2SwapReg |
+                                                                    s_stage2CReadReg | s_stage2SpmReadReg )) |
+                      (s_internalStall & s_earlyRestartReg);
   assign dataAbort          = s_stage2AbortReg & ~s_internalStall;
   assign abortAddress       = s_stage2PcReg;
   assign abortMemoryAddress = s_stage2MemoryAddressReg;
@@ -448,7 +550,7 @@ module dCache   ( input wire         clock,
   reg [7:0] s_snoopyStage1BurstSizeReg;
   reg s_snoopyStage1LookupSnoopReg, s_snoopyStage2LookupSnoopReg;
   reg [23:0] s_snoopyTag;
-  reg [8:0] s_snoopyWriteIndex;
+  reg [9:0] s_snoopyWriteIndex;
   reg [3:0] s_snoopyStage3WaySelectReg;
   reg s_snoopyStage3InvalidateReg, s_snoopyStage3UpdateStateReg, s_snoopyWbDetectReg, s_snoopyDirtyIdReg;
   wire [31:0] s_combinedSnoop1, s_combinedSnoop2, s_combinedSnoop3, s_combinedSnoop4;
@@ -462,14 +564,16 @@ module dCache   ( input wire         clock,
   wire [3:0] s_snoopyStage2Way4State = s_combinedSnoop4[3:0];
   wire s_doNotSnoopThisBurstNext = (beginTransactionIn == 1'b1 || reset == 1'b1) ? 1'b0 :
                                    (s_cacheStateReg == INIT_TRANSACTION &&
+                                    s_localLineFill == 1'b0 &&
                                     (s_busTransactionTypeReg == WRITE_THROUGH ||
                                      s_busTransactionTypeReg == CACHE_LINE_WRITE_BACK ||
                                      s_busTransactionTypeReg == CACHE_LINE_LOAD ||
                                      s_busTransactionTypeReg == SNOOPY_WRITE_BACK ||
-                                     s_busTransactionTypeReg == FLUSH_WRITE_BACK
+                                     s_busTransactionTypeReg == FLUSH_WRITE_BACK ||
+                                     s_busTransactionTypeReg == PREFETCH_LOAD
                                     )
                                    ) ? 1'b1 : s_doNotSnoopThisBurstReg;
-  wire [3:0] s_cacheConfiguration = {numberOfWays, cacheSize};
+  wire [4:0] s_cacheConfiguration = {numberOfWays, cacheSize};
   wire s_snoopyHit1 = (s_snoopyTag == s_snoopyStage2Tag1Reg &&
                        s_snoopyStage2Way1State[0] == 1'b1) ? s_snoopyStage1LookupSnoopReg : 1'b0;
   wire s_snoopyHit2 = (s_snoopyTag == s_snoopyStage2Tag2Reg &&
@@ -524,33 +628,43 @@ module dCache   ( input wire         clock,
     case (s_cacheConfiguration)
       FOUR_WAY_SET_ASSOCIATIVE_1K : begin
                                       s_snoopyTag         <= s_snoopyStage2AddressReg[31:8];
-                                      s_snoopyWriteIndex  <= { 6'd0, s_snoopyStage3AddressReg[7:5] };
+                                      s_snoopyWriteIndex  <= { 7'd0, s_snoopyStage3AddressReg[7:5] };
                                     end
       FOUR_WAY_SET_ASSOCIATIVE_2K,
       TWO_WAY_SET_ASSOCIATIVE_1K  : begin
                                       s_snoopyTag         <= { 1'b0, s_snoopyStage2AddressReg[31:9]};
-                                      s_snoopyWriteIndex  <= { 5'd0, s_snoopyStage3AddressReg[8:5] };
+                                      s_snoopyWriteIndex  <= { 6'd0, s_snoopyStage3AddressReg[8:5] };
                                     end
       FOUR_WAY_SET_ASSOCIATIVE_4K,
       TWO_WAY_SET_ASSOCIATIVE_2K,
       DIRECT_MAPPED_1K            : begin
                                       s_snoopyTag         <= { 2'd0, s_snoopyStage2AddressReg[31:10]};
-                                      s_snoopyWriteIndex  <= { 4'd0, s_snoopyStage3AddressReg[9:5] };
+                                      s_snoopyWriteIndex  <= { 5'd0, s_snoopyStage3AddressReg[9:5] };
                                     end
       FOUR_WAY_SET_ASSOCIATIVE_8K,
       TWO_WAY_SET_ASSOCIATIVE_4K,
       DIRECT_MAPPED_2K            : begin
                                       s_snoopyTag         <= { 3'd0, s_snoopyStage2AddressReg[31:11]};
-                                      s_snoopyWriteIndex  <= { 3'd0, s_snoopyStage3AddressReg[10:5] };
+                                      s_snoopyWriteIndex  <= { 4'd0, s_snoopyStage3AddressReg[10:5] };
                                     end
+      FOUR_WAY_SET_ASSOCIATIVE_16K,
       TWO_WAY_SET_ASSOCIATIVE_8K,
       DIRECT_MAPPED_4K            : begin
                                       s_snoopyTag         <= { 4'd0, s_snoopyStage2AddressReg[31:12]};
-                                      s_snoopyWriteIndex  <= { 2'd0, s_snoopyStage3AddressReg[11:5] };
+                                      s_snoopyWriteIndex  <= { 3'd0, s_snoopyStage3AddressReg[11:5] };
+                                    end
+      TWO_WAY_SET_ASSOCIATIVE_32K,
+      DIRECT_MAPPED_16K           : begin
+                                      s_snoopyTag         <= { 6'd0, s_snoopyStage2AddressReg[31:14]};
+                                      s_snoopyWriteIndex  <= { 1'b0, s_snoopyStage3AddressReg[13:5] };
+                                    end
+      DIRECT_MAPPED_32K           : begin
+                                      s_snoopyTag         <= { 7'd0, s_snoopyStage2AddressReg[31:15]};
+                                      s_snoopyWriteIndex  <= s_snoopyStage3AddressReg[14:5];
                                     end
       default                     : begin
                                       s_snoopyTag         <= { 5'd0, s_snoopyStage2AddressReg[31:13]};
-                                      s_snoopyWriteIndex  <= { 1'b0, s_snoopyStage3AddressReg[12:5]};
+                                      s_snoopyWriteIndex  <= { 2'd0, s_snoopyStage3AddressReg[12:5]};
                                     end
     endcase
     
@@ -562,9 +676,9 @@ module dCache   ( input wire         clock,
   reg s_snoopyWbBufferEmptyReg, s_snoopyWbBufferFullReg;
   reg [3:0] s_snoopyWbBufferReadAddrReg, s_snoopyWbBufferWriteAddrReg;
   reg [3:0] s_snoopyWbWaySelectReg, s_snoopyWbWaySelectNext;
-  reg [11:0] s_snoopyWbBufferEntryReg [15:0];
-  reg [10:0] s_snoopyWbBufferNewValue;
-  reg [8:0] s_snoopyWbIndexReg;
+  reg [12:0] s_snoopyWbBufferEntryReg [15:0];
+  reg [11:0] s_snoopyWbBufferNewValue;
+  reg [9:0] s_snoopyWbIndexReg;
   reg [23:0] s_snoopyWbTagReg;
   reg [31:0] s_snoopyWbAddress;
   wire [15:0] s_snoopyWbBufferHits;
@@ -605,10 +719,10 @@ module dCache   ( input wire         clock,
   
   always @*
     begin
-      s_snoopyWbBufferNewValue[10]  <= s_snoopyStage3WaySelectReg[3] | s_snoopyStage3WaySelectReg[2];
-      s_snoopyWbBufferNewValue[9]   <= s_snoopyStage3WaySelectReg[1] | s_snoopyStage3WaySelectReg[0];
-      s_snoopyWbBufferNewValue[8:0] <= s_snoopyWriteIndex;
-      case (s_snoopyWbBufferEntryReg[s_snoopyWbBufferReadAddrReg][11:9])
+      s_snoopyWbBufferNewValue[11]  <= s_snoopyStage3WaySelectReg[3] | s_snoopyStage3WaySelectReg[2];
+      s_snoopyWbBufferNewValue[10]  <= s_snoopyStage3WaySelectReg[1] | s_snoopyStage3WaySelectReg[0];
+      s_snoopyWbBufferNewValue[9:0] <= s_snoopyWriteIndex;
+      case (s_snoopyWbBufferEntryReg[s_snoopyWbBufferReadAddrReg][12:10])
         3'b100  : s_snoopyWbWaySelectNext <= 4'b0001;
         3'b101  : s_snoopyWbWaySelectNext <= 4'b0010;
         3'b110  : s_snoopyWbWaySelectNext <= 4'b0100;
@@ -632,7 +746,7 @@ module dCache   ( input wire         clock,
         s_flushActiveReg == 1'b0)
       begin
         s_snoopyWbWaySelectReg <= s_snoopyWbWaySelectNext;
-        s_snoopyWbIndexReg     <= s_snoopyWbBufferEntryReg[s_snoopyWbBufferReadAddrReg][8:0];
+        s_snoopyWbIndexReg     <= s_snoopyWbBufferEntryReg[s_snoopyWbBufferReadAddrReg][9:0];
       end
 
   always @*
@@ -662,12 +776,24 @@ module dCache   ( input wire         clock,
                                       s_snoopyWbAddress[10:5]  <= s_snoopyWbIndexReg[5:0];
                                       s_snoopyWbAddress[4:0]   <= 5'd0;
                                     end
+      FOUR_WAY_SET_ASSOCIATIVE_16K,
       TWO_WAY_SET_ASSOCIATIVE_8K,
       DIRECT_MAPPED_4K            : begin
                                       s_snoopyWbAddress[31:12] <= s_snoopyWbTagReg[19:0];
                                       s_snoopyWbAddress[11:5]  <= s_snoopyWbIndexReg[6:0];
                                       s_snoopyWbAddress[4:0]   <= 5'd0;
                                     end
+      TWO_WAY_SET_ASSOCIATIVE_32K,
+      DIRECT_MAPPED_16K           : begin
+                                      s_snoopyWbAddress[31:14] <= s_snoopyWbTagReg[17:0];
+                                      s_snoopyWbAddress[13:5]  <= s_snoopyWbIndexReg[8:0];
+                                      s_snoopyWbAddress[4:0]   <= 5'd0;
+                                    end
+      DIRECT_MAPPED_32K           : begin
+                                      s_snoopyWbAddress[31:15] <= s_snoopyWbTagReg[16:0];
+                                      s_snoopyWbAddress[14:5]  <= s_snoopyWbIndexReg[9:0];
+                                      s_snoopyWbAddress[4:0]   <= 5'd0;
+                                    end
       default                     : begin
                                       s_snoopyWbAddress[31:13] <= s_snoopyWbTagReg[18:0];
                                       s_snoopyWbAddress[12:5]  <= s_snoopyWbIndexReg[7:0];
@@ -683,7 +809,7 @@ module dCache   ( input wire         clock,
               (s_snoopyWbBufferReadAddrReg == n && s_snoopyWbBufferRe == 1'b1)) s_snoopyWbBufferEntryReg[n] <= 0;
           else if (s_snoopyWbBufferWriteAddrReg == n && s_snoopyWbBufferWe == 1'b1) s_snoopyWbBufferEntryReg[n] <= {1'b1,s_snoopyWbBufferNewValue};
         
-        assign s_snoopyWbBufferHits[n] = (s_snoopyWbBufferEntryReg[n][11] == 1'b1 && s_snoopyWbBufferEntryReg[n][10:0] == s_snoopyWbBufferNewValue) ? 1'b1 : 1'b0;
+        assign s_snoopyWbBufferHits[n] = (s_snoopyWbBufferEntryReg[n][12] == 1'b1 && s_snoopyWbBufferEntryReg[n][11:0] == s_snoopyWbBufferNewValue) ? 1'b1 : 1'b0;
       end
   endgenerate
   
@@ -725,17 +851,18 @@ module dCache   ( input wire         clock,
   reg [3:0] s_flushWaySelectReg, s_flushInvalidateVector;
   reg s_initializingFlushReg, s_flushSelectedDone, s_flushWriteBackRequired;
   reg s_flushEnableCacheDelayReg, s_dcacheDisableActiveReg;
-  reg [8:0] s_flushCounterReg;
+  reg [10:0] s_flushCounterReg;
   reg [1:0] s_flushWaySelect;
   reg [31:0] s_flushWbAddressReg;
   wire s_initializingFlushNext = (reset == 1'b1) ? 1'b1 : (s_cacheStateReg == FLUSH_DONE) ? 1'b0 : s_initializingFlushReg;
   wire s_flushInvalidate = (s_cacheStateReg == FLUSH_INVALIDATE) ? 1'b1 : 1'b0;
-  wire s_flushDone = (s_initializingFlushReg == 1'b1) ? s_flushCounterReg[8] : s_flushSelectedDone;
+  wire s_flushDone = (s_initializingFlushReg == 1'b1) ? s_flushCounterReg[MaximumSetBits] : s_flushSelectedDone;
   wire s_flushWay1RequiresWriteBack = s_stage1State1Reg[0] & (s_stage1State1Reg[3] | s_stage1State1Reg[2]);
   wire s_flushWay2RequiresWriteBack = s_stage1State2Reg[0] & (s_stage1State2Reg[3] | s_stage1State2Reg[2]);
   wire s_flushWay3RequiresWriteBack = s_stage1State3Reg[0] & (s_stage1State3Reg[3] | s_stage1State3Reg[2]);
   wire s_flushWay4RequiresWriteBack = s_stage1State4Reg[0] & (s_stage1State4Reg[3] | s_stage1State4Reg[2]);
-  wire s_dcacheDisableFlushRequest = ~s_flushActiveReg & s_dcacheDisableActiveReg & ~s_stage1CacheActionReg & ~s_stage2CacheActionReg;
+  wire s_dcacheDisableFlushRequest = ~s_flushActiveReg & s_dcacheDisableActiveReg & ~s_stage1CacheActionReg & ~s_stage2CacheActionReg &
+                                     s_writeBufferEmptyReg;
   wire s_flushRequestNext = (s_cacheStateReg == FLUSH_DONE) ? 1'b0 :
                             (reset == 1'b1 || s_dcacheDisableFlushRequest == 1'b1 ||
                              (flushCache == 1'b1 && s_cacheEnabledReg == 1'b1)) ? 1'b1 : s_flushRequestReg;
@@ -743,15 +870,24 @@ module dCache   ( input wire         clock,
                             (reset == 1'b1 || s_dcacheDisableFlushRequest == 1'b1 ||
                              (s_flushRequestReg == 1'b1 &&
                               s_stage1CacheActionReg == 1'b0 &&
-                              s_stage2CacheActionReg == 1'b0)) ? 1'b1 : s_flushActiveReg;
-  wire [8:0] s_flushCounterNext = (reset == 1'b1 || s_cacheStateReg == FLUSH_INIT) ? 9'd0 :
-                                  (s_cacheStateReg == FLUSH_INVALIDATE) ? s_flushCounterReg + 9'd1 : s_flushCounterReg;
+                              s_stage2CacheActionReg == 1'b0 &&
+                              s_writeBufferEmptyReg == 1'b1)) ? 1'b1 : s_flushActiveReg;
+  wire [10:0] s_flushCounterNext = (reset == 1'b1 || s_cacheStateReg == FLUSH_INIT) ? 11'd0 :
+                                   (s_cacheStateReg == FLUSH_INVALIDATE) ? s_flushCounterReg + 11'd1 : s_flushCounterReg;
   wire s_dcacheDisableTick = ~s_cacheEnabledReg & s_flushEnableCacheDelayReg;
   wire s_dcacheDisableActiveNext = (reset == 1'b1 || s_cacheStateReg == FLUSH_DONE) ? 1'b0 :
                                    (s_dcacheDisableTick == 1'b1) ? 1'b1 : s_dcacheDisableActiveReg;
   
   always @*
     case (cacheSize)
+      SIZE_32K : begin
+                  s_flushSelectedDone <= s_flushCounterReg[10];
+                  s_flushWaySelect    <= s_flushCounterReg[9:8];
+                end
+      SIZE_16K : begin
+                  s_flushSelectedDone <= s_flushCounterReg[9];
+                  s_flushWaySelect    <= s_flushCounterReg[8:7];
+                end
       SIZE_8K : begin
                   s_flushSelectedDone <= s_flushCounterReg[8];
                   s_flushWaySelect    <= s_flushCounterReg[7:6];
@@ -818,6 +954,38 @@ module dCache   ( input wire         clock,
           endcase
           s_flushWbAddressReg[4:0] <= 0;
           case (cacheSize)
+            SIZE_32K : case (numberOfWays)
+                        FOUR_WAY_SET_ASSOCIATIVE : begin
+                                                     s_flushWbAddressReg[12:5] <= s_flushCounterReg[7:0];
+                                                     case (s_flushWaySelect)
+                                                       2'b00   : s_flushWbAddressReg[31:13] <= s_stage1Tag1Reg[18:0];
+                                                       2'b01   : s_flushWbAddressReg[31:13] <= s_stage1Tag2Reg[18:0];
+                                                       2'b10   : s_flushWbAddressReg[31:13] <= s_stage1Tag3Reg[18:0];
+                                                       default : s_flushWbAddressReg[31:13] <= s_stage1Tag4Reg[18:0];
+                                                     endcase
+                                                   end
+                        TWO_WAY_SET_ASSOCIATIVE  : begin
+                                                     s_flushWbAddressReg[13:5]  <= s_flushCounterReg[8:0];
+                                                     s_flushWbAddressReg[31:14] <= (s_flushCounterReg[9] == 1'b0) ? s_stage1Tag1Reg[17:0] : s_stage1Tag2Reg[17:0];
+                                                   end
+                        default                  : s_flushWbAddressReg[31:5] <= {s_stage1Tag1Reg[16:0],s_flushCounterReg[9:0]};
+                      endcase
+            SIZE_16K : case (numberOfWays)
+                        FOUR_WAY_SET_ASSOCIATIVE : begin
+                                                     s_flushWbAddressReg[11:5] <= s_flushCounterReg[6:0];
+                                                     case (s_flushWaySelect)
+                                                       2'b00   : s_flushWbAddressReg[31:12] <= s_stage1Tag1Reg[19:0];
+                                                       2'b01   : s_flushWbAddressReg[31:12] <= s_stage1Tag2Reg[19:0];
+                                                       2'b10   : s_flushWbAddressReg[31:12] <= s_stage1Tag3Reg[19:0];
+                                                       default : s_flushWbAddressReg[31:12] <= s_stage1Tag4Reg[19:0];
+                                                     endcase
+                                                   end
+                        TWO_WAY_SET_ASSOCIATIVE  : begin
+                                                     s_flushWbAddressReg[12:5]  <= s_flushCounterReg[7:0];
+                                                     s_flushWbAddressReg[31:13] <= (s_flushCounterReg[8] == 1'b0) ? s_stage1Tag1Reg[18:0] : s_stage1Tag2Reg[18:0];
+                                                   end
+                        default                  : s_flushWbAddressReg[31:5] <= {s_stage1Tag1Reg[17:0],s_flushCounterReg[8:0]};
+                      endcase
             SIZE_8K : case (numberOfWays)
                         FOUR_WAY_SET_ASSOCIATIVE : begin
                                                      s_flushWbAddressReg[10:5] <= s_flushCounterReg[5:0];
@@ -896,7 +1064,7 @@ module dCache   ( input wire         clock,
   reg [3:0] s_stage2State1Reg, s_stage2State2Reg, s_stage2State3Reg, s_stage2State4Reg;
   reg s_stage2Hit1Reg, s_stage2Hit2Reg, s_stage2Hit3Reg, s_stage2Hit4Reg, s_privateCacheLineReg;
   reg [23:0] s_newTag, s_hitTag;
-  reg[8:0] s_lookupTagIndex, s_forwardTagIndex, s_activeTagIndex, s_rwTagIndex;
+  reg[9:0] s_lookupTagIndex, s_forwardTagIndex, s_activeTagIndex, s_rwTagIndex;
   reg s_hit1, s_hit2, s_hit3, s_hit4, s_stage1IsCacheLookupReg, s_stage2IsCacheLookupReg;
   reg s_stage2Hit1Next, s_stage2Hit2Next, s_stage2Hit3Next, s_stage2Hit4Next; 
   wire s_cacheWriteAction = ~s_internalStall & s_stage2CWriteReg;
@@ -929,6 +1097,7 @@ module dCache   ( input wire         clock,
                                     s_stage2MemoryAddressReg[31] == 1'b0) ? STATE_MODIFIED :
                                    (s_cacheWriteAction == 1'b1 && s_snarfUpdateTagReg == 1'b0 &&
                                     (s_stage2MemoryAddressReg[31] == 1'b1 || (coherenceEnabled == 1'b0 && writeBackPolicy == 1'b1))) ? STATE_DIRTY :
+                                   (s_cacheStateReg == UPDATE_TAGS && s_stage2ZeroReg == 1'b1) ? STATE_DIRTY :
                                    (s_cacheStateReg == UPDATE_TAGS && s_stage2MemoryAddressReg[31] == 1'b0 &&
                                     writeBackPolicy == 1'b1 && s_privateCacheLineReg == 1'b1 && mesiEnabled == 1'b1) ? STATE_EXCLUSIVE :
                                    (((s_cacheWriteAction == 1'b1 || (s_cacheStateReg == UPDATE_TAGS && s_stage2CWriteReg == 1'b1)) && writeBackPolicy == 1'b0) ||
@@ -937,10 +1106,10 @@ module dCache   ( input wire         clock,
                                     (s_cacheStateReg == UPDATE_TAGS && s_stage2MemoryAddressReg[31] == 1'b0 && coherenceEnabled == 1'b1)) ? STATE_SHARED :
                                    (s_cacheStateReg == UPDATE_TAGS) ? STATE_VALID : STATE_INVALID;
   wire [31:0] s_tagAddress = (s_snoopyStage3UpdateStateReg == 1'b1) ? s_snoopyStage3AddressReg : s_stage2MemoryAddressReg;
-  wire [8:0] s_lookupAddress = (s_flushActiveReg == 1'b1) ? s_flushCounterReg : {1'b0, memoryAddress[12:5]};
-  wire [8:0] s_rwAddress = (s_cacheStateReg == LOOKUP_TAGS || s_cacheStateReg == MARK_SHARED) ? s_snoopyWbIndexReg :
-                           (s_snoopyStage1LookupSnoopReg == 1'b1) ? {1'b0, s_snoopyStage1AddressReg[12:5]} :
-                           (s_snoopyStage3UpdateStateReg == 1'b1) ? {1'b0, s_snoopyStage3AddressReg[12:5]} : {1'b0, s_stage2MemoryAddressReg[12:5]};
+  wire [9:0] s_lookupAddress = (s_flushActiveReg == 1'b1) ? s_flushCounterReg[9:0] : memoryAddress[14:5];
+  wire [9:0] s_rwAddress = (s_cacheStateReg == LOOKUP_TAGS || s_cacheStateReg == MARK_SHARED) ? s_snoopyWbIndexReg :
+                           (s_snoopyStage1LookupSnoopReg == 1'b1) ? s_snoopyStage1AddressReg[14:5] :
+                           (s_snoopyStage3UpdateStateReg == 1'b1) ? s_snoopyStage3AddressReg[14:5] : s_stage2MemoryAddressReg[14:5];
   wire [3:0] s_stage1State1Next = (reset == 1'b1) ? STATE_INVALID :
                                   (s_updateWaysState[0] == 1'b1 &&
                                    s_flushActiveReg == 1'b0 &&
@@ -1013,6 +1182,8 @@ module dCache   ( input wire         clock,
                           (memoryStore == STORE_BYTE ||
                            memoryStore == STORE_HALF_WORD ||
                            memoryStore == STORE_WORD ||
+                           memoryStore == PREFETCH_LINE ||
+                           memoryStore == ZERO_LINE ||
                            memoryLoad != NO_LOAD)) ? 1'b1 : 1'b0;
   wire s_hitMask1 = (s_updateWaysState[0] && s_rwTagIndex == s_activeTagIndex ) ? s_newCacheLineState[0] & s_stage2IsCacheLookupReg : s_stage2IsCacheLookupReg;
   wire s_hitMask2 = (s_updateWaysState[1] && s_rwTagIndex == s_activeTagIndex ) ? s_newCacheLineState[0] & s_stage2IsCacheLookupReg : s_stage2IsCacheLookupReg;
@@ -1043,11 +1214,21 @@ module dCache   ( input wire         clock,
                                       s_newTag <= (s_cacheStateReg == MARK_SHARED) ? s_snoopyWbTagReg : { {3{1'b0}} ,s_tagAddress[31:11]};
                                       s_hitTag <= { {3{1'b0}} ,s_stage1MemoryAddressReg[31:11]};
                                     end
+      FOUR_WAY_SET_ASSOCIATIVE_16K,
       TWO_WAY_SET_ASSOCIATIVE_8K,
       DIRECT_MAPPED_4K            : begin
                                       s_newTag <= (s_cacheStateReg == MARK_SHARED) ? s_snoopyWbTagReg : { {4{1'b0}} ,s_tagAddress[31:12]};
                                       s_hitTag <= { {4{1'b0}} ,s_stage1MemoryAddressReg[31:12]};
                                     end
+      TWO_WAY_SET_ASSOCIATIVE_32K,
+      DIRECT_MAPPED_16K           : begin
+                                      s_newTag <= (s_cacheStateReg == MARK_SHARED) ? s_snoopyWbTagReg : { {6{1'b0}} ,s_tagAddress[31:14]};
+                                      s_hitTag <= { {6{1'b0}} ,s_stage1MemoryAddressReg[31:14]};
+                                    end
+      DIRECT_MAPPED_32K           : begin
+                                      s_newTag <= (s_cacheStateReg == MARK_SHARED) ? s_snoopyWbTagReg : { {7{1'b0}} ,s_tagAddress[31:15]};
+                                      s_hitTag <= { {7{1'b0}} ,s_stage1MemoryAddressReg[31:15]};
+                                    end
       default                     : begin
                                       s_newTag <= (s_cacheStateReg == MARK_SHARED) ? s_snoopyWbTagReg : { {5{1'b0}} ,s_tagAddress[31:13]};
                                       s_hitTag <= { {5{1'b0}} ,s_stage1MemoryAddressReg[31:13]};
@@ -1056,18 +1237,22 @@ module dCache   ( input wire         clock,
 
   always @*
     case (s_cacheConfiguration)
-      FOUR_WAY_SET_ASSOCIATIVE_1K : s_rwTagIndex <= { 6'd0 , s_rwAddress[2:0] };
+      FOUR_WAY_SET_ASSOCIATIVE_1K : s_rwTagIndex <= { 7'd0 , s_rwAddress[2:0] };
       FOUR_WAY_SET_ASSOCIATIVE_2K,
-      TWO_WAY_SET_ASSOCIATIVE_1K  : s_rwTagIndex <= { 5'd0 , s_rwAddress[3:0] };
+      TWO_WAY_SET_ASSOCIATIVE_1K  : s_rwTagIndex <= { 6'd0 , s_rwAddress[3:0] };
       FOUR_WAY_SET_ASSOCIATIVE_4K,
       TWO_WAY_SET_ASSOCIATIVE_2K,
-      DIRECT_MAPPED_1K            : s_rwTagIndex <= { 4'd0 , s_rwAddress[4:0] };
+      DIRECT_MAPPED_1K            : s_rwTagIndex <= { 5'd0 , s_rwAddress[4:0] };
       FOUR_WAY_SET_ASSOCIATIVE_8K,
       TWO_WAY_SET_ASSOCIATIVE_4K,
-      DIRECT_MAPPED_2K            : s_rwTagIndex <= { 3'd0 , s_rwAddress[5:0] };
+      DIRECT_MAPPED_2K            : s_rwTagIndex <= { 4'd0 , s_rwAddress[5:0] };
+      FOUR_WAY_SET_ASSOCIATIVE_16K,
       TWO_WAY_SET_ASSOCIATIVE_8K,
-      DIRECT_MAPPED_4K            : s_rwTagIndex <= { 2'd0 , s_rwAddress[6:0] };
-      default                     : s_rwTagIndex <= { 1'd0 , s_rwAddress[7:0] };
+      DIRECT_MAPPED_4K            : s_rwTagIndex <= { 3'd0 , s_rwAddress[6:0] };
+      TWO_WAY_SET_ASSOCIATIVE_32K,
+      DIRECT_MAPPED_16K           : s_rwTagIndex <= { 1'd0 , s_rwAddress[8:0] };
+      DIRECT_MAPPED_32K           : s_rwTagIndex <= s_rwAddress;
+      default                     : s_rwTagIndex <= { 2'd0 , s_rwAddress[7:0] };
     endcase
     
   always @*
@@ -1123,46 +1308,58 @@ module dCache   ( input wire         clock,
   always @*
     if (s_initializingFlushReg == 1'b1)
       begin
-        s_lookupTagIndex  <= s_flushCounterReg[8:0];
-        s_forwardTagIndex <= 9'd0;
-        s_activeTagIndex  <= 9'd0;
+        s_lookupTagIndex  <= s_flushCounterReg[9:0];
+        s_forwardTagIndex <= 10'd0;
+        s_activeTagIndex  <= 10'd0;
       end
     else case (s_cacheConfiguration)
       FOUR_WAY_SET_ASSOCIATIVE_1K : begin
-                                      s_lookupTagIndex  <= { 6'd0 , s_lookupAddress[2:0] };
-                                      s_forwardTagIndex <= { 6'd0 , s_stage1MemoryAddressReg[7:5] };
-                                      s_activeTagIndex  <= { 6'd0 , s_stage2MemoryAddressReg[7:5] };
+                                      s_lookupTagIndex  <= { 7'd0 , s_lookupAddress[2:0] };
+                                      s_forwardTagIndex <= { 7'd0 , s_stage1MemoryAddressReg[7:5] };
+                                      s_activeTagIndex  <= { 7'd0 , s_stage2MemoryAddressReg[7:5] };
                                     end
       FOUR_WAY_SET_ASSOCIATIVE_2K,
       TWO_WAY_SET_ASSOCIATIVE_1K  : begin
-                                      s_lookupTagIndex  <= { 5'd0 , s_lookupAddress[3:0] };
-                                      s_forwardTagIndex <= { 5'd0 , s_stage1MemoryAddressReg[8:5] };
-                                      s_activeTagIndex  <= { 5'd0 , s_stage2MemoryAddressReg[8:5] };
+                                      s_lookupTagIndex  <= { 6'd0 , s_lookupAddress[3:0] };
+                                      s_forwardTagIndex <= { 6'd0 , s_stage1MemoryAddressReg[8:5] };
+                                      s_activeTagIndex  <= { 6'd0 , s_stage2MemoryAddressReg[8:5] };
                                     end
       FOUR_WAY_SET_ASSOCIATIVE_4K,
       TWO_WAY_SET_ASSOCIATIVE_2K,
       DIRECT_MAPPED_1K            : begin
-                                      s_lookupTagIndex  <= { 4'd0 , s_lookupAddress[4:0] };
-                                      s_forwardTagIndex <= { 4'd0 , s_stage1MemoryAddressReg[9:5] };
-                                      s_activeTagIndex  <= { 4'd0 , s_stage2MemoryAddressReg[9:5] };
+                                      s_lookupTagIndex  <= { 5'd0 , s_lookupAddress[4:0] };
+                                      s_forwardTagIndex <= { 5'd0 , s_stage1MemoryAddressReg[9:5] };
+                                      s_activeTagIndex  <= { 5'd0 , s_stage2MemoryAddressReg[9:5] };
                                     end
       FOUR_WAY_SET_ASSOCIATIVE_8K,
       TWO_WAY_SET_ASSOCIATIVE_4K,
       DIRECT_MAPPED_2K            : begin
-                                      s_lookupTagIndex  <= { 3'd0 , s_lookupAddress[5:0] };
-                                      s_forwardTagIndex <= { 3'd0 , s_stage1MemoryAddressReg[10:5] };
-                                      s_activeTagIndex  <= { 3'd0 , s_stage2MemoryAddressReg[10:5] };
+                                      s_lookupTagIndex  <= { 4'd0 , s_lookupAddress[5:0] };
+                                      s_forwardTagIndex <= { 4'd0 , s_stage1MemoryAddressReg[10:5] };
+                                      s_activeTagIndex  <= { 4'd0 , s_stage2MemoryAddressReg[10:5] };
                                     end
+      FOUR_WAY_SET_ASSOCIATIVE_16K,
       TWO_WAY_SET_ASSOCIATIVE_8K,
       DIRECT_MAPPED_4K            : begin
-                                      s_lookupTagIndex  <= { 2'd0 , s_lookupAddress[6:0] };
-                                      s_forwardTagIndex <= { 2'd0 , s_stage1MemoryAddressReg[11:5] };
-                                      s_activeTagIndex  <= { 2'd0 , s_stage2MemoryAddressReg[11:5] };
+                                      s_lookupTagIndex  <= { 3'd0 , s_lookupAddress[6:0] };
+                                      s_forwardTagIndex <= { 3'd0 , s_stage1MemoryAddressReg[11:5] };
+                                      s_activeTagIndex  <= { 3'd0 , s_stage2MemoryAddressReg[11:5] };
+                                    end
+      TWO_WAY_SET_ASSOCIATIVE_32K,
+      DIRECT_MAPPED_16K           : begin
+                                      s_lookupTagIndex  <= { 1'b0 , s_lookupAddress[8:0] };
+                                      s_forwardTagIndex <= { 1'b0 , s_stage1MemoryAddressReg[13:5] };
+                                      s_activeTagIndex  <= { 1'b0 , s_stage2MemoryAddressReg[13:5] };
+                                    end
+      DIRECT_MAPPED_32K           : begin
+                                      s_lookupTagIndex  <= s_lookupAddress;
+                                      s_forwardTagIndex <= s_stage1MemoryAddressReg[14:5];
+                                      s_activeTagIndex  <= s_stage2MemoryAddressReg[14:5];
                                     end
       default                     : begin
-                                      s_lookupTagIndex  <= { 1'b0 , s_lookupAddress[7:0] };
-                                      s_forwardTagIndex <= { 1'b0 , s_stage1MemoryAddressReg[12:5] };
-                                      s_activeTagIndex  <= { 1'b0 , s_stage2MemoryAddressReg[12:5] };
+                                      s_lookupTagIndex  <= { 2'd0 , s_lookupAddress[7:0] };
+                                      s_forwardTagIndex <= { 2'd0 , s_stage1MemoryAddressReg[12:5] };
+                                      s_activeTagIndex  <= { 2'd0 , s_stage2MemoryAddressReg[12:5] };
                                     end
     endcase
 
@@ -1189,49 +1386,57 @@ module dCache   ( input wire         clock,
       s_stage2IsCacheLookupReg <= (s_internalStall == 1'b0) ? s_stage1IsCacheLookupReg : s_stage2IsCacheLookupReg;
     end
   
-  sram512X32Dp tagRam1 ( .clockA(s_invertedClock),
-                         .writeEnableA(s_flushInvalidateVector[0]),
-                         .addressA(s_lookupTagIndex),
-                         .dataInA(32'hFFFFFFF0),
-                         .dataOutA(s_combinedTag1),
-                         .clockB(clock),
-                         .writeEnableB(s_updateWaysState[0]),
-                         .addressB(s_rwTagIndex),
-                         .dataInB(s_newCombinedTag),
-                         .dataOutB(s_combinedSnoop1));
+  sramDp #( .nrOfAddressBits(MaximumSetBits),
+            .nrOfDataBits(32)) tagRam1
+          ( .clockA(s_invertedClock),
+            .writeEnableA(s_flushInvalidateVector[0]),
+            .addressA(s_lookupTagIndex[MaximumSetBits-1:0]),
+            .dataInA(32'hFFFFFFF0),
+            .dataOutA(s_combinedTag1),
+            .clockB(clock),
+            .writeEnableB(s_updateWaysState[0]),
+            .addressB(s_rwTagIndex[MaximumSetBits-1:0]),
+            .dataInB(s_newCombinedTag),
+            .dataOutB(s_combinedSnoop1));
 
-  sram512X32Dp tagRam2 ( .clockA(s_invertedClock),
-                         .writeEnableA(s_flushInvalidateVector[1]),
-                         .addressA(s_lookupTagIndex),
-                         .dataInA(32'hFFFFFFF0),
-                         .dataOutA(s_combinedTag2),
-                         .clockB(clock),
-                         .writeEnableB(s_updateWaysState[1]),
-                         .addressB(s_rwTagIndex),
-                         .dataInB(s_newCombinedTag),
-                         .dataOutB(s_combinedSnoop2));
+  sramDp #( .nrOfAddressBits(MaximumSetBits),
+            .nrOfDataBits(32)) tagRam2
+          ( .clockA(s_invertedClock),
+            .writeEnableA(s_flushInvalidateVector[1]),
+            .addressA(s_lookupTagIndex[MaximumSetBits-1:0]),
+            .dataInA(32'hFFFFFFF0),
+            .dataOutA(s_combinedTag2),
+            .clockB(clock),
+            .writeEnableB(s_updateWaysState[1]),
+            .addressB(s_rwTagIndex[MaximumSetBits-1:0]),
+            .dataInB(s_newCombinedTag),
+            .dataOutB(s_combinedSnoop2));
 
-  sram512X32Dp tagRam3 ( .clockA(s_invertedClock),
-                         .writeEnableA(s_flushInvalidateVector[2]),
-                         .addressA(s_lookupTagIndex),
-                         .dataInA(32'hFFFFFFF0),
-                         .dataOutA(s_combinedTag3),
-                         .clockB(clock),
-                         .writeEnableB(s_updateWaysState[2]),
-                         .addressB(s_rwTagIndex),
-                         .dataInB(s_newCombinedTag),
-                         .dataOutB(s_combinedSnoop3));
+  sramDp #( .nrOfAddressBits(MaximumSetBits),
+            .nrOfDataBits(32)) tagRam3
+          ( .clockA(s_invertedClock),
+            .writeEnableA(s_flushInvalidateVector[2]),
+            .addressA(s_lookupTagIndex[MaximumSetBits-1:0]),
+            .dataInA(32'hFFFFFFF0),
+            .dataOutA(s_combinedTag3),
+            .clockB(clock),
+            .writeEnableB(s_updateWaysState[2]),
+            .addressB(s_rwTagIndex[MaximumSetBits-1:0]),
+            .dataInB(s_newCombinedTag),
+            .dataOutB(s_combinedSnoop3));
 
-  sram512X32Dp tagRam4 ( .clockA(s_invertedClock),
-                         .writeEnableA(s_flushInvalidateVector[3]),
-                         .addressA(s_lookupTagIndex),
-                         .dataInA(32'hFFFFFFF0),
-                         .dataOutA(s_combinedTag4),
-                         .clockB(clock),
-                         .writeEnableB(s_updateWaysState[3]),
-                         .addressB(s_rwTagIndex),
-                         .dataInB(s_newCombinedTag),
-                         .dataOutB(s_combinedSnoop4));
+  sramDp #( .nrOfAddressBits(MaximumSetBits),
+            .nrOfDataBits(32)) tagRam4
+          ( .clockA(s_invertedClock),
+            .writeEnableA(s_flushInvalidateVector[3]),
+            .addressA(s_lookupTagIndex[MaximumSetBits-1:0]),
+            .dataInA(32'hFFFFFFF0),
+            .dataOutA(s_combinedTag4),
+            .clockB(clock),
+            .writeEnableB(s_updateWaysState[3]),
+            .addressB(s_rwTagIndex[MaximumSetBits-1:0]),
+            .dataInB(s_newCombinedTag),
+            .dataOutB(s_combinedSnoop4));
 
   /*
    *
@@ -1241,7 +1446,7 @@ module dCache   ( input wire         clock,
   reg s_busWriteStallReg;
   reg [1:0] s_dataSelectVector, s_addrBits, s_weSelectVector1, s_weSelectVector2, s_busAddrBits, s_cacheSelectVector;
   reg [3:0] s_weDataCacheVector;
-  reg [8:0] s_rwDataIndex, s_lookupDataIndex;
+  reg [10:0] s_rwDataIndex, s_lookupDataIndex;
   reg [31:0] s_dataToCache, s_selectedDataFromCache, s_selectedDataFromCacheReg;
   reg [31:0] s_stage1CacheData1Reg, s_stage1CacheData2Reg, s_stage1CacheData3Reg, s_stage1CacheData4Reg;
   reg s_selectedDataValidReg, s_dataForward0;
@@ -1254,7 +1459,7 @@ module dCache   ( input wire         clock,
                         (s_busTransactionTypeReg == CACHE_LINE_WRITE_BACK ||
                          s_busTransactionTypeReg == SNOOPY_WRITE_BACK ||
                          s_busTransactionTypeReg == FLUSH_WRITE_BACK)) ? 1'b1 : 1'b0;
-  wire [5:0] s_dataIndexAddr = (s_cacheWriteAction == 1'b1 || s_snarfActiveReg == 1'b1) ? s_stage2MemoryAddressReg[10:5] : s_busAddressReg[10:5];
+  wire [7:0] s_dataIndexAddr = (s_cacheWriteAction == 1'b1 || s_snarfActiveReg == 1'b1) ? s_stage2MemoryAddressReg[12:5] : s_busAddressReg[12:5];
   wire s_selectedDataValidNext = (s_busWriteStall == 1'b1) ? s_selectedDataValidReg :
                                  (s_cacheStateReg == DO_WRITE &&
                                   (s_busTransactionTypeReg == CACHE_LINE_WRITE_BACK ||
@@ -1287,42 +1492,60 @@ module dCache   ( input wire         clock,
     begin
       s_rwDataIndex[2:0] <= (s_cacheWriteAction == 1'b1 && s_snarfActiveReg == 1'b0) ? s_stage2MemoryAddressReg[4:2] : s_wordBurstSelectReg;
       case (cacheSize)
-        SIZE_8K : begin
-                    s_lookupDataIndex  <= memoryAddress[10:2];
-                    s_rwDataIndex[8:3] <= s_dataIndexAddr;
-                    s_dataForward0     <= (s_rwDataIndex == memoryAddress[10:2]) ? 1'b1 : 1'b0;
-                    s_dataForward1     <= (s_rwDataIndex == s_stage1MemoryAddressReg[10:2]) ? 1'b1 : 1'b0;
-                    s_dataForward2     <= (s_rwDataIndex == s_stage2MemoryAddressReg[10:2]) ? 1'b1 : 1'b0;
-                    s_addrBits         <= s_stage2MemoryAddressReg[12:11];
-                    s_busAddrBits      <= s_busAddressReg[12:11];
-                  end
-        SIZE_4K : begin
-                    s_lookupDataIndex  <= { 1'b0, memoryAddress[9:2] };
-                    s_rwDataIndex[8:3] <= { 1'b0, s_dataIndexAddr[4:0] };
-                    s_dataForward0     <= (s_rwDataIndex[7:0] == memoryAddress[9:2]) ? 1'b1 : 1'b0;
-                    s_dataForward1     <= (s_rwDataIndex[7:0] == s_stage1MemoryAddressReg[9:2]) ? 1'b1 : 1'b0;
-                    s_dataForward2     <= (s_rwDataIndex[7:0] == s_stage2MemoryAddressReg[9:2]) ? 1'b1 : 1'b0;
-                    s_addrBits         <= s_stage2MemoryAddressReg[11:10];
-                    s_busAddrBits      <= s_busAddressReg[11:10];
-                  end
-        SIZE_2K : begin
-                    s_lookupDataIndex  <= { 2'd0 , memoryAddress[8:2] };
-                    s_rwDataIndex[8:3] <= { 2'd0 , s_dataIndexAddr[3:0] };
-                    s_dataForward0     <= (s_rwDataIndex[6:0] == memoryAddress[8:2]) ? 1'b1 : 1'b0;
-                    s_dataForward1     <= (s_rwDataIndex[6:0] == s_stage1MemoryAddressReg[8:2]) ? 1'b1 : 1'b0;
-                    s_dataForward2     <= (s_rwDataIndex[6:0] == s_stage2MemoryAddressReg[8:2]) ? 1'b1 : 1'b0;
-                    s_addrBits         <= s_stage2MemoryAddressReg[10:9];
-                    s_busAddrBits      <= s_busAddressReg[10:9];
-                  end
-        default : begin
-                    s_lookupDataIndex  <= { 3'd0 , memoryAddress[7:2] };
-                    s_rwDataIndex[8:3] <= { 3'd0 , s_dataIndexAddr[2:0] };
-                    s_dataForward0     <= (s_rwDataIndex[5:0] == memoryAddress[7:2]) ? 1'b1 : 1'b0;
-                    s_dataForward1     <= (s_rwDataIndex[5:0] == s_stage1MemoryAddressReg[7:2]) ? 1'b1 : 1'b0;
-                    s_dataForward2     <= (s_rwDataIndex[5:0] == s_stage2MemoryAddressReg[7:2]) ? 1'b1 : 1'b0;
-                    s_addrBits         <= s_stage2MemoryAddressReg[9:8];
-                    s_busAddrBits      <= s_busAddressReg[9:8];
-                  end
+        SIZE_32K : begin
+                     s_lookupDataIndex   <= memoryAddress[12:2];
+                     s_rwDataIndex[10:3] <= s_dataIndexAddr;
+                     s_dataForward0      <= (s_rwDataIndex == memoryAddress[12:2]) ? 1'b1 : 1'b0;
+                     s_dataForward1      <= (s_rwDataIndex == s_stage1MemoryAddressReg[12:2]) ? 1'b1 : 1'b0;
+                     s_dataForward2      <= (s_rwDataIndex == s_stage2MemoryAddressReg[12:2]) ? 1'b1 : 1'b0;
+                     s_addrBits          <= s_stage2MemoryAddressReg[14:13];
+                     s_busAddrBits       <= s_busAddressReg[14:13];
+                   end
+        SIZE_16K : begin
+                     s_lookupDataIndex   <= { 1'b0 , memoryAddress[11:2] };
+                     s_rwDataIndex[10:3] <= { 1'b0 , s_dataIndexAddr[6:0] };
+                     s_dataForward0      <= (s_rwDataIndex[9:0] == memoryAddress[11:2]) ? 1'b1 : 1'b0;
+                     s_dataForward1      <= (s_rwDataIndex[9:0] == s_stage1MemoryAddressReg[11:2]) ? 1'b1 : 1'b0;
+                     s_dataForward2      <= (s_rwDataIndex[9:0] == s_stage2MemoryAddressReg[11:2]) ? 1'b1 : 1'b0;
+                     s_addrBits          <= s_stage2MemoryAddressReg[13:12];
+                     s_busAddrBits       <= s_busAddressReg[13:12];
+                   end
+        SIZE_8K  : begin
+                     s_lookupDataIndex   <= { 2'd0 , memoryAddress[10:2] };
+                     s_rwDataIndex[10:3] <= { 2'd0 , s_dataIndexAddr[5:0] };
+                     s_dataForward0      <= (s_rwDataIndex[8:0] == memoryAddress[10:2]) ? 1'b1 : 1'b0;
+                     s_dataForward1      <= (s_rwDataIndex[8:0] == s_stage1MemoryAddressReg[10:2]) ? 1'b1 : 1'b0;
+                     s_dataForward2      <= (s_rwDataIndex[8:0] == s_stage2MemoryAddressReg[10:2]) ? 1'b1 : 1'b0;
+                     s_addrBits          <= s_stage2MemoryAddressReg[12:11];
+                     s_busAddrBits       <= s_busAddressReg[12:11];
+                   end
+        SIZE_4K  : begin
+                     s_lookupDataIndex   <= { 3'd0 , memoryAddress[9:2] };
+                     s_rwDataIndex[10:3] <= { 3'd0 , s_dataIndexAddr[4:0] };
+                     s_dataForward0      <= (s_rwDataIndex[7:0] == memoryAddress[9:2]) ? 1'b1 : 1'b0;
+                     s_dataForward1      <= (s_rwDataIndex[7:0] == s_stage1MemoryAddressReg[9:2]) ? 1'b1 : 1'b0;
+                     s_dataForward2      <= (s_rwDataIndex[7:0] == s_stage2MemoryAddressReg[9:2]) ? 1'b1 : 1'b0;
+                     s_addrBits          <= s_stage2MemoryAddressReg[11:10];
+                     s_busAddrBits       <= s_busAddressReg[11:10];
+                   end
+        SIZE_2K  : begin
+                     s_lookupDataIndex   <= { 4'd0 , memoryAddress[8:2] };
+                     s_rwDataIndex[10:3] <= { 4'd0 , s_dataIndexAddr[3:0] };
+                     s_dataForward0      <= (s_rwDataIndex[6:0] == memoryAddress[8:2]) ? 1'b1 : 1'b0;
+                     s_dataForward1      <= (s_rwDataIndex[6:0] == s_stage1MemoryAddressReg[8:2]) ? 1'b1 : 1'b0;
+                     s_dataForward2      <= (s_rwDataIndex[6:0] == s_stage2MemoryAddressReg[8:2]) ? 1'b1 : 1'b0;
+                     s_addrBits          <= s_stage2MemoryAddressReg[10:9];
+                     s_busAddrBits       <= s_busAddressReg[10:9];
+                   end
+        default  : begin
+                     s_lookupDataIndex   <= { 5'd0 , memoryAddress[7:2] };
+                     s_rwDataIndex[10:3] <= { 5'd0 , s_dataIndexAddr[2:0] };
+                     s_dataForward0      <= (s_rwDataIndex[5:0] == memoryAddress[7:2]) ? 1'b1 : 1'b0;
+                     s_dataForward1      <= (s_rwDataIndex[5:0] == s_stage1MemoryAddressReg[7:2]) ? 1'b1 : 1'b0;
+                     s_dataForward2      <= (s_rwDataIndex[5:0] == s_stage2MemoryAddressReg[7:2]) ? 1'b1 : 1'b0;
+                     s_addrBits          <= s_stage2MemoryAddressReg[9:8];
+                     s_busAddrBits       <= s_busAddressReg[9:8];
+                   end
       endcase
     end
 
@@ -1338,6 +1561,8 @@ module dCache   ( input wire         clock,
       TWO_WAY_SET_ASSOCIATIVE  : begin
                                    s_dataSelectVector[1] <= s_hit2;
                                    case (cacheSize)
+                                     SIZE_32K : s_dataSelectVector[0] <= s_stage1MemoryAddressReg[13];
+                                     SIZE_16K : s_dataSelectVector[0] <= s_stage1MemoryAddressReg[12];
                                      SIZE_8K : s_dataSelectVector[0] <= s_stage1MemoryAddressReg[11];
                                      SIZE_4K : s_dataSelectVector[0] <= s_stage1MemoryAddressReg[10];
                                      SIZE_2K : s_dataSelectVector[0] <= s_stage1MemoryAddressReg[9];
@@ -1352,6 +1577,8 @@ module dCache   ( input wire         clock,
                                  end
       default                  : begin
                                    case (cacheSize)
+                                     SIZE_32K : s_dataSelectVector <= s_stage1MemoryAddressReg[14:13];
+                                     SIZE_16K : s_dataSelectVector <= s_stage1MemoryAddressReg[13:12];
                                      SIZE_8K : s_dataSelectVector <= s_stage1MemoryAddressReg[12:11];
                                      SIZE_4K : s_dataSelectVector <= s_stage1MemoryAddressReg[11:10];
                                      SIZE_2K : s_dataSelectVector <= s_stage1MemoryAddressReg[10:9];
@@ -1429,49 +1656,57 @@ module dCache   ( input wire         clock,
     end
   
   
-  sram512X32Dp dataRam1 ( .clockA(s_invertedClock),
-                          .writeEnableA(1'b0),
-                          .addressA(s_lookupDataIndex[8:0]),
-                          .dataInA({32{1'b0}}),
-                          .dataOutA(s_cacheData1),
-                          .clockB(clock),
-                          .writeEnableB(s_weDataCacheVector[0] & s_rwDataCache),
-                          .addressB(s_rwDataIndex[8:0]),
-                          .dataInB(s_dataToCache),
-                          .dataOutB(s_dataFromCache1));
+  sramDp #( .nrOfAddressBits(DataIndexBits),
+            .nrOfDataBits(32)) dataRam1
+          ( .clockA(s_invertedClock),
+            .writeEnableA(1'b0),
+            .addressA(s_lookupDataIndex[DataIndexBits-1:0]),
+            .dataInA({32{1'b0}}),
+            .dataOutA(s_cacheData1),
+            .clockB(clock),
+            .writeEnableB(s_weDataCacheVector[0] & s_rwDataCache),
+            .addressB(s_rwDataIndex[DataIndexBits-1:0]),
+            .dataInB(s_dataToCache),
+            .dataOutB(s_dataFromCache1));
 
-  sram512X32Dp dataRam2 ( .clockA(s_invertedClock),
-                          .writeEnableA(1'b0),
-                          .addressA(s_lookupDataIndex[8:0]),
-                          .dataInA({32{1'b0}}),
-                          .dataOutA(s_cacheData2),
-                          .clockB(clock),
-                          .writeEnableB(s_weDataCacheVector[1] & s_rwDataCache),
-                          .addressB(s_rwDataIndex[8:0]),
-                          .dataInB(s_dataToCache),
-                          .dataOutB(s_dataFromCache2));
+  sramDp #( .nrOfAddressBits(DataIndexBits),
+            .nrOfDataBits(32)) dataRam2
+          ( .clockA(s_invertedClock),
+            .writeEnableA(1'b0),
+            .addressA(s_lookupDataIndex[DataIndexBits-1:0]),
+            .dataInA({32{1'b0}}),
+            .dataOutA(s_cacheData2),
+            .clockB(clock),
+            .writeEnableB(s_weDataCacheVector[1] & s_rwDataCache),
+            .addressB(s_rwDataIndex[DataIndexBits-1:0]),
+            .dataInB(s_dataToCache),
+            .dataOutB(s_dataFromCache2));
 
-  sram512X32Dp dataRam3 ( .clockA(s_invertedClock),
-                          .writeEnableA(1'b0),
-                          .addressA(s_lookupDataIndex[8:0]),
-                          .dataInA({32{1'b0}}),
-                          .dataOutA(s_cacheData3),
-                          .clockB(clock),
-                          .writeEnableB(s_weDataCacheVector[2] & s_rwDataCache),
-                          .addressB(s_rwDataIndex[8:0]),
-                          .dataInB(s_dataToCache),
-                          .dataOutB(s_dataFromCache3));
+  sramDp #( .nrOfAddressBits(DataIndexBits),
+            .nrOfDataBits(32)) dataRam3
+          ( .clockA(s_invertedClock),
+            .writeEnableA(1'b0),
+            .addressA(s_lookupDataIndex[DataIndexBits-1:0]),
+            .dataInA({32{1'b0}}),
+            .dataOutA(s_cacheData3),
+            .clockB(clock),
+            .writeEnableB(s_weDataCacheVector[2] & s_rwDataCache),
+            .addressB(s_rwDataIndex[DataIndexBits-1:0]),
+            .dataInB(s_dataToCache),
+            .dataOutB(s_dataFromCache3));
 
-  sram512X32Dp dataRam4 ( .clockA(s_invertedClock),
-                          .writeEnableA(1'b0),
-                          .addressA(s_lookupDataIndex[8:0]),
-                          .dataInA({32{1'b0}}),
-                          .dataOutA(s_cacheData4),
-                          .clockB(clock),
-                          .writeEnableB(s_weDataCacheVector[3] & s_rwDataCache),
-                          .addressB(s_rwDataIndex[8:0]),
-                          .dataInB(s_dataToCache),
-                          .dataOutB(s_dataFromCache4));
+  sramDp #( .nrOfAddressBits(DataIndexBits),
+            .nrOfDataBits(32)) dataRam4
+          ( .clockA(s_invertedClock),
+            .writeEnableA(1'b0),
+            .addressA(s_lookupDataIndex[DataIndexBits-1:0]),
+            .dataInA({32{1'b0}}),
+            .dataOutA(s_cacheData4),
+            .clockB(clock),
+            .writeEnableB(s_weDataCacheVector[3] & s_rwDataCache),
+            .addressB(s_rwDataIndex[DataIndexBits-1:0]),
+            .dataInB(s_dataToCache),
+            .dataOutB(s_dataFromCache4));
 
   /*
    *
@@ -1479,7 +1714,7 @@ module dCache   ( input wire         clock,
    *
    */
   reg [4:0] s_newPlru;
-  reg [3:0] s_replacementWay;
+  reg [3:0] s_policyReplacementWay, s_lockedWayMask, s_fillWayMask;
   reg [1:0] s_newLru1, s_newLru2, s_newLru3, s_newLru4, s_newFifo, s_lruSelect;
   reg [4:0] s_stage1PlruReg, s_stage2PlruReg;
   reg [1:0] s_stage1Lru1Reg, s_stage1Lru2Reg, s_stage1Lru3Reg, s_stage1Lru4Reg, s_stage1FifoReg;
@@ -1488,6 +1723,7 @@ module dCache   ( input wire         clock,
   wire [31:0] s_combinedPolicy;
   wire [31:0] s_newCombinedPolicy = {{17{1'b0}}, s_newPlru, s_newLru4, s_newLru3, s_newLru2, s_newLru1, s_newFifo};
   wire [1:0] s_policySelect;
+  wire [3:0] s_replacementWay;
   wire s_weNewPolicy = ((s_cacheStateReg == UPDATE_TAGS && s_busTransactionTypeReg == CACHE_LINE_LOAD) ||
                         s_cacheWriteAction == 1'b1 ||
                         s_cacheReadAction == 1'b1) ? 1'b1 : 1'b0;
@@ -1546,26 +1782,65 @@ module dCache   ( input wire         clock,
   always @*
     case (replacementPolicy)
       FIFO_REPLACEMENT : case (s_stage1FifoReg)
-                           2'b00   : s_replacementWay <= 4'h1;
-                           2'b01   : s_replacementWay <= 4'h2;
-                           2'b10   : s_replacementWay <= 4'h4;
-                           default : s_replacementWay <= 4'h8;
+                           2'b00   : s_policyReplacementWay <= 4'h1;
+                           2'b01   : s_policyReplacementWay <= 4'h2;
+                           2'b10   : s_policyReplacementWay <= 4'h4;
+                           default : s_policyReplacementWay <= 4'h8;
                          endcase
       PLRU_REPLACEMENT : if (s_stage1PlruReg[4] == 1'b1)
                            begin
-                             s_replacementWay[3:2] <= 2'b00;
-                             s_replacementWay[1:0] <= (s_stage1PlruReg[1:0] == 2'b00 || s_stage1PlruReg[1:0] == 2'b11) ? 2'b01 : ~s_stage1PlruReg[1:0];
+                             s_policyReplacementWay[3:2] <= 2'b00;
+                             s_policyReplacementWay[1:0] <= (s_stage1PlruReg[1:0] == 2'b00 || s_stage1PlruReg[1:0] == 2'b11) ? 2'b01 : ~s_stage1PlruReg[1:0];
                            end
                          else
                            begin
-                             s_replacementWay[1:0] <= 2'b00;
-                             s_replacementWay[3:2] <= (s_stage1PlruReg[3:2] == 2'b00 || s_stage1PlruReg[3:2] == 2'b11) ? 2'b01 : ~s_stage1PlruReg[3:2];
+                             s_policyReplacementWay[1:0] <= 2'b00;
+                             s_policyReplacementWay[3:2] <= (s_stage1PlruReg[3:2] == 2'b00 || s_stage1PlruReg[3:2] == 2'b11) ? 2'b01 : ~s_stage1PlruReg[3:2];
                            end
-      default          : s_replacementWay <= ((s_stage1Lru1Reg <= s_stage1Lru2Reg) & (s_stage1Lru1Reg <= s_stage1Lru3Reg) & (s_stage1Lru1Reg <= s_stage1Lru4Reg)) ? 4'h1 :
-                                             ((s_stage1Lru2Reg <= s_stage1Lru1Reg) & (s_stage1Lru2Reg <= s_stage1Lru3Reg) & (s_stage1Lru2Reg <= s_stage1Lru4Reg)) ? 4'h2 :
-                                             ((s_stage1Lru3Reg <= s_stage1Lru1Reg) & (s_stage1Lru3Reg <= s_stage1Lru2Reg) & (s_stage1Lru3Reg <= s_stage1Lru4Reg)) ? 4'h4 : 4'h8;
+      default          : s_policyReplacementWay <= ((s_stage1Lru1Reg <= s_stage1Lru2Reg) & (s_stage1Lru1Reg <= s_stage1Lru3Reg) & (s_stage1Lru1Reg <= s_stage1Lru4Reg)) ? 4'h1 :
+                                                   ((s_stage1Lru2Reg <= s_stage1Lru1Reg) & (s_stage1Lru2Reg <= s_stage1Lru3Reg) & (s_stage1Lru2Reg <= s_stage1Lru4Reg)) ? 4'h2 :
+                                                   ((s_stage1Lru3Reg <= s_stage1Lru1Reg) & (s_stage1Lru3Reg <= s_stage1Lru2Reg) & (s_stage1Lru3Reg <= s_stage1Lru4Reg)) ? 4'h4 : 4'h8;
     endcase
   
+  /*
+   *
+   * Here the way locking is defined
+   *
+   */
+  wire s_lockActive = (numberOfWays != DIRECT_MAPPED && (lockedWays != 2'd0 || lockFill == 1'b1)) ? 1'b1 : 1'b0;
+  wire [3:0] s_usableWays = (numberOfWays == FOUR_WAY_SET_ASSOCIATIVE) ? 4'hF : 4'h3;
+  wire [3:0] s_allowedWays = (lockFill == 1'b1) ? s_fillWayMask : s_usableWays & ~s_lockedWayMask;
+  wire [3:0] s_firstAllowedWay = (s_allowedWays[0] == 1'b1) ? 4'h1 :
+                                 (s_allowedWays[1] == 1'b1) ? 4'h2 :
+                                 (s_allowedWays[2] == 1'b1) ? 4'h4 : 4'h8;
+  assign s_replacementWay = (s_lockActive == 1'b0 || (s_policyReplacementWay & s_allowedWays) != 4'h0) ? s_policyReplacementWay : s_firstAllowedWay;
+  
+  always @*
+    if (numberOfWays == FOUR_WAY_SET_ASSOCIATIVE)
+      case (lockedWays)
+        2'd0    : begin
+                    s_lockedWayMask <= 4'b0000;
+                    s_fillWayMask   <= 4'b1000;
+                  end
+        2'd1    : begin
+                    s_lockedWayMask <= 4'b1000;
+                    s_fillWayMask   <= 4'b0100;
+                  end
+        2'd2    : begin
+                    s_lockedWayMask <= 4'b1100;
+                    s_fillWayMask   <= 4'b0010;
+                  end
+        default : begin
+                    s_lockedWayMask <= 4'b1110;
+                    s_fillWayMask   <= 4'b0001;
+                  end
+      endcase
+    else
+      begin
+        s_lockedWayMask <= (lockedWays == 2'd0) ? 4'b0000 : 4'b0010;
+        s_fillWayMask   <= (lockedWays == 2'd0) ? 4'b0010 : 4'b0001;
+      end
+  
   always @*
     if (s_cacheStateReg == UPDATE_TAGS)
       begin
@@ -1659,7 +1934,9 @@ module dCache   ( input wire         clock,
       s_stage2FifoReg           <= s_stage2FifoNext;
       if (s_internalStall == 1'b0)
         begin
-          s_stage2ReplacementWayReg <= s_replacementWay;
+          s_stage2ReplacementWayReg <= (s_stage1ZeroReg == 1'b1 &&
+                                        (s_stage2Hit1Next | s_stage2Hit2Next | s_stage2Hit3Next | s_stage2Hit4Next) == 1'b1) ?
+                                       {s_stage2Hit4Next, s_stage2Hit3Next, s_stage2Hit2Next, s_stage2Hit1Next} : s_replacementWay;
           case (s_policySelect)
             2'b00   : s_stage2SelectedTagReg <= s_stage1Tag1Reg;
             2'b01   : s_stage2SelectedTagReg <= s_stage1Tag2Reg;
@@ -1669,16 +1946,254 @@ module dCache   ( input wire         clock,
         end
     end
       
-    sram512X32Dp policyRam ( .clockA(s_invertedClock),
-                             .writeEnableA(s_flushInvalidate),
-                             .addressA(s_lookupTagIndex),
-                             .dataInA({32{1'b0}}),
-                             .dataOutA(s_combinedPolicy),
-                             .clockB(clock),
-                             .writeEnableB(s_weNewPolicy),
-                             .addressB(s_rwTagIndex),
-                             .dataInB(s_newCombinedPolicy),
-                             .dataOutB());
+  sramDp #( .nrOfAddressBits(MaximumSetBits),
+            .nrOfDataBits(32)) policyRam
+          ( .clockA(s_invertedClock),
+            .writeEnableA(s_flushInvalidate),
+            .addressA(s_lookupTagIndex[MaximumSetBits-1:0]),
+            .dataInA({32{1'b0}}),
+            .dataOutA(s_combinedPolicy),
+            .clockB(clock),
+            .writeEnableB(s_weNewPolicy),
+            .addressB(s_rwTagIndex[MaximumSetBits-1:0]),
+            .dataInB(s_newCombinedPolicy),
+            .dataOutB());
+
+  /*
+   *
+   * Here the prefetcher is defined
+   *
+   */
+  reg [31:0] s_prefetchDataReg [7:0];
+  reg [26:0] s_prefetchLineReg, s_prefetchLastMissReg, s_prefetchStrideReg;
+  reg [3:0] s_prefetchWordCountReg;
+  reg [2:0] s_prefetchCopyIndexReg;
+  reg s_prefetchValidReg, s_prefetchPendingReg, s_prefetchAbortReg, s_prefetchCopyReg;
+  wire s_prefetchMiss = (s_cacheStateReg == INIT_TRANSACTION && s_busTransactionTypeReg == CACHE_LINE_LOAD && s_stage2ZeroReg == 1'b0) ? 1'b1 : 1'b0;
+  wire s_zeroLineFill = (s_cacheStateReg == INIT_TRANSACTION && s_busTransactionTypeReg == CACHE_LINE_LOAD && s_stage2ZeroReg == 1'b1) ? 1'b1 : 1'b0;
+  wire s_prefetchIssue = (s_cacheStateReg == INIT_TRANSACTION && s_busTransactionTypeReg == PREFETCH_LOAD) ? 1'b1 : 1'b0;
+  wire s_prefetchFill = ((s_cacheStateReg == WAIT_READ_BURST || s_cacheStateReg == NOP) &&
+                         s_busTransactionTypeReg == PREFETCH_LOAD) ? s_busDataInValidReg : 1'b0;
+  wire [26:0] s_prefetchMissLine = s_stage2MemoryAddressReg[31:5];
+  wire [26:0] s_prefetchDistance = s_prefetchMissLine - s_prefetchLastMissReg;
+  wire [26:0] s_prefetchTarget = (prefetchMode == NEXT_LINE_PREFETCH) ? s_prefetchMissLine + 27'd1 : s_prefetchMissLine + s_prefetchDistance;
+  wire s_prefetchStream = (prefetchMode == NEXT_LINE_PREFETCH ||
+                           (prefetchMode[1] == 1'b1 &&
+                            s_prefetchDistance == s_prefetchStrideReg &&
+                            s_prefetchDistance != 27'd0)) ? 1'b1 : 1'b0;
+  wire s_prefetchAllowed = (s_cacheEnabledReg == 1'b1 &&
+                            s_flushRequestReg == 1'b0 &&
+                            s_prefetchTarget[25] == 1'b0 &&
+                            s_prefetchTarget[26] == s_prefetchMissLine[26] &&
+                            (coherenceEnabled == 1'b0 || s_prefetchTarget[26] == 1'b1)) ? 1'b1 : 1'b0;
+  wire s_prefetchSchedule = ~reset & s_prefetchMiss & s_prefetchStream & s_prefetchAllowed;
+  wire s_prefetchInFlight = (s_cacheStateReg != IDLE && s_busTransactionTypeReg == PREFETCH_LOAD) ? 1'b1 : 1'b0;
+  wire s_prefetchHint = (reset == 1'b0 &&
+                         s_internalStall == 1'b0 &&
+                         s_flushRequestReg == 1'b0 &&
+                         s_stage2PrefetchReg == 1'b1 &&
+                         s_prefetchInFlight == 1'b0 &&
+                         (s_stage2Hit1Reg | s_stage2Hit2Reg | s_stage2Hit3Reg | s_stage2Hit4Reg) == 1'b0 &&
+                         (s_prefetchValidReg == 1'b0 || s_prefetchLineReg != s_prefetchMissLine)) ? 1'b1 : 1'b0;
+  wire [8:0] s_prefetchSnoopEnd = {6'd0, addressDataIn[4:2]} + {1'b0, burstSizeIn};
+  wire [24:0] s_prefetchSnoopFirstLine = addressDataIn[29:5];
+  wire [24:0] s_prefetchSnoopLastLine = addressDataIn[29:5] + {19'd0, s_prefetchSnoopEnd[8:3]};
+  wire s_prefetchSnoopHit = (beginTransactionIn == 1'b1 &&
+                             readNotWriteIn == 1'b0 &&
+                             s_prefetchLineReg[24:0] >= s_prefetchSnoopFirstLine &&
+                             s_prefetchLineReg[24:0] <= s_prefetchSnoopLastLine) ? 1'b1 : 1'b0;
+  wire s_prefetchValidNext = (reset == 1'b1 ||
+                              s_flushActiveReg == 1'b1 ||
+                              s_cacheEnabledReg == 1'b0 ||
+                              s_prefetchSnoopHit == 1'b1 ||
+                              s_prefetchBufferHit == 1'b1 ||
+                              s_prefetchSchedule == 1'b1 ||
+                              s_prefetchHint == 1'b1 ||
+                              s_prefetchIssue == 1'b1 ||
+                              (s_zeroLineFill == 1'b1 && s_prefetchLineReg == s_prefetchMissLine)) ? 1'b0 :
+                             (s_prefetchFill == 1'b1 && s_prefetchWordCountReg == 4'd7) ? ~(s_prefetchAbortReg | busErrorIn) : s_prefetchValidReg;
+  wire s_prefetchPendingNext = (reset == 1'b1 || s_flushActiveReg == 1'b1 || s_prefetchIssue == 1'b1) ? 1'b0 :
+                               (s_prefetchSchedule == 1'b1 || s_prefetchHint == 1'b1) ? 1'b1 : s_prefetchPendingReg;
+  wire s_prefetchAbortNext = (s_prefetchIssue == 1'b1) ? 1'b0 :
+                             (s_prefetchSnoopHit == 1'b1 ||
+                              s_flushActiveReg == 1'b1 ||
+                              busErrorIn == 1'b1 ||
+                              privateDirtyIn == 1'b1) ? 1'b1 : s_prefetchAbortReg;
+  wire [3:0] s_prefetchWordCountNext = (s_prefetchIssue == 1'b1) ? 4'd0 :
+                                       (s_prefetchFill == 1'b1) ? s_prefetchWordCountReg + 4'd1 : s_prefetchWordCountReg;
+  
+  assign s_prefetchBufferHit = (s_prefetchMiss == 1'b1 &&
+                                s_prefetchValidReg == 1'b1 &&
+                                s_prefetchLineReg == s_prefetchMissLine) ? 1'b1 : 1'b0;
+  assign s_localLineFill = s_prefetchBufferHit | s_victimBufferHit | s_zeroLineFill;
+
+  always @(posedge clock)
+    begin
+      s_prefetchValidReg     <= s_prefetchValidNext;
+      s_prefetchPendingReg   <= s_prefetchPendingNext;
+      s_prefetchAbortReg     <= s_prefetchAbortNext;
+      s_prefetchWordCountReg <= s_prefetchWordCountNext;
+      s_prefetchCopyIndexReg <= (s_cacheStateReg == PREFETCH_COPY) ? s_prefetchCopyIndexReg + 3'd1 : 3'd0;
+      s_prefetchCopyReg      <= (reset == 1'b1 || s_cacheStateReg == RELEASE) ? 1'b0 : s_prefetchCopyReg | s_localLineFill;
+      if (s_prefetchSchedule == 1'b1) s_prefetchLineReg <= s_prefetchTarget;
+      else if (s_prefetchHint == 1'b1) s_prefetchLineReg <= s_prefetchMissLine;
+      if (s_prefetchFill == 1'b1) s_prefetchDataReg[s_wordBurstSelectReg] <= s_busDataInReg;
+      if (reset == 1'b1)
+        begin
+          s_prefetchLastMissReg <= 27'd0;
+          s_prefetchStrideReg   <= 27'd0;
+        end
+      else if (s_prefetchMiss == 1'b1)
+        begin
+          s_prefetchLastMissReg <= s_prefetchMissLine;
+          s_prefetchStrideReg   <= s_prefetchDistance;
+        end
+    end
+
+  /*
+   *
+   * Here the victim buffer is defined
+   *
+   */
+  reg [31:0] s_victimDataReg [31:0];
+  reg [26:0] s_victimLineReg [3:0];
+  reg [26:0] s_victimPendingLineReg;
+  reg [3:0] s_victimValidReg;
+  reg [2:0] s_victimCaptureWordReg, s_victimCaptureCountReg;
+  reg [1:0] s_victimNextSlotReg, s_victimSlotReg;
+  reg s_victimPendingReg, s_victimCaptureActiveReg, s_victimCaptureReg, s_victimAbortReg, s_victimBlockReg, s_victimCopyReg;
+  wire [3:0] s_victimMatch, s_victimSnoopHit, s_victimValidNext;
+  wire s_victimLookup = s_prefetchMiss | s_zeroLineFill;
+  wire [1:0] s_victimHitSlot = {s_victimMatch[3] | s_victimMatch[2], s_victimMatch[3] | s_victimMatch[1]};
+  wire [1:0] s_victimCaptureSlot = (s_victimMatch != 4'd0) ? s_victimHitSlot : s_victimNextSlotReg;
+  wire s_victimInvalidate = reset | s_flushActiveReg | ~s_cacheEnabledReg | ~victimEnabled;
+  wire s_victimReplacedValid = (s_stage2ReplacementWayReg[0] & s_stage2State1Reg[0]) |
+                               (s_stage2ReplacementWayReg[1] & s_stage2State2Reg[0]) |
+                               (s_stage2ReplacementWayReg[2] & s_stage2State3Reg[0]) |
+                               (s_stage2ReplacementWayReg[3] & s_stage2State4Reg[0]);
+  wire s_victimZeroHit = s_stage2ZeroReg & (s_stage2Hit1Reg | s_stage2Hit2Reg | s_stage2Hit3Reg | s_stage2Hit4Reg);
+  wire [26:0] s_victimEvictLine = (s_victimPendingReg == 1'b1) ? s_victimPendingLineReg : s_writeBackAddress[31:5];
+  wire s_victimCaptureStart = (s_victimLookup == 1'b1 &&
+                               s_victimInvalidate == 1'b0 &&
+                               s_victimBlockReg == 1'b0 &&
+                               s_victimZeroHit == 1'b0 &&
+                               (s_victimPendingReg == 1'b1 || s_victimReplacedValid == 1'b1) &&
+                               (coherenceEnabled == 1'b0 || s_victimEvictLine[26] == 1'b1)) ? 1'b1 : 1'b0;
+  wire s_victimStore = s_victimCaptureReg & s_victimCaptureActiveReg;
+  wire s_victimCaptureDone = (s_victimStore == 1'b1 && s_victimCaptureCountReg == 3'd7) ? 1'b1 : 1'b0;
+  wire s_victimPendingSnoopHit = (beginTransactionIn == 1'b1 &&
+                                  readNotWriteIn == 1'b0 &&
+                                  s_victimPendingLineReg[24:0] >= s_prefetchSnoopFirstLine &&
+                                  s_victimPendingLineReg[24:0] <= s_prefetchSnoopLastLine) ? 1'b1 : 1'b0;
+  wire s_victimPendingNext = (reset == 1'b1 ||
+                              s_flushActiveReg == 1'b1 ||
+                              s_cacheStateReg == RELEASE ||
+                              s_victimLookup == 1'b1 ||
+                              s_victimPendingSnoopHit == 1'b1) ? 1'b0 :
+                             (s_cacheStateReg == NOP && s_busTransactionTypeReg == CACHE_LINE_WRITE_BACK) ? 1'b1 : s_victimPendingReg;
+  wire s_victimCaptureActiveNext = (reset == 1'b1 ||
+                                    s_cacheStateReg == RELEASE ||
+                                    s_cacheStateReg == BACKOFF ||
+                                    s_victimCaptureDone == 1'b1) ? 1'b0 :
+                                   (s_victimCaptureStart == 1'b1) ? 1'b1 : s_victimCaptureActiveReg;
+  wire s_victimBlockNext = (reset == 1'b1 || s_cacheStateReg == RELEASE) ? 1'b0 :
+                           (s_cacheStateReg == BACKOFF) ? 1'b1 : s_victimBlockReg;
+  wire s_victimAbortNext = (s_victimCaptureStart == 1'b1) ? 1'b0 : s_victimAbortReg | s_victimInvalidate;
+
+  assign s_victimBufferHit = (s_prefetchMiss == 1'b1 &&
+                              s_prefetchBufferHit == 1'b0 &&
+                              victimEnabled == 1'b1 &&
+                              s_victimMatch != 4'd0 &&
+                              (coherenceEnabled == 1'b0 || s_prefetchMissLine[26] == 1'b1)) ? 1'b1 : 1'b0;
+
+  generate
+    for (n = 0 ; n < 4 ; n = n + 1)
+      begin : victim
+        assign s_victimMatch[n] = (s_victimValidReg[n] == 1'b1 && s_victimLineReg[n] == s_prefetchMissLine) ? 1'b1 : 1'b0;
+        assign s_victimSnoopHit[n] = (beginTransactionIn == 1'b1 &&
+                                      readNotWriteIn == 1'b0 &&
+                                      s_victimLineReg[n][24:0] >= s_prefetchSnoopFirstLine &&
+                                      s_victimLineReg[n][24:0] <= s_prefetchSnoopLastLine) ? 1'b1 : 1'b0;
+        assign s_victimValidNext[n] = (s_victimInvalidate == 1'b1 ||
+                                       s_victimSnoopHit[n] == 1'b1 ||
+                                       (s_victimLookup == 1'b1 && s_victimMatch[n] == 1'b1) ||
+                                       (s_victimCaptureStart == 1'b1 && s_victimCaptureSlot == n)) ? 1'b0 :
+                                      (s_victimCaptureDone == 1'b1 && s_victimSlotReg == n) ? ~s_victimAbortReg : s_victimValidReg[n];
+
+        always @(posedge clock)
+          if (s_victimCaptureStart == 1'b1 && s_victimCaptureSlot == n) s_victimLineReg[n] <= s_victimEvictLine;
+      end
+  endgenerate
+
+  always @(posedge clock)
+    begin
+      s_victimValidReg         <= s_victimValidNext;
+      s_victimPendingReg       <= s_victimPendingNext;
+      s_victimCaptureActiveReg <= s_victimCaptureActiveNext;
+      s_victimBlockReg         <= s_victimBlockNext;
+      s_victimAbortReg         <= s_victimAbortNext;
+      s_victimCaptureReg       <= (reset == 1'b0 &&
+                                   s_victimCaptureActiveReg == 1'b1 &&
+                                   s_busDataInValidReg == 1'b1 &&
+                                   s_snarfActiveReg == 1'b0 &&
+                                   s_busTransactionTypeReg == CACHE_LINE_LOAD) ? 1'b1 : 1'b0;
+      s_victimCaptureWordReg   <= s_wordBurstSelectReg;
+      s_victimCopyReg          <= (reset == 1'b1 || s_cacheStateReg == RELEASE) ? 1'b0 : s_victimCopyReg | s_victimBufferHit;
+      if (s_cacheStateReg == NOP && s_busTransactionTypeReg == CACHE_LINE_WRITE_BACK) s_victimPendingLineReg <= s_busAddressReg[31:5];
+      if (s_victimBufferHit == 1'b1 || s_victimCaptureStart == 1'b1) s_victimSlotReg <= s_victimCaptureSlot;
+      if (s_victimStore == 1'b1) s_victimDataReg[{s_victimSlotReg, s_victimCaptureWordReg}] <= s_selectedDataFromCache;
+      if (s_victimCaptureStart == 1'b1) s_victimCaptureCountReg <= 3'd0;
+      else if (s_victimStore == 1'b1) s_victimCaptureCountReg <= s_victimCaptureCountReg + 3'd1;
+      if (reset == 1'b1) s_victimNextSlotReg <= 2'd0;
+      else if (s_victimCaptureStart == 1'b1 && s_victimMatch == 4'd0) s_victimNextSlotReg <= s_victimNextSlotReg + 2'd1;
+    end
+
+  /*
+   *
+   * Here the write buffer is defined
+   *
+   */
+  reg [31:0] s_writeBufferAddressReg [3:0];
+  reg [31:0] s_writeBufferDataReg [3:0];
+  reg [3:0] s_writeBufferByteEnablesReg [3:0];
+  reg [3:0] s_writeBufferThroughReg;
+  reg [1:0] s_writeBufferReadAddrReg, s_writeBufferWriteAddrReg;
+  reg [2:0] s_writeBufferCountReg;
+  wire s_writeBufferStall = (s_stage2UWriteReg | s_writeThroughRequired) & s_writeBufferFullReg;
+  wire s_writeBufferWe = ~s_internalStall & (s_stage2UWriteReg | s_writeThroughRequired);
+  wire s_writeBufferRe = (s_cacheStateReg == RELEASE &&
+                          (s_busTransactionTypeReg == UNCACHEABLE_WRITE ||
+                           s_busTransactionTypeReg == WRITE_THROUGH)) ? 1'b1 : 1'b0;
+  wire [2:0] s_writeBufferCountNext = s_writeBufferCountReg + {2'd0, s_writeBufferWe} - {2'd0, s_writeBufferRe};
+  wire [31:0] s_writeBufferHeadAddress = s_writeBufferAddressReg[s_writeBufferReadAddrReg];
+  wire [31:0] s_writeBufferHeadData = s_writeBufferDataReg[s_writeBufferReadAddrReg];
+  wire [3:0] s_writeBufferHeadByteEnables = s_writeBufferByteEnablesReg[s_writeBufferReadAddrReg];
+  wire s_writeBufferHeadThrough = s_writeBufferThroughReg[s_writeBufferReadAddrReg];
+
+  always @(posedge clock)
+    if (reset == 1'b1)
+      begin
+        s_writeBufferReadAddrReg  <= 2'd0;
+        s_writeBufferWriteAddrReg <= 2'd0;
+        s_writeBufferCountReg     <= 3'd0;
+        s_writeBufferEmptyReg     <= 1'b1;
+        s_writeBufferFullReg      <= 1'b0;
+      end
+    else
+      begin
+        s_writeBufferCountReg <= s_writeBufferCountNext;
+        s_writeBufferEmptyReg <= (s_writeBufferCountNext == 3'd0) ? 1'b1 : 1'b0;
+        s_writeBufferFullReg  <= (s_writeBufferCountNext == 3'd4) ? 1'b1 : 1'b0;
+        if (s_writeBufferRe == 1'b1) s_writeBufferReadAddrReg <= s_writeBufferReadAddrReg + 2'd1;
+        if (s_writeBufferWe == 1'b1)
+          begin
+            s_writeBufferWriteAddrReg                              <= s_writeBufferWriteAddrReg + 2'd1;
+            s_writeBufferAddressReg[s_writeBufferWriteAddrReg]     <= s_stage2MemoryAddressReg;
+            s_writeBufferDataReg[s_writeBufferWriteAddrReg]        <= s_stage2DataFromCoreReg;
+            s_writeBufferByteEnablesReg[s_writeBufferWriteAddrReg] <= s_stage2DataByteEnableReg;
+            s_writeBufferThroughReg[s_writeBufferWriteAddrReg]     <= s_writeThroughRequired;
+          end
+      end
 
   /*
    *
@@ -1687,7 +2202,7 @@ module dCache   ( input wire         clock,
    */
   reg s_beginTransactionReg, s_forceControlReg, s_dataValidReg, s_endTransactionReg, s_forceDataReg;
   reg s_readnWriteReg;
-  reg [31:0] s_busDataOutReg, s_writeBackAddress, s_busAddressNext;
+  reg [31:0] s_busDataOutReg, s_busAddressNext;
   reg [3:0] s_byteEnablesReg, s_myBurstCountReg;
   reg [7:0] s_burstSizeReg;
   reg s_doStore, s_busErrorReg;
@@ -1699,6 +2214,8 @@ module dCache   ( input wire         clock,
                            s_busTransactionTypeReg != SNOOPY_WRITE_BACK &&
                            s_busTransactionTypeReg != FLUSH_WRITE_BACK))) ? 1'b1 : 1'b0;
   wire [31:0] s_busDataOutNext = (s_weBusDataOut == 1'b0) ? s_busDataOutReg :
+                                 (s_busTransactionTypeReg == UNCACHEABLE_WRITE ||
+                                  s_busTransactionTypeReg == WRITE_THROUGH) ? s_writeBufferHeadData :
                                  (s_busTransactionTypeReg != CACHE_LINE_WRITE_BACK &&
                                   s_busTransactionTypeReg != SNOOPY_WRITE_BACK &&
                                   s_busTransactionTypeReg != FLUSH_WRITE_BACK) ? s_stage2DataFromCoreReg : 
@@ -1709,7 +2226,7 @@ module dCache   ( input wire         clock,
                            s_busTransactionTypeReg != CACHE_LINE_WRITE_BACK &&
                            s_busTransactionTypeReg != SNOOPY_WRITE_BACK &&
                            s_busTransactionTypeReg != FLUSH_WRITE_BACK)) ? 1'b1 : 1'b0;
-  wire s_beginTransactionNext = ((s_cacheStateReg == INIT_TRANSACTION && s_busTransactionTypeReg != NOOP) ||
+  wire s_beginTransactionNext = ((s_cacheStateReg == INIT_TRANSACTION && s_busTransactionTypeReg != NOOP && s_localLineFill == 1'b0) ||
                                  s_cacheStateReg == ATOMIC_INIT) ? 1'b1 : 1'b0;
   wire s_endTransactionNext = (s_cacheStateReg == END_TRANSACTION || s_cacheStateReg == BACKOFF ||
                                ((s_busTransactionTypeReg == CACHE_LINE_WRITE_BACK ||
@@ -1718,7 +2235,7 @@ module dCache   ( input wire         clock,
                                 s_busWriteStall == 1'b0 &&
                                 s_dataValidReg == 1'b1 &&
                                 s_selectedDataValidReg == 1'b0)) ? 1'b1 : 1'b0;
-  wire s_weBusRegs = ((s_cacheStateReg == INIT_TRANSACTION && s_busTransactionTypeReg != NOOP) ||
+  wire s_weBusRegs = ((s_cacheStateReg == INIT_TRANSACTION && s_busTransactionTypeReg != NOOP && s_localLineFill == 1'b0) ||
                       s_cacheStateReg == ATOMIC_INIT) ? 1'b1 : 1'b0;
   wire s_readnWriteNext = (s_weBusRegs == 1'b0 ||
                            (s_cacheStateReg == ATOMIC_INIT && s_doStore == 1'b1) ||
@@ -1732,7 +2249,10 @@ module dCache   ( input wire         clock,
                            (s_busTransactionTypeReg == CACHE_LINE_WRITE_BACK ||
                             s_busTransactionTypeReg == CACHE_LINE_LOAD ||
                             s_busTransactionTypeReg == FLUSH_WRITE_BACK ||
-                            s_busTransactionTypeReg == SNOOPY_WRITE_BACK) ? 4'hF : s_stage2DataByteEnableReg;
+                            s_busTransactionTypeReg == SNOOPY_WRITE_BACK ||
+                            s_busTransactionTypeReg == PREFETCH_LOAD) ? 4'hF :
+                           (s_busTransactionTypeReg == UNCACHEABLE_WRITE ||
+                            s_busTransactionTypeReg == WRITE_THROUGH) ? s_writeBufferHeadByteEnables : s_stage2DataByteEnableReg;
   wire s_busErrorNext = (busAccessGranted == 1'b1 || reset == 1'b1) ? 1'b0 : busErrorIn | s_busErrorReg;
   wire [3:0] s_expectedBurstSize = {1'b0,s_busTransactionLengthReg} + 4'd1;
   wire s_forceControlNext = (endTransactionIn == 1'b1 || reset == 1'b1) ? 1'b0 : s_forceControlReg | busAccessGranted;
@@ -1742,13 +2262,19 @@ module dCache   ( input wire         clock,
                                    dataValidIn == 1'b1 &&
                                    busyIn == 1'b0 &&
                                    s_forceControlReg == 1'b1) ? s_myBurstCountReg + 4'd1 : s_myBurstCountReg;
-  wire [2:0] s_wordBurstSelectNext = (busAccessGranted == 1'b1 || s_snarfActiveNext == 1'b1) ? 3'b000 :
+  wire [2:0] s_wordBurstSelectNext = (s_snarfActiveNext == 1'b1) ? s_snoopyStage1AddressReg[4:2] :
+                                     (busAccessGranted == 1'b1) ? 3'b000 :
+                                     (s_weBusRegs == 1'b1 && s_busTransactionTypeReg == CACHE_LINE_LOAD) ? s_stage2MemoryAddressReg[4:2] :
                                      ((s_busWriteStall == 1'b0 && s_cacheStateReg == DO_WRITE) ||
                                       s_busDataInValidReg == 1'b1) ? s_wordBurstSelectReg + 3'd1 : s_wordBurstSelectReg;
-  wire [31:0] s_busDataInNext = (dataValidIn == 1'b1 && busyIn == 1'b0 &&
+  wire [31:0] s_busDataInNext = (s_cacheStateReg == PREFETCH_COPY) ? ((s_stage2ZeroReg == 1'b1) ? 32'd0 :
+                                                                     (s_victimCopyReg == 1'b1) ? s_victimDataReg[{s_victimSlotReg, s_prefetchCopyIndexReg}] :
+                                                                                                 s_prefetchDataReg[s_prefetchCopyIndexReg]) :
+                                (dataValidIn == 1'b1 && busyIn == 1'b0 &&
                                  ((s_forceControlReg == 1'b1 && s_forceDataReg == 1'b0) ||
                                   (s_snarfActiveNext == 1'b1 || s_snarfActiveReg == 1'b1))) ? addressDataIn : s_busDataInReg;
-  wire s_busDataInValidNext = (dataValidIn == 1'b1 && busyIn == 1'b0 &&
+  wire s_busDataInValidNext = (s_cacheStateReg == PREFETCH_COPY) ? 1'b1 :
+                              (dataValidIn == 1'b1 && busyIn == 1'b0 &&
                                ((s_forceControlReg == 1'b1 && s_forceDataReg == 1'b0) ||
                                 (s_snarfActiveNext == 1'b1 || s_snarfActiveReg == 1'b1))) ? 1'b1 : 1'b0;
                             
@@ -1765,8 +2291,11 @@ module dCache   ( input wire         clock,
   assign readNotWriteOut = s_readnWriteReg;
   assign dataValidOut = s_dataValidReg & s_forceControlReg;
   assign burstSizeOut = s_burstSizeReg;
-  assign s_busError = ((s_busErrorReg == 1'b1 || s_expectedBurstSize != s_myBurstCountReg) &&
-                       (s_cacheStateReg == RELEASE || s_cacheStateReg == UPDATE_TAGS)) ? 1'b1 : 1'b0;
+  assign wrapBurstOut = s_wrapBurstReg;
+  assign s_busError = ((s_busErrorReg == 1'b1 || (s_expectedBurstSize != s_myBurstCountReg && s_prefetchCopyReg == 1'b0)) &&
+                       (s_cacheStateReg == RELEASE || s_cacheStateReg == UPDATE_TAGS) &&
+                       s_busTransactionTypeReg != UNCACHEABLE_WRITE &&
+                       s_busTransactionTypeReg != WRITE_THROUGH) ? 1'b1 : 1'b0;
   
   always @*
     if (s_busTransactionTypeReg == ATOMIC_SWAP) s_doStore <= 1'b1;
@@ -1790,18 +2319,25 @@ module dCache   ( input wire         clock,
       FOUR_WAY_SET_ASSOCIATIVE_8K,
       TWO_WAY_SET_ASSOCIATIVE_4K,
       DIRECT_MAPPED_2K            : s_writeBackAddress <= {s_stage2SelectedTagReg[20:0],s_stage2MemoryAddressReg[10:5], {5{1'b0}}};
+      FOUR_WAY_SET_ASSOCIATIVE_16K,
       TWO_WAY_SET_ASSOCIATIVE_8K,
       DIRECT_MAPPED_4K            : s_writeBackAddress <= {s_stage2SelectedTagReg[19:0],s_stage2MemoryAddressReg[11:5], {5{1'b0}}};
+      TWO_WAY_SET_ASSOCIATIVE_32K,
+      DIRECT_MAPPED_16K           : s_writeBackAddress <= {s_stage2SelectedTagReg[17:0],s_stage2MemoryAddressReg[13:5], {5{1'b0}}};
+      DIRECT_MAPPED_32K           : s_writeBackAddress <= {s_stage2SelectedTagReg[16:0],s_stage2MemoryAddressReg[14:5], {5{1'b0}}};
       default                     : s_writeBackAddress <= {s_stage2SelectedTagReg[18:0],s_stage2MemoryAddressReg[12:5], {5{1'b0}}};
     endcase
   
   always @*
-    if (s_weBusRegs == 1'b0) s_busAddressNext <= s_busAddressReg;
+    if (s_weBusRegs == 1'b0 && s_localLineFill == 1'b0) s_busAddressNext <= s_busAddressReg;
     else case (s_busTransactionTypeReg)
       CACHE_LINE_WRITE_BACK : s_busAddressNext <= s_writeBackAddress;
-      CACHE_LINE_LOAD       : s_busAddressNext <= {s_stage2MemoryAddressReg[31:5], {5{1'b0}}};
+      CACHE_LINE_LOAD       : s_busAddressNext <= {s_stage2MemoryAddressReg[31:2], 2'b00};
+      PREFETCH_LOAD         : s_busAddressNext <= {s_prefetchLineReg, {5{1'b0}}};
       SNOOPY_WRITE_BACK     : s_busAddressNext <= s_snoopyWbAddress;
       FLUSH_WRITE_BACK      : s_busAddressNext <= s_flushWbAddressReg;
+      UNCACHEABLE_WRITE,
+      WRITE_THROUGH         : s_busAddressNext <= s_writeBufferHeadAddress;
       default               : s_busAddressNext <= s_stage2MemoryAddressReg;
     endcase
   
@@ -1813,6 +2349,7 @@ module dCache   ( input wire         clock,
       s_endTransactionReg   <= s_endTransactionNext;
       s_readnWriteReg       <= s_readnWriteNext;
       s_burstSizeReg        <= s_burstSizeNext;
+      s_wrapBurstReg        <= s_weBusRegs & ~reset & (s_busTransactionTypeReg == CACHE_LINE_LOAD);
       s_byteEnablesReg      <= s_byteEnablesNext;
       s_busAddressReg       <= s_busAddressNext;
       s_busErrorReg         <= s_busErrorNext;
@@ -1829,7 +2366,7 @@ module dCache   ( input wire         clock,
    * Here some generic control signals are defined
    *
    */
-  reg s_writeThroughDoneReg;
+  reg s_zeroLineDoneReg;
   reg [10:0] s_waitWriteBackTimeOutReg;
   wire s_cacheRwCollision = ((s_snoopyStage1LookupSnoopReg == 1'b1 ||
                               s_snoopyStage2LookupSnoopReg == 1'b1 ||
@@ -1837,12 +2374,12 @@ module dCache   ( input wire         clock,
                               s_cacheStateReg == LOOKUP_TAGS ||
                               s_cacheStateReg == MARK_SHARED ||
                               (s_cacheStateReg == DO_WRITE && s_busTransactionTypeReg == SNOOPY_WRITE_BACK)) &&
-                             (s_stage2CWriteReg == 1'b1 || s_stage2CReadReg == 1'b1)) ? 1'b1 : 1'b0;
-  wire s_writeThroughRequired = (s_stage2CWriteReg == 1'b1 &&
-                                 ( (s_stage2Hit1Reg == 1'b1 && s_stage2State1Reg[1] == 1'b1) ||
-                                   (s_stage2Hit2Reg == 1'b1 && s_stage2State2Reg[1] == 1'b1) ||
-                                   (s_stage2Hit3Reg == 1'b1 && s_stage2State3Reg[1] == 1'b1) ||
-                                   (s_stage2Hit4Reg == 1'b1 && s_stage2State4Reg[1] == 1'b1))) ? 1'b1 : 1'b0;
+                             (s_stage2CWriteReg == 1'b1 || s_stage2CReadReg == 1'b1 || s_stage2ZeroReg == 1'b1)) ? 1'b1 : 1'b0;
+  assign s_writeThroughRequired = (s_stage2CWriteReg == 1'b1 &&
+                                   ( (s_stage2Hit1Reg == 1'b1 && s_stage2State1Reg[1] == 1'b1) ||
+                                     (s_stage2Hit2Reg == 1'b1 && s_stage2State2Reg[1] == 1'b1) ||
+                                     (s_stage2Hit3Reg == 1'b1 && s_stage2State3Reg[1] == 1'b1) ||
+                                     (s_stage2Hit4Reg == 1'b1 && s_stage2State4Reg[1] == 1'b1))) ? 1'b1 : 1'b0;
   wire s_waitWriteBackNext = (reset == 1'b1 ||
                               s_waitWriteBackTimeOutReg[10] == 1'b1 ||
                               s_snarfUpdateTagReg == 1'b1 ||
@@ -1850,6 +2387,15 @@ module dCache   ( input wire         clock,
                                s_snoopyWbDetectReg == 1'b1)) ? 1'b0 :
                              (s_cacheStateReg == BACKOFF) ? 1'b1 : s_waitWriteBackReg;
   wire [10:0] s_waitWriteBackTimeOutNext = (s_waitWriteBackReg == 1'b0) ? {11{1'b0}} : s_waitWriteBackTimeOutReg + 11'd1;
+  wire s_earlyRestartNext = (reset == 1'b0 &&
+                             s_internalStall == 1'b1 &&
+                             s_stage2CReadReg == 1'b1 &&
+                             s_earlyRestartReg == 1'b0 &&
+                             s_earlyRestartDoneReg == 1'b0 &&
+                             s_busDataInValidReg == 1'b1 &&
+                             s_busTransactionTypeReg == CACHE_LINE_LOAD &&
+                             s_dataForward2 == 1'b1) ? 1'b1 : 1'b0;
+  wire s_earlyRestartDoneNext = (reset == 1'b1 || s_internalStall == 1'b0) ? 1'b0 : s_earlyRestartDoneReg | s_earlyRestartReg;
   wire s_writeDependencyStall = (wbWriteEnable == 1'b1 &&
                                  (s_registerWe == 1'b1 ||
                                   (s_stage1TargetRegisterReg[4:0] == wbRegisterAddress &&
@@ -1861,6 +2407,7 @@ module dCache   ( input wire         clock,
   wire s_memorySyncStall = (memorySync == 1'b1 &&
                             (s_stage1CacheActionReg == 1'b1 ||
                              s_stage2CacheActionReg == 1'b1 ||
+                             s_writeBufferEmptyReg == 1'b0 ||
                              s_flushRequestReg == 1'b1)) ? 1'b1 : 1'b0;
   wire s_dataDependencyStall = ( (cid == s_stage1TargetRegisterReg[8:5] &&
                                   (s_stage1CReadReg == 1'b1 ||
@@ -1874,6 +2421,7 @@ module dCache   ( input wire         clock,
                                    rfStoreAddress == s_stage1TargetRegisterReg[4:0])
                                  ) || 
                                  (cid == s_stage2TargetRegisterReg[8:5] &&
+                                  s_earlyRestartDoneReg == 1'b0 &&
                                   (s_stage2CReadReg == 1'b1 ||
                                    s_stage2UReadReg == 1'b1 ||
                                    s_stage2CasReg == 1'b1 ||
@@ -1899,7 +2447,8 @@ module dCache   ( input wire         clock,
                                    ((s_stage2CReadReg == 1'b1 ||
                                      s_stage2UReadReg == 1'b1 ||
                                      s_stage2CasReg == 1'b1 ||
-                                     s_stage2SwapReg == 1'b1) && s_stage2TargetRegisterReg == rfDestination))
+                                     s_stage2SwapReg == 1'b1) && s_stage2TargetRegisterReg == rfDestination &&
+                                    s_earlyRestartDoneReg == 1'b0))
                                  )) ? 1'b1 : 1'b0;
   wire s_processorStall = ( ((s_internalStall == 1'b1 || s_flushRequestReg == 1'b1)&&
                              (memoryStore != NO_STORE || memoryLoad != NO_LOAD)) ||
@@ -1914,12 +2463,12 @@ module dCache   ( input wire         clock,
                       s_stage2Hit3Reg == 1'b0 &&
                       s_stage2Hit4Reg == 1'b0) ? 1'b1 : 1'b0;
   wire s_uncacheableAction = (s_stage2ValidReg == 1'b0 && 
-                              (s_stage2UWriteReg == 1'b1 ||
-                               s_stage2UReadReg == 1'b1 ||
+                              (s_stage2UReadReg == 1'b1 ||
                                s_stage2SwapReg == 1'b1 ||
                                s_stage2CasReg == 1'b1)) ? 1'b1 : 1'b0;
 
-  assign s_internalStall = s_cacheMiss | s_uncacheableAction | (s_writeThroughRequired & ~s_writeThroughDoneReg);
+  assign s_internalStall = s_cacheMiss | s_uncacheableAction | s_writeBufferStall |
+                           (s_stage2ZeroReg & ~s_zeroLineDoneReg);
   assign stallCpu = s_processorStall;
   assign resetExeLoad = pipelineStall & ~s_internalStall & ~s_flushRequestReg & ~s_dcacheDisableActiveReg & ~s_dcacheDisableTick;
   
@@ -1927,8 +2476,10 @@ module dCache   ( input wire         clock,
     begin
       s_waitWriteBackTimeOutReg <= s_waitWriteBackTimeOutNext;
       s_waitWriteBackReg        <= s_waitWriteBackNext;
-      if (s_cacheStateReg == RELEASE && s_busTransactionTypeReg == WRITE_THROUGH) s_writeThroughDoneReg <= 1'b1;
-      else s_writeThroughDoneReg <= 1'b0;
+      s_earlyRestartReg         <= s_earlyRestartNext;
+      s_earlyRestartDoneReg     <= s_earlyRestartDoneNext;
+      if (s_cacheStateReg == RELEASE && s_busTransactionTypeReg == CACHE_LINE_LOAD && s_stage2ZeroReg == 1'b1) s_zeroLineDoneReg <= 1'b1;
+      else s_zeroLineDoneReg <= 1'b0;
     end
 
   /*
@@ -1939,14 +2490,15 @@ module dCache   ( input wire         clock,
   reg [2:0] s_busTransactionLengthNext;
   reg [4:0] s_busTransactionTypeNext;
   reg [5:0] s_cacheStateNext;
-  wire s_dirtyReplacer = (s_stage2ReplacementWayReg[0] & (s_stage2State1Reg[2] | s_stage2State1Reg[3])) ||
-                         (s_stage2ReplacementWayReg[1] & (s_stage2State2Reg[2] | s_stage2State2Reg[3])) ||
-                         (s_stage2ReplacementWayReg[2] & (s_stage2State3Reg[2] | s_stage2State3Reg[3])) ||
-                         (s_stage2ReplacementWayReg[3] & (s_stage2State4Reg[2] | s_stage2State4Reg[3]));
-  wire [3:0] s_action = {s_stage2CReadReg,
-                         s_stage2CWriteReg,
-                         s_stage2UReadReg | s_stage2CasReg | s_stage2SwapReg,
-                         s_stage2UWriteReg};
+  wire s_zeroLineHit = s_stage2ZeroReg & (s_stage2Hit1Reg | s_stage2Hit2Reg | s_stage2Hit3Reg | s_stage2Hit4Reg);
+  wire s_dirtyReplacer = ~s_zeroLineHit &
+                         ((s_stage2ReplacementWayReg[0] & (s_stage2State1Reg[2] | s_stage2State1Reg[3])) ||
+                          (s_stage2ReplacementWayReg[1] & (s_stage2State2Reg[2] | s_stage2State2Reg[3])) ||
+                          (s_stage2ReplacementWayReg[2] & (s_stage2State3Reg[2] | s_stage2State3Reg[3])) ||
+                          (s_stage2ReplacementWayReg[3] & (s_stage2State4Reg[2] | s_stage2State4Reg[3])));
+  wire [2:0] s_action = {s_stage2CReadReg,
+                         s_stage2CWriteReg | s_stage2ZeroReg,
+                         s_stage2UReadReg | s_stage2CasReg | s_stage2SwapReg};
   
   always @*
     if (reset == 1'b1)
@@ -1966,22 +2518,24 @@ module dCache   ( input wire         clock,
             s_busTransactionLengthNext <= 3'b111;
             s_busTransactionTypeNext   <= SNOOPY_WRITE_BACK;
           end
+        else if (s_writeBufferEmptyReg == 1'b0)
+          begin
+            s_busTransactionLengthNext <= 3'b000;
+            s_busTransactionTypeNext   <= (s_writeBufferHeadThrough == 1'b1) ? WRITE_THROUGH : UNCACHEABLE_WRITE;
+          end
+        else if (s_internalStall == 1'b0)
+          begin
+            s_busTransactionLengthNext <= 3'b111;
+            s_busTransactionTypeNext   <= (s_prefetchPendingReg == 1'b1) ? PREFETCH_LOAD : NOOP;
+          end
         else case (s_action)
-          4'b0001  : begin
-                       s_busTransactionLengthNext <= 3'b000;
-                       s_busTransactionTypeNext   <= UNCACHEABLE_WRITE;
-                     end
-          4'b0010  : begin
+          3'b001   : begin
                        s_busTransactionLengthNext <= 3'b000;
                        s_busTransactionTypeNext   <= (s_stage2CasReg == 1'b1) ? ATOMIC_CAS :
                                                      (s_stage2SwapReg == 1'b1) ? ATOMIC_SWAP : UNCACHEABLE_READ;
                      end
-          4'b0100  : begin
-                       s_busTransactionLengthNext <= (s_writeThroughRequired == 1'b1) ? 3'b000 : 3'b111;
-                       s_busTransactionTypeNext   <= (s_writeThroughRequired == 1'b1) ? WRITE_THROUGH :
-                                                     (s_dirtyReplacer == 1'b1) ? CACHE_LINE_WRITE_BACK : CACHE_LINE_LOAD;
-                     end
-          4'b1000  : begin
+          3'b010,
+          3'b100   : begin
                        s_busTransactionLengthNext <= 3'b111;
                        s_busTransactionTypeNext   <= (s_dirtyReplacer == 1'b1) ? CACHE_LINE_WRITE_BACK : CACHE_LINE_LOAD;
                      end
@@ -2001,9 +2555,13 @@ module dCache   ( input wire         clock,
     case (s_cacheStateReg)
       IDLE               : s_cacheStateNext <= (s_flushActiveReg == 1'b1) ? FLUSH_INIT :
                                                (s_snoopyWbBufferEmptyReg == 1'b0 ||
+                                                s_writeBufferEmptyReg == 1'b0 ||
                                                 (s_internalStall == 1'b1 &&
                                                  s_cacheRwCollision == 1'b0 &&
-                                                 s_waitWriteBackReg == 1'b0)) ? REQUEST_THE_BUS : IDLE;
+                                                 s_waitWriteBackReg == 1'b0) ||
+                                                (s_internalStall == 1'b0 &&
+                                                 s_prefetchPendingReg == 1'b1 &&
+                                                 s_flushRequestReg == 1'b0)) ? REQUEST_THE_BUS : IDLE;
       REQUEST_THE_BUS    : s_cacheStateNext <= (busAccessGranted == 1'b1) ? DET_TRANSACTION : REQUEST_THE_BUS;
       DET_TRANSACTION    : s_cacheStateNext <= (s_snoopyStage1LookupSnoopReg == 1'b1 ||
                                                 s_snoopyStage2LookupSnoopReg == 1'b1 ||
@@ -2019,7 +2577,8 @@ module dCache   ( input wire         clock,
                              UNCACHEABLE_READ,
                              ATOMIC_CAS,
                              ATOMIC_SWAP,
-                             CACHE_LINE_LOAD        : s_cacheStateNext <= WAIT_READ_BURST;
+                             PREFETCH_LOAD          : s_cacheStateNext <= WAIT_READ_BURST;
+                             CACHE_LINE_LOAD        : s_cacheStateNext <= (s_localLineFill == 1'b1) ? PREFETCH_COPY : WAIT_READ_BURST;
                              default                : s_cacheStateNext <= END_TRANSACTION;
                            endcase
       DO_WRITE           : s_cacheStateNext <= (busErrorIn == 1'b1) ? END_TRANSACTION :
@@ -2034,6 +2593,8 @@ module dCache   ( input wire         clock,
                                                   s_busTransactionTypeReg == ATOMIC_SWAP)) ||
                                                 busErrorIn == 1'b1) ? END_TRANSACTION : WAIT_N_BUSY;
       WAIT_READ_BURST   : s_cacheStateNext <= (privateDirtyIn == 1'b1 &&
+                                               s_busTransactionTypeReg == PREFETCH_LOAD) ? END_TRANSACTION :
+                                              (privateDirtyIn == 1'b1 &&
                                                (s_busTransactionTypeReg == CACHE_LINE_LOAD ||
                                                 s_busTransactionTypeReg == ATOMIC_SWAP ||
                                                 s_busTransactionTypeReg == ATOMIC_CAS)) ? BACKOFF :
@@ -2045,9 +2606,11 @@ module dCache   ( input wire         clock,
       END_TRANSACTION  : s_cacheStateNext <= (s_busTransactionTypeReg == NOOP) ? IDLE : NOP;
       NOP              : s_cacheStateNext <= (s_busTransactionTypeReg == FLUSH_WRITE_BACK) ? FLUSH_LOOKUP :
                                              ((s_busTransactionTypeReg == CACHE_LINE_WRITE_BACK && s_busErrorReg == 1'b0) ||
-                                              s_busTransactionTypeReg == SNOOPY_WRITE_BACK) ? IDLE :
+                                              s_busTransactionTypeReg == SNOOPY_WRITE_BACK ||
+                                              s_busTransactionTypeReg == PREFETCH_LOAD) ? IDLE :
                                              (s_busTransactionTypeReg == CACHE_LINE_LOAD) ? UPDATE_TAGS : RELEASE;
       UPDATE_TAGS      : s_cacheStateNext <= RELEASE;
+      PREFETCH_COPY    : s_cacheStateNext <= (s_prefetchCopyIndexReg == 3'd7) ? END_TRANSACTION : PREFETCH_COPY;
       ATOMIC_REQUEST   : s_cacheStateNext <= (busAccessGranted == 1'b1) ? ATOMIC_INIT : ATOMIC_REQUEST;
       ATOMIC_INIT      : s_cacheStateNext <= (s_doStore == 1'b1) ? DO_WRITE : ATOMIC_WAIT;
       ATOMIC_WAIT      : s_cacheStateNext <= (endTransactionIn == 1'b1) ? NOP :
@@ -2083,14 +2646,19 @@ module dCache   ( input wire         clock,
        uncachedRead    <= ~s_internalStall && s_stage2UReadReg;
        swapInstruction <= ~s_internalStall && s_stage2SwapReg;
        casInstruction  <= ~s_internalStall && s_stage2CasReg;
-       cacheMiss       <= (s_cacheStateReg == INIT_TRANSACTION && s_busTransactionTypeReg == CACHE_LINE_LOAD) ? 1'b1 : 1'b0;
+       cacheMiss       <= s_prefetchMiss;
        cacheWriteBack  <= (s_cacheStateReg == INIT_TRANSACTION && s_busTransactionTypeReg == CACHE_LINE_WRITE_BACK) ? 1'b1 : 1'b0;
        dataStall       <= s_dataDependencyStall;
        writeStall      <= s_writeDependencyStall;
        processorStall  <= s_processorStall;
        cacheStall      <= s_internalStall;
-       writeThrough    <= s_writeThroughDoneReg;
+       writeThrough    <= (s_cacheStateReg == INIT_TRANSACTION && s_busTransactionTypeReg == WRITE_THROUGH) ? 1'b1 : 1'b0;
        invalidate      <= s_snoopyStage3InvalidateReg;
+       prefetch        <= s_prefetchIssue;
+       prefetchHit     <= s_prefetchBufferHit;
+       postedWrite     <= s_writeBufferWe;
+       writeBufferStall <= s_writeBufferStall;
+       victimHit       <= s_victimBufferHit;
      end
 
 endmodule
@@ -1,4 +1,5 @@
-module icache   ( input wire         clock,
+module icache #( parameter [2:0] MaximumCacheSize = 3'd3 )
+                ( input wire         clock,
                                      reset,
                   
                   // Here the bus interface is defined
@@ -14,6 +15,7 @@ module icache   ( input wire         clock,
                   input wire         dataValidIn,
                   input wire         busyIn,
                   output wire [7:0]  burstSizeOut,
+                  output wire        wrapBurstOut,
 
                   // here the profiling interface is defined
                   output reg         instructionFetch,
@@ -33,10 +35,12 @@ module icache   ( input wire         clock,
                                      flushPipe,
                                      flushCache,
                   input wire [1:0]   replacementPolicy,
-                                     cacheSize,
                                      numberOfWays,
+                  input wire [2:0]   cacheSize,
                   input wire         cacheEnabled,
-                                     loadPc,
+                                     lockFill,
+                  input wire [1:0]   lockedWays,
+                  input wire         loadPc,
                                      jump,
                   input wire [29:0]  pcLoadValue,
                                      jumpTarget,
@@ -50,23 +54,31 @@ module icache   ( input wire         clock,
   localparam [1:0] TWO_WAY_SET_ASSOCIATIVE  = 2'b01;
   localparam [1:0] FOUR_WAY_SET_ASSOCIATIVE = 2'b10;
   
-  localparam [3:0] DIRECT_MAPPED_1K            = 4'b0000;
-  localparam [3:0] DIRECT_MAPPED_2K            = 4'b0001;
-  localparam [3:0] DIRECT_MAPPED_4K            = 4'b0010;
-  localparam [3:0] DIRECT_MAPPED_8K            = 4'b0011;
-  localparam [3:0] TWO_WAY_SET_ASSOCIATIVE_1K  = 4'b0100;
-  localparam [3:0] TWO_WAY_SET_ASSOCIATIVE_2K  = 4'b0101;
-  localparam [3:0] TWO_WAY_SET_ASSOCIATIVE_4K  = 4'b0110;
-  localparam [3:0] TWO_WAY_SET_ASSOCIATIVE_8K  = 4'b0111;
-  localparam [3:0] FOUR_WAY_SET_ASSOCIATIVE_1K = 4'b1000;
-  localparam [3:0] FOUR_WAY_SET_ASSOCIATIVE_2K = 4'b1001;
-  localparam [3:0] FOUR_WAY_SET_ASSOCIATIVE_4K = 4'b1010;
-  localparam [3:0] FOUR_WAY_SET_ASSOCIATIVE_8K = 4'b1011;
+  localparam [4:0] DIRECT_MAPPED_1K             = 5'b00000;
+  localparam [4:0] DIRECT_MAPPED_2K             = 5'b00001;
+  localparam [4:0] DIRECT_MAPPED_4K             = 5'b00010;
+  localparam [4:0] DIRECT_MAPPED_8K             = 5'b00011;
+  localparam [4:0] DIRECT_MAPPED_16K            = 5'b00100;
+  localparam [4:0] DIRECT_MAPPED_32K            = 5'b00101;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_1K   = 5'b01000;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_2K   = 5'b01001;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_4K   = 5'b01010;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_8K   = 5'b01011;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_16K  = 5'b01100;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_32K  = 5'b01101;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_1K  = 5'b10000;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_2K  = 5'b10001;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_4K  = 5'b10010;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_8K  = 5'b10011;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_16K = 5'b10100;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_32K = 5'b10101;
   
-  localparam [1:0] SIZE_1K = 2'b00;
-  localparam [1:0] SIZE_2K = 2'b01;
-  localparam [1:0] SIZE_4K = 2'b10;
-  localparam [1:0] SIZE_8K = 2'b11;
+  localparam [2:0] SIZE_1K  = 3'b000;
+  localparam [2:0] SIZE_2K  = 3'b001;
+  localparam [2:0] SIZE_4K  = 3'b010;
+  localparam [2:0] SIZE_8K  = 3'b011;
+  localparam [2:0] SIZE_16K = 3'b100;
+  localparam [2:0] SIZE_32K = 3'b101;
 
   localparam [1:0] FIFO_REPLACEMENT         = 2'b00;
   localparam [1:0] PLRU_REPLACEMENT         = 2'b01;
@@ -83,13 +95,21 @@ module icache   ( input wire         clock,
   localparam [3:0] DO_FLUSH         = 4'd8;
   localparam [3:0] FLUSH_DONE       = 4'd9;
 
+  /*
+   * The tag and data memories are sized for the largest cache selectable at run time
+   * (MaximumCacheSize, direct mapped); smaller configurations use only part of them.
+   */
+  localparam integer MaximumSetBits = MaximumCacheSize + 5;
+  localparam integer DataIndexBits  = MaximumCacheSize + 6;
+
   parameter [31:0] NopInstruction = 32'h1500FFFF;
   reg s_flushActiveReg, s_busDataInValidReg, s_cacheEnabledReg;
   reg [3:0] s_stage3ReplacementWayReg;
   reg [2:0] s_wordBurstSelectReg;
-  reg [31:0] s_selectedCacheData, s_fetchedInstructionReg, s_busDataInReg;
+  reg [31:0] s_selectedCacheData, s_busDataInReg;
   reg [3:0] s_cacheStateReg;
-  wire s_internalStall, s_flushCache, s_busError, s_hit;
+  wire s_internalStall, s_flushCache, s_busError, s_hit, s_streamHit;
+  wire [31:0] s_streamInstruction;
   wire s_stall = stall | s_internalStall;
   
   /*
@@ -144,7 +164,8 @@ module icache   ( input wire         clock,
                                         (s_cacheEnabledReg == 1'b1 && stall == 1'b0 &&
                                          ((s_hit == 1'b0 && s_internalStall == 1'b0) || flushPipe == 1'b1 || s_flushCache == 1'b1 || s_flushActiveReg == 1'b1)) ? NopInstruction :
                                         (s_cacheEnabledReg == 1'b1 && s_stall == 1'b0 && s_internalStall == 1'b0 && s_hit == 1'b1) ? s_selectedCacheData :
-                                        (s_cacheEnabledReg == 1'b1 && s_cacheStateReg == RELEASE && s_busError == 1'b0) ? s_fetchedInstructionReg : s_stage3InstructionReg;
+                                        (s_streamHit == 1'b1 ||
+                                         (s_cacheEnabledReg == 1'b1 && s_cacheStateReg == RELEASE && s_busError == 1'b0)) ? s_streamInstruction : s_stage3InstructionReg;
   wire s_stage3InsertedNopNext = (reset == 1'b1) ? 1'b1 :
                                  (s_cacheEnabledReg == 1'b0 && stall == 1'b0 &&
                                   (s_internalStall == 1'b0 || flushPipe == 1'b1 || s_flushCache == 1'b1 || s_flushActiveReg == 1'b1)) ? 1'b1 :
@@ -152,9 +173,12 @@ module icache   ( input wire         clock,
                                  (s_cacheEnabledReg == 1'b1 && stall == 1'b0 &&
                                   ((s_hit == 1'b0 && s_internalStall == 1'b0) || flushPipe == 1'b1 || s_flushCache == 1'b1 || s_flushActiveReg == 1'b1)) ? 1'b1 :
                                  (s_cacheEnabledReg == 1'b1 && s_stall == 1'b0 && s_internalStall == 1'b0 && s_hit == 1'b1) ? 1'b0 :
-                                 (s_cacheEnabledReg == 1'b1 && s_cacheStateReg == RELEASE && s_busError == 1'b0) ? 1'b0 : s_stage3InsertedNopReg;
+                                 (s_streamHit == 1'b1 ||
+                                  (s_cacheEnabledReg == 1'b1 && s_cacheStateReg == RELEASE && s_busError == 1'b0)) ? 1'b0 : s_stage3InsertedNopReg;
   wire s_stage3AbortNext = (reset == 1'b1 || s_stall == 1'b0) ? 1'b0 : s_stage3AbortReg | s_busError;
-  wire s_stage3ValidNext = (reset == 1'b1) ? 1'b0 : (s_cacheStateReg == RELEASE && s_cacheEnabledReg == 1'b0) ? 1'b1 : (s_stall == 1'b0) ? 1'b0 : s_stage3ValidReg;
+  wire s_stage3ValidNext = (reset == 1'b1) ? 1'b0 :
+                           ((s_cacheStateReg == RELEASE && s_cacheEnabledReg == 1'b0) || s_streamHit == 1'b1) ? 1'b1 :
+                           (s_stall == 1'b0) ? 1'b0 : s_stage3ValidReg;
   
   assign insertedNop      = s_stage3InsertedNopReg;
   assign instruction      = s_stage3InstructionReg;
@@ -174,11 +198,11 @@ module icache   ( input wire         clock,
    *
    */
   reg s_cacheEnabledDelayReg;
-  reg [7:0] s_flushCounterReg;
+  reg [9:0] s_flushCounterReg;
   wire s_flushActiveNext = (s_flushCache == 1'b1 || reset == 1'b1) ? 1'b1 :
                            (s_cacheStateReg == FLUSH_DONE) ? 1'b0 : s_flushActiveReg;
-  wire [7:0] s_flushCounterNext = (reset == 1'b1 || s_cacheStateReg == FLUSH_INIT) ? {8{1'b0}} :
-                                  (s_cacheStateReg == DO_FLUSH) ? s_flushCounterReg + 8'd1 : s_flushCounterReg;
+  wire [9:0] s_flushCounterNext = (reset == 1'b1 || s_cacheStateReg == FLUSH_INIT) ? {10{1'b0}} :
+                                  (s_cacheStateReg == DO_FLUSH) ? s_flushCounterReg + 10'd1 : s_flushCounterReg;
   
   assign s_flushCache = (flushCache == 1'b1 || (s_cacheEnabledDelayReg == 1'b1 && s_cacheEnabledReg == 1'b0)) ? 1'b1 : 1'b0;
   
@@ -195,14 +219,14 @@ module icache   ( input wire         clock,
    *
    */
   reg [23:0] s_newTag, s_compareTag;
-  reg [8:0] s_tagStateLookupIndex, s_tagStateForwardIndex, s_tagStateCurrentIndex;
+  reg [9:0] s_tagStateLookupIndex, s_tagStateForwardIndex, s_tagStateCurrentIndex;
   reg s_hit1, s_hit2, s_hit3, s_hit4;
   reg s_stage3Hit1Reg, s_stage3Hit2Reg, s_stage3Hit3Reg, s_stage3Hit4Reg;
-  wire [3:0] s_cacheConfiguration = {numberOfWays, cacheSize};
+  wire [4:0] s_cacheConfiguration = {numberOfWays, cacheSize};
   wire s_newState = ~s_flushActiveReg;
   wire [3:0] s_tagUpdateVector = (s_cacheStateReg == DO_FLUSH) ? 4'hF :
                                  (s_cacheStateReg == UPDATE_TAGS) ? s_stage3ReplacementWayReg : 4'h0;
-  wire [8:0] s_tagIndex = (s_flushActiveReg == 1'b1) ? {1'b0, s_flushCounterReg} :
+  wire [9:0] s_tagIndex = (s_flushActiveReg == 1'b1) ? s_flushCounterReg :
                           (s_tagUpdateVector == 4'h0) ? s_tagStateLookupIndex : s_tagStateCurrentIndex;
   wire [31:0] s_newCombinedTag = {6'd0 , s_newTag, s_newState};
   wire [31:0] s_combinedTag1, s_combinedTag2, s_combinedTag3, s_combinedTag4;
@@ -238,50 +262,66 @@ module icache   ( input wire         clock,
       FOUR_WAY_SET_ASSOCIATIVE_1K : begin
                                       s_newTag               <= s_stage3PcReg[31:8];
                                       s_compareTag           <= s_stage2PcReg[31:8];
-                                      s_tagStateLookupIndex  <= { 6'd0 , s_nextPc[7:5] };
-                                      s_tagStateForwardIndex <= { 6'd0 , s_stage2PcReg[7:5] };
-                                      s_tagStateCurrentIndex <= { 6'd0 , s_stage3PcReg[7:5] };
+                                      s_tagStateLookupIndex  <= { 7'd0 , s_nextPc[7:5] };
+                                      s_tagStateForwardIndex <= { 7'd0 , s_stage2PcReg[7:5] };
+                                      s_tagStateCurrentIndex <= { 7'd0 , s_stage3PcReg[7:5] };
                                     end
       FOUR_WAY_SET_ASSOCIATIVE_2K,
       TWO_WAY_SET_ASSOCIATIVE_1K  : begin
                                       s_newTag               <= { 1'b0 , s_stage3PcReg[31:9]};
                                       s_compareTag           <= { 1'b0 , s_stage2PcReg[31:9]};
-                                      s_tagStateLookupIndex  <= { 5'd0 , s_nextPc[8:5] };
-                                      s_tagStateForwardIndex <= { 5'd0 , s_stage2PcReg[8:5] };
-                                      s_tagStateCurrentIndex <= { 5'd0 , s_stage3PcReg[8:5] };
+                                      s_tagStateLookupIndex  <= { 6'd0 , s_nextPc[8:5] };
+                                      s_tagStateForwardIndex <= { 6'd0 , s_stage2PcReg[8:5] };
+                                      s_tagStateCurrentIndex <= { 6'd0 , s_stage3PcReg[8:5] };
                                     end
       FOUR_WAY_SET_ASSOCIATIVE_4K,
       TWO_WAY_SET_ASSOCIATIVE_2K,
       DIRECT_MAPPED_1K            : begin
                                       s_newTag               <= { 2'd0 , s_stage3PcReg[31:10]};
                                       s_compareTag           <= { 2'd0 , s_stage2PcReg[31:10]};
-                                      s_tagStateLookupIndex  <= { 4'd0 , s_nextPc[9:5] };
-                                      s_tagStateForwardIndex <= { 4'd0 , s_stage2PcReg[9:5] };
-                                      s_tagStateCurrentIndex <= { 4'd0 , s_stage3PcReg[9:5] };
+                                      s_tagStateLookupIndex  <= { 5'd0 , s_nextPc[9:5] };
+                                      s_tagStateForwardIndex <= { 5'd0 , s_stage2PcReg[9:5] };
+                                      s_tagStateCurrentIndex <= { 5'd0 , s_stage3PcReg[9:5] };
                                     end
       FOUR_WAY_SET_ASSOCIATIVE_8K,
       TWO_WAY_SET_ASSOCIATIVE_4K,
       DIRECT_MAPPED_2K            : begin
                                       s_newTag               <= { 3'd0 , s_stage3PcReg[31:11]};
                                       s_compareTag           <= { 3'd0 , s_stage2PcReg[31:11]};
-                                      s_tagStateLookupIndex  <= { 3'd0 , s_nextPc[10:5] };
-                                      s_tagStateForwardIndex <= { 3'd0 , s_stage2PcReg[10:5] };
-                                      s_tagStateCurrentIndex <= { 3'd0 , s_stage3PcReg[10:5] };
+                                      s_tagStateLookupIndex  <= { 4'd0 , s_nextPc[10:5] };
+                                      s_tagStateForwardIndex <= { 4'd0 , s_stage2PcReg[10:5] };
+                                      s_tagStateCurrentIndex <= { 4'd0 , s_stage3PcReg[10:5] };
                                     end
+      FOUR_WAY_SET_ASSOCIATIVE_16K,
       TWO_WAY_SET_ASSOCIATIVE_8K,
       DIRECT_MAPPED_4K            : begin
                                       s_newTag               <= { 4'd0 , s_stage3PcReg[31:12]};
                                       s_compareTag           <= { 4'd0 , s_stage2PcReg[31:12]};
-                                      s_tagStateLookupIndex  <= { 2'd0 , s_nextPc[11:5] };
-                                      s_tagStateForwardIndex <= { 2'd0 , s_stage2PcReg[11:5] };
-                                      s_tagStateCurrentIndex <= { 2'd0 , s_stage3PcReg[11:5] };
+                                      s_tagStateLookupIndex  <= { 3'd0 , s_nextPc[11:5] };
+                                      s_tagStateForwardIndex <= { 3'd0 , s_stage2PcReg[11:5] };
+                                      s_tagStateCurrentIndex <= { 3'd0 , s_stage3PcReg[11:5] };
+                                    end
+      TWO_WAY_SET_ASSOCIATIVE_32K,
+      DIRECT_MAPPED_16K           : begin
+                                      s_newTag               <= { 6'd0 , s_stage3PcReg[31:14]};
+                                      s_compareTag           <= { 6'd0 , s_stage2PcReg[31:14]};
+                                      s_tagStateLookupIndex  <= { 1'b0 , s_nextPc[13:5] };
+                                      s_tagStateForwardIndex <= { 1'b0 , s_stage2PcReg[13:5] };
+                                      s_tagStateCurrentIndex <= { 1'b0 , s_stage3PcReg[13:5] };
+                                    end
+      DIRECT_MAPPED_32K           : begin
+                                      s_newTag               <= { 7'd0 , s_stage3PcReg[31:15]};
+                                      s_compareTag           <= { 7'd0 , s_stage2PcReg[31:15]};
+                                      s_tagStateLookupIndex  <= s_nextPc[14:5];
+                                      s_tagStateForwardIndex <= s_stage2PcReg[14:5];
+                                      s_tagStateCurrentIndex <= s_stage3PcReg[14:5];
                                     end
       default                     : begin
                                       s_newTag               <= { 5'd0 , s_stage3PcReg[31:13]};
                                       s_compareTag           <= { 5'd0 , s_stage2PcReg[31:13]};
-                                      s_tagStateLookupIndex  <= { 1'b0 , s_nextPc[12:5] };
-                                      s_tagStateForwardIndex <= { 1'b0 , s_stage2PcReg[12:5] };
-                                      s_tagStateCurrentIndex <= { 1'b0 , s_stage3PcReg[12:5] };
+                                      s_tagStateLookupIndex  <= { 2'd0 , s_nextPc[12:5] };
+                                      s_tagStateForwardIndex <= { 2'd0 , s_stage2PcReg[12:5] };
+                                      s_tagStateCurrentIndex <= { 2'd0 , s_stage3PcReg[12:5] };
                                     end
     endcase
       
@@ -315,63 +355,70 @@ module icache   ( input wire         clock,
       s_stage3Hit4Reg <= s_stage3Hit4Next;
     end
     
-  wire [8:0] s_tagIndexB = {1'b1,s_tagIndex[7:0]};
-  sram512X32Dp tagRamA( .clockA(clock),
-                        .writeEnableA(s_tagUpdateVector[0]),
-                        .addressA(s_tagIndex),
-                        .dataInA(s_newCombinedTag),
-                        .dataOutA(s_combinedTag1),
-                        .clockB(clock),
-                        .writeEnableB(s_tagUpdateVector[1]),
-                        .addressB(s_tagIndexB),
-                        .dataInB(s_newCombinedTag),
-                        .dataOutB(s_combinedTag2));  
-  sram512X32Dp tagRamB( .clockA(clock),
-                        .writeEnableA(s_tagUpdateVector[2]),
-                        .addressA(s_tagIndex),
-                        .dataInA(s_newCombinedTag),
-                        .dataOutA(s_combinedTag3),
-                        .clockB(clock),
-                        .writeEnableB(s_tagUpdateVector[3]),
-                        .addressB(s_tagIndexB),
-                        .dataInB(s_newCombinedTag),
-                        .dataOutB(s_combinedTag4));  
+  wire [MaximumSetBits:0] s_tagIndexA = {1'b0,s_tagIndex[MaximumSetBits-1:0]};
+  wire [MaximumSetBits:0] s_tagIndexB = {1'b1,s_tagIndex[MaximumSetBits-1:0]};
+  sramDp #( .nrOfAddressBits(MaximumSetBits+1),
+            .nrOfDataBits(32)) tagRamA
+          ( .clockA(clock),
+            .writeEnableA(s_tagUpdateVector[0]),
+            .addressA(s_tagIndexA),
+            .dataInA(s_newCombinedTag),
+            .dataOutA(s_combinedTag1),
+            .clockB(clock),
+            .writeEnableB(s_tagUpdateVector[1]),
+            .addressB(s_tagIndexB),
+            .dataInB(s_newCombinedTag),
+            .dataOutB(s_combinedTag2));  
+  sramDp #( .nrOfAddressBits(MaximumSetBits+1),
+            .nrOfDataBits(32)) tagRamB
+          ( .clockA(clock),
+            .writeEnableA(s_tagUpdateVector[2]),
+            .addressA(s_tagIndexA),
+            .dataInA(s_newCombinedTag),
+            .dataOutA(s_combinedTag3),
+            .clockB(clock),
+            .writeEnableB(s_tagUpdateVector[3]),
+            .addressB(s_tagIndexB),
+            .dataInB(s_newCombinedTag),
+            .dataOutB(s_combinedTag4));  
   /*
    *
    * here the data related signals are defined
    *
    */
-  reg [8:0] s_dataLookupIndex, s_dataWriteIndex;
+  reg [10:0] s_dataLookupIndex, s_dataWriteIndex;
   reg [1:0] s_select, s_weSelect;
   reg [3:0] s_weDataVector;
-  reg s_iHit;
   wire [31:0] s_dataToCache = {s_busDataInReg[7:0],s_busDataInReg[15:8],s_busDataInReg[23:16],s_busDataInReg[31:24]};
   wire [31:0] s_dataMem1, s_dataMem2, s_dataMem3, s_dataMem4;
-  wire [31:0] s_fetchedInstructionNext = (s_cacheEnabledReg == 1'b1 && s_busDataInValidReg == 1'b1 && s_iHit == 1'b1) ? s_dataToCache : s_fetchedInstructionReg;
-  wire [9:0] s_dataIndex = (s_weDataVector == 4'h0) ? s_dataLookupIndex : s_dataWriteIndex;
+  wire [10:0] s_dataIndex = (s_weDataVector == 4'h0) ? s_dataLookupIndex : s_dataWriteIndex;
   
   always @*
     case (cacheSize)
-      SIZE_8K : begin
-                  s_dataLookupIndex <= s_nextPc[10:2];
-                  s_dataWriteIndex  <= {s_stage3PcReg[10:5], s_wordBurstSelectReg};
-                  s_iHit = (s_dataWriteIndex == s_stage3PcReg[10:2]) ? 1'b1 : 1'b0;
-                end
-      SIZE_4K : begin
-                  s_dataLookupIndex <= {1'b0, s_nextPc[9:2]};
-                  s_dataWriteIndex  <= {1'b0, s_stage3PcReg[9:5], s_wordBurstSelectReg};
-                  s_iHit = (s_dataWriteIndex[7:0] == s_stage3PcReg[9:2]) ? 1'b1 : 1'b0;
-                end
-      SIZE_2K : begin
-                  s_dataLookupIndex <= {2'd0, s_nextPc[8:2]};
-                  s_dataWriteIndex  <= {2'd0, s_stage3PcReg[8:5], s_wordBurstSelectReg};
-                  s_iHit = (s_dataWriteIndex[6:0] == s_stage3PcReg[8:2]) ? 1'b1 : 1'b0;
-                end
-      default : begin
-                  s_dataLookupIndex <= {3'd0, s_nextPc[7:2]};
-                  s_dataWriteIndex  <= {3'd0, s_stage3PcReg[7:5], s_wordBurstSelectReg};
-                  s_iHit = (s_dataWriteIndex[5:0] == s_stage3PcReg[7:2]) ? 1'b1 : 1'b0;
-                end
+      SIZE_32K : begin
+                   s_dataLookupIndex <= s_nextPc[12:2];
+                   s_dataWriteIndex  <= {s_stage3PcReg[12:5], s_wordBurstSelectReg};
+                 end
+      SIZE_16K : begin
+                   s_dataLookupIndex <= {1'b0, s_nextPc[11:2]};
+                   s_dataWriteIndex  <= {1'b0, s_stage3PcReg[11:5], s_wordBurstSelectReg};
+                 end
+      SIZE_8K  : begin
+                   s_dataLookupIndex <= {2'd0, s_nextPc[10:2]};
+                   s_dataWriteIndex  <= {2'd0, s_stage3PcReg[10:5], s_wordBurstSelectReg};
+                 end
+      SIZE_4K  : begin
+                   s_dataLookupIndex <= {3'd0, s_nextPc[9:2]};
+                   s_dataWriteIndex  <= {3'd0, s_stage3PcReg[9:5], s_wordBurstSelectReg};
+                 end
+      SIZE_2K  : begin
+                   s_dataLookupIndex <= {4'd0, s_nextPc[8:2]};
+                   s_dataWriteIndex  <= {4'd0, s_stage3PcReg[8:5], s_wordBurstSelectReg};
+                 end
+      default  : begin
+                   s_dataLookupIndex <= {5'd0, s_nextPc[7:2]};
+                   s_dataWriteIndex  <= {5'd0, s_stage3PcReg[7:5], s_wordBurstSelectReg};
+                 end
     endcase
   
   always @*
@@ -386,6 +433,14 @@ module icache   ( input wire         clock,
                                    s_select[1]   <= s_hit2;
                                    s_weSelect[1] <= s_stage3ReplacementWayReg[1];
                                    case (cacheSize)
+                                     SIZE_32K : begin
+                                                  s_select[0]   <= s_stage2PcReg[13];
+                                                  s_weSelect[0] <= s_stage3PcReg[13];
+                                                end
+                                     SIZE_16K : begin
+                                                  s_select[0]   <= s_stage2PcReg[12];
+                                                  s_weSelect[0] <= s_stage3PcReg[12];
+                                                end
                                      SIZE_8K : begin
                                                  s_select[0]   <= s_stage2PcReg[11];
                                                  s_weSelect[0] <= s_stage3PcReg[11];
@@ -405,6 +460,14 @@ module icache   ( input wire         clock,
                                    endcase
                                  end
      default                   : case (cacheSize)
+                                   SIZE_32K : begin
+                                                s_select   <= s_stage2PcReg[14:13];
+                                                s_weSelect <= s_stage3PcReg[14:13];
+                                              end
+                                   SIZE_16K : begin
+                                                s_select   <= s_stage2PcReg[13:12];
+                                                s_weSelect <= s_stage3PcReg[13:12];
+                                              end
                                    SIZE_8K : begin
                                                s_select   <= s_stage2PcReg[12:11];
                                                s_weSelect <= s_stage3PcReg[12:11];
@@ -442,32 +505,84 @@ module icache   ( input wire         clock,
       endcase
     else s_weDataVector <= 4'h0;
   
+      sramDp #( .nrOfAddressBits(DataIndexBits),
+                .nrOfDataBits(32)) dataRam1
+              ( .clockA(clock),
+                .writeEnableA(s_weDataVector[0]),
+                .addressA(s_dataIndex[DataIndexBits-1:0]),
+                .dataInA(s_dataToCache),
+                .dataOutA(s_dataMem1),
+                .clockB(clock),
+                .writeEnableB(1'b0),
+                .addressB({DataIndexBits{1'b0}}),
+                .dataInB({32{1'b0}}),
+                .dataOutB());
+      sramDp #( .nrOfAddressBits(DataIndexBits),
+                .nrOfDataBits(32)) dataRam2
+              ( .clockA(clock),
+                .writeEnableA(s_weDataVector[1]),
+                .addressA(s_dataIndex[DataIndexBits-1:0]),
+                .dataInA(s_dataToCache),
+                .dataOutA(s_dataMem2),
+                .clockB(clock),
+                .writeEnableB(1'b0),
+                .addressB({DataIndexBits{1'b0}}),
+                .dataInB({32{1'b0}}),
+                .dataOutB());
+      sramDp #( .nrOfAddressBits(DataIndexBits),
+                .nrOfDataBits(32)) dataRam3
+              ( .clockA(clock),
+                .writeEnableA(s_weDataVector[2]),
+                .addressA(s_dataIndex[DataIndexBits-1:0]),
+                .dataInA(s_dataToCache),
+                .dataOutA(s_dataMem3),
+                .clockB(clock),
+                .writeEnableB(1'b0),
+                .addressB({DataIndexBits{1'b0}}),
+                .dataInB({32{1'b0}}),
+                .dataOutB());
+      sramDp #( .nrOfAddressBits(DataIndexBits),
+                .nrOfDataBits(32)) dataRam4
+              ( .clockA(clock),
+                .writeEnableA(s_weDataVector[3]),
+                .addressA(s_dataIndex[DataIndexBits-1:0]),
+                .dataInA(s_dataToCache),
+                .dataOutA(s_dataMem4),
+                .clockB(clock),
+                .writeEnableB(1'b0),
+                .addressB({DataIndexBits{1'b0}}),
+                .dataInB({32{1'b0}}),
+                .dataOutB());
+
+  /*
+   *
+   * Here the fill buffer is defined. Lines are fetched critical word first; each word
+   * of the line is kept in the fill buffer such that the instructions of the line can
+   * be handed to the core while the line is still being filled (early restart)
+   *
+   */
+  reg [31:0] s_fillBufferReg [7:0];
+  reg [7:0] s_fillValidReg;
+  wire [2:0] s_stage3Word = s_stage3PcReg[4:2];
+  wire s_fillArrived = (s_busDataInValidReg == 1'b1 && s_wordBurstSelectReg == s_stage3Word) ? 1'b1 : 1'b0;
+  wire [7:0] s_fillValidNext = (reset == 1'b1 || s_cacheStateReg == INIT_TRANSACTION) ? 8'd0 :
+                               (s_busDataInValidReg == 1'b1) ? s_fillValidReg | (8'd1 << s_wordBurstSelectReg) : s_fillValidReg;
+  
+  assign s_streamInstruction = (s_fillValidReg[s_stage3Word] == 1'b1) ? s_fillBufferReg[s_stage3Word] : s_dataToCache;
+  assign s_streamHit = (s_cacheEnabledReg == 1'b1 &&
+                        s_cacheStateReg == WAIT_READ_BURST &&
+                        s_flushActiveReg == 1'b0 &&
+                        s_internalStall == 1'b1 &&
+                        s_stage2PcReg[31:5] == s_stage3PcReg[31:5] &&
+                        (stall == 1'b1 || (jump == 1'b0 && loadPc == 1'b0)) &&
+                        (s_fillValidReg[s_stage3Word] == 1'b1 || s_fillArrived == 1'b1)) ? 1'b1 : 1'b0;
+  
   always @(posedge clock)
     begin
-      s_fetchedInstructionReg <= s_fetchedInstructionNext;
+      s_fillValidReg <= s_fillValidNext;
+      if (s_busDataInValidReg == 1'b1) s_fillBufferReg[s_wordBurstSelectReg] <= s_dataToCache;
     end
 
-      sram512X32 dataRam1 ( .clock(clock),
-                            .writeEnable(s_weDataVector[0]),
-                            .address(s_dataIndex[8:0]),
-                            .dataIn(s_dataToCache),
-                            .dataOut(s_dataMem1));
-      sram512X32 dataRam2 ( .clock(clock),
-                            .writeEnable(s_weDataVector[1]),
-                            .address(s_dataIndex[8:0]),
-                            .dataIn(s_dataToCache),
-                            .dataOut(s_dataMem2));
-      sram512X32 dataRam3 ( .clock(clock),
-                            .writeEnable(s_weDataVector[2]),
-                            .address(s_dataIndex[8:0]),
-                            .dataIn(s_dataToCache),
-                            .dataOut(s_dataMem3));
-      sram512X32 dataRam4 ( .clock(clock),
-                            .writeEnable(s_weDataVector[3]),
-                            .address(s_dataIndex[8:0]),
-                            .dataIn(s_dataToCache),
-                            .dataOut(s_dataMem4));
-
   /*
    *
    * Here all policy related signals are defined
@@ -476,7 +591,7 @@ module icache   ( input wire         clock,
   reg [1:0] s_newFifo, s_newLru1, s_newLru2, s_newLru3, s_newLru4;
   reg [4:0] s_newPlru, s_stage3PlruReg;
   reg [1:0] s_stage3FifoReg, s_stage3Lru1Reg, s_stage3Lru2Reg, s_stage3Lru3Reg, s_stage3Lru4Reg;
-  reg [3:0] s_stage3ReplacementWayNext;
+  reg [3:0] s_policyReplacementWay, s_lockedWayMask, s_fillWayMask;
   wire [31:0] s_combinedPolicy, s_dummyPolicy;
   wire [31:0] s_newCombinedPolicy = (s_flushActiveReg == 1'b1) ? {32{1'b0}} : { {17{1'b0}}, s_newPlru, s_newLru4, s_newLru3, s_newLru2, s_newLru1, s_newFifo};
   wire [1:0] s_stage2FifoReg = s_combinedPolicy[1:0];
@@ -520,29 +635,70 @@ module icache   ( input wire         clock,
   wire [1:0] s_lruSelect = {s_stage3Hit4Reg | s_stage3Hit3Reg, s_stage3Hit4Reg | s_stage3Hit2Reg};
     
   always @*
-    if (s_internalStall == 1'b1) s_stage3ReplacementWayNext <= s_stage3ReplacementWayReg;
-    else case (replacementPolicy)
+    case (replacementPolicy)
       FIFO_REPLACEMENT : case (s_stage2FifoReg)
-                           2'b00   : s_stage3ReplacementWayNext <= 4'h1;
-                           2'b01   : s_stage3ReplacementWayNext <= 4'h2;
-                           2'b10   : s_stage3ReplacementWayNext <= 4'h4;
-                           default : s_stage3ReplacementWayNext <= 4'h8;
+                           2'b00   : s_policyReplacementWay <= 4'h1;
+                           2'b01   : s_policyReplacementWay <= 4'h2;
+                           2'b10   : s_policyReplacementWay <= 4'h4;
+                           default : s_policyReplacementWay <= 4'h8;
                          endcase
       PLRU_REPLACEMENT : if (s_stage2PlruReg[4] == 1'b1)
                            begin
-                             s_stage3ReplacementWayNext[3:2] <= 2'b00;
-                             s_stage3ReplacementWayNext[1:0] <= (s_stage2PlruReg[1:0] == 2'b00 || s_stage2PlruReg[1:0] == 2'b11) ? 2'b01 : ~s_stage2PlruReg[1:0];
+                             s_policyReplacementWay[3:2] <= 2'b00;
+                             s_policyReplacementWay[1:0] <= (s_stage2PlruReg[1:0] == 2'b00 || s_stage2PlruReg[1:0] == 2'b11) ? 2'b01 : ~s_stage2PlruReg[1:0];
                            end
                          else
                            begin
-                             s_stage3ReplacementWayNext[1:0] <= 2'b00;
-                             s_stage3ReplacementWayNext[3:2] <= (s_stage2PlruReg[3:2] == 2'b00 || s_stage2PlruReg[3:2] == 2'b11) ? 2'b01 : ~s_stage2PlruReg[3:2];
+                             s_policyReplacementWay[1:0] <= 2'b00;
+                             s_policyReplacementWay[3:2] <= (s_stage2PlruReg[3:2] == 2'b00 || s_stage2PlruReg[3:2] == 2'b11) ? 2'b01 : ~s_stage2PlruReg[3:2];
                            end
-      default          : s_stage3ReplacementWayNext <= (s_stage2Lru1Reg == 2'b00) ? 4'h1 :
-                                                       (s_stage2Lru2Reg == 2'b00) ? 4'h2 :
-                                                       (s_stage2Lru3Reg == 2'b00) ? 4'h4 : 4'h8;
+      default          : s_policyReplacementWay <= (s_stage2Lru1Reg == 2'b00) ? 4'h1 :
+                                                   (s_stage2Lru2Reg == 2'b00) ? 4'h2 :
+                                                   (s_stage2Lru3Reg == 2'b00) ? 4'h4 : 4'h8;
     endcase
   
+  /*
+   *
+   * Here the way locking is defined; lockedWays excludes the highest ways from
+   * replacement and lockFill places all misses into the way that is locked next
+   * (see the d-cache for details). Locking has no effect when direct mapped.
+   *
+   */
+  wire s_lockActive = (numberOfWays != DIRECT_MAPPED && (lockedWays != 2'd0 || lockFill == 1'b1)) ? 1'b1 : 1'b0;
+  wire [3:0] s_usableWays = (numberOfWays == FOUR_WAY_SET_ASSOCIATIVE) ? 4'hF : 4'h3;
+  wire [3:0] s_allowedWays = (lockFill == 1'b1) ? s_fillWayMask : s_usableWays & ~s_lockedWayMask;
+  wire [3:0] s_firstAllowedWay = (s_allowedWays[0] == 1'b1) ? 4'h1 :
+                                 (s_allowedWays[1] == 1'b1) ? 4'h2 :
+                                 (s_allowedWays[2] == 1'b1) ? 4'h4 : 4'h8;
+  wire [3:0] s_stage3ReplacementWayNext = (s_internalStall == 1'b1 || s_cacheStateReg != IDLE) ? s_stage3ReplacementWayReg :
+                                          (s_lockActive == 1'b0 || (s_policyReplacementWay & s_allowedWays) != 4'h0) ? s_policyReplacementWay : s_firstAllowedWay;
+  
+  always @*
+    if (numberOfWays == FOUR_WAY_SET_ASSOCIATIVE)
+      case (lockedWays)
+        2'd0    : begin
+                    s_lockedWayMask <= 4'b0000;
+                    s_fillWayMask   <= 4'b1000;
+                  end
+        2'd1    : begin
+                    s_lockedWayMask <= 4'b1000;
+                    s_fillWayMask   <= 4'b0100;
+                  end
+        2'd2    : begin
+                    s_lockedWayMask <= 4'b1100;
+                    s_fillWayMask   <= 4'b0010;
+                  end
+        default : begin
+                    s_lockedWayMask <= 4'b1110;
+                    s_fillWayMask   <= 4'b0001;
+                  end
+      endcase
+    else
+      begin
+        s_lockedWayMask <= (lockedWays == 2'd0) ? 4'b0000 : 4'b0010;
+        s_fillWayMask   <= (lockedWays == 2'd0) ? 4'b0010 : 4'b0001;
+      end
+  
   always @*
     if (s_cacheStateReg == UPDATE_TAGS)
       case (numberOfWays)
@@ -618,16 +774,18 @@ module icache   ( input wire         clock,
       s_stage3ReplacementWayReg <= s_stage3ReplacementWayNext;
     end
   
-  sram512X32Dp policyRam ( .clockA(clock),
-                           .writeEnableA(1'b0),
-                           .addressA(s_tagStateLookupIndex),
-                           .dataInA( {32{1'b0}} ),
-                           .dataOutA(s_combinedPolicy),
-                           .clockB(clock),
-                           .writeEnableB(s_weNewPolicy),
-                           .addressB(s_tagIndex),
-                           .dataInB(s_newCombinedPolicy),
-                           .dataOutB(s_dummyPolicy));
+  sramDp #( .nrOfAddressBits(MaximumSetBits),
+            .nrOfDataBits(32)) policyRam
+          ( .clockA(clock),
+            .writeEnableA(1'b0),
+            .addressA(s_tagStateLookupIndex[MaximumSetBits-1:0]),
+            .dataInA( {32{1'b0}} ),
+            .dataOutA(s_combinedPolicy),
+            .clockB(clock),
+            .writeEnableB(s_weNewPolicy),
+            .addressB(s_tagIndex[MaximumSetBits-1:0]),
+            .dataInB(s_newCombinedPolicy),
+            .dataOutB(s_dummyPolicy));
 
   /*
    *
@@ -638,18 +796,20 @@ module icache   ( input wire         clock,
   reg [3:0] s_myBurstCountReg;
   reg [7:0] s_burstSizeOutReg;
   reg [31:0] s_busAddressReg;
+  reg s_wrapBurstOutReg;
   wire s_beginTransactionOutNext = (s_cacheStateReg == INIT_TRANSACTION) ? 1'b1 : 1'b0;
   wire s_weBusRegs = (s_cacheStateReg == INIT_TRANSACTION) ? 1'b1 : 1'b0;
   wire [7:0] s_burstSizeOutNext = (s_weBusRegs == 1'b0 || s_cacheEnabledReg == 1'b0) ? 8'h00 : 8'h07;
   wire [31:0] s_busAddressNext = (s_weBusRegs == 1'b0) ? {32{1'b0}} :
-                                 (s_cacheEnabledReg == 1'b0) ? s_stage3PcReg : {s_stage3PcReg[31:5], {5{1'b0}}};
+                                 (s_cacheEnabledReg == 1'b0) ? s_stage3PcReg : {s_stage3PcReg[31:2], 2'b00};
   wire s_busErrorNext = (busAccessGranted == 1'b1 || reset == 1'b1) ? 1'b0 : s_busErrorReg | busErrorIn;
   wire s_forceControlNext = (endTransactionIn == 1'b1 || reset == 1'b1) ? 1'b0 : s_forceControlReg | busAccessGranted;
   wire s_validDataIn = dataValidIn & ~busyIn & s_forceControlReg;
   wire [3:0] s_myBurstCountNext = (busAccessGranted == 1'b1 || reset == 1'b1) ? 4'h0 :
                                   (s_myBurstCountReg != 4'hF &
                                    s_validDataIn == 1'b1) ? s_myBurstCountReg + 4'd1 : s_myBurstCountReg;
-  wire [2:0] s_wordBurstSelectNext = (reset == 1'b1 || busAccessGranted == 1'b1) ? 3'b000 :
+  wire [2:0] s_wordBurstSelectNext = (reset == 1'b1) ? 3'b000 :
+                                     (busAccessGranted == 1'b1) ? s_stage3Word :
                                      (s_busDataInValidReg == 1'b1) ? s_wordBurstSelectReg + 3'd1 : s_wordBurstSelectReg;
   wire s_busDataInValidNext = s_validDataIn & ~reset;
   wire [31:0] s_busDataInNext = (s_validDataIn == 1'b1) ? addressDataIn : s_busDataInReg;
@@ -658,6 +818,7 @@ module icache   ( input wire         clock,
   assign beginTransactionOut = s_beginTransactionOutReg;
   assign byteEnablesOut = (s_beginTransactionOutReg == 1'b1) ? 4'hF : 4'h0;
   assign burstSizeOut = s_burstSizeOutReg;
+  assign wrapBurstOut = s_wrapBurstOutReg;
   assign addressDataOut = (s_beginTransactionOutReg == 1'b1) ? s_busAddressReg : {32{1'b0}};
   assign readNotWriteOut = s_beginTransactionOutReg;
   
@@ -665,6 +826,7 @@ module icache   ( input wire         clock,
     begin
       s_beginTransactionOutReg <= s_beginTransactionOutNext;
       s_burstSizeOutReg        <= s_burstSizeOutNext;
+      s_wrapBurstOutReg        <= s_weBusRegs & s_cacheEnabledReg;
       s_busAddressReg          <= s_busAddressNext;
       s_busErrorReg            <= s_busErrorNext;
       s_forceControlReg        <= s_forceControlNext;
@@ -680,7 +842,8 @@ module icache   ( input wire         clock,
    *
    */
   assign s_internalStall = s_flushActiveReg |
-                           (s_stage3ActivePcReg & ~s_stage3ValidReg & ~s_stage3Hit1Reg & ~s_stage3Hit2Reg & ~s_stage3Hit3Reg & ~s_stage3Hit4Reg);
+                           (s_stage3ActivePcReg & ~(s_stage3ValidReg & (s_cacheStateReg != RELEASE)) &
+                            ~s_stage3Hit1Reg & ~s_stage3Hit2Reg & ~s_stage3Hit3Reg & ~s_stage3Hit4Reg);
   assign s_busError = (s_cacheStateReg == RELEASE &&
                        (s_busErrorReg == 1'b1 ||
                         (s_cacheEnabledReg == 1'b0 && s_myBurstCountReg != 4'h1) ||
@@ -704,7 +867,7 @@ module icache   ( input wire         clock,
       NOP              : s_cacheStateNext <= (s_cacheEnabledReg == 1'b1) ? UPDATE_TAGS : RELEASE;
       UPDATE_TAGS      : s_cacheStateNext <= RELEASE;
       FLUSH_INIT       : s_cacheStateNext <= DO_FLUSH;
-      DO_FLUSH         : s_cacheStateNext <= (s_flushCounterReg == 8'hFF) ? FLUSH_DONE : DO_FLUSH;
+      DO_FLUSH         : s_cacheStateNext <= (s_flushCounterReg[MaximumSetBits-1:0] == {MaximumSetBits{1'b1}}) ? FLUSH_DONE : DO_FLUSH;
       default          : s_cacheStateNext <= IDLE;
     endcase
     
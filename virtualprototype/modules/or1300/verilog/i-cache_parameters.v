@@ -2,23 +2,31 @@
   localparam [1:0] TWO_WAY_SET_ASSOCIATIVE  = 2'b01;
   localparam [1:0] FOUR_WAY_SET_ASSOCIATIVE = 2'b10;
   
-  localparam [3:0] DIRECT_MAPPED_1K            = 4'b0000;
-  localparam [3:0] DIRECT_MAPPED_2K            = 4'b0001;
-  localparam [3:0] DIRECT_MAPPED_4K            = 4'b0010;
-  localparam [3:0] DIRECT_MAPPED_8K            = 4'b0011;
-  localparam [3:0] TWO_WAY_SET_ASSOCIATIVE_1K  = 4'b0100;
-  localparam [3:0] TWO_WAY_SET_ASSOCIATIVE_2K  = 4'b0101;
-  localparam [3:0] TWO_WAY_SET_ASSOCIATIVE_4K  = 4'b0110;
-  localparam [3:0] TWO_WAY_SET_ASSOCIATIVE_8K  = 4'b0111;
-  localparam [3:0] FOUR_WAY_SET_ASSOCIATIVE_1K = 4'b1000;
-  localparam [3:0] FOUR_WAY_SET_ASSOCIATIVE_2K = 4'b1001;
-  localparam [3:0] FOUR_WAY_SET_ASSOCIATIVE_4K = 4'b1010;
-  localparam [3:0] FOUR_WAY_SET_ASSOCIATIVE_8K = 4'b1011;
+  localparam [4:0] DIRECT_MAPPED_1K             = 5'b00000;
+  localparam [4:0] DIRECT_MAPPED_2K             = 5'b00001;
+  localparam [4:0] DIRECT_MAPPED_4K             = 5'b00010;
+  localparam [4:0] DIRECT_MAPPED_8K             = 5'b00011;
+  localparam [4:0] DIRECT_MAPPED_16K            = 5'b00100;
+  localparam [4:0] DIRECT_MAPPED_32K            = 5'b00101;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_1K   = 5'b01000;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_2K   = 5'b01001;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_4K   = 5'b01010;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_8K   = 5'b01011;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_16K  = 5'b01100;
+  localparam [4:0] TWO_WAY_SET_ASSOCIATIVE_32K  = 5'b01101;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_1K  = 5'b10000;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_2K  = 5'b10001;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_4K  = 5'b10010;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_8K  = 5'b10011;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_16K = 5'b10100;
+  localparam [4:0] FOUR_WAY_SET_ASSOCIATIVE_32K = 5'b10101;
   
-  localparam [1:0] SIZE_1K = 2'b00;
-  localparam [1:0] SIZE_2K = 2'b01;
-  localparam [1:0] SIZE_4K = 2'b10;
-  localparam [1:0] SIZE_8K = 2'b11;
+  localparam [2:0] SIZE_1K  = 3'b000;
+  localparam [2:0] SIZE_2K  = 3'b001;
+  localparam [2:0] SIZE_4K  = 3'b010;
+  localparam [2:0] SIZE_8K  = 3'b011;
+  localparam [2:0] SIZE_16K = 3'b100;
+  localparam [2:0] SIZE_32K = 3'b101;
 
   localparam [1:0] FIFO_REPLACEMENT         = 2'b00;
   localparam [1:0] PLRU_REPLACEMENT         = 2'b01;
@@ -1,7 +1,9 @@
 module or1300Top #( parameter [2:0] processorId = 1,
                     parameter [2:0] NumberOfProcessors = 1,
                     parameter nrOfBreakpoints = 8,
-                    parameter ReferenceClockFrequencyInHz = 12000000 )
+                    parameter ReferenceClockFrequencyInHz = 12000000,
+                    parameter [2:0] ICacheMaximumSize = 3'd3,
+                    parameter [2:0] DCacheMaximumSize = 3'd3 )
                   ( input wire         clock,
                                        referenceClock,
                                        reset,
@@ -90,7 +92,8 @@ module or1300Top #( parameter [2:0] processorId = 1,
                     output wire        privateDirtyOut,
                     input wire         privateDirtyIn,
                     output wire [7:0]  burstSizeOut,
-                    input wire [7:0]   burstSizeIn);
+                    input wire [7:0]   burstSizeIn,
+                    output wire        wrapBurstOut);
 
   wire        s_debugWeSprData, s_debugReSprData;
   wire [31:0] s_debugSprDataOut;
@@ -110,10 +113,13 @@ module or1300Top #( parameter [2:0] processorId = 1,
   wire [29:0] s_ebuPcLoadValue, s_exeJumpRegister;
   wire [7:0] s_icacheBurstSizeOut;
   wire [3:0] s_icacheByteEnablesOut;
-  wire [1:0] s_icacheReplacementPolicy, s_icacheSize, s_icacheNumberOfWays;
-  wire s_icacheReadNotWriteOut, s_instructionFetch, s_icacheMiss, s_icacheMissActive, s_icacheFlushActive, s_cacheInsertedNop;
+  wire [1:0] s_icacheReplacementPolicy, s_icacheNumberOfWays, s_icacheLockedWays;
+  wire [2:0] s_icacheSize;
+  wire s_icacheLockFill;
+  wire s_icacheReadNotWriteOut, s_icacheWrapBurstOut, s_instructionFetch, s_icacheMiss, s_icacheMissActive, s_icacheFlushActive, s_cacheInsertedNop;
   
-  icache theIcache ( .clock(clock),
+  icache #( .MaximumCacheSize(ICacheMaximumSize)) theIcache
+                   ( .clock(clock),
                      .reset(reset),
                      .requestBus(icacheRequestBus),
                      .busAccessGranted(icacheBusAccessGranted),
@@ -127,6 +133,7 @@ module or1300Top #( parameter [2:0] processorId = 1,
                      .dataValidIn(dataValidIn),
                      .busyIn(busyIn),
                      .burstSizeOut(s_icacheBurstSizeOut),
+                     .wrapBurstOut(s_icacheWrapBurstOut),
                      .instructionFetch(s_instructionFetch),
                      .cacheMiss(s_icacheMiss),
                      .cacheMissActive(s_icacheMissActive),
@@ -141,6 +148,8 @@ module or1300Top #( parameter [2:0] processorId = 1,
                      .cacheSize(s_icacheSize),
                      .numberOfWays(s_icacheNumberOfWays),
                      .cacheEnabled(s_icacheEnabled),
+                     .lockFill(s_icacheLockFill),
+                     .lockedWays(s_icacheLockedWays),
                      .loadPc(s_ebuLoadPc),
                      .jump(s_idecJump),
                      .pcLoadValue(s_ebuPcLoadValue),
@@ -376,18 +385,21 @@ module or1300Top #( parameter [2:0] processorId = 1,
    *
    */
   
-  wire        s_flushDcache, s_dcacheBeginTransactionOut, s_dcacheReadNotWriteOut, s_ebuMemorySync;
+  wire        s_flushDcache, s_dcacheBeginTransactionOut, s_dcacheReadNotWriteOut, s_dcacheWrapBurstOut, s_ebuMemorySync;
   wire [31:0] s_dcacheAddressDataOut, s_dcacheAbortAddress, s_dcacheAbortMemoryAddress;
   wire [3:0]  s_dcacheByteEnablesOut;
   wire [7:0]  s_dcacheBurstSizeOut;
-  wire [1:0]  s_dcacheReplacementPolicy, s_dcacheNumberOfWays, s_dcacheCacheSize;
+  wire [1:0]  s_dcacheReplacementPolicy, s_dcacheNumberOfWays, s_dcachePrefetchMode, s_dcacheLockedWays;
+  wire [2:0]  s_dcacheCacheSize;
   wire        s_dcacheWriteBackPolicy, s_dcacheCoherenceEnabled, s_dcacheMesiEnabled, s_dcacheSnarfingEnabled;
-  wire        s_dcacheDataAbort, s_dcacheEnabled;
+  wire        s_dcacheDataAbort, s_dcacheEnabled, s_dcacheVictimEnabled, s_dcacheLockFill;
   wire        s_cachedWrite, s_cachedRead, s_uncachedWrite, s_uncachedRead, s_swapInstruction;
   wire        s_casInstruction, s_cacheMiss, s_cacheWriteBack, s_dataStall, s_writeStall;
-  wire        s_processorStall, s_cacheStall, s_writeThrough, s_invalidate;
+  wire        s_processorStall, s_cacheStall, s_writeThrough, s_invalidate, s_prefetch, s_prefetchHit;
+  wire        s_postedWrite, s_writeBufferStall, s_victimHit;
   
-  dCache datacache ( .clock(clock),
+  dCache #( .MaximumCacheSize(DCacheMaximumSize)) datacache
+                   ( .clock(clock),
                      .reset(reset),
                      .flushCache(s_flushDcache),
                      .pipelineStall(s_stall),
@@ -412,6 +424,7 @@ module or1300Top #( parameter [2:0] processorId = 1,
                      .privateDirtyIn(privateDirtyIn),
                      .burstSizeOut(s_dcacheBurstSizeOut),
                      .burstSizeIn(burstSizeIn),
+                     .wrapBurstOut(s_dcacheWrapBurstOut),
                      .dataToSpm(dataToSpm),
                      .dataFromSpm(dataFromSpm),
                      .spmAddress(spmAddress),
@@ -432,12 +445,21 @@ module or1300Top #( parameter [2:0] processorId = 1,
                      .cacheStall(s_cacheStall),
                      .writeThrough(s_writeThrough),
                      .invalidate(s_invalidate),
+                     .prefetch(s_prefetch),
+                     .prefetchHit(s_prefetchHit),
+                     .postedWrite(s_postedWrite),
+                     .writeBufferStall(s_writeBufferStall),
+                     .victimHit(s_victimHit),
                      .stallCpu(s_dcacheStall),
                      .enableCache(s_dcacheEnabled),
                      .memorySync(s_ebuMemorySync),
                      .replacementPolicy(s_dcacheReplacementPolicy),
                      .numberOfWays(s_dcacheNumberOfWays),
                      .cacheSize(s_dcacheCacheSize),
+                     .prefetchMode(s_dcachePrefetchMode),
+                     .victimEnabled(s_dcacheVictimEnabled),
+                     .lockFill(s_dcacheLockFill),
+                     .lockedWays(s_dcacheLockedWays),
                      .writeBackPolicy(s_dcacheWriteBackPolicy),
                      .coherenceEnabled(s_dcacheCoherenceEnabled),
                      .mesiEnabled(s_dcacheMesiEnabled),
@@ -480,7 +502,9 @@ module or1300Top #( parameter [2:0] processorId = 1,
    registerFile #( .processorId(processorId),
                    .NumberOfProcessors(NumberOfProcessors),
                    .nrOfBreakpoints(nrOfBreakpoints),
-                   .ReferenceClockFrequencyInHz(ReferenceClockFrequencyInHz)) registers
+                   .ReferenceClockFrequencyInHz(ReferenceClockFrequencyInHz),
+                   .ICacheMaximumSize(ICacheMaximumSize),
+                   .DCacheMaximumSize(DCacheMaximumSize)) registers
                  ( .clock(clock),
                    .referenceClock(referenceClock),
                    .reset(reset),
@@ -498,14 +522,20 @@ module or1300Top #( parameter [2:0] processorId = 1,
                    .dcacheSnarfingEnabled(s_dcacheSnarfingEnabled),
                    .dcacheMesiEnabled(s_dcacheMesiEnabled),
                    .dcacheCoherenceEnabled(s_dcacheCoherenceEnabled),
+                   .dcacheVictimEnabled(s_dcacheVictimEnabled),
+                   .dcacheLockFill(s_dcacheLockFill),
                    .dcacheSize(s_dcacheCacheSize),
                    .dcacheReplacementPolicy(s_dcacheReplacementPolicy),
                    .dcacheNumberOfWays(s_dcacheNumberOfWays),
+                   .dcachePrefetchMode(s_dcachePrefetchMode),
+                   .dcacheLockedWays(s_dcacheLockedWays),
                    .icacheEnabled(s_icacheEnabled),
                    .icacheFlush(s_flushIcache),
+                   .icacheLockFill(s_icacheLockFill),
                    .icacheSize(s_icacheSize),
                    .icacheReplacementPolicy(s_icacheReplacementPolicy),
                    .icacheNumberOfWays(s_icacheNumberOfWays),
+                   .icacheLockedWays(s_icacheLockedWays),
                    .instructionAddress(s_icacheInstructionAddress),
                    .writeAddress(s_exeWriteAddress),
                    .writeData(s_exeWriteData),
@@ -695,6 +725,11 @@ module or1300Top #( parameter [2:0] processorId = 1,
                             .profilingDCacheStall(s_cacheStall),
                             .profilingDCacheWriteThrough(s_writeThrough),
                             .profilingDCacheInvalidate(s_invalidate),
+                            .profilingDCachePrefetch(s_prefetch),
+                            .profilingDCachePrefetchHit(s_prefetchHit),
+                            .profilingDCachePostedWrite(s_postedWrite),
+                            .profilingDCacheWriteBufferStall(s_writeBufferStall),
+                            .profilingDCacheVictimHit(s_victimHit),
                             .profilingBranchPenalty(s_branchPenalty),
                             .profilingComittedInstruction(s_comittedInstruction),
                             .profilingStall(s_stall),
@@ -765,4 +800,5 @@ module or1300Top #( parameter [2:0] processorId = 1,
   assign byteEnablesOut      = s_icacheByteEnablesOut | s_dcacheByteEnablesOut;
   assign readNotWriteOut     = s_icacheReadNotWriteOut | s_dcacheReadNotWriteOut;
   assign burstSizeOut        = s_icacheBurstSizeOut | s_dcacheBurstSizeOut;
+  assign wrapBurstOut        = s_icacheWrapBurstOut | s_dcacheWrapBurstOut;
 endmodule
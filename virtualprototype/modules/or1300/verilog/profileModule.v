@@ -24,6 +24,11 @@ module profilingModule ( input wire        reset,
                                            profilingDCacheStall,
                                            profilingDCacheWriteThrough,
                                            profilingDCacheInvalidate,
+                                           profilingDCachePrefetch,
+                                           profilingDCachePrefetchHit,
+                                           profilingDCachePostedWrite,
+                                           profilingDCacheWriteBufferStall,
+                                           profilingDCacheVictimHit,
                                            profilingBranchPenalty,
                                            profilingComittedInstruction,
                                            profilingStall,
@@ -33,9 +38,10 @@ module profilingModule ( input wire        reset,
                          output wire [31:0] dataToCore );
 
         wire [31:0] s_cpuEvents;
-        assign s_cpuEvents[31:30] = 2'd0;
+        assign s_cpuEvents[31]  = profilingDCachePrefetchHit;
+        assign s_cpuEvents[30]  = profilingDCachePrefetch;
         assign s_cpuEvents[29]  = profilingDCacheInvalidate;
-        assign s_cpuEvents[28]  = 1'b0;
+        assign s_cpuEvents[28]  = profilingDCacheWriteThrough;
         assign s_cpuEvents[27]  = profilingDCacheStall;
         assign s_cpuEvents[26]  = profilingDCacheProcessorStall;
         assign s_cpuEvents[25]  = profilingDCacheWriteStall;
@@ -48,14 +54,15 @@ module profilingModule ( input wire        reset,
         assign s_cpuEvents[18]  = profilingDCacheCachedWrite;
         assign s_cpuEvents[17]  = profilingDCacheUncachedRead;
         assign s_cpuEvents[16]  = profilingDCacheUncachedWrite;
-        assign s_cpuEvents[15]  = 1'b0;
-        assign s_cpuEvents[14]  = 1'b0;
+        assign s_cpuEvents[15]  = profilingDCacheWriteBufferStall;
+        assign s_cpuEvents[14]  = profilingDCachePostedWrite;
         assign s_cpuEvents[13]  = snoopableBurst;
         assign s_cpuEvents[12]  = busIdle;
         assign s_cpuEvents[11]  = profilingStall;
         assign s_cpuEvents[10]  = profilingComittedInstruction;
         assign s_cpuEvents[9]   = profilingBranchPenalty;
-        assign s_cpuEvents[8:5] = 4'b0; 
+        assign s_cpuEvents[8]   = profilingDCacheVictimHit;
+        assign s_cpuEvents[7:5] = 3'b0; 
         assign s_cpuEvents[4]   = profilingICacheInsertedNop;
         assign s_cpuEvents[3]   = profilingICacheFlushActive;
         assign s_cpuEvents[2]   = profilingICacheMissActive;
@@ -12,7 +12,9 @@
 module registerFile #( parameter [2:0] processorId = 1,
                       parameter [2:0] NumberOfProcessors = 1,
                       parameter nrOfBreakpoints = 8,
-                      parameter ReferenceClockFrequencyInHz = 12000000 )
+                      parameter ReferenceClockFrequencyInHz = 12000000,
+                      parameter [2:0] ICacheMaximumSize = 3'd3,
+                      parameter [2:0] DCacheMaximumSize = 3'd3 )
                     ( input wire         clock,
                                          referenceClock,
                                          reset,
@@ -34,16 +36,22 @@ module registerFile #( parameter [2:0] processorId = 1,
                                          dcacheSnarfingEnabled,
                                          dcacheMesiEnabled,
                                          dcacheCoherenceEnabled,
-                      output wire [1:0]  dcacheSize,
-                                         dcacheReplacementPolicy,
+                                         dcacheVictimEnabled,
+                                         dcacheLockFill,
+                      output wire [2:0]  dcacheSize,
+                      output wire [1:0]  dcacheReplacementPolicy,
                                          dcacheNumberOfWays,
+                                         dcachePrefetchMode,
+                                         dcacheLockedWays,
 
                       // here the i-cache interface is defined
                       output wire        icacheEnabled,
                                          icacheFlush,
-                      output wire [1:0]  icacheSize,
-                                         icacheReplacementPolicy,
+                                         icacheLockFill,
+                      output wire [2:0]  icacheSize,
+                      output wire [1:0]  icacheReplacementPolicy,
                                          icacheNumberOfWays,
+                                         icacheLockedWays,
                       input wire [31:0]  instructionAddress,
                       
                       // here the write back interface is defined
@@ -284,15 +292,21 @@ module registerFile #( parameter [2:0] processorId = 1,
    * Here the i-cache control is defined
    *
    */
-  reg [1:0] s_iReplacementPolicyReg, s_iNumberOfWaysReg, s_iSizeReg;
-  reg s_flushICacheReg;
+  reg [1:0] s_iReplacementPolicyReg, s_iNumberOfWaysReg, s_iLockedWaysReg;
+  reg [2:0] s_iSizeReg;
+  reg s_flushICacheReg, s_iLockFillReg;
   reg [31:0] s_icacheConfigurationRegister;
   wire [1:0] s_iReplacementPolicyNext = (reset == 1'b1) ? 2'b10 :
                                         (writeSpr == 1'b1 && writeSprIndex == 16'h0006 && writeData[29] == 1'b0) ? writeData[17:16] : s_iReplacementPolicyReg;
+  wire [1:0] s_iLockedWaysNext = (reset == 1'b1) ? 2'b00 :
+                                 (writeSpr == 1'b1 && writeSprIndex == 16'h0006 && writeData[29] == 1'b0) ? writeData[15:14] : s_iLockedWaysReg;
+  wire s_iLockFillNext = (reset == 1'b1) ? 1'b0 :
+                         (writeSpr == 1'b1 && writeSprIndex == 16'h0006 && writeData[29] == 1'b0) ? writeData[9] : s_iLockFillReg;
   wire [1:0] s_iNumberOfWaysNext = (reset == 1'b1) ? 2'b01 :
                                    (writeSpr == 1'b1 && writeSprIndex == 16'h0006 && writeData[29] == 1'b0 && s_superVisionReg[4] == 1'b0) ? writeData[1:0] : s_iNumberOfWaysReg;
-  wire [1:0] s_nextIsize = writeData[31:30];
-  wire [1:0] s_iSizeNext = (reset == 1'b1) ? 2'b10 :
+  wire [2:0] s_writtenIsize = {writeData[28], writeData[31:30]};
+  wire [2:0] s_nextIsize = (s_writtenIsize > ICacheMaximumSize) ? ICacheMaximumSize : s_writtenIsize;
+  wire [2:0] s_iSizeNext = (reset == 1'b1) ? 3'b010 :
                            (writeSpr == 1'b1 && writeSprIndex == 16'h0006 && writeData[29] == 1'b0 && s_superVisionReg[4] == 1'b0) ? s_nextIsize : s_iSizeReg;
   wire s_flushICacheNext = (writeSpr == 1'b1 && writeSprIndex == 16'h0006 && stall == 1'b0) ? writeData[29] : 1'b0;
   
@@ -301,46 +315,67 @@ module registerFile #( parameter [2:0] processorId = 1,
   assign icacheFlush             = s_flushICacheReg;
   assign icacheSize              = s_iSizeReg;
   assign icacheNumberOfWays      = s_iNumberOfWaysReg;
+  assign icacheLockedWays        = s_iLockedWaysReg;
+  assign icacheLockFill          = s_iLockFillReg;
 
   always @(posedge clock)
     begin
       s_iReplacementPolicyReg <= s_iReplacementPolicyNext;
       s_iNumberOfWaysReg      <= s_iNumberOfWaysNext;
+      s_iLockedWaysReg        <= s_iLockedWaysNext;
+      s_iLockFillReg          <= s_iLockFillNext;
       s_iSizeReg              <= s_iSizeNext;
       s_flushICacheReg        <= s_flushICacheNext;
     end
   
   always @*
     begin
-      s_icacheConfigurationRegister[31:30] <= s_iSizeReg;
-      s_icacheConfigurationRegister[29:20] <= 10'd0;
+      s_icacheConfigurationRegister[31:30] <= s_iSizeReg[1:0];
+      s_icacheConfigurationRegister[29]    <= 1'b0;
+      s_icacheConfigurationRegister[28]    <= s_iSizeReg[2];
+      s_icacheConfigurationRegister[27:25] <= ICacheMaximumSize;
+      s_icacheConfigurationRegister[24:20] <= 5'd0;
       s_icacheConfigurationRegister[19]    <= s_superVisionReg[4];
       s_icacheConfigurationRegister[18]    <= 1'b0;
       s_icacheConfigurationRegister[17:16] <= s_iReplacementPolicyReg;
-      s_icacheConfigurationRegister[15:7]  <= 9'd1;
+      s_icacheConfigurationRegister[15:14] <= s_iLockedWaysReg;
+      s_icacheConfigurationRegister[13:12] <= 2'b10;
+      s_icacheConfigurationRegister[11:10] <= 2'd0;
+      s_icacheConfigurationRegister[9]     <= s_iLockFillReg;
+      s_icacheConfigurationRegister[8:7]   <= 2'd1;
       s_icacheConfigurationRegister[2]     <= 1'b0;
       s_icacheConfigurationRegister[1:0]   <= s_iNumberOfWaysReg;
       case (s_iSizeReg)
-        2'b00   : case (s_iNumberOfWaysReg)
+        3'b000  : case (s_iNumberOfWaysReg)
                     2'b01   : s_icacheConfigurationRegister[6:3] <= 4'h5;
                     2'b10   : s_icacheConfigurationRegister[6:3] <= 4'h4;
                     default : s_icacheConfigurationRegister[6:3] <= 4'h6;
                   endcase
-        2'b01   : case (s_iNumberOfWaysReg)
+        3'b001  : case (s_iNumberOfWaysReg)
                     2'b01   : s_icacheConfigurationRegister[6:3] <= 4'h6;
                     2'b10   : s_icacheConfigurationRegister[6:3] <= 4'h5;
                     default : s_icacheConfigurationRegister[6:3] <= 4'h7;
                   endcase
-        2'b10   : case (s_iNumberOfWaysReg)
+        3'b010  : case (s_iNumberOfWaysReg)
                     2'b01   : s_icacheConfigurationRegister[6:3] <= 4'h7;
                     2'b10   : s_icacheConfigurationRegister[6:3] <= 4'h6;
                     default : s_icacheConfigurationRegister[6:3] <= 4'h8;
                   endcase
-        default : case (s_iNumberOfWaysReg)
+        3'b011  : case (s_iNumberOfWaysReg)
                     2'b01   : s_icacheConfigurationRegister[6:3] <= 4'h8;
                     2'b10   : s_icacheConfigurationRegister[6:3] <= 4'h7;
                     default : s_icacheConfigurationRegister[6:3] <= 4'h9;
                   endcase
+        3'b100  : case (s_iNumberOfWaysReg)
+                    2'b01   : s_icacheConfigurationRegister[6:3] <= 4'h9;
+                    2'b10   : s_icacheConfigurationRegister[6:3] <= 4'h8;
+                    default : s_icacheConfigurationRegister[6:3] <= 4'hA;
+                  endcase
+        default : case (s_iNumberOfWaysReg)
+                    2'b01   : s_icacheConfigurationRegister[6:3] <= 4'hA;
+                    2'b10   : s_icacheConfigurationRegister[6:3] <= 4'h9;
+                    default : s_icacheConfigurationRegister[6:3] <= 4'hB;
+                  endcase
       endcase
     end
   
@@ -349,11 +384,21 @@ module registerFile #( parameter [2:0] processorId = 1,
    * Here the d-cache control is defined
    *
    */
-  reg [1:0] s_dReplacementPolicyReg, s_dNumberOfWaysReg, s_dSizeReg;
+  reg [1:0] s_dReplacementPolicyReg, s_dNumberOfWaysReg, s_dPrefetchModeReg, s_dLockedWaysReg;
+  reg [2:0] s_dSizeReg;
   reg s_dWriteBackReg, s_dCoherenceEnabledReg, s_dMesiEnabledReg, s_dSnarfingEnabledReg, s_flushDCacheReg;
+  reg s_dVictimEnabledReg, s_dLockFillReg;
   reg [31:0] s_dcacheConfigurationRegister;
   wire [1:0] s_dReplacementPolicyNext = (reset == 1'b1) ? 2'b10 :
                                         (writeSpr == 1'b1 && writeSprIndex == 16'h0005 && writeData[29] == 1'b0) ? writeData[17:16] : s_dReplacementPolicyReg;
+  wire [1:0] s_dPrefetchModeNext = (reset == 1'b1) ? 2'b00 :
+                                   (writeSpr == 1'b1 && writeSprIndex == 16'h0005 && writeData[29] == 1'b0) ? writeData[23:22] : s_dPrefetchModeReg;
+  wire s_dVictimEnabledNext = (reset == 1'b1) ? 1'b0 :
+                              (writeSpr == 1'b1 && writeSprIndex == 16'h0005 && writeData[29] == 1'b0) ? writeData[24] : s_dVictimEnabledReg;
+  wire [1:0] s_dLockedWaysNext = (reset == 1'b1) ? 2'b00 :
+                                 (writeSpr == 1'b1 && writeSprIndex == 16'h0005 && writeData[29] == 1'b0) ? writeData[15:14] : s_dLockedWaysReg;
+  wire s_dLockFillNext = (reset == 1'b1) ? 1'b0 :
+                         (writeSpr == 1'b1 && writeSprIndex == 16'h0005 && writeData[29] == 1'b0) ? writeData[9] : s_dLockFillReg;
   wire s_dWriteBackNext = (reset == 1'b1) ? 1'b1 :
                           (writeSpr == 1'b1 && writeSprIndex == 16'h0005 && writeData[29] == 1'b0) ? writeData[8] : s_dWriteBackReg;
   wire s_dSnarfingEnabledNext = (reset == 1'b1) ? 1'b1 :
@@ -362,8 +407,10 @@ module registerFile #( parameter [2:0] processorId = 1,
                             (writeSpr == 1'b1 && writeSprIndex == 16'h0005 && writeData[29] == 1'b0) ? writeData[20] : s_dMesiEnabledReg;
   wire [1:0] s_dNumberOfWaysNext = (reset == 1'b1) ? 2'b10 :
                                    (writeSpr == 1'b1 && writeSprIndex == 16'h0005 && writeData[29] == 1'b0 && s_superVisionReg[3] == 1'b0) ? writeData[1:0] : s_dNumberOfWaysReg;
-  wire [1:0] s_dSizeNext = (reset == 1'b1) ? 2'b10 :
-                           (writeSpr == 1'b1 && writeSprIndex == 16'h0005 && writeData[29] == 1'b0 && s_superVisionReg[3] == 1'b0) ? writeData[31:30] : s_dSizeReg;
+  wire [2:0] s_writtenDsize = {writeData[28], writeData[31:30]};
+  wire [2:0] s_nextDsize = (s_writtenDsize > DCacheMaximumSize) ? DCacheMaximumSize : s_writtenDsize;
+  wire [2:0] s_dSizeNext = (reset == 1'b1) ? 3'b010 :
+                           (writeSpr == 1'b1 && writeSprIndex == 16'h0005 && writeData[29] == 1'b0 && s_superVisionReg[3] == 1'b0) ? s_nextDsize : s_dSizeReg;
   wire s_dCoherenceEnabledNext = (reset == 1'b1) ? 1'b0 :
                                  (writeSpr == 1'b1 && writeSprIndex == 16'h0005 && writeData[29] == 1'b0 && s_superVisionReg[3] == 1'b0) ? writeData[18] : s_dCoherenceEnabledReg;
   wire s_flushDCacheNext = (writeSpr == 1'b1 && writeSprIndex == 16'h0005 && stall == 1'b0) ? writeData[29] : 1'b0;
@@ -377,10 +424,18 @@ module registerFile #( parameter [2:0] processorId = 1,
   assign dcacheCoherenceEnabled  = s_dCoherenceEnabledReg;
   assign dcacheSize              = s_dSizeReg;
   assign dcacheNumberOfWays      = s_dNumberOfWaysReg;
+  assign dcachePrefetchMode      = s_dPrefetchModeReg;
+  assign dcacheVictimEnabled     = s_dVictimEnabledReg;
+  assign dcacheLockedWays        = s_dLockedWaysReg;
+  assign dcacheLockFill          = s_dLockFillReg;
 
   always @(posedge clock)
     begin
       s_dReplacementPolicyReg <= s_dReplacementPolicyNext;
+      s_dPrefetchModeReg      <= s_dPrefetchModeNext;
+      s_dVictimEnabledReg     <= s_dVictimEnabledNext;
+      s_dLockedWaysReg        <= s_dLockedWaysNext;
+      s_dLockFillReg          <= s_dLockFillNext;
       s_dWriteBackReg         <= s_dWriteBackNext;
       s_dSnarfingEnabledReg   <= s_dSnarfingEnabledNext;
       s_dMesiEnabledReg       <= s_dMesiEnabledNext;
@@ -392,39 +447,56 @@ module registerFile #( parameter [2:0] processorId = 1,
   
   always @*
     begin
-      s_dcacheConfigurationRegister[31:30] <= s_dSizeReg;
-      s_dcacheConfigurationRegister[29:22] <= 8'd0;
+      s_dcacheConfigurationRegister[31:30] <= s_dSizeReg[1:0];
+      s_dcacheConfigurationRegister[29]    <= 1'b0;
+      s_dcacheConfigurationRegister[28]    <= s_dSizeReg[2];
+      s_dcacheConfigurationRegister[27:25] <= DCacheMaximumSize;
+      s_dcacheConfigurationRegister[24]    <= s_dVictimEnabledReg;
+      s_dcacheConfigurationRegister[23:22] <= s_dPrefetchModeReg;
       s_dcacheConfigurationRegister[21]    <= s_dSnarfingEnabledReg;
       s_dcacheConfigurationRegister[20]    <= s_dMesiEnabledReg;
       s_dcacheConfigurationRegister[19]    <= s_superVisionReg[3];
       s_dcacheConfigurationRegister[18]    <= s_dCoherenceEnabledReg;
       s_dcacheConfigurationRegister[17:16] <= s_dReplacementPolicyReg;
-      s_dcacheConfigurationRegister[15:9]  <= 7'd0;
+      s_dcacheConfigurationRegister[15:14] <= s_dLockedWaysReg;
+      s_dcacheConfigurationRegister[13:12] <= 2'b10;
+      s_dcacheConfigurationRegister[11:10] <= 2'd0;
+      s_dcacheConfigurationRegister[9]     <= s_dLockFillReg;
       s_dcacheConfigurationRegister[8]     <= s_dWriteBackReg;
       s_dcacheConfigurationRegister[7]     <= 1'd1;
       s_dcacheConfigurationRegister[2]     <= 1'd0;
       s_dcacheConfigurationRegister[1:0]   <= s_dNumberOfWaysReg;
       case (s_dSizeReg)
-        2'b00   : case (s_dNumberOfWaysReg)
+        3'b000  : case (s_dNumberOfWaysReg)
                     2'b01   : s_dcacheConfigurationRegister[6:3] <= 4'h5;
                     2'b10   : s_dcacheConfigurationRegister[6:3] <= 4'h4;
                     default : s_dcacheConfigurationRegister[6:3] <= 4'h6;
                   endcase
-        2'b01   : case (s_dNumberOfWaysReg)
+        3'b001  : case (s_dNumberOfWaysReg)
                     2'b01   : s_dcacheConfigurationRegister[6:3] <= 4'h6;
                     2'b10   : s_dcacheConfigurationRegister[6:3] <= 4'h5;
                     default : s_dcacheConfigurationRegister[6:3] <= 4'h7;
                   endcase
-        2'b10   : case (s_dNumberOfWaysReg)
+        3'b010  : case (s_dNumberOfWaysReg)
                     2'b01   : s_dcacheConfigurationRegister[6:3] <= 4'h7;
                     2'b10   : s_dcacheConfigurationRegister[6:3] <= 4'h6;
                     default : s_dcacheConfigurationRegister[6:3] <= 4'h8;
                   endcase
-        default : case (s_dNumberOfWaysReg)
+        3'b011  : case (s_dNumberOfWaysReg)
                     2'b01   : s_dcacheConfigurationRegister[6:3] <= 4'h8;
                     2'b10   : s_dcacheConfigurationRegister[6:3] <= 4'h7;
                     default : s_dcacheConfigurationRegister[6:3] <= 4'h9;
                   endcase
+        3'b100  : case (s_dNumberOfWaysReg)
+                    2'b01   : s_dcacheConfigurationRegister[6:3] <= 4'h9;
+                    2'b10   : s_dcacheConfigurationRegister[6:3] <= 4'h8;
+                    default : s_dcacheConfigurationRegister[6:3] <= 4'hA;
+                  endcase
+        default : case (s_dNumberOfWaysReg)
+                    2'b01   : s_dcacheConfigurationRegister[6:3] <= 4'hA;
+                    2'b10   : s_dcacheConfigurationRegister[6:3] <= 4'h9;
+                    default : s_dcacheConfigurationRegister[6:3] <= 4'hB;
+                  endcase
       endcase
     end
 
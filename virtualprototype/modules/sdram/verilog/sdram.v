@@ -17,6 +17,7 @@ module sdramController #( parameter [31:0] baseAddress = 32'h00000000,
                          input wire [31:0]  addressDataIn,
                          input wire [3:0]   byteEnablesIn,
                          input wire [7:0]   burstSizeIn,
+                         input wire         wrapBurstIn,
                          output wire        endTransactionOut,
                                             dataValidOut,
                                             busyOut,
@@ -64,7 +65,7 @@ module sdramController #( parameter [31:0] baseAddress = 32'h00000000,
   reg s_beginTransactionReg, s_readNotWriteReg, s_transactionActiveReg, s_dataInValidReg;
   reg [1:0]   s_busErrorShiftReg, s_dataOutValidReg;
   reg         s_endTransactionPendingReg, s_endTransactionReg;
-  reg         s_readPendingReg;
+  reg         s_readPendingReg, s_wrapBurstReg;
   reg [3:0]   s_byteEnablesReg;
   reg [31:0]  s_busAddressReg, s_busDataReg, s_dataOutReg;
   reg [7:0]   s_burstSizeReg;
@@ -101,6 +102,7 @@ module sdramController #( parameter [31:0] baseAddress = 32'h00000000,
       s_byteEnablesReg           <= (beginTransactionIn == 1'b1) ? byteEnablesIn : s_byteEnablesReg;
       s_busAddressReg            <= (beginTransactionIn == 1'b1) ? addressDataIn : s_busAddressReg;
       s_burstSizeReg             <= (beginTransactionIn == 1'b1) ? burstSizeIn : s_burstSizeReg;
+      s_wrapBurstReg             <= (beginTransactionIn == 1'b1) ? wrapBurstIn : s_wrapBurstReg;
       s_dataInValidReg           <= (s_isMyTransaction == 1'b1 && ~(s_delayedWriteDoneReg[0] == 1'b1 || s_sdramCurrentState == WRITE_PRECHARGE) && 
                                      s_readNotWriteReg == 1'b0 && s_writeCountReg[8] == 1'b0) ? dataValidIn : 1'b0;
       s_busDataReg               <= (dataValidIn == 1'b1) ? addressDataIn : s_busDataReg;
@@ -124,10 +126,12 @@ module sdramController #( parameter [31:0] baseAddress = 32'h00000000,
                      .readDataOut(s_readDataOut));
   /*
    *
-   * Here we define some read control signals
+   * Here we define some read control signals; a wrapping burst (critical word first line fill)
+   * is split into a burst up to the end of the 8 word line followed by a burst from the start
+   * of the line
    *
    */
-  wire [8:0] s_nrOfWordsLeft = 9'd256 - {1'b0,s_busAddressReg[9:2]};
+  wire [8:0] s_nrOfWordsLeft = (s_wrapBurstReg == 1'b1) ? 9'd8 - {6'd0,s_busAddressReg[4:2]} : 9'd256 - {1'b0,s_busAddressReg[9:2]};
   wire [8:0] s_realBurstSize = {1'd0,s_burstSizeReg} + 9'd1;
   wire [8:0] s_burstSize1 = (s_requiresTwoBursts == 1'b1) ? s_nrOfWordsLeft - 9'd1 : s_realBurstSize - 9'd1;
   wire [8:0] s_burstSize2 = (s_requiresTwoBursts == 1'b1) ? s_realBurstSize - s_nrOfWordsLeft - 9'd1 : 9'd0;
@@ -162,11 +166,12 @@ module sdramController #( parameter [31:0] baseAddress = 32'h00000000,
   reg [8:0]   s_columnAddressReg;
   reg [14:0]  s_rowAddressReg;
   wire [8:0]  s_columnAddressNext = (s_beginTransactionReg == 1'b1 && s_isMyTransaction == 1'b1 && s_sdramClkReg == 1'b1) ? {s_busAddressReg[9:2],1'b0} :
+                                    (s_sdramCurrentState == SECOND_BURST && s_wrapBurstReg == 1'b1 && s_sdramClkReg == 1'b1) ? {s_busAddressReg[9:5],4'd0} :
                                     ((s_sdramCurrentState == WAIT_WRITE_LO || s_sdramCurrentState == WAIT_WRITE_HI || s_sdramDataValidReg == 1'b1) && s_sdramClkReg == 1'b1) ? s_columnAddressReg + 9'd1 : 
                                     s_columnAddressReg;
   wire [14:0] s_rowAddressNext = (s_beginTransactionReg == 1'b1 && s_isMyTransaction == 1'b1 && s_sdramClkReg == 1'b1) ? s_busAddressReg[24:10] : 
                                  ((s_sdramCurrentState == WAIT_WRITE_LO || s_sdramCurrentState == WAIT_WRITE_HI || s_sdramDataValidReg == 1'b1) && 
-                                  s_sdramClkReg == 1'b1 && s_columnAddressReg == 9'b111111111) ? s_rowAddressReg + 9'd1 : s_rowAddressReg;
+                                  s_sdramClkReg == 1'b1 && s_columnAddressReg == 9'b111111111 && s_wrapBurstReg == 1'b0) ? s_rowAddressReg + 9'd1 : s_rowAddressReg;
   
   always @(posedge clockX2)
     begin
@@ -23,6 +23,7 @@ module testbench ( input wire clock,
                     .addressDataIn(addressDataIn),
                     .byteEnablesIn(byteEnablesIn),
                     .burstSizeIn(burstSizeIn),
+                    .wrapBurstIn(1'b0),
                     .endTransactionOut(endTransactionOut),
                     .dataValidOut(dataValidOut),
                     .busyOut(busyOut),
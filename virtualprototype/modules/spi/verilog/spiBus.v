@@ -27,6 +27,7 @@ module spiBus #( parameter [31:0] baseAddress = 32'h00000000,
                                     busErrorIn,
                  input wire [31:0]  addressDataIn,
                  input wire [7:0]   burstSizeIn,
+                 input wire         wrapBurstIn,
                  input wire [3:0]   byteEnablesIn,
                  output wire [31:0] addressDataOut,
                  output wire        endTransactionOut,
@@ -38,7 +39,7 @@ module spiBus #( parameter [31:0] baseAddress = 32'h00000000,
    * Here the bus input interface is defined
    *
    */
-  reg s_transactionActiveReg, s_readNotWriteReg, s_beginTransactionReg, s_endTransactionReg;
+  reg s_transactionActiveReg, s_readNotWriteReg, s_beginTransactionReg, s_endTransactionReg, s_wrapBurstReg;
   reg [3:0]  s_byteEnablesReg;
   reg [7:0]  s_burstSizeReg;
   reg [31:0] s_busAddressReg;
@@ -53,6 +54,7 @@ module spiBus #( parameter [31:0] baseAddress = 32'h00000000,
       s_readNotWriteReg      <= (beginTransactionIn == 1'b1) ? readNotWriteIn : s_readNotWriteReg;
       s_byteEnablesReg       <= (beginTransactionIn == 1'b1) ? byteEnablesIn : s_byteEnablesReg;
       s_burstSizeReg         <= (beginTransactionIn == 1'b1) ? burstSizeIn : s_burstSizeReg;
+      s_wrapBurstReg         <= (beginTransactionIn == 1'b1) ? wrapBurstIn : s_wrapBurstReg;
       s_beginTransactionReg  <= beginTransactionIn;
       s_endTransactionReg    <= endTransactionIn;
       busErrorOut            <= (reset == 1'b1 || endTransactionIn == 1'b1 || s_endTransactionReg == 1'b1) ? 1'b0 : s_busErrorOut;
@@ -108,13 +110,35 @@ module spiBus #( parameter [31:0] baseAddress = 32'h00000000,
       s_programData8    <= (s_isMyCustomInstruction == 1'b1 && ciDataB[5:0] == 5'h1F) ? ciDataA : s_programData8;
     end
 
+  /*
+   *
+   * Here the wrapping bursts are handled; the flash is read from the requested word up
+   * to the end of the 8 word line, followed by a second read from the start of the line
+   *
+   */
+  reg s_wrapPendingReg, s_secondReadReg, s_startSecondReadReg;
+  wire s_resetContReadMode, s_contReadModeEnabled, s_dataOutValid, s_quadBusy, s_singleBusy;
+  wire [2:0] s_wrapWord = s_busAddressReg[4:2];
+  wire s_readDone = s_dataOutValid & ~s_quadBusy;
+  wire [23:0] s_flashReadAddress = (s_secondReadReg == 1'b1) ? {s_busAddressReg[23:5], 5'd0} : s_busAddressReg[23:0];
+  wire [7:0] s_flashReadWords = (s_secondReadReg == 1'b1) ? {5'd0, s_wrapWord - 3'd1} :
+                                (s_wrapBurstReg == 1'b1 && s_wrapWord != 3'd0) ? {5'd0, 3'd7 - s_wrapWord} : s_burstSizeReg;
+  
+  always @(posedge clock)
+    begin
+      s_wrapPendingReg     <= (reset == 1'b1 || s_endTransactionReg == 1'b1 || s_readDone == 1'b1) ? 1'b0 :
+                              (s_startRead == 1'b1 && s_wrapBurstReg == 1'b1 && s_wrapWord != 3'd0) ? 1'b1 : s_wrapPendingReg;
+      s_startSecondReadReg <= ~reset & s_wrapPendingReg & s_readDone;
+      s_secondReadReg      <= (reset == 1'b1 || s_endTransactionReg == 1'b1 || s_startRead == 1'b1) ? 1'b0 :
+                              (s_wrapPendingReg == 1'b1 && s_readDone == 1'b1) ? 1'b1 : s_secondReadReg;
+    end
+
   /*
    *
    * Here the components are mapped
    *
    */
   reg  s_endTransReg;
-  wire s_resetContReadMode, s_contReadModeEnabled, s_dataOutValid, s_quadBusy, s_singleBusy;
   wire s_quadScl, s_quadNCs, s_singleScl, s_singleNCs, s_singleSiIo0;
   wire [3:0] s_quadSiIoOut, s_quadSiIoTristateEnable;
   wire [3:0] s_quadSiIoIn = {spiIo3,spiIo2,spiSoIo1,spiSiIo0};
@@ -122,14 +146,14 @@ module spiBus #( parameter [31:0] baseAddress = 32'h00000000,
   assign dataValidOut      = s_dataOutValid;
   assign endTransactionOut = s_endTransReg;
   
-  always @(posedge clock) s_endTransReg <= ~reset & s_transactionActiveReg & ((s_dataOutValid & ~s_quadBusy) | (busErrorIn & ~s_busErrorOut));
+  always @(posedge clock) s_endTransReg <= ~reset & s_transactionActiveReg & ((s_readDone & ~s_wrapPendingReg) | (busErrorIn & ~s_busErrorOut));
 
   spiShiftQuad quad ( .clock(clock),
                       .reset(reset),
                       .resetContReadMode(s_resetContReadMode),
-                      .start(s_startRead),
-                      .flashAddress(s_busAddressReg[23:0]),
-                      .nrOfWords(s_burstSizeReg),
+                      .start(s_startRead | s_startSecondReadReg),
+                      .flashAddress(s_flashReadAddress),
+                      .nrOfWords(s_flashReadWords),
                       .contReadModeEnabled(s_contReadModeEnabled),
                       .dataOutValid(s_dataOutValid),
                       .dataOut(addressDataOut),
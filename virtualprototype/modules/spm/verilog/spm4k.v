@@ -1,5 +1,7 @@
 module spm4k #(parameter [31:0] slaveBaseAddress = 0,
-               parameter [31:0] spmBaseAddress = 32'hC0000000)
+               parameter [31:0] spmBaseAddress = 32'hC0000000,
+               parameter [31:0] dmaChannelBaseAddress = slaveBaseAddress + 32,
+               parameter        nrOfDmaChannels = 1)
              ( input wire         clock,
                                   reset,
                input wire [31:0]  dataToSpm,
@@ -84,35 +86,37 @@ module spm4k #(parameter [31:0] slaveBaseAddress = 0,
   wire [31:0] s_dmaLookupData = (s_weData == 1'b1) ? s_lookupDataReg : s_lookupData;
    
 
-  spmDma #(.slaveBaseAddress(slaveBaseAddress),
-           .spmBaseAddress(spmBaseAddress),
-           .spmSizeInBytes(4*1024)) dma
-          (.clock(clock),
-           .reset(reset),
-           .irq(irq),
-           .spmBusy(s_weData),
-           .spmAddress(s_dmaAddress),
-           .spmWe(s_dmaWe),
-           .spmWeData(s_dmaDataOut),
-           .spmReData(s_dmaLookupData),
-           .requestTransaction(requestTransaction),
-           .transactionGranted(transactionGranted),
-           .beginTransactionIn(beginTransactionIn),
-           .endTransactionIn(endTransactionIn),
-           .readNotWriteIn(readNotWriteIn),
-           .dataValidIn(dataValidIn),
-           .busErrorIn(busErrorIn),
-           .busyIn(busyIn),
-           .addressDataIn(addressDataIn),
-           .byteEnablesIn(byteEnablesIn),
-           .burstSizeIn(burstSizeIn),
-           .beginTransactionOut(beginTransactionOut),
-           .endTransactionOut(endTransactionOut),
-           .dataValidOut(dataValidOut),
-           .readNotWriteOut(readNotWriteOut),
-           .busErrorOut(busErrorOut),
-           .busyOut(busyOut),
-           .byteEnablesOut(byteEnablesOut),
-           .burstSizeOut(burstSizeOut),
-           .addressDataOut(addressDataOut));
+  spmDmaChannels #(.slaveBaseAddress(slaveBaseAddress),
+                   .spmBaseAddress(spmBaseAddress),
+                   .spmSizeInBytes(4*1024),
+                   .channelBaseAddress(dmaChannelBaseAddress),
+                   .nrOfChannels(nrOfDmaChannels)) dma
+                  (.clock(clock),
+                   .reset(reset),
+                   .irq(irq),
+                   .spmBusy(s_weData),
+                   .spmAddress(s_dmaAddress),
+                   .spmWe(s_dmaWe),
+                   .spmWeData(s_dmaDataOut),
+                   .spmReData(s_dmaLookupData),
+                   .requestTransaction(requestTransaction),
+                   .transactionGranted(transactionGranted),
+                   .beginTransactionIn(beginTransactionIn),
+                   .endTransactionIn(endTransactionIn),
+                   .readNotWriteIn(readNotWriteIn),
+                   .dataValidIn(dataValidIn),
+                   .busErrorIn(busErrorIn),
+                   .busyIn(busyIn),
+                   .addressDataIn(addressDataIn),
+                   .byteEnablesIn(byteEnablesIn),
+                   .burstSizeIn(burstSizeIn),
+                   .beginTransactionOut(beginTransactionOut),
+                   .endTransactionOut(endTransactionOut),
+                   .dataValidOut(dataValidOut),
+                   .readNotWriteOut(readNotWriteOut),
+                   .busErrorOut(busErrorOut),
+                   .busyOut(busyOut),
+                   .byteEnablesOut(byteEnablesOut),
+                   .burstSizeOut(burstSizeOut),
+                   .addressDataOut(addressDataOut));
 endmodule
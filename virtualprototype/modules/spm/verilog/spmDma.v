@@ -5,6 +5,10 @@ module spmDma #(parameter [31:0] slaveBaseAddress = 0,
                                    reset,
                 output wire        irq,
                 
+                // here the channel arbitration interface is defined (see spmDmaChannels)
+                output wire [1:0]  channelPriority,
+                output wire        spmRequest,
+                
                 // here the spm interface is defined
                 input wire         spmBusy,
                 output wire [31:0] spmAddress,
@@ -38,16 +42,49 @@ module spmDma #(parameter [31:0] slaveBaseAddress = 0,
    *
    * This module implements a DMA-controller that allows to transfer
    * data to/from the SPM-memory. It only allows word (32-bit) transfers.
-   * it generates an irq when the transfer is completed.
+   * Furthermore it can copy data from memory to memory (each burst is read
+   * into an internal buffer and written back from it) and fill memory with
+   * a constant pattern, both without involving the SPM.
+   * Finally it can walk a linked list of descriptors that each describe one
+   * of these transfers.
+   * it generates an irq when the transfer is completed, the irq stays active until the status
+   * register is read.
    * 
    * the memory map for the slave-part is (baseAddress+):
    * 0  source/destination address in memory space
    * 4  source/destination address in spm space
-   * 8  Number of words to transfer (should not be more than the size of the spm)
-   * C  Set the burst-size in word when bit 8 and bit 9 are both 0.
-   *    Start the transfer on write (writing bit8 = 1 and bit9 = 0 to this address will start the DMA-transfer from the SPM to the source/destination Address,
-   *    writing a bit8 = 0 and bit9 = 1 to this address will start the DMA-transfer from the source/destination Address to the SPM)
+   * 8  Number of words to transfer (should not be more than the size of the spm for spm transfers)
+   * C  Set the burst-size in word when bits 10 to 8 are all 0, bits 13 and 12 set the priority of the
+   *    channel at the same time (only used when there are several channels, see spmDmaChannels).
+   *    Start the transfer on write, bits 10 to 8 select:
+   *    001 the DMA-transfer from the SPM to the source/destination Address,
+   *    010 the DMA-transfer from the source/destination Address to the SPM,
+   *    011 the copy from the source/destination Address to the memory destination Address,
+   *    101 the fill of the source/destination Address with the fill pattern,
+   *    111 the descriptor chain starting at the chain address.
+   *    Writing bit 11 = 1 together with 001 or 010 starts a 2D-transfer of a tile: the number of words
+   *    to transfer is the length of one row, and the rows and strides are taken from 10 and 14.
    *    Read the status register
+   * 10 memory destination address of a memory to memory copy,
+   *    for a 2D-transfer bits 31 to 16 the number of rows and bits 15 to 0 the memory stride in words
+   * 14 fill pattern,
+   *    for a 2D-transfer bits 15 to 0 the spm stride in words (0 for the row length)
+   * 18 chain address, the address of the first descriptor (in the spm or in memory)
+   * 1C Chain control, can also be written while the dma-controller is busy:
+   *    writing adds bits 15 to 0 to the credits, writing bit 31 = 1 stops the chain after the current descriptor.
+   *    Read: bits 31 to 16 the credits, bits 15 to 0 the number of descriptors completed since the start
+   *
+   * A descriptor consists of 6 words:
+   * 0  control: bits 10 to 8 the transfer (001, 010, 011 or 101 as above, otherwise the descriptor is skipped),
+   *    bits 7 to 0 the burst-size (it stays set after the chain), bit 11 2D-transfer, bit 16 generate an irq when the descriptor
+   *    is completed, bit 17 wait for a credit before the transfer (each descriptor with this bit consumes one).
+   * 4  source/destination address in memory space
+   * 8  source/destination address in spm space
+   * C  Number of words to transfer (of one row for a 2D-transfer)
+   * 10 memory destination address of a memory to memory copy resp. fill pattern,
+   *    for a 2D-transfer the rows and the memory stride as above (the rows are packed in the spm)
+   * 14 address of the next descriptor, 0 ends the chain (pointing back gives a ring)
+   * Descriptors are not checked for errors, they have to be word aligned.
    *
    * The status register contains:
    * bit 0 -> The dma-controller is busy and will not react on the slave part, any writes to the slave-part is blocked and will
@@ -58,16 +95,23 @@ module spmDma #(parameter [31:0] slaveBaseAddress = 0,
    * bit 3 -> Memory address alignment error, in this case the DMA will not start.
    * bit 4 -> Spm address alignment error, in this case the DMA will not start.
    * bit 5 -> Spm address out of range error, in this case the DMA will not start.
+   * bit 6 -> Memory destination address alignment error, in this case a memory to memory copy will not start.
+   * bit 7 -> Chain address alignment error, in this case the chain will not start.
+   * bit 8 -> An irq is pending, reading the status register clears it.
+   *
+   * Bits 1, 4 and 5 only prevent the spm transfers, the memory to memory copy and the fill
+   * are not limited by the spm-size. For a 2D-transfer only the first row is checked.
    *
    */
 
   localparam [31:0] maxSize      = {2'd0,spmSizeInBytes[31:2]};
   localparam maxBit = $clog2(spmSizeInBytes+1);
   
-  localparam [3:0] IDLE = 4'd0, DECIDE = 4'd1, GEN_IRQ = 4'd2, REQUEST_TRANS = 4'd3, WAIT_TRANS_ACK = 4'd4, INIT_TRANSACTION = 4'd5, WAIT_READ_DATA = 4'd6, ERROR = 4'd7, 
-                   DO_WRITE_DATA = 4'd8, ERROR_STOP = 4'd9, END_TRANSACTION = 4'd10, BUSY_WAIT = 4'd11;
+  localparam [4:0] IDLE = 5'd0, DECIDE = 5'd1, GEN_IRQ = 5'd2, REQUEST_TRANS = 5'd3, WAIT_TRANS_ACK = 5'd4, INIT_TRANSACTION = 5'd5, WAIT_READ_DATA = 5'd6, ERROR = 5'd7, 
+                   DO_WRITE_DATA = 5'd8, ERROR_STOP = 5'd9, END_TRANSACTION = 5'd10, BUSY_WAIT = 5'd11, NEXT_DESC = 5'd12, FETCH_SPM = 5'd13, LOAD_DESC = 5'd14,
+                   WAIT_CREDIT = 5'd15, DESC_IRQ = 5'd16, NEXT_ROW = 5'd17;
   
-  reg [3:0] s_dmaStateReg, s_dmaStateNext;
+  reg [4:0] s_dmaStateReg, s_dmaStateNext;
 
   /*
    *
@@ -77,7 +121,21 @@ module spmDma #(parameter [31:0] slaveBaseAddress = 0,
   
   reg [31:0]           s_sourceDestinationAddressReg;
   reg [31:0]           s_spmAddressReg;
+  reg [31:0]           s_destinationAddressReg, s_fillPatternReg, s_chainAddressReg;
+  reg [15:0]           s_creditReg, s_completedReg;
+  reg                  s_chainReg;         // this is 1 while a descriptor chain is walked
+  reg                  s_stopReg;          // this is 1 when the chain has to stop after the current descriptor
+  reg [31:0]           s_descControlReg, s_descMemoryReg, s_descSpmReg, s_descSizeReg, s_descDestinationReg, s_nextDescReg;
+  wire [2:0]           s_descCommand = s_descControlReg[10:8];
+  wire                 s_loadDesc = (s_dmaStateReg == LOAD_DESC) ? 1'b1 : 1'b0;
+  reg                  s_twoDReg;          // this is 1 for a 2D-transfer
+  reg [15:0]           s_rowsLeftReg, s_memStrideReg, s_spmStrideReg;
+  reg [29:0]           s_rowLengthReg;
+  reg [31:0]           s_rowMemAddressReg, s_rowSpmAddressReg;
   reg                  s_transferToSpmReg; // this is 1 when transfering data from external to the spm
+  reg                  s_memToMemReg;      // this is 1 when copying data from memory to memory
+  reg                  s_fillReg;          // this is 1 when filling memory with the fill pattern
+  reg                  s_irqPendingReg;
   reg                  s_dmaBusyReg, s_transferSizeErrorReg, s_dmaTransferErrorReg, s_slaveDataOutValidReg, s_slaveEndTransactionReg;
   reg [31:0]           s_transferSizeInWordsReg, s_slaveDataOutReg, s_slaveDataOutNext;
   reg [3:0]            s_byteEnablesReg;
@@ -86,35 +144,46 @@ module spmDma #(parameter [31:0] slaveBaseAddress = 0,
   reg [31:0]           s_addressReg;
   reg [31:0]           s_dataInReg;
   reg [7:0]            s_burstSizeReg;
+  reg [1:0]            s_priorityReg;
   
-  wire       s_isMyTransaction = (s_transferActiveReg == 1'b1 && s_addressReg[31:4] == slaveBaseAddress[31:4]) ? 1'b1 : 1'b0;
-  wire       s_busyBlock       = s_isMyTransaction & s_dmaBusyReg & ~s_readNotWriteReg;
+  wire       s_isMyTransaction = (s_transferActiveReg == 1'b1 && s_addressReg[31:5] == slaveBaseAddress[31:5]) ? 1'b1 : 1'b0;
+  wire       s_busyBlock       = (s_addressReg[4:2] == 3'd7) ? 1'b0 : s_isMyTransaction & s_dmaBusyReg & ~s_readNotWriteReg;
   wire       s_burstSizeError  = (s_isMyTransaction == 1'b1 && (s_burstSizeInReg != 8'd0 || s_byteEnablesReg != 4'hF)) ? 1'b1 : 1'b0;
   wire       s_slaveError      = s_busyBlock | s_burstSizeError;
   wire       s_memAlignError   = (s_sourceDestinationAddressReg[1:0] == 2'd0) ? 1'b0 : 1'b1;
   wire       s_spmAlignError   = (s_spmAddressReg[1:0] == 2'd0) ? 1'b0 : 1'b1;
   wire       s_spmAddressError = (s_spmAddressReg[31:maxBit] == spmBaseAddress[31:maxBit]) ? 1'b0 : 1'b1;
-  wire       s_startDma        = (s_isMyTransaction == 1'b1 && s_slaveError == 1'b0 && s_dataInValidReg == 1'b1 && 
-                                  (s_dataInReg[9:8] == 2'b01 || s_dataInReg[9:8] == 2'b10) && s_addressReg[3:2] == 2'b11 && 
-                                  s_readNotWriteReg == 1'b0 && s_memAlignError == 1'b0 && s_spmAlignError == 1'b0 &&
-                                  s_spmAddressError == 1'b0) ? ~s_transferSizeErrorReg : 1'b0;
-  wire       s_weSourceDest    = (s_isMyTransaction == 1'b1 && s_slaveError == 1'b0 && s_dataInValidReg == 1'b1 && 
-                                  s_addressReg[3:2] == 2'b00 && s_readNotWriteReg == 1'b0) ? 1'b1 : 1'b0;
-  wire       s_weSpmAddr       = (s_isMyTransaction == 1'b1 && s_slaveError == 1'b0 && s_dataInValidReg == 1'b1 && 
-                                  s_addressReg[3:2] == 2'b01 && s_readNotWriteReg == 1'b0) ? 1'b1 : 1'b0;
-  wire       s_weTransSize     = (s_isMyTransaction == 1'b1 && s_slaveError == 1'b0 && s_dataInValidReg == 1'b1 && 
-                                  s_addressReg[3:2] == 2'b10 && s_readNotWriteReg == 1'b0) ? 1'b1 : 1'b0;
+  wire       s_destAlignError  = (s_destinationAddressReg[1:0] == 2'd0) ? 1'b0 : 1'b1;
+  wire       s_chainAlignError = (s_chainAddressReg[1:0] == 2'd0) ? 1'b0 : 1'b1;
+  wire [2:0] s_command         = s_dataInReg[10:8];
+  wire       s_spmCommandOk    = (s_command == 3'b001 || s_command == 3'b010) ? ~s_transferSizeErrorReg & ~s_spmAlignError & ~s_spmAddressError : 1'b0;
+  wire       s_memCommandOk    = (s_command == 3'b011) ? ~s_destAlignError : (s_command == 3'b101) ? 1'b1 : 1'b0;
+  wire       s_slaveWrite      = (s_isMyTransaction == 1'b1 && s_slaveError == 1'b0 && s_dataInValidReg == 1'b1 && s_readNotWriteReg == 1'b0) ? 1'b1 : 1'b0;
+  wire       s_chainCommandOk  = (s_command == 3'b111) ? ~s_chainAlignError : 1'b0;
+  wire       s_startDma        = (s_slaveWrite == 1'b1 && s_addressReg[4:2] == 3'd3) ? ((s_spmCommandOk | s_memCommandOk) & ~s_memAlignError) | s_chainCommandOk : 1'b0;
+  wire       s_weSourceDest    = (s_slaveWrite == 1'b1 && s_addressReg[4:2] == 3'd0) ? 1'b1 : 1'b0;
+  wire       s_weSpmAddr       = (s_slaveWrite == 1'b1 && s_addressReg[4:2] == 3'd1) ? 1'b1 : 1'b0;
+  wire       s_weTransSize     = (s_slaveWrite == 1'b1 && s_addressReg[4:2] == 3'd2) ? 1'b1 : 1'b0;
+  wire       s_weDestination   = (s_slaveWrite == 1'b1 && s_addressReg[4:2] == 3'd4) ? 1'b1 : 1'b0;
+  wire       s_weFillPattern   = (s_slaveWrite == 1'b1 && s_addressReg[4:2] == 3'd5) ? 1'b1 : 1'b0;
+  wire       s_weChainAddress  = (s_slaveWrite == 1'b1 && s_addressReg[4:2] == 3'd6) ? 1'b1 : 1'b0;
+  wire       s_weChainControl  = (s_slaveWrite == 1'b1 && s_addressReg[4:2] == 3'd7) ? 1'b1 : 1'b0;
   wire       s_writeSlaveData  = (s_isMyTransaction == 1'b1 && s_burstSizeError == 1'b0 && s_beginTransactionReg == 1'b1 && s_readNotWriteReg == 1'b1) ? 1'b1 : 1'b0;
-  wire       s_writeBurstSize  = (s_isMyTransaction == 1'b1 && s_slaveError == 1'b0 && s_dataInValidReg == 1'b1 && 
-                                  s_addressReg[3:2] == 2'b11 && s_readNotWriteReg == 1'b0 && s_dataInReg[9:8] == 2'b00) ? 1'b1 : 1'b0;
+  wire       s_writeBurstSize  = (s_slaveWrite == 1'b1 && s_addressReg[4:2] == 3'd3 && s_command == 3'b000) ? 1'b1 : 1'b0;
   wire [9:0] s_realBurstSize   = {1'b0,s_burstSizeReg} + 9'd1;
+  wire       s_readStatus      = (s_writeSlaveData == 1'b1 && s_addressReg[4:2] == 3'd3) ? 1'b1 : 1'b0;
+  wire       s_raiseIrq        = (s_dmaStateReg == GEN_IRQ || s_dmaStateReg == DESC_IRQ) ? 1'b1 : 1'b0;
 
   always @*
-    case (s_addressReg[3:2])
-      2'd0    : s_slaveDataOutNext <= s_sourceDestinationAddressReg;
-      2'd1    : s_slaveDataOutNext <= s_spmAddressReg;
-      2'd2    : s_slaveDataOutNext <= s_transferSizeInWordsReg;
-      default : s_slaveDataOutNext <= {26'd0, s_spmAddressError, s_spmAlignError, s_memAlignError, s_dmaTransferErrorReg, s_transferSizeErrorReg, s_dmaBusyReg};
+    case (s_addressReg[4:2])
+      3'd0    : s_slaveDataOutNext <= s_sourceDestinationAddressReg;
+      3'd1    : s_slaveDataOutNext <= s_spmAddressReg;
+      3'd2    : s_slaveDataOutNext <= s_transferSizeInWordsReg;
+      3'd4    : s_slaveDataOutNext <= s_destinationAddressReg;
+      3'd5    : s_slaveDataOutNext <= s_fillPatternReg;
+      3'd6    : s_slaveDataOutNext <= s_chainAddressReg;
+      3'd7    : s_slaveDataOutNext <= {s_creditReg, s_completedReg};
+      default : s_slaveDataOutNext <= {23'd0, s_irqPendingReg, s_chainAlignError, s_destAlignError, s_spmAddressError, s_spmAlignError, s_memAlignError, s_dmaTransferErrorReg, s_transferSizeErrorReg, s_dmaBusyReg};
     endcase
 
   always @(posedge clock)
@@ -128,17 +197,28 @@ module spmDma #(parameter [31:0] slaveBaseAddress = 0,
       s_burstSizeInReg              <= (beginTransactionIn == 1'b1) ? burstSizeIn : s_burstSizeInReg;
       s_addressReg                  <= (beginTransactionIn == 1'b1) ? addressDataIn : s_addressReg;
       s_dataInReg                   <= (dataValidIn == 1'b1) ? addressDataIn : s_dataInReg;
+      s_irqPendingReg               <= (reset == 1'b1) ? 1'b0 : (s_raiseIrq == 1'b1) ? 1'b1 : (s_readStatus == 1'b1) ? 1'b0 : s_irqPendingReg;
       s_dmaBusyReg                  <= (reset == 1'b1 || s_dmaStateReg == GEN_IRQ) ? 1'b0 : (s_startDmaReg == 1'b1) ? endTransactionIn : s_dmaBusyReg;
       s_sourceDestinationAddressReg <= (reset == 1'b1) ? 32'd0 : (s_weSourceDest == 1'b1) ? s_dataInReg : s_sourceDestinationAddressReg;
       s_spmAddressReg               <= (reset == 1'b1) ? {spmBaseAddress[31:maxBit], {maxBit{1'b0}}} : (s_weSpmAddr == 1'b1) ? s_dataInReg : s_spmAddressReg;
-      s_transferToSpmReg            <= (s_startDma == 1'b1) ? s_dataInReg[9] : s_transferToSpmReg;
+      s_destinationAddressReg       <= (reset == 1'b1) ? 32'd0 : (s_weDestination == 1'b1) ? s_dataInReg : s_destinationAddressReg;
+      s_fillPatternReg              <= (reset == 1'b1) ? 32'd0 : (s_weFillPattern == 1'b1) ? s_dataInReg : s_fillPatternReg;
+      s_chainAddressReg             <= (reset == 1'b1) ? 32'd0 : (s_weChainAddress == 1'b1) ? s_dataInReg : s_chainAddressReg;
+      s_transferToSpmReg            <= (s_startDma == 1'b1) ? (s_command == 3'b010) : (s_loadDesc == 1'b1) ? (s_descCommand == 3'b010) : s_transferToSpmReg;
+      s_memToMemReg                 <= (reset == 1'b1) ? 1'b0 : (s_startDma == 1'b1) ? (s_command == 3'b011) :
+                                       (s_loadDesc == 1'b1) ? (s_descCommand == 3'b011) : s_memToMemReg;
+      s_fillReg                     <= (reset == 1'b1) ? 1'b0 : (s_startDma == 1'b1) ? (s_command == 3'b101) :
+                                       (s_loadDesc == 1'b1) ? (s_descCommand == 3'b101) : s_fillReg;
+      s_chainReg                    <= (reset == 1'b1) ? 1'b0 : (s_startDma == 1'b1) ? (s_command == 3'b111) : s_chainReg;
+      s_stopReg                     <= (reset == 1'b1 || s_startDma == 1'b1) ? 1'b0 : (s_weChainControl == 1'b1 && s_dataInReg[31] == 1'b1) ? 1'b1 : s_stopReg;
       s_transferSizeInWordsReg      <= (reset == 1'b1) ? 32'd0 : (s_weTransSize == 1'b1) ? s_dataInReg : s_transferSizeInWordsReg;
       s_transferSizeErrorReg        <= (s_transferSizeInWordsReg > maxSize) ? 1'b1 : 1'b0;
       s_slaveDataOutValidReg        <= (s_writeSlaveData == 1'b1) ? 1'b1 : (s_isMyTransaction == 1'b1 && busyIn == 1'b1) ? s_slaveDataOutValidReg : 1'b0;
       s_slaveEndTransactionReg      <= (s_slaveDataOutValidReg == 1'b1 && busyIn == 1'b0) ? 1'b1 : 1'b0;
       s_slaveDataOutReg             <= (s_writeSlaveData == 1'b1) ? s_slaveDataOutNext : (s_isMyTransaction == 1'b1 && busyIn == 1'b1) ? s_slaveDataOutReg : 32'd0;
       s_startDmaReg                 <= (reset == 1'b1 || endTransactionIn == 1'b1) ? 1'b0 : s_startDma | s_startDmaReg;
-      s_burstSizeReg                <= (reset == 1'b1) ? 8'h7 : (s_writeBurstSize == 1'b1) ? s_dataInReg[7:0] : s_burstSizeReg;
+      s_priorityReg                 <= (reset == 1'b1) ? 2'd0 : (s_writeBurstSize == 1'b1) ? s_dataInReg[13:12] : s_priorityReg;
+      s_burstSizeReg                <= (reset == 1'b1) ? 8'h7 : (s_writeBurstSize == 1'b1) ? s_dataInReg[7:0] : (s_loadDesc == 1'b1) ? s_descControlReg[7:0] : s_burstSizeReg;
     end
   
   /*
@@ -147,6 +227,7 @@ module spmDma #(parameter [31:0] slaveBaseAddress = 0,
    *
    */
   reg [31:0]  s_currentAddressReg;
+  reg [31:0]  s_currentDestinationReg; // the memory destination address resp. the fill pattern
   reg [31:0]  s_currentSpmAddressReg;
   reg [31:0]  s_busAddressReg, s_dmaDataOutReg;
   reg [29:0]  s_remainingTransSizeReg;
@@ -154,15 +235,53 @@ module spmDma #(parameter [31:0] slaveBaseAddress = 0,
   reg [3:0]   s_byteEnablesOutReg;
   reg [7:0]   s_burstSizeOutReg;
   reg [8:0]   s_receivedWordsReg;
-  wire        s_spmWe = (s_dmaStateReg == WAIT_READ_DATA) ? s_dataInValidReg & ~spmBusy : 1'b0;
+  reg         s_writePhaseReg; // this is 1 when the buffer of a memory to memory copy is written back
+  reg         s_fetchReg;      // this is 1 when a descriptor is read from memory
+  reg [2:0]   s_descWordReg;
+  reg [7:0]   s_bufferIndexReg;
+  reg [31:0]  s_bufferMem [255:0];
+  wire        s_readPhase = s_fetchReg | s_transferToSpmReg | (s_memToMemReg & ~s_writePhaseReg);
+  wire        s_readWord = (s_dmaStateReg == WAIT_READ_DATA) ? s_dataInValidReg & (s_fetchReg | s_memToMemReg | ~spmBusy) : 1'b0;
+  wire        s_spmWe = s_readWord & s_transferToSpmReg & ~s_fetchReg;
+  wire        s_bufferWe = s_readWord & s_memToMemReg & ~s_fetchReg;
   wire        s_doWrite = (s_dmaStateReg == DO_WRITE_DATA && s_receivedWordsReg[8] == 1'b0) ? ~busyIn : 1'd0;
+  wire [31:0] s_bufferData = s_bufferMem[s_bufferIndexReg];
+  wire [31:0] s_writeData = (s_fillReg == 1'b1) ? s_currentDestinationReg : (s_memToMemReg == 1'b1) ? s_bufferData : spmReData;
   wire [7:0]  s_currentTransSize = (s_remainingTransSizeReg > {21'd0, s_realBurstSize}) ? s_burstSizeReg : s_remainingTransSizeReg[7:0] - 8'd1;
+  wire [7:0]  s_busTransSize = (s_fetchReg == 1'b1) ? 8'd5 : s_currentTransSize;
+  /* a burst of a memory to memory copy is read and written with the same size, the remaining size is counted on the write */
+  wire        s_initTransfer = (s_dmaStateReg == INIT_TRANSACTION) ? ~s_fetchReg : 1'b0;
+  wire        s_initRead = s_initTransfer & s_memToMemReg & ~s_writePhaseReg;
+  wire        s_initWrite = s_initTransfer & s_memToMemReg & s_writePhaseReg;
+  /* the descriptors are read over the bus or, if they are in the spm, through the spm-port */
+  wire        s_descInSpm = (s_nextDescReg[31:maxBit] == spmBaseAddress[31:maxBit]) ? 1'b1 : 1'b0;
+  wire        s_descFromBus = s_readWord & s_fetchReg;
+  wire        s_descFromSpm = (s_dmaStateReg == FETCH_SPM) ? ~spmBusy : 1'b0;
+  wire        s_descWe = s_descFromBus | s_descFromSpm;
+  wire [31:0] s_descData = (s_descFromBus == 1'b1) ? s_dataInReg : spmReData;
+  wire        s_descValid = (s_descCommand == 3'b001 || s_descCommand == 3'b010 || s_descCommand == 3'b011 || s_descCommand == 3'b101) ? 1'b1 : 1'b0;
+  wire        s_descDone = (s_dmaStateReg == DECIDE && s_remainingTransSizeReg == 30'd0 && (s_twoDReg == 1'b0 || s_rowsLeftReg <= 16'd1)) ? s_chainReg : 1'b0;
+  wire        s_consumeCredit = (s_dmaStateReg == WAIT_CREDIT && s_creditReg != 16'd0) ? ~s_stopReg : 1'b0;
+  /* a 2D-transfer is a sequence of row transfers, the next row starts a stride after the previous one */
+  wire        s_nextRow = (s_dmaStateReg == NEXT_ROW) ? 1'b1 : 1'b0;
+  wire [31:0] s_nextRowMemAddress = s_rowMemAddressReg + {14'd0,s_memStrideReg,2'd0};
+  wire [31:0] s_nextRowSpmAddress = s_rowSpmAddressReg + {14'd0,s_spmStrideReg,2'd0};
   wire [29:0] s_remainingTransSizeNext = (s_startDma == 1'd1) ? s_transferSizeInWordsReg[29:0] :
-                                         (s_dmaStateReg == INIT_TRANSACTION) ? s_remainingTransSizeReg - {22'd0,s_currentTransSize} - 30'd1 : s_remainingTransSizeReg;
+                                         (s_loadDesc == 1'b1) ? ((s_descValid == 1'b1) ? s_descSizeReg[29:0] : 30'd0) :
+                                         (s_nextRow == 1'b1) ? s_rowLengthReg :
+                                         (s_initTransfer == 1'b1 && s_initRead == 1'b0) ? s_remainingTransSizeReg - {22'd0,s_currentTransSize} - 30'd1 : s_remainingTransSizeReg;
   wire [31:0] s_currentAddressNext = (s_startDma == 1'd1) ? s_sourceDestinationAddressReg :
-                                     (s_dmaStateReg == INIT_TRANSACTION) ? s_currentAddressReg + {22'd0,s_currentTransSize,2'd0} + 30'd4 : s_currentAddressReg;
+                                     (s_loadDesc == 1'b1) ? s_descMemoryReg :
+                                     (s_nextRow == 1'b1) ? s_nextRowMemAddress :
+                                     (s_initTransfer == 1'b1 && s_initWrite == 1'b0) ? s_currentAddressReg + {22'd0,s_currentTransSize,2'd0} + 30'd4 : s_currentAddressReg;
+  wire [31:0] s_currentDestinationNext = (s_startDma == 1'd1) ? ((s_command == 3'b101) ? s_fillPatternReg : s_destinationAddressReg) :
+                                         (s_loadDesc == 1'b1) ? s_descDestinationReg :
+                                         (s_initWrite == 1'b1) ? s_currentDestinationReg + {22'd0,s_currentTransSize,2'd0} + 30'd4 : s_currentDestinationReg;
   wire [31:0] s_currentSpmAddressNext = (s_startDma == 1'd1) ? s_spmAddressReg : 
-                                        (s_spmWe == 1'b1 || s_doWrite == 1'b1) ? s_currentSpmAddressReg + 32'd4 : s_currentSpmAddressReg;
+                                        (s_loadDesc == 1'b1) ? s_descSpmReg :
+                                        (s_nextRow == 1'b1) ? s_nextRowSpmAddress :
+                                        (s_dmaStateReg == NEXT_DESC) ? s_nextDescReg :
+                                        (s_spmWe == 1'b1 || s_doWrite == 1'b1 || s_descFromSpm == 1'b1) ? s_currentSpmAddressReg + 32'd4 : s_currentSpmAddressReg;
   
   assign spmAddress = s_currentSpmAddressReg;
   assign spmWe      = s_spmWe;
@@ -170,12 +289,19 @@ module spmDma #(parameter [31:0] slaveBaseAddress = 0,
   
   always @*
     case (s_dmaStateReg)
-      IDLE             : s_dmaStateNext <= (s_startDma == 1'd1) ? DECIDE : IDLE;
-      DECIDE           : s_dmaStateNext <= (s_remainingTransSizeReg == 30'd0) ? GEN_IRQ : REQUEST_TRANS;
+      IDLE             : s_dmaStateNext <= (s_startDma == 1'd1) ? ((s_command == 3'b111) ? NEXT_DESC : DECIDE) : IDLE;
+      DECIDE           : s_dmaStateNext <= (s_remainingTransSizeReg != 30'd0) ? REQUEST_TRANS : (s_twoDReg == 1'b1 && s_rowsLeftReg > 16'd1) ? NEXT_ROW :
+                                           (s_chainReg == 1'b0) ? GEN_IRQ : (s_descControlReg[16] == 1'b1) ? DESC_IRQ : NEXT_DESC;
+      NEXT_ROW         : s_dmaStateNext <= DECIDE;
+      DESC_IRQ         : s_dmaStateNext <= NEXT_DESC;
+      NEXT_DESC        : s_dmaStateNext <= (s_nextDescReg == 32'd0 || s_stopReg == 1'b1) ? GEN_IRQ : (s_descInSpm == 1'b1) ? FETCH_SPM : REQUEST_TRANS;
+      FETCH_SPM        : s_dmaStateNext <= (s_descFromSpm == 1'b1 && s_descWordReg == 3'd5) ? LOAD_DESC : FETCH_SPM;
+      LOAD_DESC        : s_dmaStateNext <= (s_descControlReg[17] == 1'b1) ? WAIT_CREDIT : DECIDE;
+      WAIT_CREDIT      : s_dmaStateNext <= (s_stopReg == 1'b1) ? GEN_IRQ : (s_creditReg != 16'd0) ? DECIDE : WAIT_CREDIT;
       REQUEST_TRANS    : s_dmaStateNext <= (transactionGranted == 1'b1) ? INIT_TRANSACTION : WAIT_TRANS_ACK;
       WAIT_TRANS_ACK   : s_dmaStateNext <= (transactionGranted == 1'b1) ? INIT_TRANSACTION : WAIT_TRANS_ACK;
-      INIT_TRANSACTION : s_dmaStateNext <= (s_transferToSpmReg == 1'b1) ? WAIT_READ_DATA : DO_WRITE_DATA;
-      WAIT_READ_DATA   : s_dmaStateNext <= (busErrorIn == 1'b1) ? ERROR : (s_endTransactionReg == 1'b1 && s_receivedWordsReg[8] == 1'b1) ? DECIDE : 
+      INIT_TRANSACTION : s_dmaStateNext <= (s_readPhase == 1'b1) ? WAIT_READ_DATA : DO_WRITE_DATA;
+      WAIT_READ_DATA   : s_dmaStateNext <= (busErrorIn == 1'b1) ? ERROR : (s_endTransactionReg == 1'b1 && s_receivedWordsReg[8] == 1'b1) ? ((s_fetchReg == 1'b1) ? LOAD_DESC : DECIDE) : 
                          (s_endTransactionReg == 1'b1) ? ERROR : WAIT_READ_DATA;
       DO_WRITE_DATA    : s_dmaStateNext <= (busErrorIn == 1'b1) ? ERROR_STOP : (s_receivedWordsReg[8] == 1'b1 && busyIn == 1'b1) ? BUSY_WAIT :
                          (s_receivedWordsReg[8] == 1'b1) ? END_TRANSACTION : DO_WRITE_DATA;
@@ -191,24 +317,89 @@ module spmDma #(parameter [31:0] slaveBaseAddress = 0,
       s_dmaStateReg            <= (reset == 1'b1) ? IDLE : s_dmaStateNext;
       s_remainingTransSizeReg  <= s_remainingTransSizeNext;
       s_currentAddressReg      <= s_currentAddressNext;
+      s_currentDestinationReg  <= s_currentDestinationNext;
       s_currentSpmAddressReg   <= (reset == 1'b1) ? 32'd0 : s_currentSpmAddressNext;
-      s_busAddressReg          <= (s_dmaStateReg == INIT_TRANSACTION) ? s_currentAddressReg : 32'd0;
+      s_busAddressReg          <= (s_dmaStateReg != INIT_TRANSACTION) ? 32'd0 : (s_fetchReg == 1'b1) ? s_nextDescReg :
+                                  (s_initWrite == 1'b1) ? s_currentDestinationReg : s_currentAddressReg;
       s_beginTransactionOutReg <= (s_dmaStateReg == INIT_TRANSACTION) ? 1'b1 : 1'b0;
-      s_readNotWriteOutReg     <= (s_dmaStateReg == INIT_TRANSACTION) ? s_transferToSpmReg : 1'b0;
+      s_readNotWriteOutReg     <= (s_dmaStateReg == INIT_TRANSACTION) ? s_readPhase : 1'b0;
       s_byteEnablesOutReg      <= (s_dmaStateReg == INIT_TRANSACTION) ? 4'hF : 4'd0;
-      s_burstSizeOutReg        <= (s_dmaStateReg == INIT_TRANSACTION) ? s_currentTransSize : 8'd0;
-      s_receivedWordsReg       <= (s_dmaStateReg == INIT_TRANSACTION) ? {1'b0,s_currentTransSize} : (s_spmWe == 1'b1 || s_doWrite == 1'b1) ? s_receivedWordsReg - 8'd1 : s_receivedWordsReg;
+      s_burstSizeOutReg        <= (s_dmaStateReg == INIT_TRANSACTION) ? s_busTransSize : 8'd0;
+      s_receivedWordsReg       <= (s_dmaStateReg == INIT_TRANSACTION) ? {1'b0,s_busTransSize} : (s_readWord == 1'b1 || s_doWrite == 1'b1) ? s_receivedWordsReg - 8'd1 : s_receivedWordsReg;
+      s_writePhaseReg          <= (reset == 1'b1 || s_startDma == 1'b1 || s_dmaStateReg == END_TRANSACTION) ? 1'b0 :
+                                  (s_dmaStateReg == WAIT_READ_DATA && s_memToMemReg == 1'b1 && s_fetchReg == 1'b0 && busErrorIn == 1'b0 &&
+                                   s_endTransactionReg == 1'b1 && s_receivedWordsReg[8] == 1'b1) ? 1'b1 : s_writePhaseReg;
+      s_bufferIndexReg         <= (s_dmaStateReg == INIT_TRANSACTION) ? 8'd0 : 
+                                  (s_bufferWe == 1'b1 || (s_doWrite == 1'b1 && s_memToMemReg == 1'b1)) ? s_bufferIndexReg + 8'd1 : s_bufferIndexReg;
       s_dmaTransferErrorReg    <= (reset == 1'b1 || s_dmaStateReg == DECIDE) ? 1'b0 : (s_dmaStateReg == ERROR || s_dmaStateReg == ERROR_STOP) ? 1'b1 : s_dmaTransferErrorReg;
       s_dmaDataOutValidReg     <= ((s_dmaStateReg != DO_WRITE_DATA || s_receivedWordsReg[8] == 1'b1) && busyIn == 1'b0) ? 1'b0 : s_doWrite | s_dmaDataOutValidReg;
-      s_dmaDataOutReg          <= ((s_dmaStateReg != DO_WRITE_DATA || s_receivedWordsReg[8] == 1'b1) && busyIn == 1'b0) ? 32'd0 : (s_doWrite == 1'b1) ? spmReData : s_dmaDataOutReg;
+      s_dmaDataOutReg          <= ((s_dmaStateReg != DO_WRITE_DATA || s_receivedWordsReg[8] == 1'b1) && busyIn == 1'b0) ? 32'd0 : (s_doWrite == 1'b1) ? s_writeData : s_dmaDataOutReg;
+    end
+  
+  /*
+   *
+   * Here the descriptor chain is defined
+   *
+   */
+  always @(posedge clock)
+    begin
+      s_fetchReg           <= (reset == 1'b1 || s_startDma == 1'b1 || s_loadDesc == 1'b1) ? 1'b0 :
+                              (s_dmaStateReg == NEXT_DESC && s_nextDescReg != 32'd0 && s_stopReg == 1'b0 && s_descInSpm == 1'b0) ? 1'b1 : s_fetchReg;
+      s_descWordReg        <= (s_dmaStateReg == NEXT_DESC) ? 3'd0 : (s_descWe == 1'b1) ? s_descWordReg + 3'd1 : s_descWordReg;
+      s_descControlReg     <= (reset == 1'b1) ? 32'd0 : (s_descWe == 1'b1 && s_descWordReg == 3'd0) ? s_descData : s_descControlReg;
+      s_descMemoryReg      <= (s_descWe == 1'b1 && s_descWordReg == 3'd1) ? s_descData : s_descMemoryReg;
+      s_descSpmReg         <= (s_descWe == 1'b1 && s_descWordReg == 3'd2) ? s_descData : s_descSpmReg;
+      s_descSizeReg        <= (s_descWe == 1'b1 && s_descWordReg == 3'd3) ? s_descData : s_descSizeReg;
+      s_descDestinationReg <= (s_descWe == 1'b1 && s_descWordReg == 3'd4) ? s_descData : s_descDestinationReg;
+      s_nextDescReg        <= (reset == 1'b1) ? 32'd0 : (s_startDma == 1'b1) ? s_chainAddressReg :
+                              (s_descWe == 1'b1 && s_descWordReg == 3'd5) ? s_descData : s_nextDescReg;
+      s_creditReg          <= (reset == 1'b1 || s_startDma == 1'b1) ? 16'd0 :
+                              s_creditReg + ((s_weChainControl == 1'b1) ? s_dataInReg[15:0] : 16'd0) - {15'd0, s_consumeCredit};
+      s_completedReg       <= (reset == 1'b1 || s_startDma == 1'b1) ? 16'd0 : (s_descDone == 1'b1) ? s_completedReg + 16'd1 : s_completedReg;
+    end
+  
+  /*
+   *
+   * Here the rows of a 2D-transfer are defined
+   *
+   */
+  wire s_twoDCommand = (s_command == 3'b001 || s_command == 3'b010) ? s_dataInReg[11] : 1'b0;
+  wire s_twoDDesc    = (s_descCommand == 3'b001 || s_descCommand == 3'b010) ? s_descControlReg[11] : 1'b0;
+  
+  always @(posedge clock)
+    begin
+      s_twoDReg          <= (reset == 1'b1) ? 1'b0 : (s_startDma == 1'b1) ? s_twoDCommand : (s_loadDesc == 1'b1) ? s_twoDDesc : s_twoDReg;
+      s_rowsLeftReg      <= (s_startDma == 1'b1) ? s_destinationAddressReg[31:16] : (s_loadDesc == 1'b1) ? s_descDestinationReg[31:16] :
+                            (s_nextRow == 1'b1) ? s_rowsLeftReg - 16'd1 : s_rowsLeftReg;
+      s_memStrideReg     <= (s_startDma == 1'b1) ? s_destinationAddressReg[15:0] : (s_loadDesc == 1'b1) ? s_descDestinationReg[15:0] : s_memStrideReg;
+      s_spmStrideReg     <= (s_startDma == 1'b1) ? ((s_fillPatternReg[15:0] == 16'd0) ? s_transferSizeInWordsReg[15:0] : s_fillPatternReg[15:0]) :
+                            (s_loadDesc == 1'b1) ? s_descSizeReg[15:0] : s_spmStrideReg;
+      s_rowLengthReg     <= (s_startDma == 1'b1) ? s_transferSizeInWordsReg[29:0] : (s_loadDesc == 1'b1) ? s_descSizeReg[29:0] : s_rowLengthReg;
+      s_rowMemAddressReg <= (s_startDma == 1'b1) ? s_sourceDestinationAddressReg : (s_loadDesc == 1'b1) ? s_descMemoryReg :
+                            (s_nextRow == 1'b1) ? s_nextRowMemAddress : s_rowMemAddressReg;
+      s_rowSpmAddressReg <= (s_startDma == 1'b1) ? s_spmAddressReg : (s_loadDesc == 1'b1) ? s_descSpmReg :
+                            (s_nextRow == 1'b1) ? s_nextRowSpmAddress : s_rowSpmAddressReg;
     end
   
+  /*
+   *
+   * Here the burst buffer of the memory to memory copy is defined
+   *
+   */
+  always @(posedge clock)
+    if (s_bufferWe == 1'b1) s_bufferMem[s_bufferIndexReg] <= s_dataInReg;
+  
   /*
    *
    * here the bus output signals are defined
    *
    */
-  assign irq                 = (s_dmaStateReg == GEN_IRQ) ? 1'b1 : 1'b0;
+  assign irq                 = s_irqPendingReg;
+  assign channelPriority     = s_priorityReg;
+  /* the spm-port is needed during the own bus transactions and to read descriptors from the spm */
+  assign spmRequest          = (s_dmaStateReg == FETCH_SPM || s_dmaStateReg == INIT_TRANSACTION || s_dmaStateReg == WAIT_READ_DATA ||
+                                s_dmaStateReg == DO_WRITE_DATA || s_dmaStateReg == BUSY_WAIT || s_dmaStateReg == END_TRANSACTION ||
+                                s_dmaStateReg == ERROR || s_dmaStateReg == ERROR_STOP) ? 1'b1 : 1'b0;
   assign requestTransaction  = (s_dmaStateReg == REQUEST_TRANS || s_dmaStateReg == WAIT_TRANS_ACK) ? 1'b1 : 1'b0;
   assign busErrorOut         = s_slaveError & ~s_endTransactionReg;
   assign endTransactionOut   = (s_dmaStateReg == END_TRANSACTION) ? 1'b1 : s_slaveEndTransactionReg;
@@ -218,6 +409,6 @@ module spmDma #(parameter [31:0] slaveBaseAddress = 0,
   assign readNotWriteOut     = s_readNotWriteOutReg;
   assign byteEnablesOut      = s_byteEnablesOutReg;
   assign burstSizeOut        = s_burstSizeOutReg;
-  assign busyOut             = (s_dmaStateReg == WAIT_READ_DATA) ? dataValidIn & spmBusy : 1'b0;
+  assign busyOut             = (s_dmaStateReg == WAIT_READ_DATA) ? dataValidIn & spmBusy & s_transferToSpmReg & ~s_fetchReg : 1'b0;
 
 endmodule
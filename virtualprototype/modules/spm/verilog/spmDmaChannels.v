@@ -0,0 +1,196 @@
+module spmDmaChannels #(parameter [31:0] slaveBaseAddress = 0,
+                        parameter [31:0] channelBaseAddress = 32,
+                        parameter [31:0] spmBaseAddress = 32'hC0000000,
+                        parameter [31:0] spmSizeInBytes = 8*1024,
+                        parameter        nrOfChannels = 1)
+                       (input wire         clock,
+                                           reset,
+                        output wire        irq,
+
+                        // here the spm interface is defined
+                        input wire         spmBusy,
+                        output wire [31:0] spmAddress,
+                        output wire        spmWe,
+                        output wire [31:0] spmWeData,
+                        input wire [31:0]  spmReData,
+
+                        // here the bus interface is defined
+                        output wire        requestTransaction,
+                        input wire         transactionGranted,
+                        input wire         beginTransactionIn,
+                                           endTransactionIn,
+                                           readNotWriteIn,
+                                           dataValidIn,
+                                           busErrorIn,
+                                           busyIn,
+                        input wire [31:0]  addressDataIn,
+                        input wire [3:0]   byteEnablesIn,
+                        input wire [7:0]   burstSizeIn,
+                        output wire        beginTransactionOut,
+                                           endTransactionOut,
+                                           dataValidOut,
+                                           readNotWriteOut,
+                                           busErrorOut,
+                                           busyOut,
+                        output wire [3:0]  byteEnablesOut,
+                        output wire [7:0]  burstSizeOut,
+                        output wire [31:0] addressDataOut);
+
+  /*
+   *
+   * This module combines 1 to 4 independent DMA-channels (see spmDma) on one
+   * spm-port and one bus master port. Channel 0 has its registers at the
+   * slaveBaseAddress, channel n > 0 at channelBaseAddress + (n-1)*32.
+   *
+   * The channels request the bus on their own, a grant is passed on to the
+   * requesting channel with the highest priority; channels with the same
+   * priority are served round-robin. The spm-port belongs to the channel that
+   * was granted the bus last, when it does not need it the lowest channel that
+   * reads a descriptor from the spm gets it.
+   *
+   * The irq is active as long as a channel has an irq pending, bit 8 of the
+   * status registers tells which ones.
+   *
+   */
+
+  wire [3:0]   s_irqs, s_requests, s_spmRequests, s_spmWes;
+  wire [7:0]   s_priorities;
+  wire [3:0]   s_beginTransactions, s_endTransactions, s_dataValids, s_readNotWrites, s_busErrors, s_busys;
+  wire [15:0]  s_byteEnables;
+  wire [31:0]  s_burstSizes;
+  wire [127:0] s_spmAddresses, s_spmWeDatas, s_addressDatas;
+  reg  [1:0]   s_grantIndex, s_spmIndex, s_bestPriority;
+  reg  [1:0]   s_lastGrantReg;
+  reg  [3:0]   s_grants, s_spmBusys;
+  reg          s_found;
+  integer      i, j; // the loop variables of the bus resp. the spm-port arbitration, one per block
+
+  /*
+   *
+   * Here the bus is arbitrated, the search starts after the channel granted last
+   *
+   */
+  always @*
+    begin
+      s_found        = 1'b0;
+      s_grantIndex   = 2'd0;
+      s_bestPriority = 2'd0;
+      for (i = 1 ; i <= 4 ; i = i + 1)
+        if (i <= nrOfChannels &&
+            s_requests[(s_lastGrantReg + i) % nrOfChannels] == 1'b1 &&
+            (s_found == 1'b0 || s_priorities[((s_lastGrantReg + i) % nrOfChannels)*2 +: 2] > s_bestPriority))
+          begin
+            s_found        = 1'b1;
+            s_grantIndex   = (s_lastGrantReg + i) % nrOfChannels;
+            s_bestPriority = s_priorities[((s_lastGrantReg + i) % nrOfChannels)*2 +: 2];
+          end
+    end
+
+  always @*
+    begin
+      s_grants               = 4'd0;
+      s_grants[s_grantIndex] = transactionGranted & s_found;
+    end
+
+  always @(posedge clock) s_lastGrantReg <= (reset == 1'b1) ? 2'd0 : (transactionGranted == 1'b1 && s_found == 1'b1) ? s_grantIndex : s_lastGrantReg;
+
+  /*
+   *
+   * Here the spm-port is arbitrated
+   *
+   */
+  always @*
+    begin
+      s_spmIndex = s_lastGrantReg;
+      if (s_spmRequests[s_lastGrantReg] == 1'b0)
+        for (j = 3 ; j >= 0 ; j = j - 1)
+          if (s_spmRequests[j] == 1'b1) s_spmIndex = j;
+      s_spmBusys             = 4'hF;
+      s_spmBusys[s_spmIndex] = spmBusy;
+    end
+
+  assign spmAddress          = s_spmAddresses[s_spmIndex*32 +: 32];
+  assign spmWe               = s_spmWes[s_spmIndex];
+  assign spmWeData           = s_spmWeDatas[s_spmIndex*32 +: 32];
+
+  /*
+   *
+   * Here the bus outputs are combined, they are 0 for all channels without a transaction
+   *
+   */
+  assign irq                 = |s_irqs;
+  assign requestTransaction  = |s_requests;
+  assign beginTransactionOut = |s_beginTransactions;
+  assign endTransactionOut   = |s_endTransactions;
+  assign dataValidOut        = |s_dataValids;
+  assign readNotWriteOut     = |s_readNotWrites;
+  assign busErrorOut         = |s_busErrors;
+  assign busyOut             = |s_busys;
+  assign byteEnablesOut      = s_byteEnables[3:0] | s_byteEnables[7:4] | s_byteEnables[11:8] | s_byteEnables[15:12];
+  assign burstSizeOut        = s_burstSizes[7:0] | s_burstSizes[15:8] | s_burstSizes[23:16] | s_burstSizes[31:24];
+  assign addressDataOut      = s_addressDatas[31:0] | s_addressDatas[63:32] | s_addressDatas[95:64] | s_addressDatas[127:96];
+
+  genvar n;
+
+  generate
+    for (n = 0 ; n < 4 ; n = n + 1)
+      begin : channels
+        if (n < nrOfChannels)
+          begin : channel
+            spmDma #(.slaveBaseAddress((n == 0) ? slaveBaseAddress : channelBaseAddress + (n-1)*32),
+                     .spmBaseAddress(spmBaseAddress),
+                     .spmSizeInBytes(spmSizeInBytes)) dma
+                    (.clock(clock),
+                     .reset(reset),
+                     .irq(s_irqs[n]),
+                     .channelPriority(s_priorities[n*2+1:n*2]),
+                     .spmRequest(s_spmRequests[n]),
+                     .spmBusy(s_spmBusys[n]),
+                     .spmAddress(s_spmAddresses[n*32+31:n*32]),
+                     .spmWe(s_spmWes[n]),
+                     .spmWeData(s_spmWeDatas[n*32+31:n*32]),
+                     .spmReData(spmReData),
+                     .requestTransaction(s_requests[n]),
+                     .transactionGranted(s_grants[n]),
+                     .beginTransactionIn(beginTransactionIn),
+                     .endTransactionIn(endTransactionIn),
+                     .readNotWriteIn(readNotWriteIn),
+                     .dataValidIn(dataValidIn),
+                     .busErrorIn(busErrorIn),
+                     .busyIn(busyIn),
+                     .addressDataIn(addressDataIn),
+                     .byteEnablesIn(byteEnablesIn),
+                     .burstSizeIn(burstSizeIn),
+                     .beginTransactionOut(s_beginTransactions[n]),
+                     .endTransactionOut(s_endTransactions[n]),
+                     .dataValidOut(s_dataValids[n]),
+                     .readNotWriteOut(s_readNotWrites[n]),
+                     .busErrorOut(s_busErrors[n]),
+                     .busyOut(s_busys[n]),
+                     .byteEnablesOut(s_byteEnables[n*4+3:n*4]),
+                     .burstSizeOut(s_burstSizes[n*8+7:n*8]),
+                     .addressDataOut(s_addressDatas[n*32+31:n*32]));
+          end
+        else
+          begin : unused
+            assign s_irqs[n]                     = 1'b0;
+            assign s_priorities[n*2+1:n*2]       = 2'd0;
+            assign s_spmRequests[n]              = 1'b0;
+            assign s_spmAddresses[n*32+31:n*32]  = 32'd0;
+            assign s_spmWes[n]                   = 1'b0;
+            assign s_spmWeDatas[n*32+31:n*32]    = 32'd0;
+            assign s_requests[n]                 = 1'b0;
+            assign s_beginTransactions[n]        = 1'b0;
+            assign s_endTransactions[n]          = 1'b0;
+            assign s_dataValids[n]               = 1'b0;
+            assign s_readNotWrites[n]            = 1'b0;
+            assign s_busErrors[n]                = 1'b0;
+            assign s_busys[n]                    = 1'b0;
+            assign s_byteEnables[n*4+3:n*4]      = 4'd0;
+            assign s_burstSizes[n*8+7:n*8]       = 8'd0;
+            assign s_addressDatas[n*32+31:n*32]  = 32'd0;
+          end
+      end
+  endgenerate
+
+endmodule
@@ -12,13 +12,14 @@ module ssram_8k #( parameter [31:0] baseAddress = 32'h50000000)
                    input wire [31:0]   addressDataIn,
                    input wire [3:0]    byteEnablesIn,
                    input wire [7:0]    burstSizeIn,
+                   input wire          wrapBurstIn,
                    output wire         endTransactionOut,
                    output wire         dataValidOut,
                    output wire [31:0]  addressDataOut
                  );
 
    /* here we define the bus registers */
-   reg        s_beginTransactionInReg, s_dataValidReg, s_transactionActiveReg, s_readNotWriteReg;
+   reg        s_beginTransactionInReg, s_dataValidReg, s_transactionActiveReg, s_readNotWriteReg, s_wrapBurstReg;
    reg [31:0] s_addressDataInReg;
    reg [3:0]  s_byteEnablesReg;
    reg [8:0]  s_burstSizeReg;
@@ -33,6 +34,7 @@ module ssram_8k #( parameter [31:0] baseAddress = 32'h50000000)
        s_beginTransactionInReg <= beginTransactionIn;
        s_dataValidReg          <= dataValidIn;
        s_readNotWriteReg       <= (beginTransactionIn == 1'b1) ? readNotWriteIn : s_readNotWriteReg;
+       s_wrapBurstReg          <= (beginTransactionIn == 1'b1) ? wrapBurstIn : s_wrapBurstReg;
        s_addressDataInReg      <= addressDataIn;
        s_byteEnablesReg        <= (beginTransactionIn == 1'b1) ? byteEnablesIn : s_byteEnablesReg;
        s_burstSizeReg          <= (beginTransactionIn == 1'b1) ? {1'b0,burstSizeIn} : 
@@ -76,6 +78,8 @@ module ssram_8k #( parameter [31:0] baseAddress = 32'h50000000)
    reg        s_dataValidOutReg;
    wire [10:0] s_ramAddressNext = (reset == 1'b1) ? 11'd0 :
                                   (s_isMyTransaction == 1'b1) ? s_addressDataInReg[12:2] :
+                                  (s_currentStateReg == READ && s_doRead == 1'b1 && s_wrapBurstReg == 1'b1) ?
+                                  {s_ramAddressReg[10:3], s_ramAddressReg[2:0] + 3'd1} :
                                   ((s_currentStateReg == WRITE && s_dataValidReg == 1'b1) ||
                                    (s_currentStateReg == READ && s_doRead == 1'b1)) ?
                                   s_ramAddressReg + 11'd1 : s_ramAddressReg;
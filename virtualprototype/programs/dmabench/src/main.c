@@ -0,0 +1,151 @@
+#include <cache.h>
+#include <cpu2.h>
+#include <dma.h>
+#include <perf.h>
+#include <platform.h>
+#include <stdio.h>
+#include <swap.h>
+
+// Throughput of the DMA-controller over the burst size, the transfer size and the number
+// of SPM buffers of dma_pipeline_run(), without load on the bus and while the VGA-controller
+// and/or the second core use it. The second core only exists on the dual- and triple-core
+// systems, the cpu2 loads are skipped on the single-core system. Every point is printed as
+// one CSV line:
+//   load,burst,line_bytes,buffers,runtime,bus_idle,stall,errors
+
+#define SPM_ADDRESS 0xC0000000
+#define SPM_SIZE (8 * 1024)    // the SPM of cpu1
+#define TOTAL_SIZE (64 * 1024) // bytes transferred per point
+
+#define SCREEN_WIDTH 512
+#define SCREEN_HEIGHT 512
+#define LOAD_SIZE (16 * 1024)
+
+static uint32_t destination[TOTAL_SIZE / sizeof(uint32_t)] __aligned(CACHE_LINE_SIZE);
+static uint16_t frame_buffer[SCREEN_WIDTH * SCREEN_HEIGHT] __aligned(CACHE_LINE_SIZE);
+static uint32_t load_buffer[LOAD_SIZE / sizeof(uint32_t)] __aligned(CACHE_LINE_SIZE);
+
+static const uint32_t bursts[] = {1, 4, 16, 64, 256};
+static const size_t line_sizes[] = {64, 256, 1024, 4096};
+static const uint32_t buffer_counts[] = {2, 4, 8};
+
+typedef enum { LOAD_NONE, LOAD_VGA, LOAD_CPU2, LOAD_VGA_CPU2 } load_t;
+
+static const char *load_names[] = {"none", "vga", "cpu2", "vga+cpu2"};
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+/**
+ * @brief The number of cores of the system, bits 6..4 of the processor-id register.
+ *
+ */
+static uint32_t nr_of_cores() {
+    return (SPR_READ(9) >> 4) & 7;
+}
+
+/**
+ * @brief Keeps the bus of cpu2 busy: the D$ is off, so every access is a bus transaction.
+ *
+ */
+void main2() {
+    volatile uint32_t *buffer = load_buffer;
+
+    icache_enable(1);
+    dcache_enable(0);
+    while (1) {
+        for (size_t i = 0; i < ARRAY_SIZE(load_buffer); ++i)
+            buffer[i] += i;
+    }
+}
+
+/**
+ * @brief Marks the line, the rest of the buffer is left as it is to measure the DMA only.
+ *
+ */
+static void mark_line(void *buffer, uint32_t line, void *arg) {
+    (void)arg;
+    *(volatile uint32_t *)buffer = line;
+}
+
+static void vga_load(int on) {
+    volatile uint32_t *vga = (uint32_t *)0x50000020;
+
+    if (on) {
+        vga[0] = swap_u32(SCREEN_WIDTH);
+        vga[1] = swap_u32(SCREEN_HEIGHT);
+        vga[3] = swap_u32((uint32_t)&frame_buffer[0]);
+    } else {
+        // an unaligned frame buffer address stops the graphics mode
+        vga[3] = swap_u32(1);
+    }
+}
+
+static void run(load_t load, uint32_t burst, size_t line_size, uint32_t buffers) {
+    const uint32_t lines = TOTAL_SIZE / line_size;
+
+    perf_start();
+    int errors = dma_pipeline_run((void *)SPM_ADDRESS, buffers, destination, line_size, line_size, lines,
+                                  burst, mark_line, NULL);
+    perf_stop();
+
+    // the pipeline flushed the D$, hence the lines are read from memory
+    for (uint32_t k = 0; k < lines && errors == 0; ++k) {
+        if (destination[k * (line_size / sizeof(uint32_t))] != k)
+            errors = -1;
+    }
+
+    printf("%s,%u,%u,%u,%u,%u,%u,%d\n", load_names[load], burst, line_size, buffers,
+           (uint32_t)perf_read_counter(PERF_COUNTER_RUNTIME), (uint32_t)perf_read_counter(PERF_COUNTER_0),
+           (uint32_t)perf_read_counter(PERF_COUNTER_1), errors);
+}
+
+static void sweep(load_t load) {
+    for (size_t b = 0; b < ARRAY_SIZE(bursts); ++b) {
+        for (size_t s = 0; s < ARRAY_SIZE(line_sizes); ++s) {
+            for (size_t n = 0; n < ARRAY_SIZE(buffer_counts); ++n) {
+                if (buffer_counts[n] * line_sizes[s] > SPM_SIZE)
+                    continue;
+                run(load, bursts[b], line_sizes[s], buffer_counts[n]);
+            }
+        }
+    }
+}
+
+int main() {
+    // initializes the UART, performance counters, peripherals etc.
+    platform_init();
+    perf_init();
+    perf_set_mask(PERF_COUNTER_0, PERF_BUS_IDLE_MASK);
+    perf_set_mask(PERF_COUNTER_1, PERF_STALL_CYCLES_MASK);
+
+    icache_write_cfg(CACHE_TWO_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU);
+    dcache_write_cfg(CACHE_FOUR_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK);
+    icache_enable(1);
+    dcache_enable(1);
+
+    dma_init(DMA_BASE_ADDRESS);
+
+    printf("load,burst,line_bytes,buffers,runtime,bus_idle,stall,errors\n");
+    sweep(LOAD_NONE);
+
+    vga_load(1);
+    sweep(LOAD_VGA);
+    vga_load(0);
+
+    if (nr_of_cores() < 2) {
+        printf("# single-core system, no cpu2 loads\n");
+        return 0;
+    }
+
+    // cpu2 cannot be stopped again, so its loads come last
+    SET_CPU2_MAIN(&init_cpu2);
+    set_stack_cpu2(1ull << 20 /* 1 MB*/);
+    START_CPU2();
+    sweep(LOAD_CPU2);
+
+    vga_load(1);
+    sweep(LOAD_VGA_CPU2);
+    vga_load(0);
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <cache.h>
+#include <heap.h>
+#include <linalg.h>
+#include <perf.h>
+#include <platform.h>
+#include <stdio.h>
+
+#define MATRIX_N 128
+
+// the matrices are huge, they are placed on the heap
+static int32_t *mat_a, *mat_b, *mat_c;
+
+static int32_t in_vector[MATRIX_N];
+static int32_t out_vector[MATRIX_N];
+
+static void init(int q28) {
+    for (size_t i = 0; i < MATRIX_N; ++i) {
+        for (size_t j = 0; j < MATRIX_N; ++j) {
+            int32_t v = (int32_t)((i * 31 + j * 17) % 256) - 128;
+            // Q4.28 values in [-0.125, 0.125), the sums stay in range
+            mat_a[i * MATRIX_N + j] = q28 ? v << 18 : v;
+            mat_b[i * MATRIX_N + j] = q28 ? (v ^ 0x55) << 18 : v ^ 0x55;
+        }
+        in_vector[i] = q28 ? (int32_t)(i - MATRIX_N / 2) << 20 : (int32_t)i;
+    }
+}
+
+/**
+ * @brief Multiplies the matrix with the input vector without tiling, the baseline.
+ *
+ */
+static void naive_matvec() {
+    for (int i = 0; i < MATRIX_N; ++i) {
+        out_vector[i] = 0;
+        for (int j = 0; j < MATRIX_N; ++j) {
+            out_vector[i] += mat_a[i * MATRIX_N + j] * in_vector[j];
+        }
+    }
+}
+
+static void naive_matmul() {
+    for (int i = 0; i < MATRIX_N; ++i) {
+        for (int j = 0; j < MATRIX_N; ++j) {
+            int32_t sum = 0;
+            for (int k = 0; k < MATRIX_N; ++k) {
+                sum += mat_a[i * MATRIX_N + k] * mat_b[k * MATRIX_N + j];
+            }
+            mat_c[i * MATRIX_N + j] = sum;
+        }
+    }
+}
+
+static void naive_transpose() {
+    for (int i = 0; i < MATRIX_N; ++i) {
+        for (int j = 0; j < MATRIX_N; ++j) {
+            mat_c[j * MATRIX_N + i] = mat_a[i * MATRIX_N + j];
+        }
+    }
+}
+
+static void bench_start() {
+    dcache_flush();
+    perf_start();
+}
+
+static void bench_stop(const char *name) {
+    perf_stop();
+    printf("%-16s cycles %10lld dcache misses %10lld stalls %10lld\n", name,
+           perf_read_counter(PERF_COUNTER_RUNTIME), perf_read_counter(PERF_COUNTER_0),
+           perf_read_counter(PERF_COUNTER_1));
+}
+
+static void bench_verify(int result) {
+    if (result == 0) {
+        printf("    verification successful!\n");
+    }
+}
+
+static void linalg_main() {
+    const size_t n = MATRIX_N;
+
+    mat_a = malloc(n * n * sizeof(int32_t));
+    mat_b = malloc(n * n * sizeof(int32_t));
+    mat_c = malloc(n * n * sizeof(int32_t));
+    if (mat_a == NULL || mat_b == NULL || mat_c == NULL) {
+        printf("Out-of-memory!\n");
+        return;
+    }
+    heap_print_stats();
+
+    printf("N = %d, D$ tile = %lu, matvec block = %lu\n", MATRIX_N,
+           (unsigned long)linalg_tile(3), (unsigned long)linalg_block());
+
+    init(0);
+
+    bench_start();
+    naive_matvec();
+    bench_stop("matvec naive");
+    bench_verify(linalg_verify_matvec_i32(mat_a, in_vector, out_vector, n, n));
+
+    bench_start();
+    linalg_matvec_i32(mat_a, in_vector, out_vector, n, n);
+    bench_stop("matvec i32");
+    bench_verify(linalg_verify_matvec_i32(mat_a, in_vector, out_vector, n, n));
+
+    bench_start();
+    naive_matmul();
+    bench_stop("matmul naive");
+    bench_verify(linalg_verify_matmul_i32(mat_a, mat_b, mat_c, n, n, n));
+
+    bench_start();
+    linalg_matmul_i32(mat_a, mat_b, mat_c, n, n, n);
+    bench_stop("matmul i32");
+    bench_verify(linalg_verify_matmul_i32(mat_a, mat_b, mat_c, n, n, n));
+
+    bench_start();
+    linalg_matmul_i32_spm(mat_a, mat_b, mat_c, n, n, n);
+    bench_stop("matmul i32 spm");
+    bench_verify(linalg_verify_matmul_i32(mat_a, mat_b, mat_c, n, n, n));
+
+    bench_start();
+    naive_transpose();
+    bench_stop("transpose naive");
+    bench_verify(linalg_verify_transpose(mat_a, mat_c, n, n));
+
+    bench_start();
+    linalg_transpose(mat_a, mat_c, n, n);
+    bench_stop("transpose");
+    bench_verify(linalg_verify_transpose(mat_a, mat_c, n, n));
+
+    init(1);
+
+    bench_start();
+    linalg_matvec_q28(mat_a, in_vector, out_vector, n, n);
+    bench_stop("matvec q28");
+    bench_verify(linalg_verify_matvec_q28(mat_a, in_vector, out_vector, n, n));
+
+    bench_start();
+    linalg_matmul_q28(mat_a, mat_b, mat_c, n, n, n);
+    bench_stop("matmul q28");
+    bench_verify(linalg_verify_matmul_q28(mat_a, mat_b, mat_c, n, n, n));
+
+    bench_start();
+    linalg_matmul_q28_spm(mat_a, mat_b, mat_c, n, n, n);
+    bench_stop("matmul q28 spm");
+    bench_verify(linalg_verify_matmul_q28(mat_a, mat_b, mat_c, n, n, n));
+
+    free(mat_c);
+    free(mat_b);
+    free(mat_a);
+}
+
+int main() {
+    // initializes the UART, performance counters, peripherals etc.
+    platform_init();
+    perf_init();
+
+    icache_write_cfg(CACHE_TWO_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU);
+    dcache_write_cfg(CACHE_FOUR_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK);
+    icache_enable(1);
+    dcache_enable(1);
+
+    perf_set_mask(PERF_COUNTER_0, PERF_DCACHE_MISS_MASK);
+    perf_set_mask(PERF_COUNTER_1, PERF_STALL_CYCLES_MASK);
+
+    linalg_main();
+
+    return 0;
+}
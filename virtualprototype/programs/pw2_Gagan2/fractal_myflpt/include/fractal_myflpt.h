@@ -37,6 +37,27 @@ typedef uint16_t rgb565;
 typedef uint16_t (*calc_frac_point_p)(mfp cx, mfp cy, uint16_t n_max);
 
 uint16_t calc_mandelbrot_point_soft(mfp cx, mfp cy, uint16_t n_max);
+uint16_t calc_mandelbrot_point_ise(mfp cx, mfp cy, uint16_t n_max);
+
+// Fast paths of calc_mandelbrot_point_fast(), or-ed into mandelbrot_fast_paths
+#define MANDELBROT_CARDIOID    1 //!< points in the main cardioid and the period-2 bulb return n_max at once
+#define MANDELBROT_PERIODICITY 2 //!< an orbit that repeats exactly returns n_max
+#define MANDELBROT_LAST_PIXEL  4 //!< the periodicity check only runs if the previous pixel reached n_max
+
+extern uint32_t mandelbrot_fast_paths; //!< all fast paths by default
+
+uint16_t calc_mandelbrot_point_fast(mfp cx, mfp cy, uint16_t n_max);
+
+//! \brief  Compares calc_mandelbrot_point_fast with calc_mandelbrot_point_soft over the view,
+//!         pixel by pixel in the order of draw_fractal
+//! \return number of pixels with different iteration counts
+uint32_t check_mandelbrot_point_fast(int width, int height,
+                                     mfp cx_0, mfp cy_0, mfp delta, uint16_t n_max);
+
+//! \brief  Compares mfp_add, mfp_sub, mfp_mul and mfp_cmp with the mfp ISE on n_pairs
+//!         pseudo-random operand pairs
+//! \return number of differing results
+uint32_t check_mfp_ise(uint32_t n_pairs);
 
 //! Pointer to function mapping iteration to colour value
 typedef rgb565 (*iter_to_colour_p)(uint16_t iter, uint16_t n_max);
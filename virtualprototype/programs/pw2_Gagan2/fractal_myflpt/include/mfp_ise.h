@@ -0,0 +1,36 @@
+#ifndef MFP_ISE_H
+#define MFP_ISE_H
+
+#include "fractal_myflpt.h"
+
+// Custom instructions 0x24 to 0x27 of the mfp ISE (mfpIse.v), bit-exact with the software functions
+
+//! \brief  mfp_add in hardware (1 cycle)
+static inline mfp mfp_add_ise(mfp a, mfp b) {
+    mfp result;
+    asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x24":[out1]"=r"(result):[in1]"r"(a),[in2]"r"(b));
+    return result;
+}
+
+//! \brief  mfp_sub in hardware (1 cycle)
+static inline mfp mfp_sub_ise(mfp a, mfp b) {
+    mfp result;
+    asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x25":[out1]"=r"(result):[in1]"r"(a),[in2]"r"(b));
+    return result;
+}
+
+//! \brief  mfp_mul in hardware (2 cycles)
+static inline mfp mfp_mul_ise(mfp a, mfp b) {
+    mfp result;
+    asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x26":[out1]"=r"(result):[in1]"r"(a),[in2]"r"(b));
+    return result;
+}
+
+//! \brief  mfp_cmp in hardware (1 cycle)
+static inline int mfp_cmp_ise(mfp a, mfp b) {
+    int result;
+    asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x27":[out1]"=r"(result):[in1]"r"(a),[in2]"r"(b));
+    return result;
+}
+
+#endif // MFP_ISE_H
@@ -1,4 +1,5 @@
 #include "fractal_myflpt.h"
+#include "mfp_ise.h"
 #include <swap.h>
 
 bool mfp_sign(mfp v){ return (v & MFP_SIGN_MASK) != 0; }
@@ -279,6 +280,133 @@ uint16_t calc_mandelbrot_point_soft(mfp cx, mfp cy, uint16_t n_max) {
     return n;
 }
 
+//! \brief  calc_mandelbrot_point_soft with the arithmetic of the mfp ISE
+uint16_t calc_mandelbrot_point_ise(mfp cx, mfp cy, uint16_t n_max) {
+    mfp x = cx;
+    mfp y = cy;
+    uint16_t n = 0;
+    mfp xx, yy, two_xy;
+    do {
+        xx = mfp_mul_ise(x,x);
+        yy = mfp_mul_ise(y,y);
+        two_xy = mfp_mul_ise(MFP_TWO, mfp_mul_ise(x,y));
+
+        x = mfp_add_ise(mfp_sub_ise(xx,yy),cx);
+        y = mfp_add_ise(two_xy,cy);
+        ++n;
+    } while ((mfp_cmp_ise(mfp_add_ise(xx, yy), MFP_FOUR) < 0) && (n < n_max));
+    return n;
+}
+
+uint32_t mandelbrot_fast_paths = MANDELBROT_CARDIOID | MANDELBROT_PERIODICITY | MANDELBROT_LAST_PIXEL;
+
+#define MFP_SIXTEENTH ((1u<<22)<<8 | (uint8_t)(247))
+
+//! \brief  Tests whether (cx, cy) lies in the main cardioid or in the period-2 bulb, in mfp arithmetic
+static bool mfp_in_cardioid(mfp cx, mfp cy) {
+    mfp yy = mfp_mul(cy, cy);
+    mfp x1 = mfp_add(cx, MFP_ONE);
+    if (mfp_cmp(mfp_add(mfp_mul(x1, x1), yy), MFP_SIXTEENTH) < 0) return true;
+
+    mfp xq = mfp_sub(cx, MFP_QUARTER);
+    mfp q = mfp_add(mfp_mul(xq, xq), yy);
+    return mfp_cmp(mfp_mul(q, mfp_add(q, xq)), mfp_mul(MFP_QUARTER, yy)) < 0;
+}
+
+//! \brief  calc_mandelbrot_point_soft with the fast paths selected by mandelbrot_fast_paths
+//! \note   The periodicity check stops on an exact repetition of the orbit only, the iteration
+//!         count stays the same. The cardioid test is checked with check_mandelbrot_point_fast().
+uint16_t calc_mandelbrot_point_fast(mfp cx, mfp cy, uint16_t n_max) {
+    static bool last_inside = true; // the previous pixel reached n_max
+    const uint32_t paths = mandelbrot_fast_paths;
+
+    if ((paths & MANDELBROT_CARDIOID) && mfp_in_cardioid(cx, cy)) {
+        last_inside = true;
+        return n_max;
+    }
+
+    // escaping orbits only pay for the check next to the set
+    const bool periodicity = (paths & MANDELBROT_PERIODICITY) && (last_inside || !(paths & MANDELBROT_LAST_PIXEL));
+    mfp x = cx;
+    mfp y = cy;
+    mfp px = cx, py = cy; // saved orbit point, moved on after 1, 2, 4, ... iterations (Brent)
+    uint16_t steps = 0, period = 1;
+    uint16_t n = 0;
+    mfp xx, yy, two_xy;
+    bool inside;
+    do {
+        xx = mfp_mul(x,x);
+        yy = mfp_mul(y,y);
+        two_xy = mfp_mul(MFP_TWO, mfp_mul(x,y));
+
+        x = mfp_add(mfp_sub(xx,yy),cx);
+        y = mfp_add(two_xy,cy);
+        ++n;
+        inside = mfp_cmp(mfp_add(xx, yy), MFP_FOUR) < 0;
+        if (periodicity && inside) {
+            // the orbit is back at a point that passed the escape test, it never escapes
+            if (x == px && y == py) {
+                n = n_max;
+                break;
+            }
+            if (++steps == period) {
+                steps = 0;
+                period <<= 1;
+                px = x;
+                py = y;
+            }
+        }
+    } while (inside && (n < n_max));
+    last_inside = n == n_max;
+    return n;
+}
+
+uint32_t check_mandelbrot_point_fast(int width, int height,
+                                     mfp cx_0, mfp cy_0, mfp delta, uint16_t n_max) {
+    uint32_t differing = 0;
+    mfp cy = cy_0;
+
+    for (int k = 0; k < height; ++k) {
+        mfp cx = cx_0;
+        for (int i = 0; i < width; ++i) {
+            if (calc_mandelbrot_point_fast(cx, cy, n_max) != calc_mandelbrot_point_soft(cx, cy, n_max))
+                differing++;
+            cx = mfp_add(cx, delta);
+        }
+        cy = mfp_add(cy, delta);
+    }
+    return differing;
+}
+
+//! \brief  Next operand of check_mfp_ise (xorshift32), a quarter of them are zero or near one
+static mfp mfp_random(uint32_t *state) {
+    uint32_t r = *state;
+    r ^= r << 13;
+    r ^= r >> 17;
+    r ^= r << 5;
+    *state = r;
+    switch (r & 3) {
+        case 0:  return (r & 0x70) ? r : MFP_ZERO;
+        case 1:  return (r & 0xBFFFFF00u) | 0x40000000u | (uint8_t)(MFP_EXP_BIAS - 5 + (r >> 4) % 11);
+        default: return r;
+    }
+}
+
+uint32_t check_mfp_ise(uint32_t n_pairs) {
+    uint32_t state = 0x2545F491u;
+    uint32_t differing = 0;
+
+    for (uint32_t i = 0; i < n_pairs; ++i) {
+        mfp a = mfp_random(&state);
+        mfp b = (i & 7) == 0 ? a ^ (state & MFP_SIGN_MASK) : mfp_random(&state);
+        if (mfp_add_ise(a, b) != mfp_add(a, b)) differing++;
+        if (mfp_sub_ise(a, b) != mfp_sub(a, b)) differing++;
+        if (mfp_mul_ise(a, b) != mfp_mul(a, b)) differing++;
+        if (mfp_cmp_ise(a, b) != mfp_cmp(a, b)) differing++;
+    }
+    return differing;
+}
+
 //! \brief  Map number of performed iterations to black and white
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
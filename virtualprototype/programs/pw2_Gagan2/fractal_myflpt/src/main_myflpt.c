@@ -16,6 +16,16 @@ mfp MFP_CY_0;
 //! max iterations
 const uint16_t N_MAX = 64;
 
+// #define __MFP_ISE__ // the mfp arithmetic runs on the custom instructions, __MFP_ISE_CHECK__ checks them
+// #define __FAST_PATHS__ // the software kernel skips the cardioid and periodic orbits, __FAST_PATHS_CHECK__ checks it
+#ifdef __MFP_ISE__
+#define CALC_MANDELBROT_POINT calc_mandelbrot_point_ise
+#elif defined(__FAST_PATHS__)
+#define CALC_MANDELBROT_POINT calc_mandelbrot_point_fast
+#else
+#define CALC_MANDELBROT_POINT calc_mandelbrot_point_soft
+#endif
+
 int main() {
     volatile unsigned int *vga = (unsigned int *) 0x50000020;
     rgb565 frameBuffer[SCREEN_WIDTH*SCREEN_HEIGHT];
@@ -47,7 +57,7 @@ int main() {
     mfp delta = mfp_from_float(delta_f);
 
     draw_fractal(frameBuffer, SCREEN_WIDTH, SCREEN_HEIGHT,
-                 &calc_mandelbrot_point_soft, &iter_to_colour,
+                 &CALC_MANDELBROT_POINT, &iter_to_colour,
                  MFP_CX_0, MFP_CY_0, delta, N_MAX);
 
 #ifdef __OR1300__
@@ -55,5 +65,12 @@ int main() {
 #endif
 
     printf("Done\n");
+#ifdef __MFP_ISE_CHECK__
+    printf("%u of %u results of the mfp ISE differ from the software\n", check_mfp_ise(100000), 4 * 100000);
+#endif
+#ifdef __FAST_PATHS_CHECK__
+    printf("%u pixels of the fast paths differ from the software\n",
+           check_mandelbrot_point_fast(SCREEN_WIDTH, SCREEN_HEIGHT, MFP_CX_0, MFP_CY_0, delta, N_MAX));
+#endif
     return 0;
 }
\ No newline at end of file
@@ -11,6 +11,21 @@ typedef uint16_t (*calc_frac_point_p)(float cx, float cy, uint16_t n_max);
 
 uint16_t calc_mandelbrot_point_soft(float cx, float cy, uint16_t n_max);
 
+// Fast paths of calc_mandelbrot_point_fast(), or-ed into mandelbrot_fast_paths
+#define MANDELBROT_CARDIOID    1 //!< points in the main cardioid and the period-2 bulb return n_max at once
+#define MANDELBROT_PERIODICITY 2 //!< an orbit that repeats exactly returns n_max
+#define MANDELBROT_LAST_PIXEL  4 //!< the periodicity check only runs if the previous pixel reached n_max
+
+extern uint32_t mandelbrot_fast_paths; //!< all fast paths by default
+
+uint16_t calc_mandelbrot_point_fast(float cx, float cy, uint16_t n_max);
+
+//! \brief  Compares calc_mandelbrot_point_fast with calc_mandelbrot_point_soft over the view,
+//!         pixel by pixel in the order of draw_fractal
+//! \return number of pixels with different iteration counts
+uint32_t check_mandelbrot_point_fast(int width, int height,
+                                     float cx_0, float cy_0, float delta, uint16_t n_max);
+
 //! Pointer to function mapping iteration to colour value
 typedef rgb565 (*iter_to_colour_p)(uint16_t iter, uint16_t n_max);
 
@@ -22,4 +37,17 @@ void draw_fractal(rgb565 *fbuf, int width, int height,
                   calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
                   float cx_0, float cy_0, float delta, uint16_t n_max);
 
+//! \brief  Draws like draw_fractal, but computes only the borders of uniform rectangles
+//!         (see subdivide.h)
+//! \return number of computed pixels
+uint32_t draw_fractal_subdivide(rgb565 *fbuf, int width, int height,
+                                calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                                float cx_0, float cy_0, float delta, uint16_t n_max);
+
+//! \brief  Renders the frame with draw_fractal into reference and compares fbuf with it
+//! \return number of differing pixels
+uint32_t diff_fractal_subdivide(const rgb565 *fbuf, rgb565 *reference, int width, int height,
+                                calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                                float cx_0, float cy_0, float delta, uint16_t n_max);
+
 #endif // FRACTAL_FLPT_H
@@ -1,5 +1,6 @@
 #include "fractal_flpt.h"
 #include <swap.h>
+#include <subdivide.h>
 
 //! \brief  Mandelbrot fractal point calculation function
 //! \param  cx    x-coordinate
@@ -23,6 +24,83 @@ uint16_t calc_mandelbrot_point_soft(float cx, float cy, uint16_t n_max) {
   return n;
 }
 
+uint32_t mandelbrot_fast_paths = MANDELBROT_CARDIOID | MANDELBROT_PERIODICITY | MANDELBROT_LAST_PIXEL;
+
+//! \brief  Tests whether (cx, cy) lies in the main cardioid or in the period-2 bulb
+static int mandelbrot_in_cardioid(float cx, float cy) {
+  float yy = cy * cy;
+  if ((cx + 1) * (cx + 1) + yy < 0.0625f) return 1;
+
+  float xq = cx - 0.25f;
+  float q = xq * xq + yy;
+  return q * (q + xq) < 0.25f * yy;
+}
+
+//! \brief  calc_mandelbrot_point_soft with the fast paths selected by mandelbrot_fast_paths
+//! \note   The periodicity check only stops on an exact repetition of the orbit, which then
+//!         never escapes, so the iteration counts do not change. The cardioid test is exact for
+//!         the real orbit; that the rounded orbit does not escape either is checked with
+//!         check_mandelbrot_point_fast().
+uint16_t calc_mandelbrot_point_fast(float cx, float cy, uint16_t n_max) {
+  static int last_inside = 1; // the previous pixel reached n_max
+  const uint32_t paths = mandelbrot_fast_paths;
+
+  if ((paths & MANDELBROT_CARDIOID) && mandelbrot_in_cardioid(cx, cy)) {
+    last_inside = 1;
+    return n_max;
+  }
+
+  // escaping orbits only pay for the check next to the set
+  const int periodicity = (paths & MANDELBROT_PERIODICITY) && (last_inside || !(paths & MANDELBROT_LAST_PIXEL));
+  float x = cx;
+  float y = cy;
+  float px = cx, py = cy; // saved orbit point, moved on after 1, 2, 4, ... iterations (Brent)
+  uint16_t steps = 0, period = 1;
+  uint16_t n = 0;
+  float xx, yy, two_xy;
+  do {
+    xx = x * x;
+    yy = y * y;
+    two_xy = 2 * x * y;
+
+    x = xx - yy + cx;
+    y = two_xy + cy;
+    ++n;
+    if (periodicity) {
+      // all points of the cycle passed the escape test already
+      if (x == px && y == py && (xx + yy) < 4) {
+        n = n_max;
+        break;
+      }
+      if (++steps == period) {
+        steps = 0;
+        period <<= 1;
+        px = x;
+        py = y;
+      }
+    }
+  } while (((xx + yy) < 4) && (n < n_max));
+  last_inside = n == n_max;
+  return n;
+}
+
+uint32_t check_mandelbrot_point_fast(int width, int height,
+                                     float cx_0, float cy_0, float delta, uint16_t n_max) {
+  uint32_t differing = 0;
+  float cy = cy_0;
+
+  for (int k = 0; k < height; ++k) {
+    float cx = cx_0;
+    for (int i = 0; i < width; ++i) {
+      if (calc_mandelbrot_point_fast(cx, cy, n_max) != calc_mandelbrot_point_soft(cx, cy, n_max))
+        differing++;
+      cx += delta;
+    }
+    cy += delta;
+  }
+  return differing;
+}
+
 
 //! \brief  Map number of performed iterations to black and white
 //! \param  iter  performed number of iterations
@@ -114,3 +192,46 @@ void draw_fractal(rgb565 *fbuf, int width, int height,
     cy += delta;
   }
 }
+
+//! \brief  Arguments of the pixel function of draw_fractal_subdivide, the coordinates
+//!         are accumulated as in draw_fractal (cx_0 + x * delta is rounded differently)
+typedef struct {
+  calc_frac_point_p cfp_p;
+  const float *cx, *cy;
+  uint16_t n_max;
+} fractal_pixels_t;
+
+//! \brief  Number of iterations at pixel (x, y)
+static uint16_t fractal_iter(int x, int y, void *arg) {
+  const fractal_pixels_t *frac = arg;
+  return (*frac->cfp_p)(frac->cx[x], frac->cy[y], frac->n_max);
+}
+
+uint32_t draw_fractal_subdivide(rgb565 *fbuf, int width, int height,
+                                calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                                float cx_0, float cy_0, float delta, uint16_t n_max) {
+  float cx[width], cy[height];
+  fractal_pixels_t frac = { cfp_p, cx, cy, n_max };
+  subdivide_stats_t stats;
+
+  cx[0] = cx_0;
+  for (int i = 1; i < width; ++i) cx[i] = cx[i - 1] + delta;
+  cy[0] = cy_0;
+  for (int k = 1; k < height; ++k) cy[k] = cy[k - 1] + delta;
+
+  // the frame buffer holds the iteration counts until they are mapped to colours
+  subdivide_render(fbuf, width, height, &fractal_iter, &frac, &stats);
+  for (int i = 0; i < width * height; ++i) fbuf[i] = (*i2c_p)(fbuf[i], n_max);
+  return stats.evaluated;
+}
+
+uint32_t diff_fractal_subdivide(const rgb565 *fbuf, rgb565 *reference, int width, int height,
+                                calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                                float cx_0, float cy_0, float delta, uint16_t n_max) {
+  uint32_t differing = 0;
+
+  draw_fractal(reference, width, height, cfp_p, i2c_p, cx_0, cy_0, delta, n_max);
+  for (int i = 0; i < width * height; ++i)
+    if (fbuf[i] != reference[i]) differing++;
+  return differing;
+}
@@ -15,6 +15,17 @@ const float CX_0 = -2.0;      //!< default start x-coordinate (-2.0 in Q4.28)
 const float CY_0 = -1.5;      //!< default start y-coordinate (-1.5 in Q4.28)
 const uint16_t N_MAX = 64;    //!< maximum number of iterations
 
+// #define __FAST_PATHS__ // cardioid test and periodicity check, __FAST_PATHS_CHECK__ checks the result
+#ifdef __FAST_PATHS__
+#define CALC_MANDELBROT_POINT calc_mandelbrot_point_fast
+#else
+#define CALC_MANDELBROT_POINT calc_mandelbrot_point_soft
+#endif
+
+#ifdef __SUBDIVIDE_DIFF__
+rgb565 referenceBuffer[512*512]; //!< the brute-force rendering of draw_fractal
+#endif
+
 int main() {
    volatile unsigned int *vga = (unsigned int *) 0x50000020;
    volatile unsigned int reg, hi;
@@ -38,9 +49,20 @@ int main() {
    /* Clear screen */
    for (i = 0 ; i < SCREEN_WIDTH*SCREEN_HEIGHT ; i++) frameBuffer[i]=0;
 
-   draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
+#ifdef __SUBDIVIDE__
+   uint32_t evaluated = draw_fractal_subdivide(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&CALC_MANDELBROT_POINT, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
+   printf("%u of %u pixels computed\n", evaluated, SCREEN_WIDTH*SCREEN_HEIGHT);
+#ifdef __SUBDIVIDE_DIFF__
+   printf("%u pixels differ from the brute-force rendering\n", diff_fractal_subdivide(frameBuffer,referenceBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&CALC_MANDELBROT_POINT, &iter_to_colour,CX_0,CY_0,delta,N_MAX));
+#endif
+#else
+   draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&CALC_MANDELBROT_POINT, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
+#endif
 #ifdef __OR1300__
    dcache_flush();
 #endif
    printf("Done\n");
+#ifdef __FAST_PATHS_CHECK__
+   printf("%u pixels with other iteration counts than calc_mandelbrot_point_soft\n", check_mandelbrot_point_fast(SCREEN_WIDTH,SCREEN_HEIGHT,CX_0,CY_0,delta,N_MAX));
+#endif
 }
@@ -22,4 +22,17 @@ void draw_fractal(rgb565 *fbuf, int width, int height,
                   calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
                   float cx_0, float cy_0, float delta, uint16_t n_max);
 
+//! \brief  Draws like draw_fractal, but computes only the borders of uniform rectangles
+//!         (see subdivide.h)
+//! \return number of computed pixels
+uint32_t draw_fractal_subdivide(rgb565 *fbuf, int width, int height,
+                                calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                                float cx_0, float cy_0, float delta, uint16_t n_max);
+
+//! \brief  Renders the frame with draw_fractal into reference and compares fbuf with it
+//! \return number of differing pixels
+uint32_t diff_fractal_subdivide(const rgb565 *fbuf, rgb565 *reference, int width, int height,
+                                calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                                float cx_0, float cy_0, float delta, uint16_t n_max);
+
 #endif // FRACTAL_MYFLPT_H
@@ -1,5 +1,6 @@
 #include "fractal_myflpt.h"
 #include <swap.h>
+#include <subdivide.h>
 
 //! \brief  Mandelbrot fractal point calculation function
 //! \param  cx    x-coordinate
@@ -114,3 +115,46 @@ void draw_fractal(rgb565 *fbuf, int width, int height,
     cy += delta;
   }
 }
+
+//! \brief  Arguments of the pixel function of draw_fractal_subdivide, the coordinates
+//!         are accumulated as in draw_fractal (cx_0 + x * delta is rounded differently)
+typedef struct {
+  calc_frac_point_p cfp_p;
+  const float *cx, *cy;
+  uint16_t n_max;
+} fractal_pixels_t;
+
+//! \brief  Number of iterations at pixel (x, y)
+static uint16_t fractal_iter(int x, int y, void *arg) {
+  const fractal_pixels_t *frac = arg;
+  return (*frac->cfp_p)(frac->cx[x], frac->cy[y], frac->n_max);
+}
+
+uint32_t draw_fractal_subdivide(rgb565 *fbuf, int width, int height,
+                                calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                                float cx_0, float cy_0, float delta, uint16_t n_max) {
+  float cx[width], cy[height];
+  fractal_pixels_t frac = { cfp_p, cx, cy, n_max };
+  subdivide_stats_t stats;
+
+  cx[0] = cx_0;
+  for (int i = 1; i < width; ++i) cx[i] = cx[i - 1] + delta;
+  cy[0] = cy_0;
+  for (int k = 1; k < height; ++k) cy[k] = cy[k - 1] + delta;
+
+  // the frame buffer holds the iteration counts until they are mapped to colours
+  subdivide_render(fbuf, width, height, &fractal_iter, &frac, &stats);
+  for (int i = 0; i < width * height; ++i) fbuf[i] = (*i2c_p)(fbuf[i], n_max);
+  return stats.evaluated;
+}
+
+uint32_t diff_fractal_subdivide(const rgb565 *fbuf, rgb565 *reference, int width, int height,
+                                calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                                float cx_0, float cy_0, float delta, uint16_t n_max) {
+  uint32_t differing = 0;
+
+  draw_fractal(reference, width, height, cfp_p, i2c_p, cx_0, cy_0, delta, n_max);
+  for (int i = 0; i < width * height; ++i)
+    if (fbuf[i] != reference[i]) differing++;
+  return differing;
+}
@@ -0,0 +1,99 @@
+#include <arena.h>
+
+/**
+ * @brief Rounds an object size up to a power of two if it fits into a line,
+ * otherwise up to a multiple of a word.
+ *
+ */
+static uint32_t elem_size(size_t size) {
+    if (size > ARENA_LINE_SIZE) {
+        return (size + 3) & ~((uint32_t)3);
+    }
+
+    uint32_t res = 4;
+    while (res < size) {
+        res <<= 1;
+    }
+    return res;
+}
+
+void arena_init(arena_t* arena, void* buffer, size_t size) {
+    uint32_t start = ((uint32_t)buffer + ARENA_LINE_SIZE - 1) & ~((uint32_t)ARENA_LINE_SIZE - 1);
+    uint32_t skip = start - (uint32_t)buffer;
+
+    arena->base = (uint8_t*)start;
+    arena->size = (size > skip) ? size - skip : 0;
+    arena->next = 0;
+}
+
+void* arena_alloc(arena_t* arena, size_t size, size_t align) {
+    size_t start = (arena->next + align - 1) & ~(align - 1);
+
+    if (start + size > arena->size) {
+        return NULL;
+    }
+
+    arena->next = start + size;
+    return arena->base + start;
+}
+
+void arena_reset(arena_t* arena) {
+    arena->next = 0;
+}
+
+void arena_pool_init(arena_pool_t* pool, arena_t* arena, size_t elem, size_t slab_count) {
+    pool->arena = arena;
+    pool->elem_size = elem_size(elem);
+    pool->slab_count = slab_count ? slab_count : 1;
+    arena_pool_reset(pool);
+}
+
+void* arena_pool_alloc(arena_pool_t* pool) {
+    if (pool->free_list != NULL) {
+        void* res = pool->free_list;
+        pool->free_list = *(void**)res;
+        return res;
+    }
+
+    if (pool->slab == NULL || pool->slab_used == pool->slab_count) {
+        uint8_t* slab = arena_alloc(pool->arena, pool->elem_size * pool->slab_count, ARENA_LINE_SIZE);
+        if (slab == NULL) {
+            return NULL;
+        }
+        pool->slab = slab;
+        pool->slab_used = 0;
+    }
+
+    return pool->slab + pool->elem_size * pool->slab_used++;
+}
+
+void arena_pool_free(arena_pool_t* pool, void* object) {
+    // the first word of a free object links the free list
+    *(void**)object = pool->free_list;
+    pool->free_list = object;
+}
+
+void arena_pool_reset(arena_pool_t* pool) {
+    pool->slab = NULL;
+    pool->slab_used = 0;
+    pool->free_list = NULL;
+}
+
+int arena_split_init(arena_split_t* split, arena_t* hot_arena, arena_t* cold_arena,
+                     size_t hot_size, size_t cold_size, size_t capacity) {
+    split->hot_size = elem_size(hot_size);
+    split->cold_size = elem_size(cold_size);
+    split->capacity = capacity;
+    split->count = 0;
+
+    split->hot = arena_alloc(hot_arena, split->hot_size * capacity, ARENA_LINE_SIZE);
+    split->cold = arena_alloc(cold_arena, split->cold_size * capacity, ARENA_LINE_SIZE);
+    return (split->hot == NULL || split->cold == NULL) ? -1 : 0;
+}
+
+uint32_t arena_split_alloc(arena_split_t* split) {
+    if (split->count == split->capacity) {
+        return ARENA_NONE;
+    }
+    return split->count++;
+}
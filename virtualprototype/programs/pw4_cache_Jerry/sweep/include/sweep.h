@@ -0,0 +1,17 @@
+#ifndef SWEEP_H_INCLUDED
+#define SWEEP_H_INCLUDED
+
+/**
+ * @brief Starts the measurement of a data point.
+ *
+ */
+void sweep_start();
+
+/**
+ * @brief Stops the measurement and prints one CSV row for the data point and the
+ * current cache configuration (see main.c for the columns).
+ *
+ */
+void sweep_stop(int count, int datalen, int packed, int size);
+
+#endif /* SWEEP_H_INCLUDED */
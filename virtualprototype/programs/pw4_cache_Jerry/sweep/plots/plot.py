@@ -1,6 +1,8 @@
 import matplotlib
 import matplotlib.pyplot as plt
+import csv
 import re
+import sys
 import pathlib
 import dataclasses
 from typing import *
@@ -8,6 +10,10 @@ from typing import *
 REGEX = r"^.*?(\d+).*?(\d+).*?(True|False).*?(\d+).*?(\d+)$"
 COUNT = 256
 
+# the configuration used before the sweep iterated over the caches (see main.c)
+DEFAULT_ICACHE = "4k-2way-lru"
+DEFAULT_DCACHE = "4k-4way-lru-wb"
+
 
 @dataclasses.dataclass(frozen=True)
 class Row:
@@ -16,22 +22,57 @@ class Row:
     packed: bool
     sizeof: int
     misses: int
+    icache: str = DEFAULT_ICACHE
+    dcache: str = DEFAULT_DCACHE
+    writebacks: int = 0
+    stalls: int = 0
+    icache_misses: int = 0
+    cycles: int = 0
+
+
+def load_csv(lines: List[str]) -> List[Row]:
+    l: List[Row] = []
+
+    for r in csv.DictReader(lines):
+        l.append(Row(
+            count=int(r["count"]),
+            datalen=int(r["datalen"]),
+            packed=r["packed"] == "True",
+            sizeof=int(r["sizeof"]),
+            misses=int(r["misses"]),
+            icache=r["icache"],
+            dcache=r["dcache"],
+            writebacks=int(r["writebacks"]),
+            stalls=int(r["stalls"]),
+            icache_misses=int(r["icache_misses"]),
+            cycles=int(r["cycles"])
+        ))
+
+    return l
 
 
 def load_data(fpath: pathlib.Path) -> List[Row]:
     l: List[Row] = []
 
     with open(fpath) as f:
-        matches = re.finditer(REGEX, f.read(), re.MULTILINE)
-        for match in matches:
-            groups = match.groups()
-            l.append(Row(
-                count=int(groups[0]),
-                datalen=int(groups[1]),
-                packed=groups[2] == "True",
-                sizeof=int(groups[3]),
-                misses=int(groups[4])
-            ))
+        text = f.read()
+
+    # the sweep prints CSV (after the boot messages); older runs printed one "Config:" line per point
+    lines = text.splitlines()
+    for i, line in enumerate(lines):
+        if line.startswith("count,"):
+            return load_csv([x for x in lines[i:] if x.count(",") == line.count(",")])
+
+    matches = re.finditer(REGEX, text, re.MULTILINE)
+    for match in matches:
+        groups = match.groups()
+        l.append(Row(
+            count=int(groups[0]),
+            datalen=int(groups[1]),
+            packed=groups[2] == "True",
+            sizeof=int(groups[3]),
+            misses=int(groups[4])
+        ))
 
     return l
 
@@ -50,6 +91,10 @@ def fig_axes(title, ylabel, xlabel):
     return (fig, axes)
 
 
+def default_config(data: List[Row]) -> List[Row]:
+    return list(filter(lambda x: x.icache == DEFAULT_ICACHE and x.dcache == DEFAULT_DCACHE, data))
+
+
 def plot1(data: List[Row]):
     # sizeof vs datalen
     print("plot1")
@@ -98,8 +143,33 @@ def plot2(data: List[Row]):
     fig.savefig("plot2.pdf")
 
 
+def plot3(data: List[Row]):
+    # misses vs datalen for every D$ size and associativity (LRU, write-back)
+    print("plot3")
+    fig, axes = fig_axes(
+        "Data Cache Misses per Configuration", "Number of Misses", "Data Length (bytes)")
+
+    axes.grid()
+    axes.set_xticks([0, 4, 8, 12, 16, 20, 24, 28, 32])
+
+    configs = sorted(set(map(lambda x: x.dcache, filter(
+        lambda x: x.icache == DEFAULT_ICACHE and x.dcache.endswith("-lru-wb"), data))))
+    for config in configs:
+        points = sorted(filter(lambda x: x.dcache == config and x.icache == DEFAULT_ICACHE and
+                               not x.packed and x.count == COUNT, data), key=lambda x: x.datalen)
+        axes.plot([x.datalen for x in points], [x.misses for x in points], label=config, marker=".")
+    axes.legend(fontsize=8, ncol=2)
+
+    fig.savefig("plot3.pdf")
+
+
 if __name__ == "__main__":
     set_font()
-    data = load_data("data.txt")
-    plot1(data)
-    plot2(data)
+    if len(sys.argv) > 1:
+        fname = sys.argv[1]
+    else:
+        fname = "data.csv" if pathlib.Path("data.csv").exists() else "data.txt"
+    data = load_data(fname)
+    plot1(default_config(data))
+    plot2(default_config(data))
+    plot3(data)
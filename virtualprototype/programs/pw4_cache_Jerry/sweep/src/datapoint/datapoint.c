@@ -5,6 +5,7 @@
 #include <string.h>
 
 #include "params.h"
+#include "sweep.h"
 
 /**
  * @brief Item struct.
@@ -57,14 +58,7 @@ item_t* items_find(uint32_t id) {
 void PARAM_ENTRY() {
     dcache_flush();
 
-    perf_start();
+    sweep_start();
     items_find(PARAM_MAGIC);
-    perf_stop();
-
-    printf(
-        "Config: %-32s, sizeof(item_t): %2d, dcache misses: %10lld\n",
-        PARAM_DESC,
-        sizeof(item_t),
-        perf_read_counter(PERF_COUNTER_0)
-    );
+    sweep_stop(PARAM_COUNT, PARAM_DATALEN, PARAM_IS_PACKED, sizeof(item_t));
 }
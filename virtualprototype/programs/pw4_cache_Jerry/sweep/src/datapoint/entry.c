@@ -3,6 +3,5 @@
 #endif
 
 void entry() {
-    puts("");
     ALL_ENTRIES
 }
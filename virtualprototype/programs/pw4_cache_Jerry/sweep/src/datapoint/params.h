@@ -20,8 +20,10 @@
 
 #ifdef PARAM_PACKED
 #define PACKED __packed
+#define PARAM_IS_PACKED 1
 #else
 #define PACKED
+#define PARAM_IS_PACKED 0
 #endif
 
 // If PARAM_PACKED is defined, then PACKED becomes __packed (i.e., packed attribute).
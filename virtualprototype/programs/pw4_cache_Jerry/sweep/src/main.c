@@ -1,22 +1,103 @@
 #include "datapoint/entry.h"
+#include "sweep.h"
 #include <cache.h>
 #include <perf.h>
 #include <platform.h>
 #include <stdio.h>
 #include <string.h>
 
+#define DEFAULT_ICACHE_CFG (CACHE_TWO_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU)
+#define DEFAULT_DCACHE_CFG (CACHE_FOUR_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK)
+
+static const uint32_t sizes[] = { CACHE_SIZE_1K, CACHE_SIZE_2K, CACHE_SIZE_4K, CACHE_SIZE_8K };
+static const uint32_t ways[] = { CACHE_DIRECT_MAPPED, CACHE_TWO_WAY, CACHE_FOUR_WAY };
+static const uint32_t policies[] = { CACHE_REPLACE_FIFO, CACHE_REPLACE_PLRU, CACHE_REPLACE_LRU };
+static const uint32_t write_policies[] = { CACHE_WRITE_BACK, CACHE_WRITE_THROUGH };
+
+static const char *size_names[] = { "1k", "2k", "4k", "8k" };
+static const char *ways_names[] = { "dm", "2way", "4way" };
+static const char *policy_names[] = { "fifo", "plru", "lru" };
+
+static char icache_name[32], dcache_name[32];
+
+/**
+ * @brief Writes the short name of a configuration (e.g. "4k-4way-lru-wb") into `name`.
+ *
+ */
+static void cfg_name(char *name, uint32_t cfg, int dcache) {
+    sprintf(name, "%s-%s-%s%s", size_names[(cfg >> 30) & 3], ways_names[cfg & 3],
+            policy_names[(cfg >> 16) & 3], dcache ? ((cfg & CACHE_WRITE_BACK) ? "-wb" : "-wt") : "");
+}
+
+/**
+ * @brief Switches both caches to a new configuration.
+ *
+ * The size and the associativity can only be changed while a cache is disabled; the
+ * D$ is flushed first such that no dirty line is lost.
+ */
+static void apply_cfg(uint32_t icfg, uint32_t dcfg) {
+    dcache_flush();
+    dcache_enable(0);
+    icache_enable(0);
+    dcache_write_cfg(dcfg);
+    icache_write_cfg(icfg);
+    icache_enable(1);
+    dcache_enable(1);
+    icache_flush();
+    dcache_flush();
+    cfg_name(icache_name, icfg, 0);
+    cfg_name(dcache_name, dcfg, 1);
+}
+
+void sweep_start() {
+    perf_start();
+}
+
+void sweep_stop(int count, int datalen, int packed, int size) {
+    perf_stop();
+    printf("%d,%d,%s,%d,%s,%s,%lld,%lld,%lld,%lld,%lld\n", count, datalen, packed ? "True" : "False", size,
+           icache_name, dcache_name,
+           perf_read_counter(PERF_COUNTER_0), perf_read_counter(PERF_COUNTER_1),
+           perf_read_counter(PERF_COUNTER_2), perf_read_counter(PERF_COUNTER_3),
+           perf_read_counter(PERF_COUNTER_RUNTIME));
+}
+
 int main() {
     // initializes the UART, performance counters, peripherals etc.
     platform_init();
     perf_init();
 
-    dcache_write_cfg(CACHE_FOUR_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK);
-    dcache_enable(1);
-
     perf_set_mask(PERF_COUNTER_0, PERF_DCACHE_MISS_MASK);
+    perf_set_mask(PERF_COUNTER_1, PERF_DCACHE_WRITE_BACK_MASK);
+    perf_set_mask(PERF_COUNTER_2, PERF_STALL_CYCLES_MASK);
+    perf_set_mask(PERF_COUNTER_3, PERF_ICACHE_MISS_MASK);
+
+    puts("");
+    puts("count,datalen,packed,sizeof,icache,dcache,misses,writebacks,stalls,icache_misses,cycles");
+
+    // every D$ configuration with the I$ at its default...
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+        for (size_t w = 0; w < sizeof(ways) / sizeof(ways[0]); ++w)
+            for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); ++p)
+                for (size_t wp = 0; wp < sizeof(write_policies) / sizeof(write_policies[0]); ++wp) {
+                    apply_cfg(DEFAULT_ICACHE_CFG, sizes[s] | ways[w] | policies[p] | write_policies[wp]);
+                    entry();
+                }
+
+    // ...and every I$ configuration with the D$ at its default
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+        for (size_t w = 0; w < sizeof(ways) / sizeof(ways[0]); ++w)
+            for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); ++p) {
+                const uint32_t icfg = sizes[s] | ways[w] | policies[p];
 
-    entry();
+                // both caches at their default were measured by the first sweep
+                if (icfg == DEFAULT_ICACHE_CFG)
+                    continue;
+                apply_cfg(icfg, DEFAULT_DCACHE_CFG);
+                entry();
+            }
 
+    apply_cfg(DEFAULT_ICACHE_CFG, DEFAULT_DCACHE_CFG);
     printf("done.\n");
     return 0;
 }
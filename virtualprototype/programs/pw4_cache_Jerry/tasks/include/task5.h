@@ -0,0 +1,6 @@
+#ifndef TASK5_H_INCLUDED
+#define TASK5_H_INCLUDED
+
+void task5_main();
+
+#endif /* TASK5_H_INCLUDED */
@@ -9,6 +9,7 @@
 #include <task2.h>
 #include <task3.h>
 #include <task4.h>
+#include <task5.h>
 
 int main() {
     // initializes the UART, performance counters, peripherals etc.
@@ -23,6 +24,7 @@ int main() {
     task1_main();
     task2_main();
     task3_main();
+    task5_main(); // task4 does not return
     task4_main();
 
     return 0;
@@ -0,0 +1,220 @@
+#include <arena.h>
+#include <cache.h>
+#include <defs.h>
+#include <item.h>
+#include <lfsr.h>
+#include <node.h>
+#include <perf.h>
+#include <stdio.h>
+#include <task5.h>
+
+// Task 5: the structures of task 1 and 2 on the arena allocator, compared to the naive layout.
+
+#define LOG2NUM 6 // 64 nodes resp. items in total
+#define NUM (1 << LOG2NUM)
+#define NODE_NONE 0xFFFF
+
+/**
+ * @brief The original layout of node_t, the links are behind the data.
+ *
+ */
+typedef struct naive_node_t naive_node_t;
+struct naive_node_t {
+    unsigned id;
+    char data[NODE_DATALEN];
+    naive_node_t* next;
+    naive_node_t* prev;
+};
+
+/**
+ * @brief The item with its data inline.
+ *
+ */
+typedef struct {
+    unsigned id;
+    char data[ITEM_DATALEN];
+} naive_item_t;
+
+/**
+ * @brief The hot fields of a node, linked by index (4 nodes per line).
+ *
+ */
+typedef struct {
+    unsigned id;
+    uint16_t next;
+    uint16_t prev;
+} hot_node_t;
+
+typedef struct {
+    char data[NODE_DATALEN];
+} cold_node_t;
+
+typedef struct {
+    char data[ITEM_DATALEN];
+} cold_item_t;
+
+static naive_node_t naive_nodes[NUM] __aligned(ARENA_LINE_SIZE);
+static naive_item_t naive_items[NUM] __aligned(ARENA_LINE_SIZE);
+
+static char arena_buffer[8 * 1024];
+static arena_t hot_arena, cold_arena;
+
+static void naive_init() {
+    struct lfsr_fibonacci lfsr;
+    lfsr_fibonacci_init(&lfsr, LOG2NUM, 5, 0);
+
+    for (size_t i = 0; i < NUM; ++i) {
+        naive_nodes[i].id = i;
+        naive_nodes[i].next = NULL;
+        naive_nodes[i].prev = NULL;
+        naive_items[i].id = i;
+        sprintf(naive_items[i].data, "item #%u", i);
+    }
+
+    naive_node_t* last = &naive_nodes[0];
+    for (size_t i = 0; i < NUM - 1; ++i) {
+        unsigned num = lfsr_fibonacci_next(&lfsr);
+        sprintf(last->data, "connects to node #%u", num);
+        last->next = &naive_nodes[num];
+        naive_nodes[num].prev = last;
+        last = &naive_nodes[num];
+    }
+}
+
+/**
+ * @brief Same nodes and items as naive_init(), with the hot and cold fields split.
+ * The nodes are index linked, the items point to their cold data. The index of the
+ * first node is stored in `first`.
+ *
+ * @return int 0 on success, -1 if the arenas are too small.
+ */
+static int split_init(arena_split_t* nodes, arena_split_t* items, uint16_t* first) {
+    struct lfsr_fibonacci lfsr;
+    uint16_t node_index[NUM]; // the index of node i in the split
+    lfsr_fibonacci_init(&lfsr, LOG2NUM, 5, 0);
+
+    if (ARENA_SPLIT_INIT(nodes, &hot_arena, &cold_arena, hot_node_t, cold_node_t, NUM) != 0 ||
+        ARENA_SPLIT_INIT(items, &hot_arena, &cold_arena, item_t, cold_item_t, NUM) != 0)
+        return -1;
+
+    for (size_t i = 0; i < NUM; ++i) {
+        uint32_t index = arena_split_alloc(nodes);
+        if (index == ARENA_NONE)
+            return -1;
+        node_index[i] = index;
+        hot_node_t* node = ARENA_SPLIT_HOT(nodes, index, hot_node_t);
+        node->id = i;
+        node->next = NODE_NONE;
+        node->prev = NODE_NONE;
+
+        index = arena_split_alloc(items);
+        if (index == ARENA_NONE)
+            return -1;
+        item_t* item = ARENA_SPLIT_HOT(items, index, item_t);
+        item->id = i;
+        item->data = ARENA_SPLIT_COLD(items, index, cold_item_t)->data;
+        sprintf(item->data, "item #%u", i);
+    }
+
+    uint16_t last = node_index[0];
+    for (size_t i = 0; i < NUM - 1; ++i) {
+        uint16_t num = node_index[lfsr_fibonacci_next(&lfsr)];
+        sprintf(ARENA_SPLIT_COLD(nodes, last, cold_node_t)->data, "connects to node #%u",
+                ARENA_SPLIT_HOT(nodes, num, hot_node_t)->id);
+        ARENA_SPLIT_HOT(nodes, last, hot_node_t)->next = num;
+        ARENA_SPLIT_HOT(nodes, num, hot_node_t)->prev = last;
+        last = num;
+    }
+    *first = node_index[0];
+    return 0;
+}
+
+static uint32_t naive_count(const naive_node_t* node) {
+    uint32_t result = 0;
+
+    while (node) {
+        result += node->id;
+        node = node->next;
+    }
+    return result;
+}
+
+static uint32_t split_count(const arena_split_t* nodes, uint16_t index) {
+    uint32_t result = 0;
+
+    while (index != NODE_NONE) {
+        const hot_node_t* node = ARENA_SPLIT_HOT(nodes, index, hot_node_t);
+        result += node->id;
+        index = node->next;
+    }
+    return result;
+}
+
+static naive_item_t* naive_find(unsigned id) {
+    for (size_t i = 0; i < NUM; ++i) {
+        if (naive_items[i].id == id)
+            return &naive_items[i];
+    }
+    return NULL;
+}
+
+static item_t* split_find(const arena_split_t* items, unsigned id) {
+    for (size_t i = 0; i < items->count; ++i) {
+        item_t* item = ARENA_SPLIT_HOT(items, i, item_t);
+        if (item->id == id)
+            return item;
+    }
+    return NULL;
+}
+
+static void report(const char* what, uint32_t result) {
+    printf("Task 5: %-12s (%4u) dcache misses: %10lld\n", what, result, perf_read_counter(PERF_COUNTER_0));
+}
+
+void task5_main() {
+    puts(__func__);
+
+    arena_init(&hot_arena, arena_buffer, sizeof(arena_buffer) / 4);
+    arena_init(&cold_arena, arena_buffer + sizeof(arena_buffer) / 4, sizeof(arena_buffer) * 3 / 4);
+
+    arena_split_t nodes, items;
+    uint16_t first;
+    naive_init();
+    if (split_init(&nodes, &items, &first) != 0) {
+        printf("Task 5: the arena of %u bytes is too small\n", (unsigned)sizeof(arena_buffer));
+        arena_reset(&hot_arena);
+        arena_reset(&cold_arena);
+        return;
+    }
+    printf("arena: %u hot bytes, %u cold bytes\n", arena_used(&hot_arena), arena_used(&cold_arena));
+
+    uint32_t result;
+
+    dcache_flush();
+    perf_start();
+    result = naive_count(&naive_nodes[0]);
+    perf_stop();
+    report("naive nodes", result);
+
+    dcache_flush();
+    perf_start();
+    result = split_count(&nodes, first);
+    perf_stop();
+    report("split nodes", result);
+
+    dcache_flush();
+    perf_start();
+    result = naive_find(NUM - 1)->id;
+    perf_stop();
+    report("naive items", result);
+
+    dcache_flush();
+    perf_start();
+    result = split_find(&items, NUM - 1)->id;
+    perf_stop();
+    report("split items", result);
+
+    // everything of this phase is freed at once
+    arena_reset(&hot_arena);
+    arena_reset(&cold_arena);
+}
@@ -8,6 +8,7 @@
 #include <perf.h>
 #include <spr.h>
 #include <exception.h>
+#include <string.h>
 
 
 // Constants describing the output device
@@ -28,6 +29,18 @@
 #define IRQ_BTN        (1 << 3)  // Buttons and Joystick Enable IRQ bit 3
 #define SR_IEE              (1 << 2)  // Interrupt Exception Enable bit inside SR!! I wrongly set this to 1<<3 before, then it did not work!!
 
+// Bits of the buttons register (not swapped), the joystick directions may differ per board
+#define JOY_UP              (1 << 0)
+#define JOY_DOWN            (1 << 1)
+#define JOY_LEFT            (1 << 2)
+#define JOY_RIGHT           (1 << 3)
+#define JOY_CENTER          (1 << 4)  // zoom in
+#define BTN_SW1             (1 << 5)  // zoom out
+#define BTN_SW2             (1 << 6)  // full redraw
+
+#define PAN_STEP            32        // pixels per joystick event, even as the ISE computes pixel pairs
+#define SHOW_FRACTAL        0         // 1 shows the frame buffer on the vga, 0 disables the vga controller
+
 /** switches.h content
  *  #define SWITCHES_BASE_ADDRESS 0x50000080
  *  #define DIP_SWITCH_STATE_ID 0
@@ -50,8 +63,11 @@ const uint16_t N_MAX = 64;
 // global variables indicating the zoom factor and x- and y- offset for the fractal
 // uint32_t delta, cxOff, cyOff, redraw;
 uint32_t delta, cxOff, cyOff;
-volatile uint32_t redraw;
-uint32_t frameBuffer[(SCREEN_WIDTH * SCREEN_HEIGHT)/2];
+volatile uint32_t pendingButtons; // the buttons pressed since the last update
+// The frame is rendered into the back buffer and then shown. The colour of a pixel only depends
+// on its iteration count, hence the front buffer is the iteration cache for the next frame.
+uint32_t frameBuffer[2][(SCREEN_WIDTH * SCREEN_HEIGHT)/2];
+int front = 0;
 
 
 void drawFractal(uint32_t *frameBuffer) {
@@ -73,6 +89,130 @@ void drawFractal(uint32_t *frameBuffer) {
   printf("Done\n");
 }
 
+/* Incremental rendering: the pixels still on the screen are copied from the front buffer */
+
+//! \brief  Computes the pixels x0, x0 + step, ... below x1 of a row with the ISE, two per call
+static void computeSpan(uint16_t *row, int x0, int x1, int step, uint32_t cy) {
+  uint32_t color = (2<<16) | N_MAX;
+  uint32_t stepDelta = delta * step;
+  uint32_t cx = CX_0 + cxOff + x0 * delta;
+  asm volatile ("l.nios_crc r0,%[in1],%[in2],0x21"::[in1]"r"(color),[in2]"r"(stepDelta));
+  for (int i = x0 ; i < x1 ; i += 2 * step) {
+    asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x20":[out1]"=r"(color):[in1]"r"(cx),[in2]"r"(cy));
+    row[i] = color >> 16; // the first pixel is in the upper half (big-endian)
+    if (i + step < x1) row[i + step] = color;
+    cx += stepDelta << 1;
+  }
+}
+
+static uint16_t *pixelBuffer(int buffer) {
+  return (uint16_t *) frameBuffer[buffer];
+}
+
+static void showBackBuffer() {
+  volatile unsigned int *vga = (unsigned int *) 0X50000020;
+  dcache_flush();
+  front ^= 1;
+  if (SHOW_FRACTAL) vga[3] = swap_u32((unsigned int) frameBuffer[front]);
+}
+
+//! \brief  Moves the view by dx, dy pixels, only the exposed strips are computed
+void panFractal(int dx, int dy) {
+  const uint16_t *src = pixelBuffer(front);
+  uint16_t *dst = pixelBuffer(front ^ 1);
+  const int x0 = (dx < 0) ? -dx : 0;
+  const int x1 = (dx > 0) ? SCREEN_WIDTH - dx : SCREEN_WIDTH;
+
+  cxOff += dx * (int32_t) delta;
+  cyOff += dy * (int32_t) delta;
+  if (dx == 0) {
+    // the kept rows are contiguous and word aligned, they are copied by the cpu as the
+    // frame buffers are in the D$ (a large memcpy may be done by the DMA-controller)
+    const int y0 = (dy < 0) ? -dy : 0;
+    const int y1 = (dy > 0) ? SCREEN_HEIGHT - dy : SCREEN_HEIGHT;
+    uint32_t *to = (uint32_t *) (dst + y0 * SCREEN_WIDTH);
+    const uint32_t *from = (const uint32_t *) (src + (y0 + dy) * SCREEN_WIDTH);
+    for (int i = 0 ; i < (y1 - y0) * SCREEN_WIDTH / 2 ; i++) to[i] = from[i];
+  }
+  uint32_t cy = CY_0 + cyOff;
+  for (int y = 0 ; y < SCREEN_HEIGHT ; y++, cy += delta) {
+    uint16_t *row = dst + y * SCREEN_WIDTH;
+    const int sy = y + dy;
+    if (sy < 0 || sy >= SCREEN_HEIGHT || x1 <= x0) {
+      computeSpan(row, 0, SCREEN_WIDTH, 1, cy);
+      continue;
+    }
+    if (dx != 0) memcpy(row + x0, src + sy * SCREEN_WIDTH + x0 + dx, (x1 - x0) * sizeof(uint16_t));
+    if (x0 > 0) computeSpan(row, 0, x0, 1, cy);
+    if (x1 < SCREEN_WIDTH) computeSpan(row, x1, SCREEN_WIDTH, 1, cy);
+  }
+  showBackBuffer();
+}
+
+//! \brief  Zooms in by 2 around the centre, the even pixels of the even rows are the old samples
+//! \note   An odd delta is not halved exactly, the old samples are off the new grid then and
+//!         the frame is redrawn completely
+void zoomInFractal() {
+  const uint16_t *src = pixelBuffer(front);
+  uint16_t *dst = pixelBuffer(front ^ 1);
+  const int exact = (delta & 1) == 0;
+
+  cxOff += (SCREEN_WIDTH / 4) * delta;
+  cyOff += (SCREEN_HEIGHT / 4) * delta;
+  delta >>= 1;
+  if (!exact) {
+    drawFractal(frameBuffer[front ^ 1]);
+    showBackBuffer();
+    return;
+  }
+  uint32_t cy = CY_0 + cyOff;
+  for (int y = 0 ; y < SCREEN_HEIGHT ; y++, cy += delta) {
+    uint16_t *row = dst + y * SCREEN_WIDTH;
+    if (y & 1) {
+      computeSpan(row, 0, SCREEN_WIDTH, 1, cy);
+      continue;
+    }
+    const uint16_t *old = src + (SCREEN_HEIGHT / 4 + y / 2) * SCREEN_WIDTH + SCREEN_WIDTH / 4;
+    for (int x = 0 ; x < SCREEN_WIDTH ; x += 2) row[x] = old[x >> 1];
+    computeSpan(row, 1, SCREEN_WIDTH, 2, cy);
+  }
+  showBackBuffer();
+}
+
+//! \brief  Tells whether the coordinates c0 ... c0 + span are in the Q4.28 range
+static int inQ428Range(int64_t c0, int64_t span) {
+  return c0 >= -0x80000000LL && c0 + span <= 0x7FFFFFFFLL;
+}
+
+//! \brief  Zooms out by 2 around the centre, the old frame becomes the centre quarter
+//! \return 0 if the zoom is refused, as the frame would leave the Q4.28 range
+int zoomOutFractal() {
+  const uint16_t *src = pixelBuffer(front);
+  uint16_t *dst = pixelBuffer(front ^ 1);
+  const int64_t newDelta = (int64_t) delta << 1;
+  const int64_t cx0 = (int64_t) (int32_t) (CX_0 + cxOff) - (SCREEN_WIDTH / 2) * (int64_t) delta;
+  const int64_t cy0 = (int64_t) (int32_t) (CY_0 + cyOff) - (SCREEN_HEIGHT / 2) * (int64_t) delta;
+
+  if (!inQ428Range(cx0, SCREEN_WIDTH * newDelta) || !inQ428Range(cy0, SCREEN_HEIGHT * newDelta)) return 0;
+  cxOff -= (SCREEN_WIDTH / 2) * delta;
+  cyOff -= (SCREEN_HEIGHT / 2) * delta;
+  delta <<= 1;
+  uint32_t cy = CY_0 + cyOff;
+  for (int y = 0 ; y < SCREEN_HEIGHT ; y++, cy += delta) {
+    uint16_t *row = dst + y * SCREEN_WIDTH;
+    if (y < SCREEN_HEIGHT / 4 || y >= 3 * SCREEN_HEIGHT / 4) {
+      computeSpan(row, 0, SCREEN_WIDTH, 1, cy);
+      continue;
+    }
+    const uint16_t *old = src + 2 * (y - SCREEN_HEIGHT / 4) * SCREEN_WIDTH;
+    for (int x = SCREEN_WIDTH / 4 ; x < 3 * SCREEN_WIDTH / 4 ; x++) row[x] = old[2 * (x - SCREEN_WIDTH / 4)];
+    computeSpan(row, 0, SCREEN_WIDTH / 4, 1, cy);
+    computeSpan(row, 3 * SCREEN_WIDTH / 4, SCREEN_WIDTH, 1, cy);
+  }
+  showBackBuffer();
+  return 1;
+}
+
 /* Interrupt Handlers Declarations */
 void buttons_handler(void);
 void dipswitch_handler(void);
@@ -94,7 +234,7 @@ int main() {
   /* Enable the vga-controller's graphic mode */
   vga[0] = swap_u32(SCREEN_WIDTH);
   vga[1] = swap_u32(SCREEN_HEIGHT);
-  // vga[3] = swap_u32((unsigned int)&frameBuffer[0]); // disable the vga controller by commenting this line
+  // the frame buffer is set by showBackBuffer() if SHOW_FRACTAL is 1
 
 
   /* IMPORTANT: First enable interrupt generation on the switch peripheral itself */
@@ -108,7 +248,7 @@ int main() {
   // switches[BUTTONS_PRESSED_IRQ_ID] = swap_u32(0xFF); // on the GECKO5 board, only the lower 8 bits are available for buttons/joystick, all others read as 0, but require change from little to big endian
 
   switches[DIP_SWITCH_PRESSED_IRQ_ID] = swap_u32(0x01); // Enable only DIP-switch 1 interrupt
-  switches[BUTTONS_PRESSED_IRQ_ID] = swap_u32(0x40); // Enable only Button SW2 interrupt (bit 6)
+  switches[BUTTONS_PRESSED_IRQ_ID] = swap_u32(0x7F); // Enable the joystick (bits 0 to 4), SW1 (bit 5) and SW2 (bit 6) interrupts
 
 
   
@@ -134,6 +274,8 @@ int main() {
   cxOff = 0;
   cyOff = 0;
   // redraw = 1;
+  drawFractal(frameBuffer[front ^ 1]); // the first frame is the cache of the following ones
+  showBackBuffer();
 
   uint32_t dip_switch_old = 0;
   uint32_t joystick_button_old = 0;
@@ -166,10 +308,29 @@ int main() {
     // printf("%#x", joystick_button_new);
 
     
-    /* Orignal redraw */
-    if (redraw == 1) {
-      redraw = 0;
-    drawFractal(frameBuffer);
+    /* Update the view, only the pixels that are not on the screen yet are computed */
+    sr = SPR_READ(SPR_SR);
+    SPR_WRITE(SPR_SR, sr & ~SR_IEE);
+    uint32_t buttons = pendingButtons;
+    pendingButtons = 0;
+    SPR_WRITE(SPR_SR, sr);
+
+    if (buttons != 0) {
+      perf_start();
+      if (buttons & BTN_SW2) {
+        drawFractal(frameBuffer[front ^ 1]);
+        showBackBuffer();
+      } else if (buttons & JOY_CENTER) {
+        if (delta >= 2) zoomInFractal();
+      } else if (buttons & BTN_SW1) {
+        if (!zoomOutFractal()) printf("Zoom out refused, the frame would leave the Q4.28 range\n");
+      } else {
+        int dx = ((buttons & JOY_RIGHT) ? PAN_STEP : 0) - ((buttons & JOY_LEFT) ? PAN_STEP : 0);
+        int dy = ((buttons & JOY_DOWN) ? PAN_STEP : 0) - ((buttons & JOY_UP) ? PAN_STEP : 0);
+        if (dx != 0 || dy != 0) panFractal(dx, dy);
+      }
+      perf_stop();
+      perf_print_cycles(PERF_COUNTER_RUNTIME, "update runtime");
     }
 
     // --- TASK 2.4 MODIFICATION ---
@@ -229,8 +390,8 @@ void buttons_handler(void) {
   // Print the latency value in decimal as requested
   printf("IRQ Latency: %u cycles\n", latency); // Use unsigned decimal format to prevent negative values
 
-  // Trigger the redraw in the main loop to measure CPU runtime 
-  redraw = 1;
+  // Trigger the update in the main loop to measure CPU runtime 
+  pendingButtons |= swap_u32(button_value);
   
   // --- TASK 2.4 END ---
 
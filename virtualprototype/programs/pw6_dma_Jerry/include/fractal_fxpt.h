@@ -10,14 +10,44 @@ typedef uint16_t (*calc_frac_point_p)(fxpt_4_28 cx, fxpt_4_28 cy, uint16_t n_max
 typedef rgb565 (*iter_to_colour_p)(uint16_t iter, uint16_t n_max);
 
 uint16_t calc_mandelbrot_point_soft(fxpt_4_28 cx, fxpt_4_28 cy, uint16_t n_max);
+uint16_t calc_mandelbrot_point_ise(fxpt_4_28 cx, fxpt_4_28 cy, uint16_t n_max);
+
+// Fast paths of calc_mandelbrot_point_fast(), or-ed into mandelbrot_fast_paths
+#define MANDELBROT_CARDIOID    1 //!< points in the main cardioid and the period-2 bulb return n_max at once
+#define MANDELBROT_PERIODICITY 2 //!< an orbit that repeats exactly returns n_max
+#define MANDELBROT_LAST_PIXEL  4 //!< the periodicity check only runs if the previous pixel reached n_max
+
+extern uint32_t mandelbrot_fast_paths; //!< all fast paths by default
+
+uint16_t calc_mandelbrot_point_fast(fxpt_4_28 cx, fxpt_4_28 cy, uint16_t n_max);
+
+//! \brief  Compares calc_mandelbrot_point_fast with calc_mandelbrot_point_soft over the view,
+//!         pixel by pixel in the order of draw_fractal
+//! \return number of pixels with different iteration counts
+uint32_t check_mandelbrot_point_fast(int width, int height,
+                                     fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max);
 
 rgb565 iter_to_bw(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_grayscale(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_colour(uint16_t iter, uint16_t n_max);
 rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max);
+rgb565 iter_to_identity(uint16_t iter, uint16_t n_max);
 
 void draw_fractal(rgb565 *fbuf, int width, int height,
                   calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
                   fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max);
 
+//! \brief  Draws like draw_fractal, but computes only the borders of uniform rectangles
+//!         (see subdivide.h), without the DMA-controller
+//! \return number of computed pixels
+uint32_t draw_fractal_subdivide(rgb565 *fbuf, int width, int height,
+                                calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                                fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max);
+
+//! \brief  Compares fbuf with the brute-force rendering
+//! \return number of differing pixels
+uint32_t diff_fractal_subdivide(const rgb565 *fbuf, int width, int height,
+                                calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                                fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max);
+
 #endif // FRACTAL_FXPT_H
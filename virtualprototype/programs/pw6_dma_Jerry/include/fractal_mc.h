@@ -0,0 +1,39 @@
+#ifndef FRACTAL_MC_H
+#define FRACTAL_MC_H
+
+#include <main.h>
+#include <perf.h>
+
+#define FRACTAL_MC_MAX_CORES 2   //!< cpu1 and cpu2 of the dual-core system
+#define FRACTAL_MC_BLOCK_ROWS 4  //!< rows handed out at once
+#define FRACTAL_MC_LOCK_ID 0     //!< protects the row counter
+
+//! \brief  What one core did during draw_fractal_mc()
+typedef struct {
+  uint32_t rows;                                  //!< number of rows rendered by the core
+  int errors;                                     //!< DMA errors of the core (see dma_error_string())
+  perf_cycles_t counters[PERF_COUNTER_RUNTIME+1]; //!< perf counters 0..7 and the runtime, with the masks of cpu1
+} fractal_mc_stats_t;
+
+//! \brief  Draw the fractal with the fractal ISE of every core
+//! \param  fbuf     frame buffer, word aligned
+//! \param  width    width of frame buffer, a multiple of 2 pixels
+//! \param  height   height of frame buffer
+//! \param  cx_0     start x-coordinate
+//! \param  cy_0     start y-coordinate
+//! \param  delta    increment for x- and y-coordinate
+//! \param  n_max    maximum number of iterations
+//! \param  cores    number of cores to use (1..FRACTAL_MC_MAX_CORES)
+//! \param  per_core filled with the results of each core, may be NULL
+//! \param  total    filled with the sum over the cores, may be NULL
+//! \return the DMA errors of all cores
+//! \note   The cores take blocks of FRACTAL_MC_BLOCK_ROWS rows from a counter in the SSRAM
+//!         until the frame is done, so a core that got cheap rows takes more of them. Each
+//!         core computes into its own SPM and copies the rows out with its own DMA-controller.
+//!         Call init_locks() first; cpu2 is started by the first call and then waits for
+//!         the next frame.
+int draw_fractal_mc(rgb565 *fbuf, int width, int height,
+                    fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max,
+                    uint32_t cores, fractal_mc_stats_t *per_core, fractal_mc_stats_t *total);
+
+#endif // FRACTAL_MC_H
@@ -1,6 +1,8 @@
 #include <fractal_fxpt.h>
 #include <swap.h>
 #include <dma.h>
+#include <stdio.h>
+#include <subdivide.h>
 
 #ifndef BURST_SIZE
 #define BURST_SIZE 255
@@ -36,6 +38,110 @@ uint16_t calc_mandelbrot_point_soft(fxpt_4_28 cx, fxpt_4_28 cy, uint16_t n_max)
   return n;
 }
 
+uint32_t mandelbrot_fast_paths = MANDELBROT_CARDIOID | MANDELBROT_PERIODICITY | MANDELBROT_LAST_PIXEL;
+
+//! \brief  Tests whether (cx, cy) lies in the main cardioid or in the period-2 bulb
+static int mandelbrot_in_cardioid(fxpt_4_28 cx, fxpt_4_28 cy) {
+  // both lie in -1.25 <= cx <= 0.375, |cy| < 0.75, which also keeps the products small
+  if (cx < -0x14000000 || cx > 0x06000000 || cy <= -0x0c000000 || cy >= 0x0c000000) return 0;
+
+  fxpt_8_56 yy = ((fxpt_8_56)cy) * ((fxpt_8_56)cy);
+  fxpt_8_56 x1 = (fxpt_8_56)(cx + 0x10000000); // cx + 1
+  if (x1 * x1 + yy < ((fxpt_8_56)1 << 52)) return 1; // (cx + 1)^2 + cy^2 < 1/16
+
+  fxpt_4_28 xq = cx - 0x04000000; // cx - 1/4
+  fxpt_4_28 q = (fxpt_4_28)((((fxpt_8_56)xq) * ((fxpt_8_56)xq) + yy) >> 28);
+  return ((fxpt_8_56)q) * ((fxpt_8_56)(q + xq)) < (yy >> 2); // q * (q + cx - 1/4) < cy^2 / 4
+}
+
+//! \brief  calc_mandelbrot_point_soft with the fast paths selected by mandelbrot_fast_paths
+//! \note   The periodicity check only stops on an exact repetition of the orbit, which then
+//!         never escapes, so the iteration counts do not change. The cardioid test is exact for
+//!         the real orbit; that the rounded orbit does not escape either is checked with
+//!         check_mandelbrot_point_fast().
+uint16_t calc_mandelbrot_point_fast(fxpt_4_28 cx, fxpt_4_28 cy, uint16_t n_max) {
+  static int last_inside = 1; // the previous pixel reached n_max
+  const uint32_t paths = mandelbrot_fast_paths;
+
+  if ((paths & MANDELBROT_CARDIOID) && mandelbrot_in_cardioid(cx, cy)) {
+    last_inside = 1;
+    return n_max;
+  }
+
+  // escaping orbits only pay for the check next to the set
+  const int periodicity = (paths & MANDELBROT_PERIODICITY) && (last_inside || !(paths & MANDELBROT_LAST_PIXEL));
+  fxpt_4_28 x = cx;
+  fxpt_4_28 y = cy;
+  fxpt_4_28 px = cx, py = cy; // saved orbit point, moved on after 1, 2, 4, ... iterations (Brent)
+  uint16_t steps = 0, period = 1;
+  uint16_t n = 0;
+  fxpt_4_28 xx, yy;
+  fxpt_8_24 xxh,yyh;
+  do {
+    fxpt_8_56 xx_tmp = ((fxpt_8_56)x) * ((fxpt_8_56)x);
+    xx = (fxpt_4_28)(xx_tmp >> 28);
+    xxh = (fxpt_8_24)(xx_tmp >> 32);
+
+    fxpt_8_56 yy_tmp = ((fxpt_8_56)y) * ((fxpt_8_56)y);
+    yy = (fxpt_4_28)(yy_tmp >> 28);
+    yyh = (fxpt_8_24)(yy_tmp >> 32);
+
+    fxpt_8_56 xy_tmp = ((fxpt_8_56)x) * ((fxpt_8_56)y);
+    fxpt_4_28 two_xy = (fxpt_4_28)(xy_tmp >> 27); // 2 * xy_tmp
+
+    x = xx - yy + cx;
+    y = two_xy + cy;
+    ++n;
+    if (periodicity) {
+      // all points of the cycle passed the escape test already
+      if (x == px && y == py && (xxh + yyh) < (1<<26)) {
+        n = n_max;
+        break;
+      }
+      if (++steps == period) {
+        steps = 0;
+        period <<= 1;
+        px = x;
+        py = y;
+      }
+    }
+  } while (((xxh + yyh) < (1<<26)) && (n < n_max));
+  last_inside = n == n_max;
+  return n;
+}
+
+uint32_t check_mandelbrot_point_fast(int width, int height,
+                                     fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max) {
+  uint32_t differing = 0;
+  fxpt_4_28 cy = cy_0;
+
+  for (int k = 0; k < height; ++k) {
+    fxpt_4_28 cx = cx_0;
+    for (int i = 0; i < width; ++i) {
+      if (calc_mandelbrot_point_fast(cx, cy, n_max) != calc_mandelbrot_point_soft(cx, cy, n_max))
+        differing++;
+      cx += delta;
+    }
+    cy += delta;
+  }
+  return differing;
+}
+
+//! \brief  Mandelbrot fractal point calculation with the fractal ISE
+//! \return colour of the ISE (colour model 2) instead of the number of iterations,
+//!         use it with iter_to_identity
+uint16_t calc_mandelbrot_point_ise(fxpt_4_28 cx, fxpt_4_28 cy, uint16_t n_max) {
+  uint32_t colour = (2<<16) | n_max;
+  asm volatile ("l.nios_crc r0,%[in1],%[in2],0x21"::[in1]"r"(colour),[in2]"r"(0));
+  asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x20":[out1]"=r"(colour):[in1]"r"(cx),[in2]"r"(cy));
+  return colour >> 16; // the ISE computes two pixels, the first one is in the upper half
+}
+
+//! \brief  Map an ISE colour to itself
+rgb565 iter_to_identity(uint16_t iter, uint16_t n_max) {
+  return iter;
+}
+
 //! \brief  Map number of performed iterations to black and white
 //! \param  iter  performed number of iterations
 //! \param  n_max maximum number of iterations
@@ -103,6 +209,29 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
 }
 
 
+//! \brief  Arguments of the line producer of draw_fractal
+typedef struct {
+  int width;
+  calc_frac_point_p cfp_p;
+  iter_to_colour_p i2c_p;
+  fxpt_4_28 cx_0, cy_0, delta;
+  uint16_t n_max;
+} fractal_lines_t;
+
+//! \brief  Computes one line of the fractal into an SPM buffer
+static void fractal_line(void *buffer, uint32_t line, void *arg) {
+  const fractal_lines_t *frac = arg;
+  volatile rgb565 *pixel = buffer;
+  fxpt_4_28 cx = frac->cx_0;
+  fxpt_4_28 cy = frac->cy_0 + (fxpt_4_28) line * frac->delta;
+
+  for (int i = 0; i < frac->width; ++i) {
+    uint16_t n_iter = (*frac->cfp_p)(cx, cy, frac->n_max);
+    pixel[i] = (*frac->i2c_p)(n_iter, frac->n_max);
+    cx += frac->delta;
+  }
+}
+
 //! \brief  Draw fractal into frame buffer
 //! \param  width  width of frame buffer
 //! \param  height height of frame buffer
@@ -116,63 +245,51 @@ rgb565 iter_to_colour1(uint16_t iter, uint16_t n_max) {
 void draw_fractal(rgb565 *fbuf, int width, int height,
                   calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
                   fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max) {
+  fractal_lines_t frac = { width, cfp_p, i2c_p, cx_0, cy_0, delta, n_max };
+  size_t line_size = width * sizeof(rgb565);
 
-  // --- STATIC DMA CONFIGURATION ---
-
-  // 1. DMA Base Address
-  volatile uint32_t *dma = (uint32_t *) DMA_BASE_ADDRESS;
-
-  // 2. Set Buffer Size
-  uint32_t spm_buffer_size = width * 2 / 4; // 1024 bytes
-  dma[TRANSFER_SIZE_ID] = swap_u32(spm_buffer_size - 1);
-
-  // 3. Set Source Address (SPM Address: 0xC0000000)
-  volatile uint16_t *write_buffer = (uint16_t *) 0xC0000000; 
-  volatile uint16_t *dma_buffer = write_buffer + spm_buffer_size * 2; // 2 * 2 * 256 = 1024 bytes
-  dma[SPM_ADDRESS_ID] = swap_u32((uint32_t) dma_buffer); // Address is 32-bit aligned
-  
-  uint32_t dma_start_cmd = swap_u32((1 << 8) | BURST_SIZE);
-  // volatile rgb565 *pixel = fbuf;
-  fxpt_4_28 cy = cy_0;
-  for (int k = 0; k < height; ++k) {
-    fxpt_4_28 cx = cx_0;
-    for(int i = 0; i < width; ++i) {
-      uint16_t n_iter = (*cfp_p)(cx, cy, n_max);
-      rgb565 colour = (*i2c_p)(n_iter, n_max);
-      // *(pixel++) = colour;
-      write_buffer[i] = colour;
-
-      cx += delta;
-    }
-
-    // Prevent overwriting data being transferred by DMA
-    while (swap_u32(dma[START_STATUS_ID]) & 1) {
-        // Wait for DMA...
-    }
-
+  // the lines are computed into two SPM buffers, the DMA-controller copies one while the other is filled
+  int errors = dma_pipeline_run((void *) 0xC0000000, 2, fbuf, line_size, line_size, height, BURST_SIZE + 1,
+                                &fractal_line, &frac);
+  if (errors != 0)
+    printf("DMA error: %s\n", dma_error_string(errors));
+}
 
-    // --- DMA TRANSFER FOR ONE LINE ---
-    // 4. Exchange the buffers for next line (Set Source Address)
-    volatile uint16_t *temp = write_buffer; 
-    write_buffer = dma_buffer; 
-    dma_buffer = temp; 
-    dma[SPM_ADDRESS_ID] = swap_u32((uint32_t) dma_buffer); 
+//! \brief  Arguments of the pixel functions of draw_fractal_subdivide
+typedef struct {
+  calc_frac_point_p cfp_p;
+  iter_to_colour_p i2c_p;
+  fxpt_4_28 cx_0, cy_0, delta;
+  uint16_t n_max;
+} fractal_pixels_t;
 
+//! \brief  Number of iterations at pixel (x, y)
+static uint16_t fractal_iter(int x, int y, void *arg) {
+  const fractal_pixels_t *frac = arg;
+  return (*frac->cfp_p)(frac->cx_0 + x * frac->delta, frac->cy_0 + y * frac->delta, frac->n_max);
+}
 
-    // 5. Set Destination Address: Current line in Frame Buffer
-    uint32_t dest_addr = (uint32_t)&fbuf[k * width];
-    dma[MEMORY_ADDRESS_ID] = swap_u32(dest_addr);
+//! \brief  Colour at pixel (x, y)
+static uint16_t fractal_colour(int x, int y, void *arg) {
+  const fractal_pixels_t *frac = arg;
+  return (*frac->i2c_p)(fractal_iter(x, y, arg), frac->n_max);
+}
 
-    // 6. Start Transfer (SPM -> RAM)
-    // Bit 8 = 1 (Start SPM->Mem), Bits 7..0 = Burst Size
-    dma[START_STATUS_ID] = dma_start_cmd;
+uint32_t draw_fractal_subdivide(rgb565 *fbuf, int width, int height,
+                                calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                                fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max) {
+  fractal_pixels_t frac = { cfp_p, i2c_p, cx_0, cy_0, delta, n_max };
+  subdivide_stats_t stats;
 
-    cy += delta;
-  }
+  // the frame buffer holds the iteration counts until they are mapped to colours
+  subdivide_render(fbuf, width, height, &fractal_iter, &frac, &stats);
+  for (int i = 0; i < width * height; ++i) fbuf[i] = (*i2c_p)(fbuf[i], n_max);
+  return stats.evaluated;
+}
 
-  // --- Patch start: Wait for the last DMA transfer to complete ---
-  while (swap_u32(dma[START_STATUS_ID]) & 1) {
-      // Wait for the last transfer...
-  }
-  
+uint32_t diff_fractal_subdivide(const rgb565 *fbuf, int width, int height,
+                                calc_frac_point_p cfp_p, iter_to_colour_p i2c_p,
+                                fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max) {
+  fractal_pixels_t frac = { cfp_p, i2c_p, cx_0, cy_0, delta, n_max };
+  return subdivide_diff(fbuf, width, height, &fractal_colour, &frac);
 }
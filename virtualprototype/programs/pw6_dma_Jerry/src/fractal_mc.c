@@ -0,0 +1,170 @@
+#include <fractal_mc.h>
+#include <cache.h>
+#include <cpu2.h>
+#include <delay.h>
+#include <dma.h>
+#include <locks.h>
+#include <spr.h>
+
+#ifndef BURST_SIZE
+#define BURST_SIZE 255
+#endif
+
+#define SPM_BUFFERS ((void *) 0xC0000000)  //!< every core sees its own SPM here
+#define FRACTAL_MC_JOB_ADDRESS 0xE0000100 //!< in the SSRAM behind the locks, it is not cached
+
+//! \brief  The frame shared by the cores
+typedef struct {
+  uint32_t frame;    //!< incremented by cpu1 for every frame
+  uint32_t next_row; //!< first row of the next block to hand out
+  uint32_t finished; //!< cores done with the frame
+  uint32_t cores;
+  rgb565 *fbuf;
+  int width, height;
+  fxpt_4_28 cx_0, cy_0, delta;
+  uint16_t n_max;
+  uint32_t masks[PERF_COUNTER_RUNTIME];
+  fractal_mc_stats_t stats[FRACTAL_MC_MAX_CORES];
+} fractal_mc_job_t;
+
+static volatile fractal_mc_job_t *const job = (fractal_mc_job_t *) FRACTAL_MC_JOB_ADDRESS;
+
+//! \brief  Arguments of the line producer, a copy of the job in the memory of the core
+typedef struct {
+  int width;
+  uint32_t first_row;
+  fxpt_4_28 cx_0, cy_0, delta;
+} fractal_mc_block_t;
+
+//! \brief  Computes one line of the block into an SPM buffer
+static void fractal_mc_line(void *buffer, uint32_t line, void *arg) {
+  const fractal_mc_block_t *block = arg;
+  volatile uint32_t *pixels = buffer;
+  fxpt_4_28 cx = block->cx_0;
+  fxpt_4_28 cy = block->cy_0 + (fxpt_4_28) (block->first_row + line) * block->delta;
+  uint32_t colour;
+
+  for (int i = 0 ; i < block->width ; i += 2) { // the ISE computes two pixels at a time
+    asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x20":[out1]"=r"(colour):[in1]"r"(cx),[in2]"r"(cy));
+    pixels[i >> 1] = colour;
+    cx += block->delta << 1;
+  }
+}
+
+//! \brief  Hands out the first row of the next block, the counter is shared by all cores
+static uint32_t fractal_mc_next_rows() {
+  uint32_t row;
+
+  get_lock(FRACTAL_MC_LOCK_ID);
+  row = job->next_row;
+  job->next_row = row + FRACTAL_MC_BLOCK_ROWS;
+  release_lock(FRACTAL_MC_LOCK_ID);
+  return row;
+}
+
+//! \brief  Renders blocks until the frame is done, runs on every core
+static void fractal_mc_worker() {
+  const uint32_t core = (SPR_READ(9) & 0xF) - 1;
+  fractal_mc_block_t block = { job->width, 0, job->cx_0, job->cy_0, job->delta };
+  rgb565 *fbuf = job->fbuf;
+  const uint32_t height = job->height;
+  const size_t line_size = block.width * sizeof(rgb565);
+  perf_cycles_t start[PERF_COUNTER_RUNTIME+1];
+  uint32_t colour = (2<<16) | job->n_max;
+  uint32_t rows = 0;
+  int errors = 0;
+
+  // every core has its own ISE, which has to be set up
+  asm volatile ("l.nios_crc r0,%[in1],%[in2],0x21"::[in1]"r"(colour),[in2]"r"(block.delta));
+  for (int i = 0 ; i <= PERF_COUNTER_RUNTIME ; i++) start[i] = perf_read_counter(i);
+
+  while ((block.first_row = fractal_mc_next_rows()) < height) {
+    uint32_t n = height - block.first_row;
+
+    if (n > FRACTAL_MC_BLOCK_ROWS) n = FRACTAL_MC_BLOCK_ROWS;
+    errors |= dma_pipeline_run(SPM_BUFFERS, 2, fbuf + block.first_row * block.width, line_size, line_size, n,
+                               BURST_SIZE + 1, &fractal_mc_line, &block);
+    rows += n;
+  }
+
+  for (int i = 0 ; i <= PERF_COUNTER_RUNTIME ; i++)
+    job->stats[core].counters[i] = perf_read_counter(i) - start[i];
+  job->stats[core].rows = rows;
+  job->stats[core].errors = errors;
+  get_lock(FRACTAL_MC_LOCK_ID);
+  job->finished++;
+  release_lock(FRACTAL_MC_LOCK_ID);
+}
+
+//! \brief  cpu2 waits for a frame and renders it together with cpu1
+void main2() {
+  uint32_t frame = 0;
+
+  icache_write_cfg( CACHE_FOUR_WAY | CACHE_SIZE_8K | CACHE_REPLACE_LRU );
+  icache_enable(1);
+  while (1) {
+    while (job->frame == frame) delay_blocking_usec(10); // poll seldom, the bus is needed by cpu1
+    frame = job->frame;
+    if (job->cores < 2) continue;
+    for (int i = 0 ; i < PERF_COUNTER_RUNTIME ; i++) perf_set_mask(i, job->masks[i]);
+    perf_start();
+    fractal_mc_worker();
+  }
+}
+
+int draw_fractal_mc(rgb565 *fbuf, int width, int height,
+                    fxpt_4_28 cx_0, fxpt_4_28 cy_0, fxpt_4_28 delta, uint16_t n_max,
+                    uint32_t cores, fractal_mc_stats_t *per_core, fractal_mc_stats_t *total) {
+  static int cpu2_started = 0;
+  int errors = 0;
+
+  if (cores < 1) cores = 1;
+  if (cores > FRACTAL_MC_MAX_CORES) cores = FRACTAL_MC_MAX_CORES;
+
+  job->fbuf = fbuf;
+  job->width = width;
+  job->height = height;
+  job->cx_0 = cx_0;
+  job->cy_0 = cy_0;
+  job->delta = delta;
+  job->n_max = n_max;
+  job->cores = cores;
+  job->next_row = 0;
+  job->finished = 0;
+  for (int i = 0 ; i < PERF_COUNTER_RUNTIME ; i++) job->masks[i] = perf_get_mask(i);
+
+  if (cores > 1 && !cpu2_started) {
+    job->frame = 0;
+    SET_CPU2_MAIN(&init_cpu2);
+    set_stack_cpu2(1ull << 20 /* 1 MB*/);
+    START_CPU2();
+    cpu2_started = 1;
+  }
+  job->frame++; // the job is complete, this releases cpu2
+
+  fractal_mc_worker();
+  while (job->finished < cores) ;
+
+  // the counters of the cores are merged
+  if (total != NULL) {
+    total->rows = 0;
+    total->errors = 0;
+    for (int i = 0 ; i <= PERF_COUNTER_RUNTIME ; i++) total->counters[i] = 0;
+  }
+  for (uint32_t c = 0 ; c < cores ; c++) {
+    volatile fractal_mc_stats_t *stats = &job->stats[c];
+
+    errors |= stats->errors;
+    if (per_core != NULL) {
+      per_core[c].rows = stats->rows;
+      per_core[c].errors = stats->errors;
+      for (int i = 0 ; i <= PERF_COUNTER_RUNTIME ; i++) per_core[c].counters[i] = stats->counters[i];
+    }
+    if (total != NULL) {
+      total->rows += stats->rows;
+      total->errors |= stats->errors;
+      for (int i = 0 ; i <= PERF_COUNTER_RUNTIME ; i++) total->counters[i] += stats->counters[i];
+    }
+  }
+  return errors;
+}
@@ -7,14 +7,30 @@
 #include <defs.h>
 #include <dma.h>
 #include <string.h>
+#include <locks.h>
+#include <fractal_engine.h>
 #include "fractal_fxpt.h"
+#include "fractal_mc.h"
 
 // #define __REALLY_FAST__
+// #define __MULTI_CORE__ // needs the dual-core system, both cores render with their fractal ISE
+// #define __SUBDIVIDE__ // computes only the borders of uniform rectangles, __SUBDIVIDE_DIFF__ checks the result
+// #define __ENGINE__ // the fractal engine renders the frame on its own and writes it to the memory (system built with fractalEngineEnabled = 1)
+// #define __FAST_PATHS__ // software kernel with the cardioid test and periodicity check, __FAST_PATHS_CHECK__ checks the result
 
-// Define DMA Burst Size (Change this to 255, 63, or 15 for experiments)
+#ifdef __FAST_PATHS__
+#define CALC_MANDELBROT_POINT calc_mandelbrot_point_fast
+#else
+#define CALC_MANDELBROT_POINT calc_mandelbrot_point_soft
+#endif
+
+// Define DMA Burst Size (minus one), see the dmabench program for a sweep over the burst sizes
 #define BURST_SIZE 255
 
 rgb565 frameBuffer[SCREEN_WIDTH*SCREEN_HEIGHT]; //! frame buffer for the VGA controller, stored each pixel as rgb565
+#ifdef __REALLY_FAST__
+dma_descriptor_t line_chain[SCREEN_HEIGHT]; //! DMA descriptors, one per line of the frame buffer
+#endif
 
 
 
@@ -22,27 +38,8 @@ int main() {
    volatile unsigned int *vga = (unsigned int *) 0X50000020; // vga controller base address
    volatile unsigned int reg, hi;
 
-   /* DMA CONFIGURATION (STATIC PART) */
-   volatile uint32_t *dma = (uint32_t *) DMA_BASE_ADDRESS;
-   printf("Current Burst Size: %#x\n", BURST_SIZE);
-   
-
-   // 1. Set Buffer Size (Transfer size)
-   uint32_t spm_buffer_size = SCREEN_WIDTH * 2 / 4; // in words (4 bytes), 512 * 2 / 4 = 256 words
-   dma[TRANSFER_SIZE_ID] = swap_u32(spm_buffer_size - 1);
-   printf("Transfer size: %#x\n", swap_u32(dma[TRANSFER_SIZE_ID]));
-
-
-   // 2. Set Source Address (SPM Address: 0xC0000000)
-   volatile uint32_t *write_buffer = (uint32_t *) 0xC0000000; // Each address stores 1 byte
-   // But we will write 4 bytes (1 word) at a time as a uint32_t in Fast Implementation
-   volatile uint32_t *dma_buffer = write_buffer + spm_buffer_size; // buffer for DMA reading back data to main memory
-   // Don't require to multiply by 4, because pointer arithmetic already accounts for the size of uint32_t
-   
-   dma[SPM_ADDRESS_ID] = swap_u32((uint32_t) dma_buffer); // Will be updated during the drawing process
-   printf("Start address in the SPM-space: %#x\n", swap_u32(dma[SPM_ADDRESS_ID]));
-   printf("Start address in the MEM-space: %#x\n", swap_u32(dma[MEMORY_ADDRESS_ID]));
-
+   /* Clear screen */
+   dma_memset(frameBuffer, 0, sizeof(frameBuffer)); // the DMA-controller fills the frame buffer while we set up the rest
 
    uint32_t *pixel;
 
@@ -67,68 +64,74 @@ int main() {
    vga[1] = swap_u32(SCREEN_HEIGHT);
    vga[3] = swap_u32( (unsigned int) &frameBuffer[0] ); // set frame buffer address, VGA gets data from memory
    
+   dma_wait(); // the clear has to be done before we draw and before the DMA can be reconfigured
 
-   /* Clear screen */
-   for (int i = 0 ; i < SCREEN_WIDTH*SCREEN_HEIGHT ; i++) frameBuffer[i]=0;
+#ifdef __REALLY_FAST__
+   /* DMA CONFIGURATION: one descriptor per line, set up once per frame */
+   printf("Current Burst Size: %#x\n", BURST_SIZE);
 
-   
+   uint32_t spm_buffer_size = SCREEN_WIDTH * 2 / 4; // in words (4 bytes), 512 * 2 / 4 = 256 words
+   // the CPU writes one buffer while the DMA transfers the other one
+   volatile uint32_t *spm_buffers[2] = { (uint32_t *) 0xC0000000, (uint32_t *) 0xC0000000 + spm_buffer_size };
 
+   for (int k = 0 ; k < SCREEN_HEIGHT ; k++) {
+     // each line waits for a credit, which the CPU gives when the line is computed
+     dma_chain_set(&line_chain[k], DMA_FROM_SPM_TO_MEM, (uint32_t) &frameBuffer[k * SCREEN_WIDTH], (uint32_t) spm_buffers[k & 1],
+                   spm_buffer_size, 0, BURST_SIZE + 1, DMA_DESC_WAIT);
+     if (k > 0) dma_chain_link(&line_chain[k - 1], &line_chain[k]);
+   }
+   dma_chain_start(&line_chain[0]);
+#elif defined(__MULTI_CORE__)
+   fractal_mc_stats_t per_core[FRACTAL_MC_MAX_CORES], total;
+   init_locks();
+#endif
 
    perf_start();
 #ifdef __REALLY_FAST__
    int color = (2<<16) | N_MAX;
    asm volatile ("l.nios_crc r0,%[in1],%[in2],0x21"::[in1]"r"(color),[in2]"r"(delta)); // custom hardware instruction to set up the hardware accelerator
-   // pixel = (uint32_t *)frameBuffer;
-
-   // Pre-calculate DMA start command (constant for all transfers)
-   // Bit 8 = 1 (Start SPM -> Mem)
-   // Bits 7..0 = Burst Size
-   uint32_t dma_start_cmd = swap_u32((1 << 8) | BURST_SIZE);
 
    fxpt_4_28 cy = CY_0;
    for (int k = 0 ; k < SCREEN_HEIGHT ; k++) {
+     volatile uint32_t *write_buffer = spm_buffers[k & 1];
      fxpt_4_28 cx = CX_0;
+
+     // Prevent overwriting data being transferred by DMA: the buffer is free once line k-2 is done
+     while (k >= 2 && dma_chain_completed() < (uint32_t) (k - 1)) {
+        // Wait for DMA...
+     }
+
      for (int i = 0 ; i < SCREEN_WIDTH ; i+=2) { // process two pixels at a time
        asm volatile ("l.nios_rrr %[out1],%[in1],%[in2],0x20":[out1]"=r"(color):[in1]"r"(cx),[in2]"r"(cy));
-      //  *(pixel++) = color;
 
        // Write 32-bit word (2 pixels) to SPM
        write_buffer[i >> 1] = color; // CPU is calculating pixels and writing to write_buffer
        cx += delta << 1;
      }
 
-      // Prevent overwriting data being transferred by DMA
-      while (swap_u32(dma[START_STATUS_ID]) & 1) {
-         // Wait for DMA...
-      }
-      // If the previous DMA transfer is not finished, wait until it is done
-
-      /* DMA TRANSFER START */
-      // 3. Exchange the buffers for next line (Set Source Address)
-      volatile uint32_t *temp = write_buffer; // Contains data just written by CPU, available for DMA
-      write_buffer = dma_buffer; // available for CPU to write next line
-      dma_buffer = temp; // Which will be used by DMA for current transfer, previously written by CPU
-      dma[SPM_ADDRESS_ID] = swap_u32((uint32_t) dma_buffer); 
-
-      // 4. Set Destination Address (Main Memory Address for the current line)
-      dma[MEMORY_ADDRESS_ID] = swap_u32((uint32_t) &frameBuffer[k * SCREEN_WIDTH]);
-      // printf("Updated Start address in the MEM-space: %#x\n", swap_u32(dma[MEMORY_ADDRESS_ID]));
-
-      // 5. Start Transfer
-      dma[START_STATUS_ID] = dma_start_cmd;
-      // printf("Current Status: %#x\n", swap_u32(dma[START_STATUS_ID]));
-     
+     dma_chain_credit(1); // the DMA-controller moves this line on its own
 
      cy += delta;
    }
+#elif defined(__MULTI_CORE__)
+   int errors = draw_fractal_mc(frameBuffer, SCREEN_WIDTH, SCREEN_HEIGHT, CX_0, CY_0, delta, N_MAX,
+                                FRACTAL_MC_MAX_CORES, per_core, &total);
+   if (errors != 0)
+     printf("DMA error: %s\n", dma_error_string(errors));
+#elif defined(__ENGINE__)
+   int errors = fractal_engine_start(frameBuffer, SCREEN_WIDTH, SCREEN_HEIGHT, CX_0, CY_0, delta, N_MAX, 2);
+   if (errors == 0)
+     errors = fractal_engine_wait(); // the cpu is free here, it only polls the status
+   if (errors != 0)
+     printf("Fractal engine error: %d\n", errors);
+#elif defined(__SUBDIVIDE__)
+   uint32_t evaluated = draw_fractal_subdivide(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&CALC_MANDELBROT_POINT, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
 #else
-   draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&calc_mandelbrot_point_soft, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
+   draw_fractal(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&CALC_MANDELBROT_POINT, &iter_to_colour,CX_0,CY_0,delta,N_MAX);
 #endif
 
-   // --- Patch start: Wait for the last DMA transfer to complete ---
-   while (swap_u32(dma[START_STATUS_ID]) & 1) {
-       // Wait for the last transfer...
-   }
+   // Wait for the last DMA transfer to complete, the chain ends with the last line
+   dma_wait();
 
    dcache_flush(); // flush the data cache to make sure VGA controller get the latest data
    asm volatile ("l.lwz %[out1],0(%[in1])":[out1]"=r"(pixel):[in1]"r"(frameBuffer)); // dummy instruction to wait for the flush to be finished
@@ -140,4 +143,23 @@ int main() {
    perf_print_cycles( PERF_COUNTER_0 , "Stall cycles" );
    perf_print_cycles( PERF_COUNTER_1 , "Bus idle cycles" );
    perf_print_cycles( PERF_COUNTER_RUNTIME , "Runtime cycles" );
+#ifdef __SUBDIVIDE__
+   printf("%u of %u pixels computed\n", evaluated, SCREEN_WIDTH*SCREEN_HEIGHT);
+#ifdef __SUBDIVIDE_DIFF__
+   printf("%u pixels differ from the brute-force rendering\n", diff_fractal_subdivide(frameBuffer,SCREEN_WIDTH,SCREEN_HEIGHT,&CALC_MANDELBROT_POINT, &iter_to_colour,CX_0,CY_0,delta,N_MAX));
+#endif
+#endif
+#ifdef __FAST_PATHS_CHECK__
+   printf("%u pixels with other iteration counts than calc_mandelbrot_point_soft\n", check_mandelbrot_point_fast(SCREEN_WIDTH,SCREEN_HEIGHT,CX_0,CY_0,delta,N_MAX));
+#endif
+#ifdef __MULTI_CORE__
+   // the rows show how the blocks were balanced, the cycles are summed over the cores
+   for (int c = 0 ; c < FRACTAL_MC_MAX_CORES ; c++)
+     printf("cpu%d: %u rows, %u stall, %u bus idle, %u cycles\n", c + 1, per_core[c].rows,
+            (uint32_t) per_core[c].counters[PERF_COUNTER_0], (uint32_t) per_core[c].counters[PERF_COUNTER_1],
+            (uint32_t) per_core[c].counters[PERF_COUNTER_RUNTIME]);
+   printf("all cores: %u rows, %u stall, %u bus idle, %u cycles\n", total.rows,
+          (uint32_t) total.counters[PERF_COUNTER_0], (uint32_t) total.counters[PERF_COUNTER_1],
+          (uint32_t) total.counters[PERF_COUNTER_RUNTIME]);
+#endif
 }
@@ -0,0 +1,124 @@
+#include <cache.h>
+#include <perf.h>
+#include <platform.h>
+#include <stdio.h>
+#include <string.h>
+
+// Throughput of memcpy(), memmove() and memset() over the size and the alignment
+// of source and destination, printed as bytes per 1000 cycles.
+
+#define MAX_SIZE (64 * 1024)
+
+static uint8_t src_buffer[MAX_SIZE + 2 * CACHE_LINE_SIZE] __aligned(CACHE_LINE_SIZE);
+static uint8_t dst_buffer[MAX_SIZE + 2 * CACHE_LINE_SIZE] __aligned(CACHE_LINE_SIZE);
+
+static const size_t sizes[] = {16, 64, 256, 1024, 4096, 16 * 1024, MAX_SIZE};
+
+typedef enum { BENCH_MEMCPY, BENCH_MEMMOVE, BENCH_MEMSET, BENCH_BYTES } bench_t;
+
+static const char *bench_names[] = {"memcpy", "memmove", "memset", "byte copy"};
+
+/**
+ * @brief The byte-at-a-time copy the library used before, as a baseline.
+ *
+ */
+static void byte_copy(void *dst, const void *src, size_t length) {
+    volatile char *d = dst;
+    const volatile char *s = src;
+
+    while (length--)
+        *d++ = *s++;
+}
+
+static uint32_t run(bench_t bench, size_t size, unsigned src_offset, unsigned dst_offset) {
+    uint8_t *dst = dst_buffer + dst_offset;
+    const uint8_t *src = src_buffer + src_offset;
+
+    dcache_flush();
+    perf_start();
+    switch (bench) {
+        case BENCH_MEMCPY:
+            memcpy(dst, src, size);
+            break;
+        case BENCH_MEMMOVE:
+            // overlapping, copied backwards
+            memmove(dst_buffer + CACHE_LINE_SIZE + dst_offset, dst_buffer + src_offset, size);
+            break;
+        case BENCH_MEMSET:
+            memset(dst, 0x5A, size);
+            break;
+        case BENCH_BYTES:
+            byte_copy(dst, src, size);
+            break;
+    }
+    perf_stop();
+
+    uint32_t cycles = (uint32_t)perf_read_counter(PERF_COUNTER_RUNTIME);
+    return cycles ? (uint32_t)(((uint64_t)size * 1000) / cycles) : 0;
+}
+
+static int verify(size_t size, unsigned src_offset, unsigned dst_offset) {
+    memcpy(dst_buffer + dst_offset, src_buffer + src_offset, size);
+    if (memcmp(dst_buffer + dst_offset, src_buffer + src_offset, size) != 0) {
+        printf("memcpy of %u bytes (%u -> %u) failed!\n", size, src_offset, dst_offset);
+        return -1;
+    }
+    return 0;
+}
+
+static void bench_table(bench_t bench) {
+    printf("\n%s, bytes per 1000 cycles\n", bench_names[bench]);
+    printf("%8s", "size");
+    for (unsigned src = 0; src < 4; ++src) {
+        for (unsigned dst = 0; dst < 4; ++dst) {
+            if (bench == BENCH_MEMSET && src != 0)
+                continue;
+            printf("   %u/%u", src, dst);
+        }
+    }
+    printf("\n");
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        printf("%8u", sizes[i]);
+        for (unsigned src = 0; src < 4; ++src) {
+            for (unsigned dst = 0; dst < 4; ++dst) {
+                if (bench == BENCH_MEMSET && src != 0)
+                    continue;
+                printf(" %5u", run(bench, sizes[i], src, dst));
+            }
+        }
+        printf("\n");
+    }
+}
+
+int main() {
+    // initializes the UART, performance counters, peripherals etc.
+    platform_init();
+    perf_init();
+
+    icache_write_cfg(CACHE_TWO_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU);
+    dcache_write_cfg(CACHE_FOUR_WAY | CACHE_SIZE_4K | CACHE_REPLACE_LRU | CACHE_WRITE_BACK);
+    icache_enable(1);
+    dcache_enable(1);
+
+    for (size_t i = 0; i < sizeof(src_buffer); ++i)
+        src_buffer[i] = (uint8_t)(i * 7 + 3);
+
+    int errors = 0;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        for (unsigned src = 0; src < 4; ++src) {
+            for (unsigned dst = 0; dst < 4; ++dst)
+                errors |= verify(sizes[i] - dst, src, dst);
+        }
+    }
+    if (errors == 0)
+        printf("verification successful!\n");
+
+    printf("src/dst columns give the byte offsets from a line boundary\n");
+    bench_table(BENCH_BYTES);
+    bench_table(BENCH_MEMCPY);
+    bench_table(BENCH_MEMMOVE);
+    bench_table(BENCH_MEMSET);
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+#ifndef ARENA_H_INCLUDED
+#define ARENA_H_INCLUDED
+
+#include <defs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief The D$ line size, slabs and split arrays start on a line boundary. */
+#define ARENA_LINE_SIZE 32
+
+/** @brief Returned by arena_split_alloc() if the split is full. */
+#define ARENA_NONE ((uint32_t)0xFFFFFFFF)
+
+typedef struct arena_t arena_t;
+typedef struct arena_pool_t arena_pool_t;
+typedef struct arena_split_t arena_split_t;
+
+/**
+ * @brief A bump allocator on a caller-provided buffer.
+ * Memory is only given back all at once by arena_reset().
+ *
+ */
+struct arena_t {
+    uint8_t* base;
+    size_t size;
+    size_t next;
+};
+
+/**
+ * @brief A pool of fixed-size objects carved from an arena in cache-line-aligned slabs.
+ *
+ * Objects of up to one line are rounded up to a power of two, such that none of them
+ * straddles two lines; freed objects are kept in a free list.
+ */
+struct arena_pool_t {
+    arena_t* arena;
+    uint32_t elem_size;
+    uint32_t slab_count;
+    uint8_t* slab;
+    uint32_t slab_used;
+    void* free_list;
+};
+
+/**
+ * @brief Parallel hot and cold arrays, element `i` has its hot fields at hot[i] and its
+ * cold fields at cold[i].
+ *
+ * The hot array only holds what is touched on the fast path (ids, links), such that
+ * more elements share a line; the links can be indices instead of pointers, which
+ * makes the hot part even smaller. Alternatively the hot part keeps a pointer to its
+ * cold part (see arena_split_cold()).
+ */
+struct arena_split_t {
+    uint8_t* hot;
+    uint8_t* cold;
+    uint32_t hot_size;
+    uint32_t cold_size;
+    uint32_t capacity;
+    uint32_t count;
+};
+
+/**
+ * @brief Initializes an arena on `buffer`, the start is aligned to a cache line.
+ *
+ * @param arena
+ * @param buffer
+ * @param size Size of `buffer` in bytes.
+ */
+void arena_init(arena_t* arena, void* buffer, size_t size);
+
+/**
+ * @brief Allocates `size` bytes aligned to `align` (a power of two).
+ *
+ * @return void* NULL if the arena is exhausted.
+ */
+void* arena_alloc(arena_t* arena, size_t size, size_t align);
+
+/**
+ * @brief Frees everything allocated from the arena at once, e.g. at the end of a phase.
+ * @note Pools and splits on the arena must be reset resp. initialized again.
+ *
+ */
+void arena_reset(arena_t* arena);
+
+__static_inline size_t arena_used(const arena_t* arena) {
+    return arena->next;
+}
+
+/**
+ * @brief Initializes a pool of `elem_size` byte objects.
+ *
+ * @param pool
+ * @param arena
+ * @param elem_size
+ * @param slab_count Number of objects per slab.
+ */
+void arena_pool_init(arena_pool_t* pool, arena_t* arena, size_t elem_size, size_t slab_count);
+
+/**
+ * @brief Allocates one object.
+ *
+ * @return void* NULL if the arena is exhausted.
+ */
+void* arena_pool_alloc(arena_pool_t* pool);
+
+void arena_pool_free(arena_pool_t* pool, void* object);
+
+/**
+ * @brief Forgets all slabs and the free list, call it together with arena_reset().
+ *
+ */
+void arena_pool_reset(arena_pool_t* pool);
+
+/**
+ * @brief Typed wrappers, e.g. `ARENA_POOL_INIT(&pool, &arena, node_t, 16)` and
+ * `node_t* n = ARENA_POOL_ALLOC(&pool, node_t)`.
+ *
+ */
+#define ARENA_POOL_INIT(pool, arena, type, slab_count) arena_pool_init((pool), (arena), sizeof(type), (slab_count))
+#define ARENA_POOL_ALLOC(pool, type) ((type*)arena_pool_alloc(pool))
+
+/**
+ * @brief Reserves the hot and cold arrays for `capacity` elements.
+ * The two arrays may come from the same arena or from two different ones.
+ *
+ * @return int 0 on success, -1 if an arena is exhausted.
+ */
+int arena_split_init(arena_split_t* split, arena_t* hot_arena, arena_t* cold_arena,
+                     size_t hot_size, size_t cold_size, size_t capacity);
+
+/**
+ * @brief Allocates the next element.
+ *
+ * @return uint32_t The index of the element or ARENA_NONE if the split is full.
+ */
+uint32_t arena_split_alloc(arena_split_t* split);
+
+__static_inline void* arena_split_hot(const arena_split_t* split, uint32_t index) {
+    return split->hot + index * split->hot_size;
+}
+
+__static_inline void* arena_split_cold(const arena_split_t* split, uint32_t index) {
+    return split->cold + index * split->cold_size;
+}
+
+__static_inline void arena_split_reset(arena_split_t* split) {
+    split->count = 0;
+}
+
+#define ARENA_SPLIT_INIT(split, hot_arena, cold_arena, hot_type, cold_type, capacity) \
+    arena_split_init((split), (hot_arena), (cold_arena), sizeof(hot_type), sizeof(cold_type), (capacity))
+#define ARENA_SPLIT_HOT(split, index, type) ((type*)arena_split_hot((split), (index)))
+#define ARENA_SPLIT_COLD(split, index, type) ((type*)arena_split_cold((split), (index)))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARENA_H_INCLUDED */
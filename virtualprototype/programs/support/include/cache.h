@@ -18,6 +18,12 @@ extern "C" {
 #define CACHE_REPLACE_FIFO (((uint32_t)0) << 16)
 #define CACHE_REPLACE_PLRU (((uint32_t)1) << 16)
 #define CACHE_REPLACE_LRU (((uint32_t)2) << 16)
+#define CACHE_PREFETCH_NONE (((uint32_t)0) << 22)
+#define CACHE_PREFETCH_NEXT_LINE (((uint32_t)1) << 22)
+#define CACHE_PREFETCH_STRIDE (((uint32_t)2) << 22)
+#define CACHE_VICTIM_ENABLE (((uint32_t)1) << 24)
+#define CACHE_LOCK_FILL (((uint32_t)1) << 9)
+#define CACHE_LOCKED_WAYS(n) ((((uint32_t)(n)) & 3) << 14)
 #define CACHE_COHERENCE (((uint32_t)1) << 18)
 #define CACHE_MSI (((uint32_t)0) << 20)
 #define CACHE_MESI (((uint32_t)1) << 20)
@@ -27,6 +33,16 @@ extern "C" {
 #define CACHE_SIZE_2K (((uint32_t)1) << 30)
 #define CACHE_SIZE_4K (((uint32_t)2) << 30)
 #define CACHE_SIZE_8K (((uint32_t)3) << 30)
+#define CACHE_SIZE_16K ((((uint32_t)0) << 30) | (((uint32_t)1) << 28))
+#define CACHE_SIZE_32K ((((uint32_t)1) << 30) | (((uint32_t)1) << 28))
+
+// Read-only fields of the configuration register: the largest size the cache was
+// synthesized for (same encoding as the size field) and the maximum associativity.
+#define CACHE_SIZE_CODE(cfg) (((((cfg) >> 28) & 1) << 2) | (((cfg) >> 30) & 3))
+#define CACHE_MAX_SIZE_CODE(cfg) (((cfg) >> 25) & 7)
+#define CACHE_MAX_WAYS_CODE(cfg) (((cfg) >> 12) & 3)
+#define CACHE_LOCKED_WAYS_CODE(cfg) (((cfg) >> 14) & 3)
+#define CACHE_SIZE_BYTES(code) (((uint32_t)1024) << (code))
 
 #define CACHE_SPR_ENABLE 17
 #define CACHE_SPR_ICACHE 6
@@ -35,6 +51,8 @@ extern "C" {
 #define CACHE_ICACHE_SHIFT 4
 #define CACHE_DCACHE_SHIFT 3
 
+#define CACHE_LINE_SIZE 32
+
 __static_inline void icache_enable(int enable) {
     uint32_t r = SPR_READ(CACHE_SPR_ENABLE) & ~(((uint32_t)1) << CACHE_ICACHE_SHIFT);
     r |= (enable & 1) << CACHE_ICACHE_SHIFT;
@@ -79,6 +97,56 @@ __static_inline void dcache_flush() {
     SPR_WRITE(CACHE_SPR_DCACHE, CACHE_FLUSH);
 }
 
+__static_inline uint32_t icache_max_size() {
+    return CACHE_SIZE_BYTES(CACHE_MAX_SIZE_CODE(icache_read_cfg()));
+}
+
+__static_inline uint32_t dcache_max_size() {
+    return CACHE_SIZE_BYTES(CACHE_MAX_SIZE_CODE(dcache_read_cfg()));
+}
+
+// The prefetch hint and the zero line operation are encoded in the l.cas opcode
+// space (bits 9:8 = 2 resp. 3) with the line address in r3.
+__static_inline void dcache_prefetch_line(const volatile void *address) {
+    register const volatile void *r3 asm("r3") = address;
+    asm volatile (".word 0x74030200" : : "r"(r3));
+}
+
+// Only performed in the non-coherent region or with a non-coherent write-back
+// D$, otherwise it is ignored; use dcache_zero() if unsure.
+__static_inline void dcache_zero_line(volatile void *address) {
+    register volatile void *r3 asm("r3") = address;
+    asm volatile (".word 0x74030300" : : "r"(r3) : "memory");
+}
+
+// Tells whether dcache_zero_line() is performed for the line at `address`.
+__static_inline int dcache_zero_line_allowed(uint32_t address) {
+    uint32_t cfg = dcache_read_cfg();
+    return dcache_enabled() && ((address >> 30) & 1) == 0 &&
+           (((address >> 31) & 1) || ((cfg & CACHE_COHERENCE) == 0 && (cfg & CACHE_WRITE_BACK)));
+}
+
+void dcache_zero(void *buffer, uint32_t size);
+
+// Way locking: the highest ways of a 2- or 4-way cache can be excluded from
+// replacement to pin real-time critical code and data. Lines are only evicted
+// from a locked way by a flush (or a coherence invalidate), hence writing the
+// configuration register without the lock field also releases the locks.
+
+// Pins [address, address + size) into the next free way of the D$ and returns the
+// number of locked ways, or -1 if the range is uncacheable, larger than one way,
+// or no way is left. The D$ is flushed and the previously pinned ranges are reloaded.
+int dcache_lock_range(const volatile void *address, uint32_t size);
+void dcache_unlock_all();
+
+// Instruction lines can only be loaded by executing them: all I$ misses between
+// icache_lock_begin() and icache_lock_end() are placed in the next free way, which
+// is locked by icache_lock_end(). Run the code to pin once in between (e.g. a pass
+// through the handler). icache_lock_begin() returns -1 if no way is left.
+int icache_lock_begin();
+void icache_lock_end();
+void icache_unlock_all();
+
 void cache_printinfo(uint32_t value);
 
 #ifdef __cplusplus
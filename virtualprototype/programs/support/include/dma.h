@@ -1,20 +1,289 @@
 #ifndef __DMA_H__
 #define __DMA_H__
 
+#include <defs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define DMA_BASE_ADDRESS 0x50000040
+#define DMA_CHANNEL_BASE_ADDRESS 0x500000A0 // channel 1 and up of cpu1, 0x20 apart
+#define DMA_NR_OF_CHANNELS 2                // as built for cpu1, at most DMA_MAX_CHANNELS
+#define DMA_MAX_CHANNELS 4
+#define DMA_CORE_BASE_ADDRESS 0x50000100 // channel 0 of cpu2 and up, 0x100 apart
+#define DMA_MAX_CORES 4
+#define DMA_IRQ_MASK (1 << 1) // the PIC-line of the DMA-controllers of cpu1
 
 #define MEMORY_ADDRESS_ID 0
 #define SPM_ADDRESS_ID 1
 #define TRANSFER_SIZE_ID 2
 #define START_STATUS_ID 3
+#define DESTINATION_ADDRESS_ID 4
+#define FILL_PATTERN_ID 5
+#define CHAIN_ADDRESS_ID 6
+#define CHAIN_CONTROL_ID 7
+
+// the registers 4 and 5 of a 2D-transfer
+#define ROWS_STRIDE_ID 4
+#define SPM_STRIDE_ID 5
 
 #define DMA_FROM_SPM_TO_MEM 1 << 8
 #define DMA_FROM_MEM_TO_SPM 1 << 9
+#define DMA_FROM_MEM_TO_MEM (3 << 8)
+#define DMA_FILL_MEM (5 << 8)
+#define DMA_START_CHAIN (7 << 8)
+#define DMA_2D (1 << 11)
+#define DMA_COMMAND_MASK (7 << 8)
 
+// the bits of the status register
 #define DMA_BUSY_BIT 1
-#define DMA_ERROR_BIT 2
-#define DMA_MEM_ALLIGN_ERROR_BIT 4
-#define DMA_SPM_ALLIGN_ERROR_BIT 8
-#define DMA_SPM_OUT_OF_RANGE_ERROR_BIT 16
+#define DMA_ERROR_BIT 2 // the transfer size is too big for the SPM
+#define DMA_TRANSFER_ERROR_BIT 4
+#define DMA_MEM_ALLIGN_ERROR_BIT 8
+#define DMA_SPM_ALLIGN_ERROR_BIT 16
+#define DMA_SPM_OUT_OF_RANGE_ERROR_BIT 32
+#define DMA_DEST_ALLIGN_ERROR_BIT 64
+#define DMA_CHAIN_ALLIGN_ERROR_BIT 128
+#define DMA_IRQ_PENDING_BIT 256
+
+#define DMA_MAX_BURST_SIZE 256
+#define DMA_MAX_PRIORITY 3
+
+// Every channel has its own registers, queue and tickets. Channel 0 is used by the functions
+// without a channel argument, the others are handed out by dma_channel_alloc(). The channels
+// share the bus: the one with the highest priority goes first, equal ones take turns.
+// Every core has its own channel 0, the controller of its SPM: DMA_BASE_ADDRESS on cpu1 and
+// DMA_CORE_BASE_ADDRESS + (id - 2) * 0x100 on cpu2 and up. Only cpu1 has further channels.
+
+typedef struct dma_channel_t dma_channel_t;
+
+/**
+ * @brief Selects the DMA-controller at `base_address` as channel 0 of the calling core and
+ * empties its request queue.
+ *
+ */
+void dma_init(uint32_t base_address);
+
+/**
+ * @brief Selects the channels 1 to `count` - 1 at `base_address` (by default
+ * DMA_NR_OF_CHANNELS at DMA_CHANNEL_BASE_ADDRESS), all of them have to be free.
+ *
+ */
+void dma_init_channels(uint32_t base_address, uint32_t count);
+
+/**
+ * @brief Hands out a free channel with `priority` (0..DMA_MAX_PRIORITY, higher goes first),
+ * returns NULL if there is none.
+ *
+ */
+dma_channel_t *dma_channel_alloc(uint32_t priority);
+
+/**
+ * @brief Waits for the requests of `channel` and frees it.
+ *
+ */
+void dma_channel_free(dma_channel_t *channel);
+
+// The driver queues the requests and starts the next one as soon as the controller is
+// idle, either from dma_poll() and the other waiting functions or from dma_irq_handler().
+// The queue is shared with the interrupt handler, it is protected by disabling interrupts.
+
+#define DMA_QUEUE_SIZE 8
+#define DMA_NO_TICKET 0
+
+typedef uint32_t dma_ticket_t;
+
+/**
+ * @brief Called when a request is completed with its errors (see dma_error_string()),
+ * possibly from the interrupt handler. It may submit further requests.
+ *
+ */
+typedef void (*dma_callback_t)(int errors, void *arg);
+
+/**
+ * @brief One transfer, the addresses and sizes are as they are written to the controller.
+ *
+ */
+typedef struct dma_request_t {
+    uint32_t command;        // DMA_FROM_SPM_TO_MEM or DMA_FROM_MEM_TO_SPM (with DMA_2D), DMA_FROM_MEM_TO_MEM or DMA_FILL_MEM
+    uint32_t memory;         // the source/destination address in memory
+    uint32_t spm;            // the source/destination address in the spm
+    uint32_t words;          // the words to transfer (of one row for a 2D-transfer)
+    uint32_t destination;    // the memory destination of a copy, the rows and memory stride of a 2D-transfer
+    uint32_t pattern;        // the fill pattern (not swapped), the spm stride of a 2D-transfer
+    uint32_t burst;          // words per bus burst (1..256), 0 keeps the current burst size
+    dma_callback_t callback; // may be NULL
+    void *arg;
+} dma_request_t;
+
+/**
+ * @brief Queues a copy of `req` and returns its ticket, or DMA_NO_TICKET if the queue is full.
+ * The D$ is not flushed, this is left to the caller.
+ *
+ */
+dma_ticket_t dma_submit(const dma_request_t *req);
+dma_ticket_t dma_channel_submit(dma_channel_t *channel, const dma_request_t *req);
+
+/**
+ * @brief Returns 1 if the request of `ticket` is completed, 0 otherwise.
+ *
+ */
+int dma_poll(dma_ticket_t ticket);
+int dma_channel_poll(dma_channel_t *channel, dma_ticket_t ticket);
+
+/**
+ * @brief Waits for the request of `ticket` and returns its errors, the errors are kept
+ * until DMA_QUEUE_SIZE later requests are completed.
+ *
+ */
+int dma_wait_ticket(dma_ticket_t ticket);
+int dma_channel_wait(dma_channel_t *channel, dma_ticket_t ticket);
+
+/**
+ * @brief Waits for all requests and a running chain of channel 0, returns the errors of
+ * all its transfers completed since the last call (0 if there were none).
+ *
+ */
+int dma_wait();
+
+int dma_busy();
+
+/**
+ * @brief Returns a description of the lowest error bit in `errors` (-1 for invalid arguments).
+ *
+ */
+const char *dma_error_string(int errors);
+
+/**
+ * @brief Enables the completion irq on the PIC-lines `irq_mask` (e.g. DMA_IRQ_MASK),
+ * 0 disables it. The external interrupt handler of the program has to call dma_irq_handler().
+ *
+ */
+void dma_irq_enable(uint32_t irq_mask);
+
+/**
+ * @brief Completes the finished requests and starts the next ones, returns 1 if a
+ * channel raised the irq, 0 otherwise.
+ *
+ */
+int dma_irq_handler();
+
+/**
+ * @brief Sets the number of words per bus burst of all following transfers (1..256).
+ *
+ */
+void dma_set_burst_size(uint32_t words);
+
+// The memory to memory modes bypass the D$: dma_memcpy() and dma_memset() flush it
+// before they queue the request (which also releases locked ways), and the regions must
+// not be accessed until the request is completed. Both return immediately with the ticket
+// of the request (see dma_wait_ticket()), DMA_NO_TICKET if the region is not word aligned
+// or the size is not a multiple of 4 (the transfer is not queued then).
+
+dma_ticket_t dma_memcpy(void *dst, const void *src, size_t size);
+dma_ticket_t dma_memset(void *dst, int c, size_t size);
+
+/**
+ * @brief Same as dma_memset() with a word pattern, e.g. two rgb565 pixels.
+ *
+ */
+dma_ticket_t dma_fill(void *dst, uint32_t pattern, size_t size);
+
+/**
+ * @brief Copies a tile of `rows` rows of `row_size` bytes between memory and the SPM in
+ * one command, `direction` is DMA_FROM_SPM_TO_MEM or DMA_FROM_MEM_TO_SPM. The strides
+ * are the distances of the rows in bytes (spm_stride 0 packs the rows in the SPM).
+ * The tile has to fit into the SPM and the sizes have to be multiples of 4. The D$ is
+ * flushed. Returns the ticket of the request (see dma_wait_ticket()), DMA_NO_TICKET for
+ * invalid arguments (the transfer is not queued then).
+ *
+ */
+dma_ticket_t dma_copy_2d(uint32_t direction, void *memory, size_t memory_stride, void *spm, size_t spm_stride,
+                         size_t row_size, size_t rows);
+
+/**
+ * @brief Fills a line of `line_size` bytes at `buffer` in the SPM.
+ *
+ */
+typedef void (*dma_producer_t)(void *buffer, uint32_t line, void *arg);
+
+/**
+ * @brief Produces `lines` lines in the SPM and copies line k to `memory` + k * `stride`.
+ * The lines rotate over `buffers` buffers of `line_size` bytes at `spm` (2..DMA_QUEUE_SIZE),
+ * so the producer fills one buffer while the previous lines are transferred. The D$ is
+ * flushed. Returns the errors of the transfers, or -1 if the arguments are not aligned.
+ *
+ */
+int dma_pipeline_run(void *spm, uint32_t buffers, void *memory, size_t stride, size_t line_size,
+                     uint32_t lines, uint32_t burst, dma_producer_t producer, void *arg);
+
+// A descriptor chain is a linked list of transfers the controller walks on its own,
+// the descriptors may reside in the SPM or in memory. Linking the last descriptor
+// back to the first gives a ring that runs until dma_chain_stop().
+
+#define DMA_DESC_IRQ (((uint32_t)1) << 16)  // irq when the descriptor is completed
+#define DMA_DESC_WAIT (((uint32_t)1) << 17) // wait for a credit (see dma_chain_credit())
+
+/**
+ * @brief The descriptor as read by the controller, fill it by dma_chain_set().
+ *
+ */
+typedef struct dma_descriptor_t {
+    uint32_t control;
+    uint32_t memory;
+    uint32_t spm;
+    uint32_t size;
+    uint32_t destination; // or the fill pattern
+    uint32_t next;
+} dma_descriptor_t;
+
+/**
+ * @brief Describes one transfer: `command` is one of DMA_FROM_SPM_TO_MEM, DMA_FROM_MEM_TO_SPM,
+ * DMA_FROM_MEM_TO_MEM or DMA_FILL_MEM, `destination` the memory destination resp. the fill
+ * pattern, `burst` the words per bus burst (1..256) and `flags` DMA_DESC_IRQ and DMA_DESC_WAIT.
+ * The descriptor ends the chain until it is linked.
+ *
+ */
+void dma_chain_set(dma_descriptor_t *desc, uint32_t command, uint32_t memory, uint32_t spm,
+                   uint32_t words, uint32_t destination, uint32_t burst, uint32_t flags);
+/**
+ * @brief Describes a 2D-transfer like dma_copy_2d(), the rows are packed in the SPM.
+ *
+ */
+void dma_chain_set_2d(dma_descriptor_t *desc, uint32_t direction, uint32_t memory, size_t memory_stride,
+                      uint32_t spm, size_t row_size, size_t rows, uint32_t burst, uint32_t flags);
+void dma_chain_link(dma_descriptor_t *desc, const dma_descriptor_t *next);
+
+/**
+ * @brief Starts the chain at `first` once the queued requests are done (their errors are
+ * returned by the next dma_wait()), returns -1 if it is not word aligned. The D$ is flushed, descriptors in memory that are changed later
+ * have to be flushed as well. Requests submitted meanwhile start after the chain.
+ *
+ */
+int dma_chain_start(const dma_descriptor_t *first);
+
+/**
+ * @brief Allows the controller to start `n` more descriptors flagged DMA_DESC_WAIT.
+ * The credits are cleared by dma_chain_start().
+ *
+ */
+void dma_chain_credit(uint32_t n);
+
+/**
+ * @brief Stops the chain after the current descriptor, use dma_wait() to wait for it.
+ *
+ */
+void dma_chain_stop();
+
+/**
+ * @brief Returns the number of descriptors completed since dma_chain_start() (modulo 2^16).
+ *
+ */
+uint32_t dma_chain_completed();
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif
@@ -0,0 +1,86 @@
+#ifndef __FRACTAL_ENGINE_H__
+#define __FRACTAL_ENGINE_H__
+
+#include <defs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The fractal engine of cpu1 renders a whole frame of the mandelbrot fractal (Q4.28 coordinates)
+// into a frame buffer, with the colours of the fractal ISE. It is programmed with the custom
+// instruction 0x22 and writes the finished lines to the memory as a bus master. The systems only
+// contain the engine if they are built with fractalEngineEnabled = 1, otherwise nothing answers
+// the custom instruction and these functions must not be called.
+
+#define FRACTAL_ENGINE_IRQ_MASK (1 << 4) // the PIC-line of the engine
+#define FRACTAL_ENGINE_MAX_WIDTH 1024
+#define FRACTAL_ENGINE_MAX_HEIGHT 2047
+
+#define FRACTAL_ENGINE_CX0_ID 0
+#define FRACTAL_ENGINE_CY0_ID 1
+#define FRACTAL_ENGINE_DELTA_ID 2
+#define FRACTAL_ENGINE_WIDTH_ID 3
+#define FRACTAL_ENGINE_HEIGHT_ID 4
+#define FRACTAL_ENGINE_NMAX_ID 5
+#define FRACTAL_ENGINE_FRAME_BUFFER_ID 6
+#define FRACTAL_ENGINE_CONTROL_STATUS_ID 7
+#define FRACTAL_ENGINE_WRITE 8 // or-ed into the register id
+
+// the bits of the control register
+#define FRACTAL_ENGINE_START 1
+#define FRACTAL_ENGINE_IRQ_ENABLE 2
+
+// the bits of the status register
+#define FRACTAL_ENGINE_BUSY_BIT 1
+#define FRACTAL_ENGINE_DONE_BIT 2
+#define FRACTAL_ENGINE_BUS_ERROR_BIT 4
+#define FRACTAL_ENGINE_PARAM_ERROR_BIT 8
+#define FRACTAL_ENGINE_IRQ_ENABLED_BIT 16
+#define FRACTAL_ENGINE_LINES(status) (((status) >> 16) & 0x7FF) // lines written so far
+
+/**
+ * @brief Starts rendering `width` x `height` pixels into `fbuf`: pixel (x, y) is the point
+ * (cx_0 + x * delta, cy_0 + y * delta). `colour_model` selects the colours as for the fractal
+ * ISE (0 black and white, 1 grayscale, 2 and 3 colour). The data cache is flushed first, the
+ * cpu must not touch `fbuf` until the frame is done.
+ * Returns 0, -1 if the engine is busy or FRACTAL_ENGINE_PARAM_ERROR_BIT for invalid arguments
+ * (`fbuf` word aligned, `width` even and at most FRACTAL_ENGINE_MAX_WIDTH).
+ *
+ */
+int fractal_engine_start(void *fbuf, int width, int height, int32_t cx_0, int32_t cy_0, int32_t delta,
+                         uint16_t n_max, uint32_t colour_model);
+
+/**
+ * @brief Returns the status register, reading it acknowledges the irq.
+ *
+ */
+uint32_t fractal_engine_status();
+
+int fractal_engine_busy();
+
+/**
+ * @brief Waits for the end of the frame and returns its error bits (0 on success).
+ *
+ */
+int fractal_engine_wait();
+
+/**
+ * @brief Enables the irq at the end of a frame on FRACTAL_ENGINE_IRQ_MASK, 0 disables it. The
+ * external interrupt handler of the program has to call fractal_engine_irq_handler().
+ *
+ */
+void fractal_engine_irq_enable(int enable);
+
+/**
+ * @brief Acknowledges the irq, returns 1 if a frame has ended since the last call (its error bits
+ * are returned by fractal_engine_wait()), 0 otherwise.
+ *
+ */
+int fractal_engine_irq_handler();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FRACTAL_ENGINE_H__ */
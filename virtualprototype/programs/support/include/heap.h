@@ -0,0 +1,77 @@
+#ifndef HEAP_H_INCLUDED
+#define HEAP_H_INCLUDED
+
+#include <defs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The heap is a TLSF (two-level segregated fit) allocator: malloc() and free() run in
+// constant time and a request is served from the smallest free block class that fits.
+// Small requests (up to HEAP_CACHE_MAX_SIZE bytes) are first served from a cache of
+// freed blocks of the calling core, the TLSF pool itself is shared by all cores.
+
+// Written into the flash image by read_elf (see determine_heap()).
+#define HEAP_INFO_ADDRESS (0x04000000 + 2040)
+#define HEAP_DEFAULT_END (32 * 1024 * 1024 - 8 * 512 - 4)
+
+#define HEAP_ALIGN 8
+#define HEAP_MAX_CORES 4
+#define HEAP_CACHE_MAX_SIZE 128
+#define HEAP_CACHE_DEPTH 16
+
+// hardware lock protecting the shared pool (see locks.h)
+#define HEAP_LOCK_ID 255
+
+typedef struct {
+    uint32_t start, end;    // heap bounds
+    uint32_t used;          // bytes in allocated blocks, including the cached ones
+    uint32_t cached;        // bytes in the per-core caches
+    uint32_t peak;          // maximum of used, only with HEAP_STATISTICS
+    uint32_t free;          // bytes in free blocks
+    uint32_t largest_free;  // largest free block
+    uint32_t free_blocks;
+    uint32_t fragmentation; // 100 - 100 * largest_free / free, in percent
+} heap_stats_t;
+
+/**
+ * @brief Initializes the heap, called by the first malloc().
+ *
+ * The bounds are the ones read_elf stored in the image, if they are sane, otherwise
+ * the heap spans from the end of the .bss up to HEAP_DEFAULT_END. If the stack lies
+ * in between, the heap starts above the stack top.
+ */
+void heap_init();
+
+/**
+ * @brief Protects the shared pool by HEAP_LOCK_ID.
+ * Call it once after init_locks() and before the other cores are started.
+ *
+ */
+void heap_enable_locking();
+
+void* malloc(size_t size);
+void* calloc(size_t count, size_t size);
+void* realloc(void* ptr, size_t size);
+void free(void* ptr);
+
+/**
+ * @brief Returns the cached blocks of the calling core to the shared pool.
+ * malloc() does so by itself before it fails.
+ *
+ */
+void heap_flush_cache();
+
+/**
+ * @brief Walks the heap and fills in `stats`.
+ *
+ */
+void heap_get_stats(heap_stats_t* stats);
+void heap_print_stats();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEAP_H_INCLUDED */
@@ -0,0 +1,66 @@
+#ifndef LINALG_H_INCLUDED
+#define LINALG_H_INCLUDED
+
+#include <defs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// All matrices are dense and stored row-major. The *_i32 kernels wrap around on
+// overflow like plain int32_t arithmetic, the *_q28 kernels work on Q4.28 values
+// (int32_t with 28 fractional bits) and truncate every product to Q4.28 before it is
+// accumulated, hence the results do not depend on the tiling.
+
+#define LINALG_SPM_ADDRESS 0xC0000000
+#define LINALG_SPM_SIZE (8 * 1024)
+
+// Smallest tile: one cache line of int32_t.
+#define LINALG_MIN_TILE 8
+
+/**
+ * @brief Returns the largest power of two `t` such that `tiles` tiles of t * t words
+ * fit into the D$ budget of the kernels.
+ *
+ * The budget is half of the unlocked part of the D$ as read from dcache_read_cfg()
+ * (a quarter for a direct mapped D$, where conflict misses are more likely).
+ */
+uint32_t linalg_tile(uint32_t tiles);
+
+/**
+ * @brief Returns the number of input vector elements processed per column block
+ * of linalg_matvec_*().
+ *
+ */
+uint32_t linalg_block();
+
+// y[rows] = a[rows][cols] * x[cols]
+void linalg_matvec_i32(const int32_t *a, const int32_t *x, int32_t *y, size_t rows, size_t cols);
+void linalg_matvec_q28(const int32_t *a, const int32_t *x, int32_t *y, size_t rows, size_t cols);
+
+// c[n][p] = a[n][m] * b[m][p]
+void linalg_matmul_i32(const int32_t *a, const int32_t *b, int32_t *c, size_t n, size_t m, size_t p);
+void linalg_matmul_q28(const int32_t *a, const int32_t *b, int32_t *c, size_t n, size_t m, size_t p);
+
+// t[cols][rows] = a[rows][cols]^T (for int32_t and Q4.28 alike)
+void linalg_transpose(const int32_t *a, int32_t *t, size_t rows, size_t cols);
+
+// SPM-staged matmul: the tiles of a and b are copied into the scratch pad memory by
+// the DMA-controller, the tile of c is accumulated there and copied back afterwards.
+// The D$ is flushed first, the matrices must be word aligned and must not overlap.
+void linalg_matmul_i32_spm(const int32_t *a, const int32_t *b, int32_t *c, size_t n, size_t m, size_t p);
+void linalg_matmul_q28_spm(const int32_t *a, const int32_t *b, int32_t *c, size_t n, size_t m, size_t p);
+
+// Each verify routine recomputes the result element by element without tiling and
+// returns 0 on success or -1 after printing the first mismatch.
+int linalg_verify_matvec_i32(const int32_t *a, const int32_t *x, const int32_t *y, size_t rows, size_t cols);
+int linalg_verify_matvec_q28(const int32_t *a, const int32_t *x, const int32_t *y, size_t rows, size_t cols);
+int linalg_verify_matmul_i32(const int32_t *a, const int32_t *b, const int32_t *c, size_t n, size_t m, size_t p);
+int linalg_verify_matmul_q28(const int32_t *a, const int32_t *b, const int32_t *c, size_t n, size_t m, size_t p);
+int linalg_verify_transpose(const int32_t *a, const int32_t *t, size_t rows, size_t cols);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LINALG_H_INCLUDED */
@@ -13,10 +13,13 @@ extern "C" {
 #define PERF_ICACHE_MISS_PENALY_MASK (((uint32_t)1) << 2)
 #define PERF_ICACHE_FLUSH_PENALTY_MASH (((uint32_t)1) << 3)
 #define PERF_ICACHE_NOP_INSERTION_MASK (((uint32_t)1) << 4)
+#define PERF_DCACHE_VICTIM_HIT_MASK (((uint32_t)1) << 8)
 #define PERF_BRANCH_PENALTY_MASK (((uint32_t)1) << 9)
 #define PERF_EXECUTED_INSTRUCTIONS_MASK (((uint32_t)1) << 10)
 #define PERF_STALL_CYCLES_MASK (((uint32_t)1) << 11)
 #define PERF_BUS_IDLE_MASK (((uint32_t)1) << 12)
+#define PERF_DCACHE_POSTED_WRITE_MASK (((uint32_t)1) << 14)
+#define PERF_DCACHE_WRITE_BUFFER_STALL_MASK (((uint32_t)1) << 15)
 #define PERF_DCACHE_UNCACHE_WRITE_MASK (((uint32_t)1) << 16)
 #define PERF_DCACHE_UNCACHE_READ_MASK (((uint32_t)1) << 17)
 #define PERF_DCACHE_CACHE_WRITE_MASK (((uint32_t)1) << 18)
@@ -31,6 +34,8 @@ extern "C" {
 #define PERF_DCACHE_INTENAL_STALL_MASK (((uint32_t)1) << 27)
 #define PERF_DCACHE_WRITE_THROUGH_MASK (((uint32_t)1) << 28)
 #define PERF_DCACHE_SNOOPY_INVAL_MASK (((uint32_t)1) << 29)
+#define PERF_DCACHE_PREFETCH_MASK (((uint32_t)1) << 30)
+#define PERF_DCACHE_PREFETCH_HIT_MASK (((uint32_t)1) << 31)
 
 #define PERF_COUNTER_0 0
 #define PERF_COUNTER_1 1
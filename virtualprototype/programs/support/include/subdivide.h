@@ -0,0 +1,50 @@
+#ifndef SUBDIVIDE_H_INCLUDED
+#define SUBDIVIDE_H_INCLUDED
+
+#include <defs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Renders an image of per-pixel values (e.g. iteration counts) by rectangle subdivision
+// (Mariani-Silver): only the borders of the rectangles are computed, a rectangle whose
+// whole border has one value is filled with it, any other one is split in two along its
+// longer side. This is exact for connected regions of one value like the iteration counts
+// of the Mandelbrot set, except for details thinner than the spacing of the computed
+// pixels; subdivide_diff() compares with the brute-force rendering.
+
+// Rectangles with at most this many interior pixels are computed pixel by pixel.
+#define SUBDIVIDE_MIN_INTERIOR 16
+
+/**
+ * @brief Returns the value of the pixel at column `x` and row `y`.
+ *
+ */
+typedef uint16_t (*subdivide_pixel_t)(int x, int y, void *arg);
+
+typedef struct subdivide_stats_t {
+    uint32_t evaluated; // pixels computed by the callback
+    uint32_t filled;    // pixels filled from a uniform border
+} subdivide_stats_t;
+
+/**
+ * @brief Fills `image` (`width` x `height` values, row-major) by subdivision, every pixel
+ * is computed at most once. `stats` may be NULL.
+ *
+ */
+void subdivide_render(uint16_t *image, int width, int height, subdivide_pixel_t pixel, void *arg,
+                      subdivide_stats_t *stats);
+
+/**
+ * @brief Computes every pixel and compares it with `image`, returns the number of
+ * differing pixels (0 if `image` equals the brute-force rendering).
+ *
+ */
+uint32_t subdivide_diff(const uint16_t *image, int width, int height, subdivide_pixel_t pixel, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SUBDIVIDE_H_INCLUDED */
@@ -2,7 +2,7 @@
 #include <stdio.h>
 
 const char* cache_size[] = {
-    "1k", "2k", "4k", "8k"
+    "1k", "2k", "4k", "8k", "16k", "32k", "?", "?"
 };
 
 const char* cache_assoc[] = {
@@ -13,6 +13,10 @@ const char* cache_policy[] = {
     "fifo", "plru", "lru"
 };
 
+const char* cache_prefetch[] = {
+    "none", "next-line", "stride", "stride"
+};
+
 void cache_printinfo(uint32_t value) {
     printf("Cache info for value = 0x%08x: ", value);
     unsigned int res;
@@ -23,12 +27,116 @@ void cache_printinfo(uint32_t value) {
         return;
     }
 
-    res = (value >> 30) & 3;
-    printf("size = %s, ", cache_size[res]);
+    res = CACHE_SIZE_CODE(value);
+    printf("size = %s (max %s), ", cache_size[res], cache_size[CACHE_MAX_SIZE_CODE(value)]);
 
     res = (value) & 3;
     printf("assoc = %s, ", cache_assoc[res]);
 
     res = (value >> 16) & 3;
-    printf("policy = %s\n", cache_policy[res]);
+    printf("policy = %s, ", cache_policy[res]);
+
+    res = (value >> 22) & 3;
+    printf("prefetch = %s, ", cache_prefetch[res]);
+
+    res = (value >> 24) & 1;
+    printf("victim = %s, ", res ? "on" : "off");
+
+    res = CACHE_LOCKED_WAYS_CODE(value);
+    printf("locked ways = %u%s\n", res, (value & CACHE_LOCK_FILL) ? " (filling)" : "");
+}
+
+void dcache_zero(void *buffer, uint32_t size) {
+    uint8_t *p = (uint8_t *) buffer;
+    uint8_t *end = p + size;
+
+    if (dcache_zero_line_allowed((uint32_t) buffer)) {
+        while (p < end && ((uint32_t) p & (CACHE_LINE_SIZE - 1))) *(p++) = 0;
+        while (p + CACHE_LINE_SIZE <= end) {
+            dcache_zero_line(p);
+            p += CACHE_LINE_SIZE;
+        }
+    }
+    while (p < end && ((uint32_t) p & 3)) *(p++) = 0;
+    while (p + 4 <= end) {
+        *((uint32_t *) p) = 0;
+        p += 4;
+    }
+    while (p < end) *(p++) = 0;
+}
+
+// interrupt (bit 2) and tick timer (bit 1) exception enables of the supervision register
+#define CACHE_SR_EXCEPTION_ENABLES (((uint32_t)3) << 1)
+#define CACHE_MAX_LOCKED_RANGES 3
+
+static struct {
+    const volatile uint8_t *address;
+    uint32_t size;
+} dcache_locked_ranges[CACHE_MAX_LOCKED_RANGES];
+static uint32_t dcache_locked_count = 0;
+
+static uint32_t cache_ways(uint32_t cfg) {
+    switch (cfg & 3) {
+        case CACHE_FOUR_WAY : return 4;
+        case CACHE_TWO_WAY  : return 2;
+        default             : return 1;
+    }
+}
+
+int dcache_lock_range(const volatile void *address, uint32_t size) {
+    uint32_t cfg = dcache_read_cfg() & ~(CACHE_LOCKED_WAYS(3) | CACHE_LOCK_FILL);
+    uint32_t ways = cache_ways(cfg);
+    uint32_t start = (uint32_t) address & ~(CACHE_LINE_SIZE - 1);
+    uint32_t end = (uint32_t) address + size;
+    uint32_t sr, i;
+
+    if (!dcache_enabled() || ((uint32_t) address >> 30) & 1 || size == 0 ||
+        dcache_locked_count + 1 >= ways || dcache_locked_count >= CACHE_MAX_LOCKED_RANGES ||
+        end - start > CACHE_SIZE_BYTES(CACHE_SIZE_CODE(cfg)) / ways) return -1;
+
+    dcache_locked_ranges[dcache_locked_count].address = (const volatile uint8_t *) start;
+    dcache_locked_ranges[dcache_locked_count].size = end - start;
+    dcache_locked_count++;
+
+    // The pinned lines must not hit in an unlocked way while filling, hence we start
+    // from an empty cache; interrupts are kept off such that no other data ends up in
+    // the filled ways.
+    sr = SPR_READ(CACHE_SPR_ENABLE);
+    SPR_WRITE(CACHE_SPR_ENABLE, sr & ~CACHE_SR_EXCEPTION_ENABLES);
+    dcache_flush();
+    for (i = 0; i < dcache_locked_count; i++) {
+        const volatile uint8_t *p = dcache_locked_ranges[i].address;
+        const volatile uint8_t *last = p + dcache_locked_ranges[i].size;
+        // load the bounds before filling, the table itself must not end up in the way
+        asm volatile ("" : "+r"(p), "+r"(last));
+        dcache_write_cfg(cfg | CACHE_LOCKED_WAYS(i) | CACHE_LOCK_FILL);
+        for (; p < last; p += CACHE_LINE_SIZE) (void) *p;
+    }
+    dcache_write_cfg(cfg | CACHE_LOCKED_WAYS(dcache_locked_count));
+    SPR_WRITE(CACHE_SPR_ENABLE, sr);
+    return dcache_locked_count;
+}
+
+void dcache_unlock_all() {
+    dcache_write_cfg(dcache_read_cfg() & ~(CACHE_LOCKED_WAYS(3) | CACHE_LOCK_FILL));
+    dcache_locked_count = 0;
+}
+
+int icache_lock_begin() {
+    uint32_t cfg = icache_read_cfg() & ~CACHE_LOCK_FILL;
+    if (!icache_enabled() || CACHE_LOCKED_WAYS_CODE(cfg) + 1 >= cache_ways(cfg)) return -1;
+    icache_write_cfg(cfg | CACHE_LOCK_FILL);
+    return 0;
+}
+
+void icache_lock_end() {
+    uint32_t cfg = icache_read_cfg();
+    uint32_t locked = CACHE_LOCKED_WAYS_CODE(cfg);
+    if ((cfg & CACHE_LOCK_FILL) == 0) return;
+    cfg &= ~(CACHE_LOCKED_WAYS(3) | CACHE_LOCK_FILL);
+    icache_write_cfg(cfg | CACHE_LOCKED_WAYS(locked + 1));
+}
+
+void icache_unlock_all() {
+    icache_write_cfg(icache_read_cfg() & ~(CACHE_LOCKED_WAYS(3) | CACHE_LOCK_FILL));
 }
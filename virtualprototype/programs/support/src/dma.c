@@ -0,0 +1,495 @@
+#include <cache.h>
+#include <dma.h>
+#include <spr.h>
+#include <swap.h>
+
+#define SPR_SR 0x11
+#define SPR_PICMR 0x4800
+#define SR_IEE (1 << 2)
+#define DMA_RESET_BURST_SIZE 8
+
+/*
+ * The requests of a channel wait in a ring, the one at queue_head is on the controller
+ * while `running` is set. Tickets are numbered in the order of submission, a ticket is
+ * completed when it is not after `completed`. A channel fills whole cache lines, hence
+ * the channels of different cores never share a line.
+ */
+struct dma_channel_t {
+    volatile uint32_t *regs;
+    dma_request_t queue[DMA_QUEUE_SIZE];
+    int queue_errors[DMA_QUEUE_SIZE]; // indexed by the ticket
+    volatile uint32_t queue_head, queue_count;
+    volatile int running, pending_errors;
+    volatile dma_ticket_t submitted, completed;
+    uint32_t burst; // 0 when not known
+    uint32_t priority;
+    int allocated;
+} __aligned(CACHE_LINE_SIZE);
+
+static dma_channel_t channels[DMA_MAX_CHANNELS] = {
+    {.regs = (uint32_t *)DMA_BASE_ADDRESS, .allocated = 1},
+    {.regs = (uint32_t *)DMA_CHANNEL_BASE_ADDRESS},
+    {.regs = (uint32_t *)(DMA_CHANNEL_BASE_ADDRESS + 0x20)},
+    {.regs = (uint32_t *)(DMA_CHANNEL_BASE_ADDRESS + 0x40)},
+};
+static uint32_t nr_of_channels = DMA_NR_OF_CHANNELS;
+
+// channel 0 of cpu2 and up, each core only reaches the controller of its own SPM
+static dma_channel_t core_channels[DMA_MAX_CORES - 1] = {
+    {.regs = (uint32_t *)DMA_CORE_BASE_ADDRESS, .allocated = 1},
+    {.regs = (uint32_t *)(DMA_CORE_BASE_ADDRESS + 0x100), .allocated = 1},
+    {.regs = (uint32_t *)(DMA_CORE_BASE_ADDRESS + 0x200), .allocated = 1},
+};
+
+static dma_channel_t *dma_core_channel() {
+    const uint32_t id = SPR_READ(9) & 0xF;
+
+    return (id < 2 || id > DMA_MAX_CORES) ? &channels[0] : &core_channels[id - 2];
+}
+
+#define dma0 dma_core_channel()
+
+static uint32_t dma_lock() {
+    uint32_t sr = SPR_READ(SPR_SR);
+
+    SPR_WRITE(SPR_SR, sr & ~SR_IEE);
+    return sr;
+}
+
+static void dma_unlock(uint32_t sr) {
+    SPR_WRITE(SPR_SR, sr);
+}
+
+static int dma_aligned(const void *address, size_t size) {
+    return (((uint32_t)address | size) & 3) == 0;
+}
+
+static dma_ticket_t dma_next_ticket(dma_ticket_t ticket) {
+    return (++ticket == DMA_NO_TICKET) ? ticket + 1 : ticket;
+}
+
+/*
+ * The status bits that belong to `command`, the others are left over from
+ * the registers of other commands.
+ */
+static int dma_errors(uint32_t command, uint32_t status) {
+    switch (command & DMA_COMMAND_MASK) {
+        case DMA_FROM_MEM_TO_MEM:
+            status &= DMA_TRANSFER_ERROR_BIT | DMA_MEM_ALLIGN_ERROR_BIT | DMA_DEST_ALLIGN_ERROR_BIT;
+            break;
+        case DMA_FILL_MEM:
+            status &= DMA_TRANSFER_ERROR_BIT | DMA_MEM_ALLIGN_ERROR_BIT;
+            break;
+        default:
+            status &= DMA_ERROR_BIT | DMA_TRANSFER_ERROR_BIT | DMA_MEM_ALLIGN_ERROR_BIT | DMA_SPM_ALLIGN_ERROR_BIT |
+                      DMA_SPM_OUT_OF_RANGE_ERROR_BIT;
+            break;
+    }
+    return status;
+}
+
+/*
+ * The burst size is written together with the priority of the channel.
+ */
+static void dma_write_burst(dma_channel_t *ch, uint32_t words) {
+    ch->regs[START_STATUS_ID] = swap_u32((words - 1) | (ch->priority << 12));
+    ch->burst = words;
+}
+
+static void dma_program(dma_channel_t *ch, const dma_request_t *req) {
+    const uint32_t command = req->command & DMA_COMMAND_MASK;
+    volatile uint32_t *regs = ch->regs;
+
+    if (ch->burst == 0 || (req->burst != 0 && req->burst != ch->burst))
+        dma_write_burst(ch, (req->burst != 0) ? req->burst : DMA_RESET_BURST_SIZE);
+    regs[MEMORY_ADDRESS_ID] = swap_u32(req->memory);
+    if (command == DMA_FROM_MEM_TO_MEM) {
+        regs[DESTINATION_ADDRESS_ID] = swap_u32(req->destination);
+    } else if (command == DMA_FILL_MEM) {
+        // not swapped, the controller writes the pattern as it is on the bus
+        regs[FILL_PATTERN_ID] = req->pattern;
+    } else {
+        regs[SPM_ADDRESS_ID] = swap_u32(req->spm);
+        if (req->command & DMA_2D) {
+            regs[ROWS_STRIDE_ID] = swap_u32(req->destination);
+            regs[SPM_STRIDE_ID] = swap_u32(req->pattern);
+        }
+    }
+    regs[TRANSFER_SIZE_ID] = swap_u32(req->words);
+    regs[START_STATUS_ID] = swap_u32(req->command);
+}
+
+/*
+ * Completes the running request and starts the next one, called with the interrupts
+ * disabled. Reading the status also acknowledges the irq. The slave part does not
+ * accept writes while the controller is busy, which may also be due to a chain.
+ */
+static void dma_service(dma_channel_t *ch) {
+    const uint32_t status = swap_u32(ch->regs[START_STATUS_ID]);
+
+    if (status & DMA_BUSY_BIT)
+        return;
+
+    if (ch->running) {
+        const dma_request_t *req = &ch->queue[ch->queue_head];
+        const dma_callback_t callback = req->callback;
+        void *const arg = req->arg;
+        const int errors = dma_errors(req->command, status);
+
+        ch->running = 0;
+        ch->completed = dma_next_ticket(ch->completed);
+        ch->queue_errors[ch->completed % DMA_QUEUE_SIZE] = errors;
+        ch->pending_errors |= errors;
+        ch->queue_head = (ch->queue_head + 1) % DMA_QUEUE_SIZE;
+        ch->queue_count--;
+        // the next request runs while the callback is executed
+        if (ch->queue_count != 0) {
+            dma_program(ch, &ch->queue[ch->queue_head]);
+            ch->running = 1;
+        }
+        if (callback != NULL)
+            callback(errors, arg);
+    } else if (ch->queue_count != 0) {
+        dma_program(ch, &ch->queue[ch->queue_head]);
+        ch->running = 1;
+    }
+}
+
+static void dma_reset(dma_channel_t *ch, uint32_t base_address) {
+    ch->regs = (uint32_t *)base_address;
+    ch->queue_head = 0;
+    ch->queue_count = 0;
+    ch->running = 0;
+    ch->pending_errors = 0;
+    ch->completed = ch->submitted;
+    ch->burst = 0;
+}
+
+void dma_init(uint32_t base_address) {
+    uint32_t sr = dma_lock();
+
+    dma_reset(dma0, base_address);
+    dma_unlock(sr);
+}
+
+void dma_init_channels(uint32_t base_address, uint32_t count) {
+    uint32_t sr = dma_lock();
+
+    if (count > DMA_MAX_CHANNELS)
+        count = DMA_MAX_CHANNELS;
+    for (uint32_t i = 1; i < count; ++i)
+        dma_reset(&channels[i], base_address + (i - 1) * 0x20);
+    nr_of_channels = (count != 0) ? count : 1;
+    dma_unlock(sr);
+}
+
+dma_channel_t *dma_channel_alloc(uint32_t priority) {
+    dma_channel_t *channel = NULL;
+    uint32_t sr = dma_lock();
+
+    for (uint32_t i = 1; i < nr_of_channels && channel == NULL; ++i) {
+        if (!channels[i].allocated) {
+            channel = &channels[i];
+            channel->allocated = 1;
+            channel->priority = (priority > DMA_MAX_PRIORITY) ? DMA_MAX_PRIORITY : priority;
+            channel->burst = 0; // the priority is written with the next burst size
+        }
+    }
+    dma_unlock(sr);
+    return channel;
+}
+
+void dma_channel_free(dma_channel_t *channel) {
+    dma_channel_wait(channel, channel->submitted);
+    channel->allocated = 0;
+}
+
+dma_ticket_t dma_channel_submit(dma_channel_t *ch, const dma_request_t *req) {
+    dma_ticket_t ticket = DMA_NO_TICKET;
+    uint32_t sr = dma_lock();
+
+    if (ch->queue_count < DMA_QUEUE_SIZE) {
+        ch->queue[(ch->queue_head + ch->queue_count) % DMA_QUEUE_SIZE] = *req;
+        ch->queue_count++;
+        ticket = ch->submitted = dma_next_ticket(ch->submitted);
+        if (!ch->running)
+            dma_service(ch);
+    }
+    dma_unlock(sr);
+    return ticket;
+}
+
+dma_ticket_t dma_submit(const dma_request_t *req) {
+    return dma_channel_submit(dma0, req);
+}
+
+int dma_channel_poll(dma_channel_t *ch, dma_ticket_t ticket) {
+    uint32_t sr = dma_lock();
+    int done;
+
+    dma_service(ch);
+    done = (int32_t)(ticket - ch->completed) <= 0;
+    dma_unlock(sr);
+    return done;
+}
+
+int dma_poll(dma_ticket_t ticket) {
+    return dma_channel_poll(dma0, ticket);
+}
+
+/*
+ * Queues the request on channel 0, waiting for a free entry.
+ */
+static dma_ticket_t dma_submit_wait(const dma_request_t *req) {
+    dma_ticket_t ticket;
+
+    while ((ticket = dma_submit(req)) == DMA_NO_TICKET)
+        dma_poll(DMA_NO_TICKET);
+    return ticket;
+}
+
+int dma_channel_wait(dma_channel_t *ch, dma_ticket_t ticket) {
+    if (ticket == DMA_NO_TICKET)
+        return 0;
+    while (!dma_channel_poll(ch, ticket))
+        ;
+    return ch->queue_errors[ticket % DMA_QUEUE_SIZE];
+}
+
+int dma_wait_ticket(dma_ticket_t ticket) {
+    return dma_channel_wait(dma0, ticket);
+}
+
+int dma_busy() {
+    uint32_t sr = dma_lock();
+    int busy;
+
+    dma_service(dma0);
+    busy = dma0->running || dma0->queue_count != 0 || (swap_u32(dma0->regs[START_STATUS_ID]) & DMA_BUSY_BIT);
+    dma_unlock(sr);
+    return busy;
+}
+
+/*
+ * Waits for the queued requests and a running chain of channel 0. The errors stay
+ * pending for dma_wait(), including the bus error of a chain, which the next start
+ * of the controller clears.
+ */
+static void dma_drain() {
+    uint32_t status, sr;
+
+    dma_wait_ticket(dma0->submitted);
+    // a chain is not queued
+    while ((status = swap_u32(dma0->regs[START_STATUS_ID])) & DMA_BUSY_BIT)
+        ;
+    sr = dma_lock();
+    dma0->pending_errors |= status & DMA_TRANSFER_ERROR_BIT;
+    dma_unlock(sr);
+}
+
+int dma_wait() {
+    uint32_t sr;
+    int errors;
+
+    dma_drain();
+    sr = dma_lock();
+    errors = dma0->pending_errors;
+    dma0->pending_errors = 0;
+    dma_unlock(sr);
+    return errors;
+}
+
+const char *dma_error_string(int errors) {
+    if (errors < 0)
+        return "invalid arguments";
+    if (errors & DMA_ERROR_BIT)
+        return "transfer size too big for the spm";
+    if (errors & DMA_TRANSFER_ERROR_BIT)
+        return "bus error during the transfer";
+    if (errors & DMA_MEM_ALLIGN_ERROR_BIT)
+        return "memory address not word aligned";
+    if (errors & DMA_SPM_ALLIGN_ERROR_BIT)
+        return "spm address not word aligned";
+    if (errors & DMA_SPM_OUT_OF_RANGE_ERROR_BIT)
+        return "spm address out of range";
+    if (errors & DMA_DEST_ALLIGN_ERROR_BIT)
+        return "destination address not word aligned";
+    if (errors & DMA_CHAIN_ALLIGN_ERROR_BIT)
+        return "chain address not word aligned";
+    return "no error";
+}
+
+void dma_irq_enable(uint32_t irq_mask) {
+    static uint32_t enabled_mask;
+    uint32_t sr = dma_lock();
+    uint32_t picmr = SPR_READ(SPR_PICMR);
+
+    // PICMR may read back as 0 on some systems, hence the lines are also tracked here
+    SPR_WRITE(SPR_PICMR, (picmr & ~enabled_mask) | irq_mask);
+    enabled_mask = irq_mask;
+    dma_unlock(irq_mask != 0 ? sr | SR_IEE : sr);
+}
+
+int dma_irq_handler() {
+    dma_channel_t *const ch0 = dma0;
+    const uint32_t count = (ch0 == &channels[0]) ? nr_of_channels : 1;
+    int handled = 0;
+
+    // the interrupts are disabled in the handler, the channels share the irq
+    for (uint32_t i = 0; i < count; ++i) {
+        dma_channel_t *const ch = (i == 0) ? ch0 : &channels[i];
+
+        if (swap_u32(ch->regs[START_STATUS_ID]) & DMA_IRQ_PENDING_BIT) {
+            dma_service(ch);
+            handled = 1;
+        }
+    }
+    return handled;
+}
+
+void dma_set_burst_size(uint32_t words) {
+    uint32_t sr;
+
+    if (words == 0 || words > DMA_MAX_BURST_SIZE)
+        words = DMA_MAX_BURST_SIZE;
+    dma_drain();
+    sr = dma_lock();
+    dma_write_burst(dma0, words);
+    dma_unlock(sr);
+}
+
+dma_ticket_t dma_memcpy(void *dst, const void *src, size_t size) {
+    dma_request_t req = {0};
+
+    if (!dma_aligned(dst, size) || !dma_aligned(src, 0))
+        return DMA_NO_TICKET;
+
+    req.command = DMA_FROM_MEM_TO_MEM;
+    req.memory = (uint32_t)src;
+    req.destination = (uint32_t)dst;
+    req.words = size >> 2;
+    dcache_flush();
+    return dma_submit_wait(&req);
+}
+
+dma_ticket_t dma_fill(void *dst, uint32_t pattern, size_t size) {
+    dma_request_t req = {0};
+
+    if (!dma_aligned(dst, size))
+        return DMA_NO_TICKET;
+
+    req.command = DMA_FILL_MEM;
+    req.memory = (uint32_t)dst;
+    req.pattern = pattern;
+    req.words = size >> 2;
+    dcache_flush();
+    return dma_submit_wait(&req);
+}
+
+dma_ticket_t dma_memset(void *dst, int c, size_t size) {
+    uint32_t pattern = (uint8_t)c;
+
+    pattern |= pattern << 8;
+    return dma_fill(dst, pattern | (pattern << 16), size);
+}
+
+dma_ticket_t dma_copy_2d(uint32_t direction, void *memory, size_t memory_stride, void *spm, size_t spm_stride,
+                         size_t row_size, size_t rows) {
+    dma_request_t req = {0};
+
+    if (!dma_aligned(memory, memory_stride) || !dma_aligned(spm, spm_stride) || (row_size & 3) != 0 ||
+        rows == 0 || rows > 0xFFFF || (memory_stride >> 2) > 0xFFFF || (spm_stride >> 2) > 0xFFFF)
+        return DMA_NO_TICKET;
+
+    req.command = direction | DMA_2D;
+    req.memory = (uint32_t)memory;
+    req.spm = (uint32_t)spm;
+    req.words = row_size >> 2;
+    req.destination = (rows << 16) | (memory_stride >> 2);
+    req.pattern = spm_stride >> 2;
+    dcache_flush();
+    return dma_submit_wait(&req);
+}
+
+int dma_pipeline_run(void *spm, uint32_t buffers, void *memory, size_t stride, size_t line_size,
+                     uint32_t lines, uint32_t burst, dma_producer_t producer, void *arg) {
+    dma_ticket_t tickets[DMA_QUEUE_SIZE];
+    dma_request_t req = {0};
+    int errors = 0;
+
+    if (buffers < 2 || buffers > DMA_QUEUE_SIZE || !dma_aligned(spm, line_size) || !dma_aligned(memory, stride))
+        return -1;
+
+    req.command = DMA_FROM_SPM_TO_MEM;
+    req.words = line_size >> 2;
+    req.burst = burst;
+    dcache_flush();
+    for (uint32_t k = 0; k < lines; ++k) {
+        const uint32_t b = k % buffers;
+        uint8_t *buffer = (uint8_t *)spm + b * line_size;
+
+        // the buffer is free once its previous line is transferred
+        if (k >= buffers)
+            errors |= dma_wait_ticket(tickets[b]);
+        producer(buffer, k, arg);
+        req.memory = (uint32_t)memory + k * stride;
+        req.spm = (uint32_t)buffer;
+        tickets[b] = dma_submit_wait(&req);
+    }
+    for (uint32_t b = 0; b < buffers && b < lines; ++b)
+        errors |= dma_wait_ticket(tickets[b]);
+    return errors;
+}
+
+void dma_chain_set(dma_descriptor_t *desc, uint32_t command, uint32_t memory, uint32_t spm,
+                   uint32_t words, uint32_t destination, uint32_t burst, uint32_t flags) {
+    if (burst == 0 || burst > DMA_MAX_BURST_SIZE)
+        burst = DMA_MAX_BURST_SIZE;
+
+    // the controller reads the descriptor like a register write, hence everything
+    // is swapped except the fill pattern (see dma_fill())
+    desc->control = swap_u32(command | flags | (burst - 1));
+    desc->memory = swap_u32(memory);
+    desc->spm = swap_u32(spm);
+    desc->size = swap_u32(words);
+    desc->destination = (command == DMA_FILL_MEM) ? destination : swap_u32(destination);
+    desc->next = 0;
+}
+
+void dma_chain_set_2d(dma_descriptor_t *desc, uint32_t direction, uint32_t memory, size_t memory_stride,
+                      uint32_t spm, size_t row_size, size_t rows, uint32_t burst, uint32_t flags) {
+    dma_chain_set(desc, direction | DMA_2D, memory, spm, row_size >> 2, (rows << 16) | (memory_stride >> 2),
+                  burst, flags);
+}
+
+void dma_chain_link(dma_descriptor_t *desc, const dma_descriptor_t *next) {
+    desc->next = swap_u32((uint32_t)next);
+}
+
+int dma_chain_start(const dma_descriptor_t *first) {
+    uint32_t sr;
+
+    if (!dma_aligned(first, 0))
+        return -1;
+
+    dma_drain();
+    dcache_flush();
+    sr = dma_lock();
+    dma0->regs[CHAIN_ADDRESS_ID] = swap_u32((uint32_t)first);
+    dma0->regs[START_STATUS_ID] = swap_u32(DMA_START_CHAIN);
+    dma0->burst = 0; // the descriptors set the burst size
+    dma_unlock(sr);
+    return 0;
+}
+
+void dma_chain_credit(uint32_t n) {
+    dma0->regs[CHAIN_CONTROL_ID] = swap_u32(n & 0xFFFF);
+}
+
+void dma_chain_stop() {
+    dma0->regs[CHAIN_CONTROL_ID] = swap_u32(((uint32_t)1) << 31);
+}
+
+uint32_t dma_chain_completed() {
+    return swap_u32(dma0->regs[CHAIN_CONTROL_ID]) & 0xFFFF;
+}
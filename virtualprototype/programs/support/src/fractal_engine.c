@@ -0,0 +1,112 @@
+#include <cache.h>
+#include <fractal_engine.h>
+#include <spr.h>
+
+#define SPR_SR 0x11
+#define SPR_PICMR 0x4800
+#define SR_IEE (1 << 2)
+
+// the status register loses the done bit when it is read, hence the end of a frame is kept here
+static volatile int frame_ended;
+static volatile uint32_t frame_errors;
+static uint32_t control;
+
+static uint32_t engine_read(uint32_t id) {
+    uint32_t value;
+
+    asm volatile("l.nios_rrc %[out1],%[in1],r0,0x22" : [out1] "=r"(value) : [in1] "r"(id));
+    return value;
+}
+
+static void engine_write(uint32_t id, uint32_t value) {
+    asm volatile("l.nios_rrr r0,%[in1],%[in2],0x22" ::[in1] "r"(id | FRACTAL_ENGINE_WRITE), [in2] "r"(value));
+}
+
+static uint32_t engine_lock() {
+    uint32_t sr = SPR_READ(SPR_SR);
+
+    SPR_WRITE(SPR_SR, sr & ~SR_IEE);
+    return sr;
+}
+
+static void engine_unlock(uint32_t sr) {
+    SPR_WRITE(SPR_SR, sr);
+}
+
+/*
+ * Keeps the end of a frame from a read status, the interrupts have to be disabled.
+ */
+static uint32_t engine_track(uint32_t status) {
+    if (status & FRACTAL_ENGINE_DONE_BIT) {
+        frame_ended = 1;
+        frame_errors = status & FRACTAL_ENGINE_BUS_ERROR_BIT;
+    }
+    return status;
+}
+
+int fractal_engine_start(void *fbuf, int width, int height, int32_t cx_0, int32_t cy_0, int32_t delta,
+                         uint16_t n_max, uint32_t colour_model) {
+    uint32_t sr;
+
+    if (((uint32_t)fbuf & 3) != 0 || width <= 0 || (width & 1) != 0 || width > FRACTAL_ENGINE_MAX_WIDTH ||
+        height <= 0 || height > FRACTAL_ENGINE_MAX_HEIGHT)
+        return FRACTAL_ENGINE_PARAM_ERROR_BIT;
+    if (fractal_engine_busy())
+        return -1;
+
+    // the engine writes around the cache, no dirty line of the frame buffer may be written back later
+    dcache_flush();
+
+    engine_write(FRACTAL_ENGINE_CX0_ID, cx_0);
+    engine_write(FRACTAL_ENGINE_CY0_ID, cy_0);
+    engine_write(FRACTAL_ENGINE_DELTA_ID, delta);
+    engine_write(FRACTAL_ENGINE_WIDTH_ID, width);
+    engine_write(FRACTAL_ENGINE_HEIGHT_ID, height);
+    engine_write(FRACTAL_ENGINE_NMAX_ID, ((colour_model & 3) << 16) | n_max);
+    engine_write(FRACTAL_ENGINE_FRAME_BUFFER_ID, (uint32_t)fbuf);
+
+    sr = engine_lock();
+    frame_ended = 0;
+    frame_errors = 0;
+    engine_write(FRACTAL_ENGINE_CONTROL_STATUS_ID, control | FRACTAL_ENGINE_START);
+    engine_unlock(sr);
+    return 0;
+}
+
+uint32_t fractal_engine_status() {
+    uint32_t sr = engine_lock();
+    uint32_t status = engine_track(engine_read(FRACTAL_ENGINE_CONTROL_STATUS_ID));
+
+    engine_unlock(sr);
+    return status;
+}
+
+int fractal_engine_busy() {
+    return (fractal_engine_status() & FRACTAL_ENGINE_BUSY_BIT) != 0;
+}
+
+int fractal_engine_wait() {
+    while (fractal_engine_busy())
+        ;
+    return frame_errors;
+}
+
+void fractal_engine_irq_enable(int enable) {
+    uint32_t sr = engine_lock();
+    uint32_t picmr = SPR_READ(SPR_PICMR);
+
+    control = enable ? FRACTAL_ENGINE_IRQ_ENABLE : 0;
+    engine_write(FRACTAL_ENGINE_CONTROL_STATUS_ID, control);
+    SPR_WRITE(SPR_PICMR, enable ? picmr | FRACTAL_ENGINE_IRQ_MASK : picmr & ~FRACTAL_ENGINE_IRQ_MASK);
+    engine_unlock(enable ? sr | SR_IEE : sr);
+}
+
+int fractal_engine_irq_handler() {
+    int ended;
+
+    // the interrupts are disabled in the handler
+    engine_track(engine_read(FRACTAL_ENGINE_CONTROL_STATUS_ID));
+    ended = frame_ended;
+    frame_ended = 0;
+    return ended;
+}
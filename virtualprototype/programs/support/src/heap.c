@@ -0,0 +1,437 @@
+#include <cache.h>
+#include <heap.h>
+#include <locks.h>
+#include <spr.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * The TLSF pool. A free block of `size` bytes is kept in list [fl][sl], where fl is the
+ * power of two below size and sl divides that range linearly into SL_COUNT parts.
+ * Blocks below SMALL_BLOCK all share fl = 0, with one list per HEAP_ALIGN step.
+ * The bitmaps tell which lists are non-empty, hence finding a fitting block needs two
+ * find-first-set operations instead of a search.
+ *
+ */
+#define SL_LOG2 4
+#define SL_COUNT (1 << SL_LOG2)
+#define ALIGN_LOG2 3
+#define FL_SHIFT (SL_LOG2 + ALIGN_LOG2)
+#define SMALL_BLOCK (1 << FL_SHIFT)
+#define FL_MAX 25 // blocks below 64 MB
+#define FL_COUNT (FL_MAX - FL_SHIFT + 2)
+
+#define HEADER_SIZE 8
+#define MIN_SIZE 8 // room for the free list links
+#define MAX_REQUEST ((uint32_t)1 << FL_MAX)
+
+#define BLOCK_FREE 1
+#define BLOCK_PREV_FREE 2
+
+#define CACHE_CLASS_SIZE 16
+#define CACHE_CLASSES (HEAP_CACHE_MAX_SIZE / CACHE_CLASS_SIZE)
+
+/**
+ * @brief A block header; next_free and prev_free are only valid in a free block, they
+ * overlay the start of the payload of an allocated one.
+ *
+ */
+typedef struct block_t block_t;
+struct block_t {
+    block_t* prev_phys;
+    uint32_t size; // payload size | BLOCK_FREE | BLOCK_PREV_FREE
+    block_t* next_free;
+    block_t* prev_free;
+};
+
+static struct {
+    int initialized, locking;
+    uint32_t start, end;
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[FL_COUNT];
+    block_t* blocks[FL_COUNT][SL_COUNT];
+    uint32_t used, peak;
+} heap;
+
+// the per-core caches of freed small blocks, class c holds blocks of at least (c + 1) * 16 bytes,
+// each one fills whole cache lines such that the cores never share a line
+static struct {
+    void* head[CACHE_CLASSES];
+    uint8_t count[CACHE_CLASSES];
+    uint32_t bytes;
+} __aligned(CACHE_LINE_SIZE) caches[HEAP_MAX_CORES];
+
+// end of the .bss, provided by the linker script
+extern char end[];
+
+__static_inline uint32_t block_size(const block_t* block) {
+    return block->size & ~((uint32_t)3);
+}
+
+__static_inline block_t* block_next(const block_t* block) {
+    return (block_t*)((uint8_t*)block + HEADER_SIZE + block_size(block));
+}
+
+__static_inline int fls32(uint32_t x) {
+    return 31 - __builtin_clz(x);
+}
+
+__static_inline int ffs32(uint32_t x) {
+    return __builtin_ctz(x);
+}
+
+__static_inline unsigned core_id() {
+    return (SPR_READ(9) & 0xF) & (HEAP_MAX_CORES - 1);
+}
+
+static void heap_lock() {
+    if (heap.locking) {
+        get_lock(HEAP_LOCK_ID);
+    }
+}
+
+static void heap_unlock() {
+    if (heap.locking) {
+        release_lock(HEAP_LOCK_ID);
+    }
+}
+
+static void mapping(uint32_t size, int* fl, int* sl) {
+    if (size < SMALL_BLOCK) {
+        *fl = 0;
+        *sl = size >> ALIGN_LOG2;
+    } else {
+        int f = fls32(size);
+        *sl = (size >> (f - SL_LOG2)) ^ SL_COUNT;
+        *fl = f - (FL_SHIFT - 1);
+    }
+}
+
+/**
+ * @brief Like mapping(), but rounds up to the next list, such that every block
+ * in the resulting list is large enough.
+ *
+ */
+static void mapping_search(uint32_t size, int* fl, int* sl) {
+    if (size >= SMALL_BLOCK) {
+        size += (((uint32_t)1) << (fls32(size) - SL_LOG2)) - 1;
+    }
+    mapping(size, fl, sl);
+}
+
+static void insert_block(block_t* block) {
+    int fl, sl;
+    mapping(block_size(block), &fl, &sl);
+
+    block_t* head = heap.blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = NULL;
+    if (head != NULL) {
+        head->prev_free = block;
+    }
+    heap.blocks[fl][sl] = block;
+    heap.fl_bitmap |= ((uint32_t)1) << fl;
+    heap.sl_bitmap[fl] |= ((uint32_t)1) << sl;
+}
+
+static void remove_block(block_t* block) {
+    int fl, sl;
+    mapping(block_size(block), &fl, &sl);
+
+    if (block->next_free != NULL) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    if (block->prev_free != NULL) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        heap.blocks[fl][sl] = block->next_free;
+        if (block->next_free == NULL) {
+            heap.sl_bitmap[fl] &= ~(((uint32_t)1) << sl);
+            if (heap.sl_bitmap[fl] == 0) {
+                heap.fl_bitmap &= ~(((uint32_t)1) << fl);
+            }
+        }
+    }
+}
+
+static block_t* find_block(uint32_t size) {
+    int fl, sl;
+    mapping_search(size, &fl, &sl);
+    if (fl >= FL_COUNT) {
+        return NULL;
+    }
+
+    uint32_t sl_map = heap.sl_bitmap[fl] & (~((uint32_t)0) << sl);
+    if (sl_map == 0) {
+        uint32_t fl_map = heap.fl_bitmap & (~((uint32_t)0) << (fl + 1));
+        if (fl_map == 0) {
+            return NULL;
+        }
+        fl = ffs32(fl_map);
+        sl_map = heap.sl_bitmap[fl];
+    }
+    return heap.blocks[fl][ffs32(sl_map)];
+}
+
+static void* pool_alloc(uint32_t size) {
+    block_t* block = find_block(size);
+    if (block == NULL) {
+        return NULL;
+    }
+    remove_block(block);
+
+    uint32_t available = block_size(block);
+    if (available >= size + HEADER_SIZE + MIN_SIZE) {
+        // give the remainder back
+        block_t* rest = (block_t*)((uint8_t*)block + HEADER_SIZE + size);
+        rest->prev_phys = block;
+        rest->size = (available - size - HEADER_SIZE) | BLOCK_FREE;
+        block->size = size | (block->size & BLOCK_PREV_FREE);
+        block_next(rest)->prev_phys = rest;
+        insert_block(rest);
+    } else {
+        block_next(block)->size &= ~BLOCK_PREV_FREE;
+    }
+
+    block->size &= ~BLOCK_FREE;
+    heap.used += block_size(block);
+#ifdef HEAP_STATISTICS
+    if (heap.used > heap.peak) {
+        heap.peak = heap.used;
+    }
+#endif
+    return (uint8_t*)block + HEADER_SIZE;
+}
+
+static void pool_free(block_t* block) {
+    heap.used -= block_size(block);
+    block->size |= BLOCK_FREE;
+
+    // merge with the physical neighbours
+    if (block->size & BLOCK_PREV_FREE) {
+        block_t* prev = block->prev_phys;
+        remove_block(prev);
+        prev->size += HEADER_SIZE + block_size(block);
+        block = prev;
+    }
+
+    block_t* next = block_next(block);
+    if (next->size & BLOCK_FREE) {
+        remove_block(next);
+        block->size += HEADER_SIZE + block_size(next);
+        next = block_next(block);
+    }
+
+    next->prev_phys = block;
+    next->size |= BLOCK_PREV_FREE;
+    insert_block(block);
+}
+
+/**
+ * @brief Returns the cached blocks of core `id` to the pool, the lock must be held.
+ *
+ */
+static void cache_drain(unsigned id) {
+    for (unsigned c = 0; c < CACHE_CLASSES; ++c) {
+        while (caches[id].head[c] != NULL) {
+            void* ptr = caches[id].head[c];
+            caches[id].head[c] = *(void**)ptr;
+            pool_free((block_t*)((uint8_t*)ptr - HEADER_SIZE));
+        }
+        caches[id].count[c] = 0;
+    }
+    caches[id].bytes = 0;
+}
+
+void heap_init() {
+    volatile uint32_t* info = (volatile uint32_t*)HEAP_INFO_ADDRESS;
+    uint32_t start = (uint32_t)end;
+    uint32_t stop = HEAP_DEFAULT_END;
+    uint32_t stack_top;
+
+    if (heap.initialized) {
+        return;
+    }
+
+    // an image without heap information (or one of another program) is ignored
+    if (info[0] >= start && info[0] < info[1] && info[1] <= HEAP_DEFAULT_END) {
+        start = info[0];
+        stop = info[1];
+    }
+
+#ifdef __OR1300__
+    asm volatile("l.mfspr %[out1],r0,0x5005;l.nop;l.nop" : [out1] "=r"(stack_top));
+#else
+    stack_top = 0x007FFFFC;
+#endif
+    if (stack_top >= start && stack_top < stop) {
+        start = stack_top + 4;
+    }
+
+    start = (start + HEAP_ALIGN - 1) & ~((uint32_t)HEAP_ALIGN - 1);
+    stop &= ~((uint32_t)HEAP_ALIGN - 1);
+    heap.start = start;
+    heap.end = stop;
+
+    // one free block and a zero-sized allocated sentinel at the end
+    block_t* block = (block_t*)start;
+    block->prev_phys = NULL;
+    block->size = (stop - start - 2 * HEADER_SIZE) | BLOCK_FREE;
+
+    block_t* sentinel = block_next(block);
+    sentinel->prev_phys = block;
+    sentinel->size = BLOCK_PREV_FREE;
+
+    insert_block(block);
+    heap.initialized = 1;
+}
+
+void heap_enable_locking() {
+    heap_init();
+    heap.locking = 1;
+}
+
+void* malloc(size_t size) {
+    if (!heap.initialized) {
+        heap_init();
+    }
+    if (size > MAX_REQUEST) {
+        return NULL;
+    }
+
+    uint32_t adjusted = (size + HEAP_ALIGN - 1) & ~((uint32_t)HEAP_ALIGN - 1);
+    if (adjusted < MIN_SIZE) {
+        adjusted = MIN_SIZE;
+    }
+
+    if (adjusted <= HEAP_CACHE_MAX_SIZE) {
+        adjusted = (adjusted + CACHE_CLASS_SIZE - 1) & ~((uint32_t)CACHE_CLASS_SIZE - 1);
+
+        unsigned c = adjusted / CACHE_CLASS_SIZE - 1;
+        unsigned id = core_id();
+        void* res = caches[id].head[c];
+        if (res != NULL) {
+            caches[id].head[c] = *(void**)res;
+            caches[id].count[c]--;
+            caches[id].bytes -= block_size((block_t*)((uint8_t*)res - HEADER_SIZE));
+            return res;
+        }
+    }
+
+    heap_lock();
+    void* res = pool_alloc(adjusted);
+    if (res == NULL) {
+        // the cached blocks may keep free neighbours apart
+        cache_drain(core_id());
+        res = pool_alloc(adjusted);
+    }
+    heap_unlock();
+    return res;
+}
+
+void free(void* ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    block_t* block = (block_t*)((uint8_t*)ptr - HEADER_SIZE);
+    uint32_t size = block_size(block);
+
+    // a block may be larger than its class, never smaller
+    if (size >= CACHE_CLASS_SIZE && size <= HEAP_CACHE_MAX_SIZE) {
+        unsigned c = size / CACHE_CLASS_SIZE - 1;
+        unsigned id = core_id();
+        if (caches[id].count[c] < HEAP_CACHE_DEPTH) {
+            *(void**)ptr = caches[id].head[c];
+            caches[id].head[c] = ptr;
+            caches[id].count[c]++;
+            caches[id].bytes += size;
+            return;
+        }
+    }
+
+    heap_lock();
+    pool_free(block);
+    heap_unlock();
+}
+
+void heap_flush_cache() {
+    heap_lock();
+    cache_drain(core_id());
+    heap_unlock();
+}
+
+void* calloc(size_t count, size_t size) {
+    if (size != 0 && count > MAX_REQUEST / size) {
+        return NULL;
+    }
+
+    void* res = malloc(count * size);
+    if (res != NULL) {
+        memset(res, 0, count * size);
+    }
+    return res;
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (ptr == NULL) {
+        return malloc(size);
+    }
+    if (size == 0) {
+        free(ptr);
+        return NULL;
+    }
+
+    uint32_t old = block_size((block_t*)((uint8_t*)ptr - HEADER_SIZE));
+    if (old >= size) {
+        return ptr;
+    }
+
+    void* res = malloc(size);
+    if (res != NULL) {
+        memcpy(res, ptr, old);
+        free(ptr);
+    }
+    return res;
+}
+
+void heap_get_stats(heap_stats_t* stats) {
+    if (!heap.initialized) {
+        heap_init();
+    }
+
+    memset(stats, 0, sizeof(heap_stats_t));
+    stats->start = heap.start;
+    stats->end = heap.end;
+
+    heap_lock();
+    stats->used = heap.used;
+    stats->peak = heap.peak;
+    for (block_t* block = (block_t*)heap.start; block_size(block) != 0; block = block_next(block)) {
+        if (block->size & BLOCK_FREE) {
+            uint32_t size = block_size(block);
+            stats->free += size;
+            stats->free_blocks++;
+            if (size > stats->largest_free) {
+                stats->largest_free = size;
+            }
+        }
+    }
+    heap_unlock();
+
+    for (unsigned i = 0; i < HEAP_MAX_CORES; ++i) {
+        stats->cached += caches[i].bytes;
+    }
+    if (stats->free != 0) {
+        stats->fragmentation = 100 - (uint32_t)(((uint64_t)stats->largest_free * 100) / stats->free);
+    }
+}
+
+void heap_print_stats() {
+    heap_stats_t stats;
+    heap_get_stats(&stats);
+
+    printf("Heap 0x%08X - 0x%08X: used %u (cached %u, peak %u), free %u in %u blocks, largest %u, fragmentation %u%%\n",
+           stats.start, stats.end, stats.used, stats.cached, stats.peak, stats.free, stats.free_blocks,
+           stats.largest_free, stats.fragmentation);
+}
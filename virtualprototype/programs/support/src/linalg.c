@@ -0,0 +1,320 @@
+#include <cache.h>
+#include <dma.h>
+#include <linalg.h>
+#include <stdio.h>
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+/**
+ * @brief Accumulates the lower 32 bits of a * b in the MAC unit of the multiplier.
+ *
+ */
+__static_inline void mac(int32_t a, int32_t b) {
+    asm volatile("l.mac %[in1],%[in2]" : : [in1] "r"(a), [in2] "r"(b));
+}
+
+/**
+ * @brief Returns the lower 32 bits of the MAC accumulator and clears it.
+ *
+ */
+__static_inline int32_t mac_read_clear() {
+    int32_t r;
+    asm volatile("l.macrc %[out1]" : [out1] "=r"(r));
+    return r;
+}
+
+__static_inline int32_t mul_q28(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * b) >> 28);
+}
+
+/**
+ * @brief Returns the sum of a[k] * b[k * stride] for k < len.
+ *
+ * The MAC unit only keeps the lower 32 bits of a product, which is all the int32_t
+ * kernels need; Q4.28 requires bits 59..28, hence these products are computed in 64 bits.
+ */
+__static_inline int32_t dot(const int32_t *a, const int32_t *b, size_t stride, size_t len, int q28) {
+    if (q28) {
+        int32_t sum = 0;
+        for (size_t k = 0; k < len; ++k) {
+            sum += mul_q28(a[k], b[k * stride]);
+        }
+        return sum;
+    }
+
+    for (size_t k = 0; k < len; ++k) {
+        mac(a[k], b[k * stride]);
+    }
+    return mac_read_clear();
+}
+
+/**
+ * @brief Returns the number of bytes of the D$ a kernel may use for its tiles.
+ *
+ */
+static uint32_t dcache_budget() {
+    uint32_t cfg = dcache_read_cfg();
+    if (((cfg >> 19) & 1) == 0) {
+        return 0; // disabled, tiling does not matter
+    }
+
+    uint32_t ways = ((uint32_t)1) << (cfg & 3);
+    uint32_t size = CACHE_SIZE_BYTES(CACHE_SIZE_CODE(cfg));
+    if (ways == 1) {
+        return size / 4;
+    }
+    return size / ways * (ways - CACHE_LOCKED_WAYS_CODE(cfg)) / 2;
+}
+
+uint32_t linalg_tile(uint32_t tiles) {
+    uint32_t words = dcache_budget() / sizeof(int32_t);
+    uint32_t t = LINALG_MIN_TILE;
+
+    while (tiles * (2 * t) * (2 * t) <= words) {
+        t <<= 1;
+    }
+    return t;
+}
+
+uint32_t linalg_block() {
+    // the block of x shares the budget with the streamed rows of a
+    uint32_t words = dcache_budget() / sizeof(int32_t) / 2;
+    uint32_t b = LINALG_MIN_TILE;
+
+    while (2 * b <= words) {
+        b <<= 1;
+    }
+    return b;
+}
+
+static void matvec(const int32_t *a, const int32_t *x, int32_t *y, size_t rows, size_t cols, int q28) {
+    const size_t block = linalg_block();
+
+    for (size_t i = 0; i < rows; ++i) {
+        y[i] = 0;
+    }
+    mac_read_clear();
+
+    // the block of x stays in the D$ while the rows of a are streamed through it
+    for (size_t jj = 0; jj < cols; jj += block) {
+        const size_t len = MIN(block, cols - jj);
+        for (size_t i = 0; i < rows; ++i) {
+            y[i] += dot(a + i * cols + jj, x + jj, 1, len, q28);
+        }
+    }
+}
+
+void linalg_matvec_i32(const int32_t *a, const int32_t *x, int32_t *y, size_t rows, size_t cols) {
+    matvec(a, x, y, rows, cols, 0);
+}
+
+void linalg_matvec_q28(const int32_t *a, const int32_t *x, int32_t *y, size_t rows, size_t cols) {
+    matvec(a, x, y, rows, cols, 1);
+}
+
+static void matmul(const int32_t *a, const int32_t *b, int32_t *c, size_t n, size_t m, size_t p, int q28) {
+    const size_t t = linalg_tile(3);
+
+    for (size_t i = 0; i < n * p; ++i) {
+        c[i] = 0;
+    }
+    mac_read_clear();
+
+    for (size_t ii = 0; ii < n; ii += t) {
+        const size_t iend = MIN(ii + t, n);
+        for (size_t kk = 0; kk < m; kk += t) {
+            const size_t len = MIN(t, m - kk);
+            for (size_t jj = 0; jj < p; jj += t) {
+                const size_t jend = MIN(jj + t, p);
+                for (size_t i = ii; i < iend; ++i) {
+                    for (size_t j = jj; j < jend; ++j) {
+                        c[i * p + j] += dot(a + i * m + kk, b + kk * p + j, p, len, q28);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void linalg_matmul_i32(const int32_t *a, const int32_t *b, int32_t *c, size_t n, size_t m, size_t p) {
+    matmul(a, b, c, n, m, p, 0);
+}
+
+void linalg_matmul_q28(const int32_t *a, const int32_t *b, int32_t *c, size_t n, size_t m, size_t p) {
+    matmul(a, b, c, n, m, p, 1);
+}
+
+void linalg_transpose(const int32_t *a, int32_t *t, size_t rows, size_t cols) {
+    // a tile of the source and one of the destination
+    const size_t tile = linalg_tile(2);
+
+    for (size_t ii = 0; ii < rows; ii += tile) {
+        const size_t iend = MIN(ii + tile, rows);
+        for (size_t jj = 0; jj < cols; jj += tile) {
+            const size_t jend = MIN(jj + tile, cols);
+            for (size_t i = ii; i < iend; ++i) {
+                for (size_t j = jj; j < jend; ++j) {
+                    t[j * rows + i] = a[i * cols + j];
+                }
+            }
+        }
+    }
+}
+
+/*
+ * The SPM-staged kernels. A tile is copied by a single 2D DMA-transfer, its rows are
+ * placed t words apart in the SPM.
+ *
+ */
+
+static void spm_dma_wait() {
+    dma_wait();
+    // the SPM has been written behind the back of the compiler
+    asm volatile("" : : : "memory");
+}
+
+/*
+ * Unlike dma_copy_2d() the D$ is not flushed for every tile, matmul_spm() does it once.
+ */
+static void spm_dma_start_2d(const int32_t *mem, size_t stride, int32_t *spm, size_t rows, size_t cols,
+                             size_t t, uint32_t direction) {
+    dma_request_t req = {0};
+
+    req.command = direction | DMA_2D;
+    req.memory = (uint32_t)mem;
+    req.spm = (uint32_t)spm;
+    req.words = cols;
+    req.destination = (rows << 16) | stride;
+    req.pattern = t;
+    req.burst = t; // one tile row
+    while (dma_submit(&req) == DMA_NO_TICKET)
+        dma_poll(DMA_NO_TICKET);
+}
+
+static void spm_copy_in(int32_t *spm, const int32_t *mem, size_t stride, size_t rows, size_t cols, size_t t) {
+    spm_dma_start_2d(mem, stride, spm, rows, cols, t, DMA_FROM_MEM_TO_SPM);
+}
+
+static void spm_copy_out(const int32_t *spm, int32_t *mem, size_t stride, size_t rows, size_t cols, size_t t) {
+    spm_dma_start_2d(mem, stride, (int32_t *)spm, rows, cols, t, DMA_FROM_SPM_TO_MEM);
+}
+
+static void matmul_spm(const int32_t *a, const int32_t *b, int32_t *c, size_t n, size_t m, size_t p, int q28) {
+    size_t t = LINALG_MIN_TILE;
+
+    // the tiles of a, b and c
+    while (3 * (2 * t) * (2 * t) * sizeof(int32_t) <= LINALG_SPM_SIZE) {
+        t <<= 1;
+    }
+
+    int32_t *sa = (int32_t *)LINALG_SPM_ADDRESS;
+    int32_t *sb = sa + t * t;
+    int32_t *sc = sb + t * t;
+
+    // the DMA-controller reads and writes the SDRAM directly
+    dcache_flush();
+    spm_dma_wait();
+    mac_read_clear();
+
+    for (size_t ii = 0; ii < n; ii += t) {
+        const size_t ih = MIN(t, n - ii);
+        for (size_t jj = 0; jj < p; jj += t) {
+            const size_t jw = MIN(t, p - jj);
+
+            spm_dma_wait(); // the previous tile of c may still be copied out
+            for (size_t i = 0; i < ih * t; ++i) {
+                sc[i] = 0;
+            }
+
+            for (size_t kk = 0; kk < m; kk += t) {
+                const size_t kw = MIN(t, m - kk);
+                spm_copy_in(sa, a + ii * m + kk, m, ih, kw, t);
+                spm_copy_in(sb, b + kk * p + jj, p, kw, jw, t);
+                spm_dma_wait();
+
+                for (size_t i = 0; i < ih; ++i) {
+                    for (size_t j = 0; j < jw; ++j) {
+                        sc[i * t + j] += dot(sa + i * t, sb + j, t, kw, q28);
+                    }
+                }
+            }
+
+            spm_copy_out(sc, c + ii * p + jj, p, ih, jw, t);
+        }
+    }
+    spm_dma_wait();
+}
+
+void linalg_matmul_i32_spm(const int32_t *a, const int32_t *b, int32_t *c, size_t n, size_t m, size_t p) {
+    matmul_spm(a, b, c, n, m, p, 0);
+}
+
+void linalg_matmul_q28_spm(const int32_t *a, const int32_t *b, int32_t *c, size_t n, size_t m, size_t p) {
+    matmul_spm(a, b, c, n, m, p, 1);
+}
+
+/*
+ * The verify routines. The references use unsigned arithmetic such that they wrap
+ * around exactly like the MAC unit.
+ *
+ */
+
+static int verify_matvec(const int32_t *a, const int32_t *x, const int32_t *y, size_t rows, size_t cols, int q28) {
+    for (size_t i = 0; i < rows; ++i) {
+        uint32_t sum = 0;
+        for (size_t j = 0; j < cols; ++j) {
+            sum += q28 ? (uint32_t)mul_q28(a[i * cols + j], x[j]) : (uint32_t)a[i * cols + j] * (uint32_t)x[j];
+        }
+        if ((int32_t)sum != y[i]) {
+            printf("matvec verification failed at i = %d, %ld != %ld!\n", (int)i, (long)(int32_t)sum, (long)y[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int linalg_verify_matvec_i32(const int32_t *a, const int32_t *x, const int32_t *y, size_t rows, size_t cols) {
+    return verify_matvec(a, x, y, rows, cols, 0);
+}
+
+int linalg_verify_matvec_q28(const int32_t *a, const int32_t *x, const int32_t *y, size_t rows, size_t cols) {
+    return verify_matvec(a, x, y, rows, cols, 1);
+}
+
+static int verify_matmul(const int32_t *a, const int32_t *b, const int32_t *c, size_t n, size_t m, size_t p, int q28) {
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < p; ++j) {
+            uint32_t sum = 0;
+            for (size_t k = 0; k < m; ++k) {
+                sum += q28 ? (uint32_t)mul_q28(a[i * m + k], b[k * p + j]) : (uint32_t)a[i * m + k] * (uint32_t)b[k * p + j];
+            }
+            if ((int32_t)sum != c[i * p + j]) {
+                printf("matmul verification failed at i = %d, j = %d, %ld != %ld!\n",
+                       (int)i, (int)j, (long)(int32_t)sum, (long)c[i * p + j]);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int linalg_verify_matmul_i32(const int32_t *a, const int32_t *b, const int32_t *c, size_t n, size_t m, size_t p) {
+    return verify_matmul(a, b, c, n, m, p, 0);
+}
+
+int linalg_verify_matmul_q28(const int32_t *a, const int32_t *b, const int32_t *c, size_t n, size_t m, size_t p) {
+    return verify_matmul(a, b, c, n, m, p, 1);
+}
+
+int linalg_verify_transpose(const int32_t *a, const int32_t *t, size_t rows, size_t cols) {
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            if (t[j * rows + i] != a[i * cols + j]) {
+                printf("transpose verification failed at i = %d, j = %d, %ld != %ld!\n",
+                       (int)i, (int)j, (long)a[i * cols + j], (long)t[j * rows + i]);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
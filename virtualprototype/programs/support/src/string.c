@@ -1,103 +1,347 @@
+#include <cache.h>
+#include <dma.h>
 #include <string.h>
 
 // Sources:
 // https://opensource.apple.com/source/xnu/xnu-2050.9.2/libsyscall/wrappers/memcpy.c
 // https://github.com/gcc-mirror/gcc/blob/master/libiberty/memset.c
+// https://graphics.stanford.edu/~seander/bithacks.html#ZeroInWord
 
-/*
- * sizeof(word) MUST BE A POWER OF TWO
- * SO THAT wmask BELOW IS ALL ONES
- */
-typedef int word; /* "word" used for optimal copy speed */
+typedef uint32_t word; /* "word" used for optimal copy speed */
 
 #define wsize sizeof(word)
 #define wmask (wsize - 1)
 
+#define LINE_WORDS (CACHE_LINE_SIZE / wsize)
+#define SMALL_SIZE 16
+
 /*
- * Copy a block of memory, handling overlap.
- * This is the routine that actually implements
- * (the portable versions of) bcopy, memcpy, and memmove.
+ * A word contains a zero byte if this is not zero.
  */
-void* memcpy(void* dst0, const void* src0, size_t length) {
-    volatile char* dst = dst0;
-    const char* src = src0;
-    size_t t;
+#define HAS_ZERO(w) (((w) - (word)0x01010101) & ~(w) & (word)0x80808080)
 
-    if (length == 0 || dst == src) /* nothing to do */
-        goto done;
+/*
+ * Shifts that move the byte at the lowest address of a word towards the
+ * highest address resp. back (the OR1300 is big-endian).
+ */
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define SHIFT_HEAD(w, n) ((w) << (n))
+#define SHIFT_TAIL(w, n) ((w) >> (n))
+#else
+#define SHIFT_HEAD(w, n) ((w) >> (n))
+#define SHIFT_TAIL(w, n) ((w) << (n))
+#endif
 
+/*
+ * Large aligned copies and fills between SDRAM addresses are done by the
+ * memory to memory modes of the DMA-controller (see dma.c), which flushes the D$.
+ * Only if channel 0 is idle: no queued requests of the program and no chain, which
+ * may wait for credits forever. Not with locked D$ ways either, the flush releases them.
+ * Only the own request is waited for, the errors of the channel are left to the program.
+ */
+#ifdef __OR1300__
+#define STRING_DMA_THRESHOLD (16 * 1024)
+
+static int dma_usable(uintptr_t address, size_t length) {
+    return length >= STRING_DMA_THRESHOLD && (address >> 25) == 0 && ((address + length) >> 25) == 0;
+}
+
+static int dma_available() {
+    return CACHE_LOCKED_WAYS_CODE(dcache_read_cfg()) == 0 && !dma_busy();
+}
+
+/*
+ * Returns 1 if the request of `ticket` completed without errors, otherwise the
+ * region is done by the cpu.
+ */
+static int dma_done(dma_ticket_t ticket) {
+    return ticket != DMA_NO_TICKET && dma_wait_ticket(ticket) == 0;
+}
+#endif
+
+/*
+ * Copies whole words from an aligned src to an aligned dst in increasing order,
+ * hence it may also be used for overlapping regions with dst < src.
+ * Returns the number of bytes copied.
+ */
+static size_t copy_words(word* dst, const word* src, size_t length, int overlap) {
+    word* const start = dst;
+    size_t t = length / wsize;
+
+    if (t >= 2 * LINE_WORDS && dcache_enabled()) {
         /*
-         * Macros: loop-t-times; and loop-t-times, t>0
-         */
-#define TLOOP(s) \
-    if (t)       \
-    TLOOP1(s)
-#define TLOOP1(s) \
-    do {          \
-        s;        \
-    } while (--t)
-
-    if ((unsigned long)dst < (unsigned long)src) {
-        /*
-         * Copy forward.
+         * Line at a time: the next lines of src are prefetched and every
+         * line of dst is allocated without reading it from memory.
          */
-        t = (uintptr_t)src; /* only need low bits */
-        if ((t | (uintptr_t)dst) & wmask) {
-            /*
-             * Try to align operands.  This cannot be done
-             * unless the low bits match.
-             */
-            if ((t ^ (uintptr_t)dst) & wmask || length < wsize)
-                t = length;
-            else
-                t = wsize - (t & wmask);
-            length -= t;
-            TLOOP1(*dst++ = *src++);
+        int zero = !overlap && dcache_zero_line_allowed((uintptr_t)dst);
+        while (((uintptr_t)dst & (CACHE_LINE_SIZE - 1)) && t) {
+            *dst++ = *src++;
+            t--;
         }
-        /*
-         * Copy whole words, then mop up any trailing bytes.
-         */
-        t = length / wsize;
-        TLOOP(*(word*)dst = *(word*)src; src += wsize; dst += wsize);
-        t = length & wmask;
-        TLOOP(*dst++ = *src++);
-    } else {
-        /*
-         * Copy backwards.  Otherwise essentially the same.
-         * Alignment works as before, except that it takes
-         * (t&wmask) bytes to align, not wsize-(t&wmask).
-         */
-        src += length;
-        dst += length;
-        t = (uintptr_t)src;
-        if ((t | (uintptr_t)dst) & wmask) {
-            if ((t ^ (uintptr_t)dst) & wmask || length <= wsize)
-                t = length;
-            else
-                t &= wmask;
-            length -= t;
-            TLOOP1(*--dst = *--src);
+        for (; t >= LINE_WORDS; t -= LINE_WORDS) {
+            if (t >= 3 * LINE_WORDS)
+                dcache_prefetch_line(src + 2 * LINE_WORDS);
+            if (zero)
+                dcache_zero_line(dst);
+            word w0 = src[0], w1 = src[1], w2 = src[2], w3 = src[3];
+            word w4 = src[4], w5 = src[5], w6 = src[6], w7 = src[7];
+            dst[0] = w0; dst[1] = w1; dst[2] = w2; dst[3] = w3;
+            dst[4] = w4; dst[5] = w5; dst[6] = w6; dst[7] = w7;
+            src += LINE_WORDS;
+            dst += LINE_WORDS;
+        }
+    }
+
+    for (; t >= 4; t -= 4) {
+        word w0 = src[0], w1 = src[1], w2 = src[2], w3 = src[3];
+        dst[0] = w0; dst[1] = w1; dst[2] = w2; dst[3] = w3;
+        src += 4;
+        dst += 4;
+    }
+    while (t--)
+        *dst++ = *src++;
+
+    return (dst - start) * wsize;
+}
+
+/*
+ * Copies whole words to an aligned dst from a src that is not word aligned by
+ * merging two aligned source words. Only whole aligned words of src are read.
+ */
+static size_t copy_words_shifted(word* dst, const unsigned char* src, size_t length) {
+    const unsigned offset = (uintptr_t)src & wmask;
+    const unsigned head = 8 * offset, tail = 32 - 8 * offset;
+    const word* s = (const word*)(src - offset);
+    size_t t = length / wsize;
+    word w0 = *s++;
+
+    for (; t >= 4; t -= 4) {
+        word w1 = s[0], w2 = s[1], w3 = s[2], w4 = s[3];
+        dst[0] = SHIFT_HEAD(w0, head) | SHIFT_TAIL(w1, tail);
+        dst[1] = SHIFT_HEAD(w1, head) | SHIFT_TAIL(w2, tail);
+        dst[2] = SHIFT_HEAD(w2, head) | SHIFT_TAIL(w3, tail);
+        dst[3] = SHIFT_HEAD(w3, head) | SHIFT_TAIL(w4, tail);
+        w0 = w4;
+        s += 4;
+        dst += 4;
+    }
+    for (; t; t--) {
+        word w1 = *s++;
+        *dst++ = SHIFT_HEAD(w0, head) | SHIFT_TAIL(w1, tail);
+        w0 = w1;
+    }
+    return (length / wsize) * wsize;
+}
+
+static void copy_forward(unsigned char* dst, const unsigned char* src, size_t length, int overlap) {
+    if (length >= SMALL_SIZE) {
+        while ((uintptr_t)dst & wmask) {
+            *dst++ = *src++;
+            length--;
+        }
+
+        size_t done;
+        if (((uintptr_t)src & wmask) == 0) {
+#ifdef __OR1300__
+            if (!overlap && dma_usable((uintptr_t)dst, length) && dma_usable((uintptr_t)src, length) &&
+                dma_available()) {
+                done = length & ~wmask;
+                if (dma_done(dma_memcpy(dst, src, done))) {
+                    dst += done;
+                    src += done;
+                    length -= done;
+                }
+            }
+#endif
+            done = copy_words((word*)dst, (const word*)src, length, overlap);
+        } else {
+            done = copy_words_shifted((word*)dst, src, length);
         }
-        t = length / wsize;
-        TLOOP(src -= wsize; dst -= wsize; *(word*)dst = *(word*)src);
-        t = length & wmask;
-        TLOOP(*--dst = *--src);
+        dst += done;
+        src += done;
+        length -= done;
     }
-done:
-    return (dst0);
+
+    while (length--)
+        *dst++ = *src++;
+}
+
+static void copy_backward(unsigned char* dst, const unsigned char* src, size_t length) {
+    dst += length;
+    src += length;
+
+    if (length >= SMALL_SIZE && (((uintptr_t)dst ^ (uintptr_t)src) & wmask) == 0) {
+        while ((uintptr_t)dst & wmask) {
+            *--dst = *--src;
+            length--;
+        }
+
+        word* d = (word*)dst;
+        const word* s = (const word*)src;
+        size_t t = length / wsize;
+        for (; t >= 4; t -= 4) {
+            s -= 4;
+            d -= 4;
+            word w3 = s[3], w2 = s[2], w1 = s[1], w0 = s[0];
+            d[3] = w3; d[2] = w2; d[1] = w1; d[0] = w0;
+        }
+        while (t--)
+            *--d = *--s;
+
+        dst = (unsigned char*)d;
+        src = (const unsigned char*)s;
+        length &= wmask;
+    }
+
+    while (length--)
+        *--dst = *--src;
+}
+
+void* memcpy(void* dst0, const void* src0, size_t length) {
+    if (length != 0 && dst0 != src0)
+        copy_forward(dst0, src0, length, 0);
+    return dst0;
 }
 
 void* memmove(void* s1, const void* s2, size_t n) {
-    return memcpy(s1, s2, n);
+    unsigned char* dst = s1;
+    const unsigned char* src = s2;
+
+    if (n == 0 || dst == src)
+        return s1;
+
+    if (dst + n <= src || src + n <= dst)
+        copy_forward(dst, src, n, 0);
+    else if (dst < src)
+        copy_forward(dst, src, n, 1);
+    else
+        copy_backward(dst, src, n);
+    return s1;
 }
 
 void bcopy(const void* s1, void* s2, size_t n) {
-    memcpy(s2, s1, n);
+    memmove(s2, s1, n);
 }
 
-void* memset(void* dest, register int val, register size_t len) {
-    volatile unsigned char* ptr = (unsigned char*)dest;
-    while (len-- > 0)
-        *ptr++ = val;
+void* memset(void* dest, int val, size_t len) {
+    unsigned char* ptr = dest;
+    const unsigned char c = val;
+
+    if (len >= SMALL_SIZE) {
+        while ((uintptr_t)ptr & wmask) {
+            *ptr++ = c;
+            len--;
+        }
+
+        word pattern = c;
+        pattern |= pattern << 8;
+        pattern |= pattern << 16;
+
+        word* w = (word*)ptr;
+        size_t t = len / wsize;
+#ifdef __OR1300__
+        // the pattern is the same in either byte order
+        if (dma_usable((uintptr_t)w, len) && dma_available() && dma_done(dma_fill(w, pattern, t * wsize))) {
+            w += t;
+            t = 0;
+        }
+#endif
+        if (t >= 2 * LINE_WORDS && dcache_zero_line_allowed((uintptr_t)w)) {
+            // lines are allocated (zeroed) without reading them from memory
+            while ((uintptr_t)w & (CACHE_LINE_SIZE - 1)) {
+                *w++ = pattern;
+                t--;
+            }
+            for (; t >= LINE_WORDS; t -= LINE_WORDS) {
+                dcache_zero_line(w);
+                if (pattern != 0) {
+                    w[0] = pattern; w[1] = pattern; w[2] = pattern; w[3] = pattern;
+                    w[4] = pattern; w[5] = pattern; w[6] = pattern; w[7] = pattern;
+                }
+                w += LINE_WORDS;
+            }
+        }
+        for (; t >= 4; t -= 4) {
+            w[0] = pattern; w[1] = pattern; w[2] = pattern; w[3] = pattern;
+            w += 4;
+        }
+        while (t--)
+            *w++ = pattern;
+
+        ptr = (unsigned char*)w;
+        len &= wmask;
+    }
+
+    while (len--)
+        *ptr++ = c;
     return dest;
 }
+
+int memcmp(const void* s1, const void* s2, size_t n) {
+    const unsigned char* p1 = s1;
+    const unsigned char* p2 = s2;
+
+    if (n >= SMALL_SIZE && (((uintptr_t)p1 ^ (uintptr_t)p2) & wmask) == 0) {
+        while ((uintptr_t)p1 & wmask) {
+            if (*p1 != *p2)
+                return *p1 - *p2;
+            p1++;
+            p2++;
+            n--;
+        }
+        // stop at the first differing word, its bytes are compared below
+        while (n >= wsize && *(const word*)p1 == *(const word*)p2) {
+            p1 += wsize;
+            p2 += wsize;
+            n -= wsize;
+        }
+    }
+
+    for (; n; n--, p1++, p2++) {
+        if (*p1 != *p2)
+            return *p1 - *p2;
+    }
+    return 0;
+}
+
+size_t strlen(const char* s) {
+    const char* p = s;
+
+    while ((uintptr_t)p & wmask) {
+        if (*p == 0)
+            return p - s;
+        p++;
+    }
+    // reading the whole aligned word that holds the terminator is safe
+    const word* w = (const word*)p;
+    while (!HAS_ZERO(*w))
+        w++;
+    p = (const char*)w;
+    while (*p)
+        p++;
+    return p - s;
+}
+
+int strcmp(const char* s1, const char* s2) {
+    const unsigned char* p1 = (const unsigned char*)s1;
+    const unsigned char* p2 = (const unsigned char*)s2;
+
+    if ((((uintptr_t)p1 ^ (uintptr_t)p2) & wmask) == 0) {
+        while ((uintptr_t)p1 & wmask) {
+            if (*p1 != *p2 || *p1 == 0)
+                return *p1 - *p2;
+            p1++;
+            p2++;
+        }
+        while (*(const word*)p1 == *(const word*)p2 && !HAS_ZERO(*(const word*)p1)) {
+            p1 += wsize;
+            p2 += wsize;
+        }
+    }
+
+    while (*p1 == *p2 && *p1 != 0) {
+        p1++;
+        p2++;
+    }
+    return *p1 - *p2;
+}
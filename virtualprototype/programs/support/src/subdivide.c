@@ -0,0 +1,113 @@
+#include <subdivide.h>
+
+typedef struct {
+    uint16_t *image;
+    int width;
+    subdivide_pixel_t pixel;
+    void *arg;
+    subdivide_stats_t stats;
+} subdivide_t;
+
+static void subdivide_compute(subdivide_t *s, int x, int y) {
+    s->image[y * s->width + x] = s->pixel(x, y, s->arg);
+    s->stats.evaluated++;
+}
+
+/*
+ * Returns 1 if all border pixels of the rectangle have the value of its top left corner.
+ */
+static int subdivide_uniform(const subdivide_t *s, int x0, int y0, int x1, int y1) {
+    const uint16_t *top = s->image + y0 * s->width;
+    const uint16_t *bottom = s->image + y1 * s->width;
+    const uint16_t value = top[x0];
+
+    for (int x = x0; x <= x1; ++x) {
+        if (top[x] != value || bottom[x] != value)
+            return 0;
+    }
+    for (int y = y0 + 1; y < y1; ++y) {
+        if (s->image[y * s->width + x0] != value || s->image[y * s->width + x1] != value)
+            return 0;
+    }
+    return 1;
+}
+
+/*
+ * The border of the rectangle (x0, y0) - (x1, y1), both inclusive, is known, its
+ * interior is filled or computed.
+ */
+static void subdivide_rect(subdivide_t *s, int x0, int y0, int x1, int y1) {
+    const int w = x1 - x0 - 1, h = y1 - y0 - 1; // the interior
+
+    if (w <= 0 || h <= 0)
+        return;
+
+    if (subdivide_uniform(s, x0, y0, x1, y1)) {
+        const uint16_t value = s->image[y0 * s->width + x0];
+
+        for (int y = y0 + 1; y < y1; ++y) {
+            uint16_t *row = s->image + y * s->width;
+            for (int x = x0 + 1; x < x1; ++x)
+                row[x] = value;
+        }
+        s->stats.filled += w * h;
+        return;
+    }
+
+    if (w * h <= SUBDIVIDE_MIN_INTERIOR) {
+        for (int y = y0 + 1; y < y1; ++y) {
+            for (int x = x0 + 1; x < x1; ++x)
+                subdivide_compute(s, x, y);
+        }
+        return;
+    }
+
+    // the dividing line becomes a border of both halves
+    if (w >= h) {
+        const int xm = (x0 + x1) / 2;
+        for (int y = y0 + 1; y < y1; ++y)
+            subdivide_compute(s, xm, y);
+        subdivide_rect(s, x0, y0, xm, y1);
+        subdivide_rect(s, xm, y0, x1, y1);
+    } else {
+        const int ym = (y0 + y1) / 2;
+        for (int x = x0 + 1; x < x1; ++x)
+            subdivide_compute(s, x, ym);
+        subdivide_rect(s, x0, y0, x1, ym);
+        subdivide_rect(s, x0, ym, x1, y1);
+    }
+}
+
+void subdivide_render(uint16_t *image, int width, int height, subdivide_pixel_t pixel, void *arg,
+                      subdivide_stats_t *stats) {
+    subdivide_t s = {image, width, pixel, arg, {0, 0}};
+
+    if (width > 0 && height > 0) {
+        // the border of the image
+        for (int x = 0; x < width; ++x) {
+            subdivide_compute(&s, x, 0);
+            if (height > 1)
+                subdivide_compute(&s, x, height - 1);
+        }
+        for (int y = 1; y < height - 1; ++y) {
+            subdivide_compute(&s, 0, y);
+            if (width > 1)
+                subdivide_compute(&s, width - 1, y);
+        }
+        subdivide_rect(&s, 0, 0, width - 1, height - 1);
+    }
+    if (stats != NULL)
+        *stats = s.stats;
+}
+
+uint32_t subdivide_diff(const uint16_t *image, int width, int height, subdivide_pixel_t pixel, void *arg) {
+    uint32_t differing = 0;
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (image[y * width + x] != pixel(x, y, arg))
+                differing++;
+        }
+    }
+    return differing;
+}
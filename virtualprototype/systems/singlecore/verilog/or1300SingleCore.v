@@ -1,4 +1,5 @@
-module or1300SingleCore ( input wire         clock12MHz,
+module or1300SingleCore #( parameter fractalEngineEnabled = 0 ) // 1 adds the fractal engine (custom instruction 0x22, irq 4)
+                        ( input wire         clock12MHz,
                                              clock50MHz,
                                              nReset,
                           input wire         RxD,
@@ -72,6 +73,7 @@ module or1300SingleCore ( input wire         clock12MHz,
   wire [3:0]  s_byteEnables;
   wire        s_readNotWrite, s_dataValid, s_busy, s_privateData, s_privateDirty;
   wire [7:0]  s_burstSize;
+  wire        s_wrapBurst;
   
   /*
    *
@@ -419,6 +421,7 @@ module or1300SingleCore ( input wire         clock12MHz,
                      .addressDataIn(s_addressData),
                      .byteEnablesIn(s_byteEnables),
                      .burstSizeIn(s_burstSize),
+                     .wrapBurstIn(s_wrapBurst),
                      .endTransactionOut(s_sdramEndTransaction),
                      .dataValidOut(s_sdramDataValid),
                      .busyOut(s_sdramBusy),
@@ -455,6 +458,7 @@ module or1300SingleCore ( input wire         clock12MHz,
              .addressDataIn(s_addressData),
              .byteEnablesIn(s_byteEnables),
              .burstSizeIn(s_burstSize),
+             .wrapBurstIn(s_wrapBurst),
              .endTransactionOut(s_ssramEndTransaction),
              .dataValidOut(s_ssramDataValid),
              .addressDataOut(s_ssramAddressData));
@@ -481,10 +485,11 @@ module or1300SingleCore ( input wire         clock12MHz,
   wire        s_cpu1IcacheRequestBus, s_cpu1DcacheRequestBus;
   wire        s_cpu1IcacheBusAccessGranted, s_cpu1DcacheBusAccessGranted;
   wire        s_cpu1BeginTransaction, s_cpu1EndTransaction, s_cpu1ReadNotWrite;
-  wire [31:0] s_cpu1AddressData, s_fractalResult, s_delayResult, s_i2cCiResult, s_camCiResult;
+  wire [31:0] s_cpu1AddressData, s_fractalResult, s_delayResult, s_i2cCiResult, s_camCiResult, s_engineCiResult, s_mfpCiResult;
   wire [3:0]  s_cpu1byteEnables;
-  wire        s_cpu1DataValid, s_cpu1PrivateData, s_cpu1PrivateDirty, s_camCiDone;
+  wire        s_cpu1DataValid, s_cpu1PrivateData, s_cpu1PrivateDirty, s_camCiDone, s_engineCiDone, s_engineIrq, s_mfpCiDone;
   wire [7:0]  s_cpu1BurstSize;
+  wire        s_cpu1WrapBurst;
   wire        s_spm1Irq;
   wire        s_myBarrierValue, s_softBios, s_fractalDone, s_delayCiDone, s_i2cCiDone;
   wire [7:0]  s_barrierValues = {8{s_myBarrierValue}};
@@ -497,15 +502,16 @@ module or1300SingleCore ( input wire         clock12MHz,
                            s_cpu1stackTopReg;
     end
   
-  assign s_cpu1IrqVector[31:4] = 28'd0;
+  assign s_cpu1IrqVector[31:5] = 27'd0;
+  assign s_cpu1IrqVector[4] = s_engineIrq;
   assign s_cpu1IrqVector[3] = s_buttonsIrq;
   assign s_cpu1IrqVector[2] = s_dipswitchIrq;
   assign s_cpu1IrqVector[1] = s_spm1Irq;
   assign s_cpu1IrqVector[0] = s_uartIrq;
-  assign s_cpu1CiDone = s_hdmiDone | s_swapByteDone | s_flashDone | s_fractalDone | s_delayCiDone | s_i2cCiDone | s_camCiDone;
+  assign s_cpu1CiDone = s_hdmiDone | s_swapByteDone | s_flashDone | s_fractalDone | s_delayCiDone | s_i2cCiDone | s_camCiDone | s_engineCiDone | s_mfpCiDone;
   assign s_cpu1Enabled = 1'b1;
   assign s_cpu1ProfilingActive = 1'b1;
-  assign s_cpu1CiResult = s_hdmiResult | s_swapByteResult | s_flashResult | s_fractalResult | s_delayResult | s_i2cCiResult | s_camCiResult; 
+  assign s_cpu1CiResult = s_hdmiResult | s_swapByteResult | s_flashResult | s_fractalResult | s_delayResult | s_i2cCiResult | s_camCiResult | s_engineCiResult | s_mfpCiResult;
 
   or1300Top #( .processorId(1),
                .NumberOfProcessors(1),
@@ -590,7 +596,8 @@ module or1300SingleCore ( input wire         clock12MHz,
                .privateDirtyOut(s_cpu1PrivateDirty),
                .privateDirtyIn(s_privateDirty),
                .burstSizeOut(s_cpu1BurstSize),
-               .burstSizeIn(s_burstSize) );
+               .burstSizeIn(s_burstSize),
+               .wrapBurstOut(s_cpu1WrapBurst) );
 
   /*
    *
@@ -605,7 +612,9 @@ module or1300SingleCore ( input wire         clock12MHz,
   wire [31:0] s_spm1AddressData;
   
   spm8k #(.slaveBaseAddress(32'h50000040),
-          .spmBaseAddress(32'hC0000000)) spm1
+          .spmBaseAddress(32'hC0000000),
+          .dmaChannelBaseAddress(32'h500000A0),
+          .nrOfDmaChannels(2)) spm1
          (.clock(s_systemClock),
           .reset(s_reset),
           .dataToSpm(s_cpu1DataToSpm),
@@ -704,6 +713,22 @@ module or1300SingleCore ( input wire         clock12MHz,
                 .ciDone(s_fractalDone),
                 .ciResult(s_fractalResult) );
 
+  /*
+   *
+   * Here the custom instructions for the myflpt number format are defined
+   *
+   */
+  mfpIse #( .customInstructionId(8'h24)) mfp1
+          ( .clock(s_systemClock),
+            .reset(s_reset),
+            .ciStart(s_cpu1CiStart),
+            .ciCke(s_cpu1CiCke),
+            .ciN(s_cpu1CiN),
+            .ciValueA(s_cpu1CiDataA),
+            .ciValueB(s_cpu1CiDataB),
+            .ciDone(s_mfpCiDone),
+            .ciResult(s_mfpCiResult) );
+
   /*
    *
    * Here we define the camera interface
@@ -741,6 +766,60 @@ module or1300SingleCore ( input wire         clock12MHz,
            .busyIn(s_busy),
            .busErrorIn(s_busError));
 
+  /*
+   *
+   * Here we define the fractal engine, it renders a frame on its own
+   *
+   */
+  wire s_engineReqBus, s_engineAckBus, s_engineBeginTransaction, s_engineEndTransaction;
+  wire s_engineDataValid;
+  wire [31:0] s_engineAddressData;
+  wire [3:0] s_engineByteEnables;
+  wire [7:0] s_engineBurstSize;
+
+  // the engine has not been simulated yet, without it its bus request, irq and custom instruction stay zero
+  generate
+    if (fractalEngineEnabled != 0)
+      begin : engineGen
+        fractalEngine #(.customInstructionId(8'h22),
+                        .nrOfUnits(4),
+                        .maxBurstSize(9'd64)) engine
+                       (.clock(s_systemClock),
+                        .reset(s_cpuReset),
+                        .ciStart(s_cpu1CiStart),
+                        .ciCke(s_cpu1CiCke),
+                        .ciN(s_cpu1CiN),
+                        .ciValueA(s_cpu1CiDataA),
+                        .ciValueB(s_cpu1CiDataB),
+                        .ciResult(s_engineCiResult),
+                        .ciDone(s_engineCiDone),
+                        .irq(s_engineIrq),
+                        .requestBus(s_engineReqBus),
+                        .busGrant(s_engineAckBus),
+                        .beginTransactionOut(s_engineBeginTransaction),
+                        .addressDataOut(s_engineAddressData),
+                        .endTransactionOut(s_engineEndTransaction),
+                        .byteEnablesOut(s_engineByteEnables),
+                        .dataValidOut(s_engineDataValid),
+                        .burstSizeOut(s_engineBurstSize),
+                        .busyIn(s_busy),
+                        .busErrorIn(s_busError));
+      end
+    else
+      begin : noEngineGen
+        assign s_engineCiResult         = 32'd0;
+        assign s_engineCiDone           = 1'b0;
+        assign s_engineIrq              = 1'b0;
+        assign s_engineReqBus           = 1'b0;
+        assign s_engineBeginTransaction = 1'b0;
+        assign s_engineAddressData      = 32'd0;
+        assign s_engineEndTransaction   = 1'b0;
+        assign s_engineByteEnables      = 4'd0;
+        assign s_engineDataValid        = 1'b0;
+        assign s_engineBurstSize        = 8'd0;
+      end
+  endgenerate
+
   /*
    *
    * Here the hdmi controller is defined
@@ -845,6 +924,7 @@ module or1300SingleCore ( input wire         clock12MHz,
             .busErrorIn(s_busError),
             .addressDataIn(s_addressData),
             .burstSizeIn(s_burstSize),
+            .wrapBurstIn(s_wrapBurst),
             .byteEnablesIn(s_byteEnables),
             .addressDataOut(s_flashAddressData),
             .endTransactionOut(s_flashEndTransaction),
@@ -869,6 +949,7 @@ module or1300SingleCore ( input wire         clock12MHz,
               .dataValidIn(s_dataValid),
               .byteEnablesIn(s_byteEnables),
               .burstSizeIn(s_burstSize),
+              .wrapBurstIn(s_wrapBurst),
               .addressDataOut(s_biosAddressData),
               .busErrorOut(s_biosBusError),
               .dataValidOut(s_biosDataValid),
@@ -887,13 +968,15 @@ module or1300SingleCore ( input wire         clock12MHz,
  assign s_busRequests[29] = s_cpu1DcacheRequestBus;
  assign s_busRequests[28] = s_cpu1IcacheRequestBus;
  assign s_busRequests[27] = s_spm1RequestTransaction;
- assign s_busRequests[26:0] = 28'd0;
+ assign s_busRequests[26] = s_engineReqBus;
+ assign s_busRequests[25:0] = 26'd0;
  
  assign s_hdmiBusgranted             = s_busGrants[31];
  assign s_camAckBus                  = s_busGrants[30];
  assign s_cpu1DcacheBusAccessGranted = s_busGrants[29];
  assign s_cpu1IcacheBusAccessGranted = s_busGrants[28];
  assign s_spm1TransactionGranted     = s_busGrants[27];
+ assign s_engineAckBus               = s_busGrants[26];
 
  busArbiter arbiter ( .clock(s_systemClock),
                       .reset(s_reset),
@@ -916,20 +999,21 @@ module or1300SingleCore ( input wire         clock12MHz,
    */
  assign s_busError         = s_arbBusError | s_biosBusError | s_uartBusError | s_sdramBusError | s_spm1BusError | s_7SegBusError |
                              s_switchesBusError | s_ledsBusError;
- assign s_beginTransaction = s_cpu1BeginTransaction | s_hdmiBeginTransaction | s_spm1BeginTransaction | s_camBeginTransaction;
+ assign s_beginTransaction = s_cpu1BeginTransaction | s_hdmiBeginTransaction | s_spm1BeginTransaction | s_camBeginTransaction | s_engineBeginTransaction;
  assign s_endTransaction   = s_cpu1EndTransaction | s_arbEndTransaction | s_biosEndTransaction | s_uartEndTransaction |
                              s_sdramEndTransaction | s_hdmiEndTransaction | s_spm1EndTransaction | s_7SegEndTransaction |
-                             s_switchesEndTransaction | s_ledsEndTransaction | s_flashEndTransaction | s_camEndTransaction | s_ssramEndTransaction;
+                             s_switchesEndTransaction | s_ledsEndTransaction | s_flashEndTransaction | s_camEndTransaction | s_engineEndTransaction | s_ssramEndTransaction;
  assign s_addressData      = s_cpu1AddressData | s_biosAddressData | s_uartAddressData | s_sdramAddressData | s_hdmiAddressData |
                              s_spm1AddressData | s_7SegAddressData | s_switchesAddressData | s_ledsAddressData | s_flashAddressData |
-                             s_camAddressData | s_ssramAddressData;
- assign s_byteEnables      = s_cpu1byteEnables | s_hdmiByteEnables | s_spm1ByteEnables | s_camByteEnables;
+                             s_camAddressData | s_engineAddressData | s_ssramAddressData;
+ assign s_byteEnables      = s_cpu1byteEnables | s_hdmiByteEnables | s_spm1ByteEnables | s_camByteEnables | s_engineByteEnables;
  assign s_readNotWrite     = s_cpu1ReadNotWrite | s_hdmiReadNotWrite | s_spm1ReadNotWrite;
  assign s_dataValid        = s_cpu1DataValid | s_biosDataValid | s_uartDataValid | s_sdramDataValid | s_hdmiDataValid | s_spm1DataValid |
-                             s_7SegDataValid | s_switchesDataValid | s_ledsDataValid | s_flashDataValid | s_camDataValid | s_ssramDataValid;
+                             s_7SegDataValid | s_switchesDataValid | s_ledsDataValid | s_flashDataValid | s_camDataValid | s_engineDataValid | s_ssramDataValid;
  assign s_busy             = s_sdramBusy | s_spm1Busy;
  assign s_privateData      = s_cpu1PrivateData;
  assign s_privateDirty     = s_cpu1PrivateDirty;
- assign s_burstSize        = s_cpu1BurstSize | s_hdmiBurstSize | s_spm1BurstSize | s_camBurstSize;
+ assign s_burstSize        = s_cpu1BurstSize | s_hdmiBurstSize | s_spm1BurstSize | s_camBurstSize | s_engineBurstSize;
+ assign s_wrapBurst        = s_cpu1WrapBurst;
  
 endmodule